@@ -26,6 +26,7 @@
 # Boston, MA 02111-1307, USA.
 ###############################################################################
 
+import math
 import os
 
 import pytest
@@ -70,7 +71,19 @@ def cleanup_tables():
         "\"geom_test\"", "\"testdate\"", "\"dm_test_20\"", "\"dm_test_21\"",
         "\"test_POINT\"", "\"test_LINESTRING\"", "\"test_POLYGON\"",
         "\"test_MULTIPOINT\"", "\"test_MULTILINESTRING\"",
-        "\"test_MULTIPOLYGON\"", "\"test_GEOMETRYCOLLECTION\"", "\"test_NONE\""
+        "\"test_MULTIPOLYGON\"", "\"test_GEOMETRYCOLLECTION\"", "\"test_NONE\"",
+        "\"batch_test\"",
+        "\"prefetch_test\"",
+        "\"stats_test\"",
+        "\"upsert_test\"",
+        "\"deferred_index_test\"",
+        "\"large_values_test\"",
+        "\"paging_test\"",
+        "\"filter_test\"",
+        "\"filter_case_test\"",
+        "\"binary_test\"",
+        "\"deferred_index_tr_test\"",
+        "\"paging_order_test\""
     ]
 
     for table in tables_to_drop:
@@ -477,3 +490,941 @@ def test_dameng_11_crud_operations():
         deleted_feat = crud_lyr.GetFeature(test_features[0])
         assert deleted_feat is None, "DeleteFeature() seems to have had no effect."
 
+
+###############################################################################
+# 12. Test batched inserts with a partial last batch
+
+def test_dameng_12_batch_insert():
+    """Test BATCH_SIZE / COMMIT_INTERVAL layer creation options"""
+
+    lyr = gdaltest.dm_ds.CreateLayer(
+        "batch_test",
+        geom_type=ogr.wkbPoint,
+        options=["OVERWRITE=YES", "BATCH_SIZE=7", "COMMIT_INTERVAL=14"]
+    )
+    lyr.CreateField(ogr.FieldDefn("VALUE", ogr.OFTInteger))
+
+    for i in range(20):
+        feat = ogr.Feature(lyr.GetLayerDefn())
+        feat.SetField("VALUE", i)
+        feat.SetGeometryDirectly(ogr.CreateGeometryFromWkt(f"POINT ({i} {i})"))
+        assert lyr.CreateFeature(feat) == ogr.OGRERR_NONE
+
+    # The last 6 features are still buffered: reading must flush them
+    assert lyr.GetFeatureCount() == 20
+
+    lyr.SetAttributeFilter("VALUE >= 14")
+    values = sorted(f.GetField("VALUE") for f in lyr)
+    assert values == list(range(14, 20))
+    lyr.SetAttributeFilter(None)
+
+    for i in range(20, 23):
+        feat = ogr.Feature(lyr.GetLayerDefn())
+        feat.SetField("VALUE", i)
+        assert lyr.CreateFeature(feat) == ogr.OGRERR_NONE
+    assert lyr.SyncToDisk() == ogr.OGRERR_NONE
+    assert lyr.GetFeatureCount() == 23
+
+
+###############################################################################
+# 13. Test transactions
+
+@gdaltest.disable_exceptions()
+def test_dameng_13_transactions():
+    """Test StartTransaction / CommitTransaction / RollbackTransaction"""
+
+    ds = gdaltest.dm_ds
+    assert ds.TestCapability(ogr.ODsCTransactions)
+
+    lyr = ds.GetLayerByName("batch_test")
+    count = lyr.GetFeatureCount()
+
+    assert ds.StartTransaction() == ogr.OGRERR_NONE
+    assert ds.GetMetadataItem("bUserTransactionActive", "_debug_") == "1"
+    for i in range(3):
+        feat = ogr.Feature(lyr.GetLayerDefn())
+        feat.SetField("VALUE", 100 + i)
+        assert lyr.CreateFeature(feat) == ogr.OGRERR_NONE
+    assert lyr.GetFeatureCount() == count + 3
+    assert ds.RollbackTransaction() == ogr.OGRERR_NONE
+    assert ds.GetMetadataItem("nSoftTransactionLevel", "_debug_") == "0"
+    assert lyr.GetFeatureCount() == count
+
+    assert ds.StartTransaction() == ogr.OGRERR_NONE
+    with gdal.quiet_errors():
+        assert ds.StartTransaction() != ogr.OGRERR_NONE
+    feat = ogr.Feature(lyr.GetLayerDefn())
+    feat.SetField("VALUE", 200)
+    assert lyr.CreateFeature(feat) == ogr.OGRERR_NONE
+    assert ds.CommitTransaction() == ogr.OGRERR_NONE
+    assert lyr.GetFeatureCount() == count + 1
+
+    with gdal.quiet_errors():
+        assert ds.CommitTransaction() != ogr.OGRERR_NONE
+        assert ds.RollbackTransaction() != ogr.OGRERR_NONE
+
+
+###############################################################################
+# 14. Test GetArrowStreamAsNumPy() against GetNextFeature()
+
+def test_dameng_14_arrow_stream():
+    """Test the columnar read path"""
+
+    gdaltest.importorskip_gdal_array()
+    pytest.importorskip("numpy")
+
+    lyr = gdaltest.dm_ds.GetLayerByName("tpoly")
+    assert lyr.TestCapability(ogr.OLCFastGetArrowStream) == 1
+    fid_name = lyr.GetFIDColumn() or "OGC_FID"
+    geom_name = lyr.GetGeometryColumn() or "wkb_geometry"
+
+    expected = []
+    lyr.ResetReading()
+    for f in lyr:
+        expected.append((f.GetFID(), f.GetField("EAS_ID"), f.GetField("PRFEDEA"),
+                         f.GetGeometryRef().ExportToIsoWkb()))
+
+    lyr.ResetReading()
+    stream = lyr.GetArrowStreamAsNumPy(
+        options=["USE_MASKED_ARRAYS=NO", "MAX_FEATURES_IN_BATCH=3"])
+    got = []
+    for batch in stream:
+        for i in range(len(batch[fid_name])):
+            got.append((batch[fid_name][i], batch["EAS_ID"][i],
+                        batch["PRFEDEA"][i].decode("UTF-8"),
+                        bytes(batch[geom_name][i])))
+    assert got == expected
+
+    # A spatial filter is pushed down to the SQL query
+    lyr.SetSpatialFilterRect(479750, 4764450, 480000, 4764800)
+    count = lyr.GetFeatureCount()
+    lyr.ResetReading()
+    stream = lyr.GetArrowStreamAsNumPy(options=["USE_MASKED_ARRAYS=NO"])
+    assert sum(len(batch[fid_name]) for batch in stream) == count
+    lyr.SetSpatialFilter(None)
+
+
+###############################################################################
+# 15. Test that the server side spatial filter keeps the features that
+# straddle its edge, and that filters which are not rectangles are refined
+
+
+@pytest.mark.require_geos
+def test_dameng_15_spatial_filter_refinement():
+    """Test spatial filter results against a client side evaluation"""
+
+    lyr = gdaltest.dm_ds.GetLayerByName("tpoly")
+
+    def expected_fids(filter_geom):
+        lyr.SetSpatialFilter(None)
+        return sorted(
+            f.GetFID() for f in lyr
+            if f.GetGeometryRef().Intersects(filter_geom))
+
+    def got_fids(filter_geom):
+        lyr.SetSpatialFilter(filter_geom)
+        fids = sorted(f.GetFID() for f in lyr)
+        assert lyr.GetFeatureCount() == len(fids)
+        lyr.SetSpatialFilter(None)
+        return fids
+
+    rect = ogr.CreateGeometryFromWkt(
+        "POLYGON ((479750 4764450,479750 4764800,480000 4764800,"
+        "480000 4764450,479750 4764450))")
+    assert got_fids(rect) == expected_fids(rect)
+
+    triangle = ogr.CreateGeometryFromWkt(
+        "POLYGON ((479000 4763000,481000 4763000,479000 4765000,"
+        "479000 4763000))")
+    assert got_fids(triangle) == expected_fids(triangle)
+
+
+###############################################################################
+# 16. Test repeated FID lookups, updates and deletes on prepared statements
+
+@gdaltest.disable_exceptions()
+def test_dameng_16_prepared_fid_operations():
+    """Test GetFeature/SetFeature/DeleteFeature reusing cached statements"""
+
+    lyr = gdaltest.dm_ds.GetLayerByName("crud_test")
+    fids = sorted(f.GetFID() for f in lyr)
+    assert len(fids) == 4
+
+    for rnd in range(3):
+        for fid in fids:
+            feat = lyr.GetFeature(fid)
+            assert feat is not None
+            feat.SetField("NAME", f"round_{rnd}_{fid}")
+            feat.SetField("VALUE", rnd * 100 + fid)
+            feat.SetGeometryDirectly(
+                ogr.CreateGeometryFromWkt(f"POINT ({rnd} {fid})"))
+            assert lyr.SetFeature(feat) == ogr.OGRERR_NONE
+
+    for fid in fids:
+        feat = lyr.GetFeature(fid)
+        assert feat.GetField("NAME") == f"round_2_{fid}"
+        assert feat.GetField("VALUE") == 200 + fid
+        assert feat.GetGeometryRef().ExportToWkt() == f"POINT (2 {fid})"
+
+    # Null values and geometry go through the same statement
+    feat = lyr.GetFeature(fids[0])
+    feat.SetFieldNull("NAME")
+    feat.SetGeometryDirectly(None)
+    assert lyr.SetFeature(feat) == ogr.OGRERR_NONE
+    feat = lyr.GetFeature(fids[0])
+    assert feat.IsFieldNull("NAME")
+    assert feat.GetGeometryRef() is None
+
+    # A new column must not be hidden by statements prepared before it
+    assert lyr.CreateField(ogr.FieldDefn("EXTRA", ogr.OFTReal)) == 0
+    feat = lyr.GetFeature(fids[1])
+    feat.SetField("EXTRA", 1.5)
+    assert lyr.SetFeature(feat) == ogr.OGRERR_NONE
+    assert lyr.GetFeature(fids[1]).GetField("EXTRA") == 1.5
+
+    feat.SetFID(12345678)
+    assert lyr.SetFeature(feat) == ogr.OGRERR_NON_EXISTING_FEATURE
+    assert lyr.DeleteFeature(fids[1]) == ogr.OGRERR_NONE
+    assert lyr.DeleteFeature(fids[1]) == ogr.OGRERR_NON_EXISTING_FEATURE
+    with gdal.quiet_errors():
+        assert lyr.GetFeature(fids[1]) is None
+
+
+###############################################################################
+# 17. Test the PARALLEL_SCAN open option against a sequential read
+
+@pytest.mark.parametrize("ordered", ["YES", "NO"])
+def test_dameng_17_parallel_scan(ordered):
+    """Test reading a table over several sessions"""
+
+    def read(lyr):
+        return [(f.GetFID(), f.GetField("EAS_ID"),
+                 f.GetGeometryRef().ExportToIsoWkb()) for f in lyr]
+
+    lyr = gdaltest.dm_ds.GetLayerByName("tpoly")
+    expected = sorted(read(lyr))
+
+    ds = gdal.OpenEx(os.environ["DAMENG_CONNECTION_STRING"], gdal.OF_VECTOR,
+                     open_options=["PARALLEL_SCAN=3",
+                                   f"PARALLEL_SCAN_ORDERED={ordered}"])
+    par_lyr = ds.GetLayerByName("tpoly")
+    got = read(par_lyr)
+    if ordered == "YES":
+        assert got == expected
+    else:
+        assert sorted(got) == expected
+
+    # Filters are applied to every FID range
+    par_lyr.SetAttributeFilter("EAS_ID > 170")
+    par_lyr.SetSpatialFilterRect(479750, 4764450, 480000, 4764800)
+    lyr.SetAttributeFilter("EAS_ID > 170")
+    lyr.SetSpatialFilterRect(479750, 4764450, 480000, 4764800)
+    assert sorted(read(par_lyr)) == sorted(read(lyr))
+    lyr.SetAttributeFilter(None)
+    lyr.SetSpatialFilter(None)
+
+    # Stopping in the middle of a scan and reading again
+    par_lyr.SetAttributeFilter(None)
+    par_lyr.SetSpatialFilter(None)
+    par_lyr.ResetReading()
+    assert par_lyr.GetNextFeature() is not None
+    par_lyr.ResetReading()
+    assert len(read(par_lyr)) == len(expected)
+    ds = None
+
+
+def test_dameng_18_connection_pool():
+    """Test reusing sessions of closed datasources"""
+
+    dm_dsname = os.environ["DAMENG_CONNECTION_STRING"]
+    count = gdaltest.dm_ds.GetLayerByName("tpoly").GetFeatureCount()
+    with gdal.config_option("DM_CONNECTION_POOL", "YES"):
+        for _ in range(3):
+            ds = ogr.Open(dm_dsname, update=1)
+            lyr = ds.GetLayerByName("tpoly")
+            assert lyr.GetFeatureCount() == count
+            # A transaction left open is ended when the session is returned
+            assert ds.StartTransaction() == ogr.OGRERR_NONE
+            ds = None
+
+        # Sessions beyond the pool size are closed when they are returned
+        with gdal.config_option("DM_CONNECTION_POOL_SIZE", "1"):
+            dss = [ogr.Open(dm_dsname) for _ in range(3)]
+            assert all(ds is not None for ds in dss)
+            dss = None
+
+        with gdal.config_option("DM_CONNECTION_POOL_IDLE_TIMEOUT", "0"):
+            ds = ogr.Open(dm_dsname)
+            assert ds.GetLayerByName("tpoly").GetFeatureCount() == count
+            ds = None
+
+
+def test_dameng_19_catalog_cache(tmp_path):
+    """Test opening with the catalog read from the cache file"""
+
+    def describe(ds):
+        ret = {}
+        for lyr in ds:
+            defn = lyr.GetLayerDefn()
+            ret[lyr.GetName()] = (
+                lyr.GetFIDColumn(),
+                [(defn.GetFieldDefn(i).GetName(),
+                  defn.GetFieldDefn(i).GetType(),
+                  defn.GetFieldDefn(i).IsNullable())
+                 for i in range(defn.GetFieldCount())],
+                [(defn.GetGeomFieldDefn(i).GetName(),
+                  defn.GetGeomFieldDefn(i).GetType(),
+                  defn.GetGeomFieldDefn(i).GetSpatialRef() is not None)
+                 for i in range(defn.GetGeomFieldCount())])
+        return ret
+
+    dm_dsname = os.environ["DAMENG_CONNECTION_STRING"]
+    cache = str(tmp_path / "catalog.json")
+    expected = describe(ogr.Open(dm_dsname))
+
+    ds = gdal.OpenEx(dm_dsname, gdal.OF_VECTOR,
+                     open_options=[f"CATALOG_CACHE={cache}"])
+    assert describe(ds) == expected
+    ds = None
+    assert os.path.exists(cache)
+
+    ds = gdal.OpenEx(dm_dsname, gdal.OF_VECTOR,
+                     open_options=[f"CATALOG_CACHE={cache}"])
+    assert describe(ds) == expected
+    ds = None
+
+    # A DDL statement invalidates the cache
+    gdaltest.dm_ds.ExecuteSQL('ALTER TABLE "tpoly" ADD "CACHE_TEST" INT')
+    try:
+        ds = gdal.OpenEx(dm_dsname, gdal.OF_VECTOR,
+                         open_options=[f"CATALOG_CACHE={cache}"])
+        defn = ds.GetLayerByName("tpoly").GetLayerDefn()
+        assert defn.GetFieldIndex("CACHE_TEST") >= 0
+        ds = None
+    finally:
+        gdaltest.dm_ds.ExecuteSQL('ALTER TABLE "tpoly" DROP "CACHE_TEST"')
+
+
+def test_dameng_20_ignored_fields():
+    """Test that ignored fields are not fetched"""
+
+    lyr = gdaltest.dm_ds.GetLayerByName("tpoly")
+    assert lyr.TestCapability(ogr.OLCIgnoreFields)
+
+    lyr.ResetReading()
+    expected = [(f.GetFID(), f.GetField("EAS_ID")) for f in lyr]
+
+    assert lyr.SetIgnoredFields(["AREA", "PRFEDEA", "OGR_GEOMETRY"]) == 0
+    try:
+        got = []
+        for f in lyr:
+            assert f.GetGeometryRef() is None
+            assert not f.IsFieldSet("AREA")
+            assert not f.IsFieldSet("PRFEDEA")
+            got.append((f.GetFID(), f.GetField("EAS_ID")))
+        assert got == expected
+
+        # Random reads honour the projection too
+        f = lyr.GetFeature(expected[0][0])
+        assert f.GetGeometryRef() is None
+        assert f.GetField("EAS_ID") == expected[0][1]
+
+        # The geometry is still read to evaluate a spatial filter
+        lyr.SetSpatialFilter(ogr.CreateGeometryFromWkt(
+            "POLYGON((479750 4764450,480000 4764450,480000 4764800,"
+            "479750 4764450))"))
+        assert lyr.GetFeatureCount() == len(list(lyr))
+        lyr.SetSpatialFilter(None)
+    finally:
+        lyr.SetIgnoredFields([])
+
+    lyr.ResetReading()
+    f = lyr.GetNextFeature()
+    assert f.GetGeometryRef() is not None
+    assert f.IsFieldSet("AREA")
+
+
+###############################################################################
+# 21. Test the PREFETCH open option against a plain read
+
+def test_dameng_21_prefetch():
+    """Test fetching the next block of rows in the background"""
+
+    def read(lyr):
+        return [(f.GetFID(), f.GetField("VALUE"),
+                 f.GetGeometryRef().ExportToIsoWkb()) for f in lyr]
+
+    lyr = gdaltest.dm_ds.CreateLayer(
+        "prefetch_test",
+        geom_type=ogr.wkbPoint,
+        options=["OVERWRITE=YES", "BATCH_SIZE=500"]
+    )
+    lyr.CreateField(ogr.FieldDefn("VALUE", ogr.OFTInteger))
+    for i in range(2500):
+        feat = ogr.Feature(lyr.GetLayerDefn())
+        feat.SetField("VALUE", i)
+        feat.SetGeometryDirectly(ogr.CreateGeometryFromWkt(f"POINT ({i} {i})"))
+        assert lyr.CreateFeature(feat) == ogr.OGRERR_NONE
+    assert lyr.SyncToDisk() == ogr.OGRERR_NONE
+    expected = read(lyr)
+
+    # A 1 MB budget fetches the points in several blocks
+    ds = gdal.OpenEx(os.environ["DAMENG_CONNECTION_STRING"],
+                     gdal.OF_VECTOR | gdal.OF_UPDATE,
+                     open_options=["PREFETCH=YES", "FETCH_MEMORY=1"])
+    pre_lyr = ds.GetLayerByName("prefetch_test")
+    assert read(pre_lyr) == expected
+
+    # Stopping in the middle of a read and reading again
+    pre_lyr.ResetReading()
+    for _ in range(1500):
+        assert pre_lyr.GetNextFeature() is not None
+    pre_lyr.ResetReading()
+    assert read(pre_lyr) == expected
+
+    # Inside a transaction, the rows are read on the main session
+    assert ds.StartTransaction() == ogr.OGRERR_NONE
+    feat = ogr.Feature(pre_lyr.GetLayerDefn())
+    feat.SetField("VALUE", 2500)
+    feat.SetGeometryDirectly(ogr.CreateGeometryFromWkt("POINT (0 0)"))
+    assert pre_lyr.CreateFeature(feat) == ogr.OGRERR_NONE
+    pre_lyr.ResetReading()
+    assert len(read(pre_lyr)) == len(expected) + 1
+    assert ds.RollbackTransaction() == ogr.OGRERR_NONE
+    ds = None
+
+
+###############################################################################
+# 22. Test the cached and estimated counts and extents
+
+def test_dameng_22_cached_count_and_extent():
+    """Test that cached counts and extents follow the writes"""
+
+    lyr = gdaltest.dm_ds.CreateLayer(
+        "stats_test", geom_type=ogr.wkbPoint, options=["OVERWRITE=YES"])
+    for i in range(10):
+        feat = ogr.Feature(lyr.GetLayerDefn())
+        feat.SetGeometryDirectly(ogr.CreateGeometryFromWkt(f"POINT ({i} {i})"))
+        assert lyr.CreateFeature(feat) == ogr.OGRERR_NONE
+
+    assert lyr.GetFeatureCount() == 10
+    assert lyr.GetExtent() == (0, 9, 0, 9)
+    # Estimates come from statistics that may not have been gathered yet
+    assert lyr.GetFeatureCount(force=0) >= -1
+
+    feat = ogr.Feature(lyr.GetLayerDefn())
+    feat.SetGeometryDirectly(ogr.CreateGeometryFromWkt("POINT (100 -5)"))
+    assert lyr.CreateFeature(feat) == ogr.OGRERR_NONE
+    assert lyr.GetFeatureCount() == 11
+    assert lyr.GetExtent() == (0, 100, -5, 9)
+
+    assert lyr.DeleteFeature(feat.GetFID()) == ogr.OGRERR_NONE
+    assert lyr.GetFeatureCount() == 10
+    assert lyr.GetExtent() == (0, 9, 0, 9)
+
+    # A rolled back insert is forgotten
+    assert gdaltest.dm_ds.StartTransaction() == ogr.OGRERR_NONE
+    feat = ogr.Feature(lyr.GetLayerDefn())
+    feat.SetGeometryDirectly(ogr.CreateGeometryFromWkt("POINT (50 50)"))
+    assert lyr.CreateFeature(feat) == ogr.OGRERR_NONE
+    assert lyr.GetFeatureCount() == 11
+    assert gdaltest.dm_ds.RollbackTransaction() == ogr.OGRERR_NONE
+    assert lyr.GetFeatureCount() == 10
+
+    # Filtered counts are not cached
+    lyr.SetSpatialFilterRect(-1, -1, 4.5, 4.5)
+    assert lyr.GetFeatureCount() == 5
+    lyr.SetSpatialFilter(None)
+    assert lyr.GetFeatureCount() == 10
+
+
+###############################################################################
+# Test UpsertFeature()
+
+
+def test_dameng_23_upsert():
+    """Test that UpsertFeature() updates existing rows and inserts new ones"""
+
+    lyr = gdaltest.dm_ds.CreateLayer(
+        "upsert_test", geom_type=ogr.wkbPoint, options=["OVERWRITE=YES"])
+    lyr.CreateField(ogr.FieldDefn("name", ogr.OFTString))
+    assert lyr.TestCapability(ogr.OLCUpsertFeature)
+
+    for i in range(3):
+        feat = ogr.Feature(lyr.GetLayerDefn())
+        feat.SetField("name", f"old{i}")
+        feat.SetGeometryDirectly(ogr.CreateGeometryFromWkt(f"POINT ({i} {i})"))
+        assert lyr.CreateFeature(feat) == ogr.OGRERR_NONE
+    fids = [f.GetFID() for f in lyr]
+
+    feat = ogr.Feature(lyr.GetLayerDefn())
+    feat.SetFID(fids[1])
+    feat.SetField("name", "new1")
+    feat.SetGeometryDirectly(ogr.CreateGeometryFromWkt("POINT (10 10)"))
+    assert lyr.UpsertFeature(feat) == ogr.OGRERR_NONE
+
+    new_fid = max(fids) + 100
+    feat = ogr.Feature(lyr.GetLayerDefn())
+    feat.SetFID(new_fid)
+    feat.SetField("name", "inserted")
+    feat.SetGeometryDirectly(ogr.CreateGeometryFromWkt("POINT (20 20)"))
+    assert lyr.UpsertFeature(feat) == ogr.OGRERR_NONE
+
+    assert lyr.GetFeatureCount() == 4
+    feat = lyr.GetFeature(fids[1])
+    assert feat.GetField("name") == "new1"
+    assert feat.GetGeometryRef().ExportToWkt() == "POINT (10 10)"
+    feat = lyr.GetFeature(new_fid)
+    assert feat.GetField("name") == "inserted"
+    assert lyr.GetFeature(fids[0]).GetField("name") == "old0"
+
+    # A FID is required
+    feat = ogr.Feature(lyr.GetLayerDefn())
+    with gdaltest.disable_exceptions(), gdal.quiet_errors():
+        assert lyr.UpsertFeature(feat) != ogr.OGRERR_NONE
+
+
+###############################################################################
+# Test deferred creation of the spatial index and geometry checks
+
+
+def test_dameng_24_deferred_index():
+    """Test that DEFERRED_INDEX builds the index after the load"""
+
+    lyr = gdaltest.dm_ds.CreateLayer(
+        "deferred_index_test",
+        geom_type=ogr.wkbPoint,
+        options=["OVERWRITE=YES", "SPATIAL_INDEX=YES", "DEFERRED_INDEX=YES"],
+    )
+    for i in range(100):
+        feat = ogr.Feature(lyr.GetLayerDefn())
+        feat.SetGeometryDirectly(ogr.CreateGeometryFromWkt(f"POINT ({i} {i})"))
+        assert lyr.CreateFeature(feat) == ogr.OGRERR_NONE
+
+    def index_count():
+        sql_lyr = gdaltest.dm_ds.ExecuteSQL(
+            "SELECT COUNT(*) FROM ALL_INDEXES WHERE INDEX_NAME = "
+            "'deferred_index_test_wkb_geometry_sidx'")
+        count = sql_lyr.GetNextFeature().GetField(0)
+        gdaltest.dm_ds.ReleaseResultSet(sql_lyr)
+        return int(count)
+
+    assert index_count() == 0
+    assert lyr.SyncToDisk() == ogr.OGRERR_NONE
+    assert index_count() == 1
+
+    # The geometry checks are back once the index is built
+    feat = ogr.Feature(lyr.GetLayerDefn())
+    feat.SetGeometryDirectly(ogr.CreateGeometryFromWkt("LINESTRING (0 0,1 1)"))
+    with gdaltest.disable_exceptions(), gdal.quiet_errors():
+        lyr.CreateFeature(feat)
+        lyr.SyncToDisk()
+    assert lyr.GetFeatureCount() == 100
+
+    lyr.SetSpatialFilterRect(-0.5, -0.5, 9.5, 9.5)
+    assert lyr.GetFeatureCount() == 10
+    lyr.SetSpatialFilter(None)
+
+
+###############################################################################
+# Test the statistics reported in the DAMENG_STATS metadata domain
+
+
+def test_dameng_25_stats():
+    """Test that the calls to the server are counted"""
+
+    assert "DAMENG_STATS" in gdaltest.dm_ds.GetMetadataDomainList()
+
+    lyr = gdaltest.dm_ds.CreateLayer(
+        "stats_test", geom_type=ogr.wkbPoint, options=["OVERWRITE=YES"]
+    )
+    before = gdaltest.dm_ds.GetMetadata("DAMENG_STATS")
+    for i in range(10):
+        feat = ogr.Feature(lyr.GetLayerDefn())
+        feat.SetGeometryDirectly(ogr.CreateGeometryFromWkt(f"POINT ({i} {i})"))
+        assert lyr.CreateFeature(feat) == ogr.OGRERR_NONE
+    assert lyr.SyncToDisk() == ogr.OGRERR_NONE
+    assert len([f for f in lyr]) == 10
+
+    after = gdaltest.dm_ds.GetMetadata("DAMENG_STATS")
+    for key in ("EXECUTE_CALLS", "FETCH_CALLS", "COMMIT_CALLS"):
+        assert int(after[key]) > int(before[key])
+    assert int(after["ENCODE_ROWS"]) - int(before["ENCODE_ROWS"]) == 10
+    assert int(after["DECODE_ROWS"]) - int(before["DECODE_ROWS"]) == 10
+    assert int(after["FETCH_ROWS"]) - int(before["FETCH_ROWS"]) >= 10
+    assert float(after["EXECUTE_TIME_MS"]) >= float(before["EXECUTE_TIME_MS"])
+    assert (
+        gdaltest.dm_ds.GetMetadataItem("FETCH_ROWS", "DAMENG_STATS")
+        == after["FETCH_ROWS"]
+    )
+
+
+###############################################################################
+# Test large geometries and LOB values with a small LOB chunk size
+
+
+def test_dameng_26_large_values():
+    """Test large values read and written piecewise"""
+
+    ds = gdal.OpenEx(
+        os.environ["DAMENG_CONNECTION_STRING"],
+        gdal.OF_VECTOR | gdal.OF_UPDATE,
+        open_options=["LOB_CHUNK_SIZE=1"],
+    )
+    lyr = ds.CreateLayer(
+        "large_values_test",
+        geom_type=ogr.wkbPolygon,
+        options=["OVERWRITE=YES", "BATCH_SIZE=100"],
+    )
+    lyr.CreateField(ogr.FieldDefn("VALUE", ogr.OFTInteger))
+    expected = {}
+    for i in range(20):
+        # One polygon out of four is well above 1 KB
+        n = 2000 if i % 4 == 0 else 4
+        ring = ",".join(
+            f"{math.cos(2 * math.pi * k / n)} {math.sin(2 * math.pi * k / n)}"
+            for k in range(n)
+        )
+        wkt = f"POLYGON (({ring},1 0))"
+        feat = ogr.Feature(lyr.GetLayerDefn())
+        feat.SetField("VALUE", i)
+        feat.SetGeometryDirectly(ogr.CreateGeometryFromWkt(wkt))
+        assert lyr.CreateFeature(feat) == ogr.OGRERR_NONE
+        expected[i] = feat.GetGeometryRef().ExportToIsoWkb()
+    assert lyr.SyncToDisk() == ogr.OGRERR_NONE
+
+    got = {f.GetField("VALUE"): f.GetGeometryRef().ExportToIsoWkb() for f in lyr}
+    assert got == expected
+
+    # The WKT of the large polygon is read in several LOB chunks
+    geom_name = lyr.GetGeometryColumn() or "wkb_geometry"
+    sql_lyr = ds.ExecuteSQL(
+        f'SELECT TO_CLOB(DMGEO2.ST_AsText("{geom_name}")) AS WKT '
+        'FROM "large_values_test" WHERE "VALUE" = 0'
+    )
+    wkt = sql_lyr.GetNextFeature().GetField("WKT")
+    ds.ReleaseResultSet(sql_lyr)
+    assert ogr.CreateGeometryFromWkt(wkt).Equals(
+        ogr.CreateGeometryFromWkb(expected[0])
+    )
+    ds = None
+
+
+###############################################################################
+# Test SetNextByIndex() paging on the server
+
+
+def test_dameng_27_set_next_by_index():
+    """Test pages read with SetNextByIndex() match a sequential read"""
+
+    ds = gdal.OpenEx(
+        os.environ["DAMENG_CONNECTION_STRING"], gdal.OF_VECTOR | gdal.OF_UPDATE
+    )
+    lyr = ds.CreateLayer(
+        "paging_test", geom_type=ogr.wkbPoint, options=["OVERWRITE=YES"]
+    )
+    lyr.CreateField(ogr.FieldDefn("VALUE", ogr.OFTInteger))
+    for i in range(250):
+        feat = ogr.Feature(lyr.GetLayerDefn())
+        feat.SetField("VALUE", i)
+        feat.SetGeometryDirectly(ogr.CreateGeometryFromWkt(f"POINT ({i} {i})"))
+        assert lyr.CreateFeature(feat) == ogr.OGRERR_NONE
+    assert lyr.SyncToDisk() == ogr.OGRERR_NONE
+    assert lyr.TestCapability(ogr.OLCFastSetNextByIndex)
+
+    expected = sorted(f.GetFID() for f in lyr)
+
+    def read_page(index, count=10):
+        assert lyr.SetNextByIndex(index) == ogr.OGRERR_NONE
+        fids = []
+        for _ in range(count):
+            feat = lyr.GetNextFeature()
+            if feat is None:
+                break
+            fids.append(feat.GetFID())
+        return fids
+
+    # Pages in order continue from the last FID read, then jump around
+    for index in list(range(0, 250, 10)) + [200, 30, 245, 0]:
+        assert read_page(index) == expected[index : index + 10]
+
+    lyr.SetAttributeFilter('"VALUE" >= 100')
+    assert read_page(5) == expected[105:115]
+    lyr.SetAttributeFilter(None)
+
+    assert lyr.SetNextByIndex(250) == ogr.OGRERR_NON_EXISTING_FEATURE
+    assert lyr.GetNextFeature() is None
+    assert lyr.SetNextByIndex(-1) == ogr.OGRERR_NON_EXISTING_FEATURE
+    ds = None
+
+
+###############################################################################
+# Test translation of OGR SQL attribute filters to DaMeng SQL
+
+
+def test_dameng_28_attribute_filter_translation():
+    """Test attribute filters evaluated on server side, client side or both"""
+
+    ds = gdal.OpenEx(
+        os.environ["DAMENG_CONNECTION_STRING"], gdal.OF_VECTOR | gdal.OF_UPDATE
+    )
+    lyr = ds.CreateLayer(
+        "filter_test", geom_type=ogr.wkbPoint, options=["OVERWRITE=YES"]
+    )
+    lyr.CreateField(ogr.FieldDefn("NAME", ogr.OFTString))
+    lyr.CreateField(ogr.FieldDefn("VALUE", ogr.OFTInteger))
+    lyr.CreateField(ogr.FieldDefn("DAY", ogr.OFTDate))
+    rows = []
+    for i in range(30):
+        feat = ogr.Feature(lyr.GetLayerDefn())
+        name = None if i % 10 == 9 else f"name_{i}"
+        feat.SetField("NAME", name)
+        feat.SetField("VALUE", i)
+        feat.SetField("DAY", f"2024-01-{i + 1:02d}")
+        feat.SetGeometryDirectly(ogr.CreateGeometryFromWkt(f"POINT ({i} {i})"))
+        assert lyr.CreateFeature(feat) == ogr.OGRERR_NONE
+        rows.append((name, i))
+    assert lyr.SyncToDisk() == ogr.OGRERR_NONE
+
+    def check(where, expected_values, fast_count):
+        lyr.SetAttributeFilter(where)
+        assert sorted(f.GetField("VALUE") for f in lyr) == expected_values, where
+        assert lyr.GetFeatureCount() == len(expected_values), where
+        assert lyr.TestCapability(ogr.OLCFastFeatureCount) == fast_count, where
+
+    # Entirely translated
+    check("VALUE >= 5 AND VALUE < 8", [5, 6, 7], True)
+    check("VALUE BETWEEN 10 AND 12 OR VALUE IN (1, 2)", [1, 2, 10, 11, 12], True)
+    check("NAME LIKE 'name_1%'", [1] + list(range(10, 19)), True)
+    check("NAME ILIKE 'NAME_2_'", list(range(20, 29)), True)
+    check("NAME IS NULL", [9, 19, 29], True)
+    check("NOT (NAME IS NULL) AND VALUE < 3", [0, 1, 2], True)
+    check("DAY > '2024/01/28'", [28, 29], True)
+    check("VALUE = 3 AND NAME = 'it''s'", [], True)
+
+    # The CONCAT() part is evaluated on client side only
+    check("VALUE > 20 AND CONCAT(NAME, 'x') = 'name_25x'", [25], False)
+    check("VALUE = 1 OR CONCAT(NAME, 'x') = 'name_25x'", [1, 25], False)
+
+    # Not OGR SQL: passed as it is to the server
+    check("MOD(VALUE, 10) = 0", [0, 10, 20], True)
+
+    lyr.SetAttributeFilter(None)
+    assert lyr.GetFeatureCount() == 30
+    ds = None
+
+
+###############################################################################
+# Test string comparisons translated to DaMeng SQL ignore case like OGR SQL
+
+
+def test_dameng_29_attribute_filter_string_case():
+    """Test translated string comparisons match those of OGR SQL"""
+
+    ds = gdal.OpenEx(
+        os.environ["DAMENG_CONNECTION_STRING"], gdal.OF_VECTOR | gdal.OF_UPDATE
+    )
+    lyr = ds.CreateLayer(
+        "filter_case_test", geom_type=ogr.wkbNone, options=["OVERWRITE=YES"]
+    )
+    mem_ds = ogr.GetDriverByName("Memory").CreateDataSource("")
+    mem_lyr = mem_ds.CreateLayer("filter_case_test", geom_type=ogr.wkbNone)
+    for target in (lyr, mem_lyr):
+        target.CreateField(ogr.FieldDefn("NAME", ogr.OFTString))
+        target.CreateField(ogr.FieldDefn("VALUE", ogr.OFTInteger))
+    names = ["ABC", "abc", "Abd", "a_c", "aZc", "ABCD", "b", None]
+    for i, name in enumerate(names):
+        for target in (lyr, mem_lyr):
+            feat = ogr.Feature(target.GetLayerDefn())
+            feat.SetField("NAME", name)
+            feat.SetField("VALUE", i)
+            assert target.CreateFeature(feat) == ogr.OGRERR_NONE
+    assert lyr.SyncToDisk() == ogr.OGRERR_NONE
+
+    for where in [
+        "NAME = 'abc'",
+        "NAME = 'ABC' AND VALUE > 0",
+        "NAME <> 'aBc'",
+        "NAME < 'abd'",
+        "NAME <= 'ABD'",
+        "NAME > 'a_c'",
+        "NAME >= 'AZC'",
+        "NAME BETWEEN 'abc' AND 'AZZ'",
+        "NAME IN ('abc', 'AZC')",
+        "NOT (NAME IN ('ABC'))",
+    ]:
+        mem_lyr.SetAttributeFilter(where)
+        expected = sorted(f.GetField("VALUE") for f in mem_lyr)
+        lyr.SetAttributeFilter(where)
+        assert lyr.TestCapability(ogr.OLCFastFeatureCount), where
+        assert sorted(f.GetField("VALUE") for f in lyr) == expected, where
+        assert lyr.GetFeatureCount() == len(expected), where
+
+    # Constants are lowered on client side, so that an index on
+    # LOWER("NAME") can serve the comparison
+    ds.ExecuteSQL(
+        'CREATE INDEX "filter_case_test_lower_idx" ON "filter_case_test"'
+        '(LOWER("NAME"))'
+    )
+    got_msg = []
+
+    def my_handler(errorClass, errno, msg):
+        got_msg.append(msg)
+
+    with gdaltest.error_handler(my_handler), gdaltest.config_option(
+        "CPL_DEBUG", "ON"
+    ):
+        lyr.SetAttributeFilter("NAME = 'ABC'")
+        lyr.SetAttributeFilter("NAME = '1-2'")
+    assert (
+        """DAMENG: Attribute filter evaluated on server side: (LOWER("NAME") = 'abc')"""
+        in got_msg
+    )
+    # Case does not matter for constants without letters
+    assert (
+        """DAMENG: Attribute filter evaluated on server side: ("NAME" = '1-2')"""
+        in got_msg
+    )
+
+    lyr.SetAttributeFilter("NAME = 'ABC'")
+    assert sorted(f.GetField("VALUE") for f in lyr) == [0, 1]
+
+    lyr.SetAttributeFilter(None)
+    ds = None
+
+
+###############################################################################
+# Test binary values read through the Arrow API
+
+
+def test_dameng_30_arrow_stream_binary():
+    """Test binary values of GetArrowStreamAsNumPy() against GetNextFeature()"""
+
+    gdaltest.importorskip_gdal_array()
+    pytest.importorskip("numpy")
+
+    ds = gdal.OpenEx(
+        os.environ["DAMENG_CONNECTION_STRING"], gdal.OF_VECTOR | gdal.OF_UPDATE
+    )
+    lyr = ds.CreateLayer(
+        "binary_test", geom_type=ogr.wkbNone, options=["OVERWRITE=YES"]
+    )
+    lyr.CreateField(ogr.FieldDefn("DATA", ogr.OFTBinary))
+    values = [b"\x00\x01\xff", None, b"GDAL", b"\x7f"]
+    for value in values:
+        feat = ogr.Feature(lyr.GetLayerDefn())
+        if value is not None:
+            feat.SetFieldBinaryFromHexString("DATA", value.hex())
+        assert lyr.CreateFeature(feat) == ogr.OGRERR_NONE
+    assert lyr.SyncToDisk() == ogr.OGRERR_NONE
+
+    with ds.ExecuteSQL('SELECT "DATA" FROM "binary_test"') as sql_lyr:
+        assert sql_lyr.GetLayerDefn().GetFieldDefn(0).GetType() == ogr.OFTBinary
+        expected = [
+            f.GetFieldAsBinary(0) if f.IsFieldSetAndNotNull(0) else None
+            for f in sql_lyr
+        ]
+        assert sorted(v for v in expected if v) == sorted(v for v in values if v)
+
+        sql_lyr.ResetReading()
+        stream = sql_lyr.GetArrowStreamAsNumPy(options=["USE_MASKED_ARRAYS=NO"])
+        got = []
+        for batch in stream:
+            got += [None if v is None else bytes(v) for v in batch["DATA"]]
+        assert got == expected
+    ds = None
+
+
+###############################################################################
+# Test DEFERRED_INDEX on a layer loaded inside an explicit transaction
+
+
+def test_dameng_31_deferred_index_in_transaction():
+    """Test that the deferred index is built once the transaction commits"""
+
+    ds = gdal.OpenEx(
+        os.environ["DAMENG_CONNECTION_STRING"], gdal.OF_VECTOR | gdal.OF_UPDATE
+    )
+    lyr = ds.CreateLayer(
+        "deferred_index_tr_test",
+        geom_type=ogr.wkbPoint,
+        options=["OVERWRITE=YES", "SPATIAL_INDEX=YES", "DEFERRED_INDEX=YES"],
+    )
+
+    def index_count():
+        sql_lyr = ds.ExecuteSQL(
+            "SELECT COUNT(*) FROM ALL_INDEXES WHERE INDEX_NAME = "
+            "'deferred_index_tr_test_wkb_geometry_sidx'")
+        count = sql_lyr.GetNextFeature().GetField(0)
+        ds.ReleaseResultSet(sql_lyr)
+        return int(count)
+
+    assert ds.StartTransaction() == ogr.OGRERR_NONE
+    for i in range(100):
+        feat = ogr.Feature(lyr.GetLayerDefn())
+        feat.SetGeometryDirectly(ogr.CreateGeometryFromWkt(f"POINT ({i} {i})"))
+        assert lyr.CreateFeature(feat) == ogr.OGRERR_NONE
+
+    # The DDL would commit the transaction, so it waits for its end
+    assert lyr.SyncToDisk() == ogr.OGRERR_NONE
+    assert index_count() == 0
+    assert ds.CommitTransaction() == ogr.OGRERR_NONE
+    assert index_count() == 1
+    assert lyr.GetFeatureCount() == 100
+
+    lyr.SetSpatialFilterRect(-0.5, -0.5, 9.5, 9.5)
+    assert lyr.GetFeatureCount() == 10
+    lyr.SetSpatialFilter(None)
+
+    # Closing the dataset in a transaction leaves the layer without index
+    lyr = ds.CreateLayer(
+        "deferred_index_tr_test",
+        geom_type=ogr.wkbPoint,
+        options=["OVERWRITE=YES", "SPATIAL_INDEX=YES", "DEFERRED_INDEX=YES"],
+    )
+    assert ds.StartTransaction() == ogr.OGRERR_NONE
+    feat = ogr.Feature(lyr.GetLayerDefn())
+    feat.SetGeometryDirectly(ogr.CreateGeometryFromWkt("POINT (0 0)"))
+    assert lyr.CreateFeature(feat) == ogr.OGRERR_NONE
+    with gdal.quiet_errors():
+        ds = None
+        assert "not created" in gdal.GetLastErrorMsg()
+
+
+###############################################################################
+# Test SetNextByIndex() on a table whose rows are not stored in FID order
+
+
+def test_dameng_32_set_next_by_index_fid_order():
+    """Test SetNextByIndex(k) returns the kth feature of a sequential read"""
+
+    ds = gdal.OpenEx(
+        os.environ["DAMENG_CONNECTION_STRING"], gdal.OF_VECTOR | gdal.OF_UPDATE
+    )
+    lyr = ds.CreateLayer(
+        "paging_order_test", geom_type=ogr.wkbPoint, options=["OVERWRITE=YES"]
+    )
+    lyr.CreateField(ogr.FieldDefn("VALUE", ogr.OFTInteger))
+    # Rows are stored in descending FID order
+    for i in range(100):
+        feat = ogr.Feature(lyr.GetLayerDefn())
+        feat.SetFID(1000 - 7 * i)
+        feat.SetField("VALUE", i)
+        feat.SetGeometryDirectly(ogr.CreateGeometryFromWkt(f"POINT ({i} {i})"))
+        assert lyr.CreateFeature(feat) == ogr.OGRERR_NONE
+    assert lyr.SyncToDisk() == ogr.OGRERR_NONE
+
+    lyr.ResetReading()
+    sequential = [f.GetFID() for f in lyr]
+    assert sequential == sorted(sequential)
+
+    for k in (0, 1, 42, 98, 99, 10):
+        assert lyr.SetNextByIndex(k) == ogr.OGRERR_NONE
+        assert lyr.GetNextFeature().GetFID() == sequential[k]
+
+    # Result layers have no FID column to page on
+    with ds.ExecuteSQL('SELECT * FROM "paging_order_test"') as sql_lyr:
+        assert not sql_lyr.TestCapability(ogr.OLCFastSetNextByIndex)
+        assert sql_lyr.SetNextByIndex(42) == ogr.OGRERR_NONE
+        assert sql_lyr.GetNextFeature() is not None
+    ds = None
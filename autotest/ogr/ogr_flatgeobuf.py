@@ -1150,6 +1150,79 @@ def test_ogr_flatgeobuf_arrow_stream_numpy(layer_creation_options):
     ogr.GetDriverByName("FlatGeobuf").DeleteDataSource("/vsimem/test.fgb")
 
 
+###############################################################################
+# Test that the column-at-a-time evaluation of attribute filters on Arrow
+# batches gives the same result as the feature per feature one
+
+
+@pytest.mark.parametrize(
+    "where",
+    [
+        "int32 = 3",
+        "int32 <> 3 AND float64 < 2.5",
+        "3 < int32",
+        "int64 IN (-3, 20000000000, NULL)",
+        "NOT (int32 IN (1, NULL))",
+        "float64 BETWEEN 0.5 AND 2",
+        "int32 = float64",
+        "bool",
+        "NOT bool OR int32 IS NULL",
+        "str = 'ABC'",
+        "str IN ('a', 'xyz')",
+        "str >= 'b'",
+        "str LIKE 'a%'",
+        "str ILIKE '%C'",
+        "str LIKE 'a_c'",
+        "str IS NULL",
+        "(int32 = 1) IS NOT NULL",
+        "FID < 10 OR FID IN (50, 60)",
+        "int32 + 1 = 4",
+    ],
+)
+def test_ogr_flatgeobuf_arrow_stream_numpy_attribute_filter(tmp_vsimem, where):
+    gdaltest.importorskip_gdal_array()
+    pytest.importorskip("numpy")
+
+    filename = str(tmp_vsimem / "test.fgb")
+    ds = ogr.GetDriverByName("FlatGeoBuf").CreateDataSource(filename)
+    lyr = ds.CreateLayer("test", geom_type=ogr.wkbPoint)
+    lyr.CreateField(ogr.FieldDefn("str", ogr.OFTString))
+    field = ogr.FieldDefn("bool", ogr.OFTInteger)
+    field.SetSubType(ogr.OFSTBoolean)
+    lyr.CreateField(field)
+    lyr.CreateField(ogr.FieldDefn("int32", ogr.OFTInteger))
+    lyr.CreateField(ogr.FieldDefn("int64", ogr.OFTInteger64))
+    lyr.CreateField(ogr.FieldDefn("float64", ogr.OFTReal))
+    strs = ["abc", "ABC", "abd", "a", "", "xyz", "b"]
+    for i in range(200):
+        f = ogr.Feature(lyr.GetLayerDefn())
+        if i % 7 != 0:
+            f["str"] = strs[i % len(strs)]
+        if i % 5 != 0:
+            f["bool"] = i % 2
+        if i % 11 != 0:
+            f["int32"] = i % 6
+            f["int64"] = (i % 3) * 10000000000 - 3
+        if i % 13 != 0:
+            f["float64"] = (i % 9) / 2
+        f.SetGeometryDirectly(ogr.CreateGeometryFromWkt("POINT(%d 0)" % i))
+        lyr.CreateFeature(f)
+    ds = None
+
+    ds = ogr.Open(filename)
+    lyr = ds.GetLayer(0)
+    assert lyr.SetAttributeFilter(where) == ogr.OGRERR_NONE
+    expected = [f.GetFID() for f in lyr]
+
+    def get_fids():
+        stream = lyr.GetArrowStreamAsNumPy(["MAX_FEATURES_IN_BATCH=64"])
+        return [fid for batch in stream for fid in batch["OGC_FID"]]
+
+    with gdal.config_option("OGR_ARROW_VECTORIZED_FILTER", "NO"):
+        assert get_fids() == expected
+    assert get_fids() == expected
+
+
 ###############################################################################
 # Test reading an empty file with GetArrowStream()
 
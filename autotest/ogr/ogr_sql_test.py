@@ -1436,6 +1436,299 @@ def test_ogr_sql_48():
             assert sql_lyr.GetFeature(i)["int_field"] == lyr.GetFeature(i)["int_field"]
 
 
+###############################################################################
+# Test ORDER BY spilling sorted runs into temporary files
+
+
+@pytest.mark.parametrize("max_memory", ["1k", "100k", None])
+def test_ogr_sql_order_by_external_sort(max_memory):
+
+    ds = ogr.GetDriverByName("MEM").CreateDataSource("")
+    lyr = ds.CreateLayer("test", geom_type=ogr.wkbPoint)
+    lyr.CreateField(ogr.FieldDefn("int_field", ogr.OFTInteger))
+    lyr.CreateField(ogr.FieldDefn("str_field", ogr.OFTString))
+    for i in range(2000):
+        f = ogr.Feature(lyr.GetLayerDefn())
+        f["int_field"] = (i * 7919) % 100
+        if i % 13 != 0:
+            f["str_field"] = "%04d" % ((i * 104729) % 1000)
+        f.SetGeometry(ogr.CreateGeometryFromWkt("POINT (%d %d)" % (i, -i)))
+        if i % 3 == 0:
+            f.SetStyleString("PEN(c:#FF0000)")
+        lyr.CreateFeature(f)
+
+    # Expected result: stable sort on (int_field ASC, str_field DESC)
+    expected = sorted(
+        [(f["int_field"], f["str_field"], f.GetFID()) for f in lyr],
+        key=lambda x: (x[1] is not None, x[1] or ""),
+        reverse=True,
+    )
+    expected = [x[2] for x in sorted(expected, key=lambda x: x[0])]
+
+    with gdal.config_option("OGR_SQL_ORDER_BY_MAX_MEMORY", max_memory):
+        with ds.ExecuteSQL(
+            "SELECT * FROM test ORDER BY int_field, str_field DESC"
+        ) as sql_lyr:
+            assert sql_lyr.GetFeatureCount() == 2000
+            got = []
+            for f in sql_lyr:
+                fid = f.GetFID()
+                got.append(fid)
+                assert f.GetGeometryRef().GetX() == fid
+                assert (f.GetStyleString() is not None) == (fid % 3 == 0)
+            assert got == expected
+
+            # Read again, and reposition backwards
+            sql_lyr.ResetReading()
+            assert [f.GetFID() for f in sql_lyr] == expected
+            sql_lyr.SetNextByIndex(1500)
+            assert sql_lyr.GetNextFeature().GetFID() == expected[1500]
+            sql_lyr.SetNextByIndex(10)
+            assert sql_lyr.GetNextFeature().GetFID() == expected[10]
+
+            sql_lyr.SetAttributeFilter("int_field >= 90")
+            assert [f.GetFID() for f in sql_lyr] == [
+                fid for fid in expected if lyr.GetFeature(fid)["int_field"] >= 90
+            ]
+
+        with ds.ExecuteSQL(
+            "SELECT * FROM test ORDER BY int_field, str_field DESC LIMIT 30 OFFSET 5"
+        ) as sql_lyr:
+            assert [f.GetFID() for f in sql_lyr] == expected[5:35]
+
+        with ds.ExecuteSQL(
+            "SELECT * FROM test WHERE int_field < 50 ORDER BY int_field, str_field DESC"
+        ) as sql_lyr:
+            assert [f.GetFID() for f in sql_lyr] == [
+                fid for fid in expected if lyr.GetFeature(fid)["int_field"] < 50
+            ]
+
+
+###############################################################################
+# Test GROUP BY
+
+
+def test_ogr_sql_group_by():
+
+    ds = ogr.GetDriverByName("MEM").CreateDataSource("")
+    lyr = ds.CreateLayer("test", geom_type=ogr.wkbPoint)
+    lyr.CreateField(ogr.FieldDefn("int_field", ogr.OFTInteger))
+    lyr.CreateField(ogr.FieldDefn("str_field", ogr.OFTString))
+    lyr.CreateField(ogr.FieldDefn("real_field", ogr.OFTReal))
+    for i in range(1000):
+        f = ogr.Feature(lyr.GetLayerDefn())
+        f["int_field"] = (i * 7919) % 10
+        if i % 13 != 0:
+            f["str_field"] = "v%d" % ((i * 104729) % 7)
+        f["real_field"] = i / 4
+        f.SetGeometry(ogr.CreateGeometryFromWkt("POINT (%d %d)" % (i, -i)))
+        lyr.CreateFeature(f)
+
+    # Expected result, with NULL first
+    groups = {}
+    for f in lyr:
+        groups.setdefault(f["str_field"], []).append(f)
+    keys = sorted(groups, key=lambda x: (x is not None, x or ""))
+
+    with ds.ExecuteSQL(
+        "SELECT str_field, COUNT(*), SUM(int_field), MIN(real_field), "
+        "MAX(real_field), COUNT(DISTINCT int_field) FROM test "
+        "GROUP BY str_field ORDER BY str_field"
+    ) as sql_lyr:
+        assert sql_lyr.GetGeomType() == ogr.wkbNone
+        assert sql_lyr.GetFeatureCount() == len(keys)
+        assert (
+            sql_lyr.GetLayerDefn().GetFieldDefn(1).GetType() == ogr.OFTInteger
+        )
+        got = [
+            (
+                f["str_field"],
+                f["COUNT_*"],
+                f["SUM_int_field"],
+                f["MIN_real_field"],
+                f["MAX_real_field"],
+                f["COUNT_int_field"],
+            )
+            for f in sql_lyr
+        ]
+        assert got == [
+            (
+                k,
+                len(groups[k]),
+                sum(f["int_field"] for f in groups[k]),
+                min(f["real_field"] for f in groups[k]),
+                max(f["real_field"] for f in groups[k]),
+                len(set(f["int_field"] for f in groups[k])),
+            )
+            for k in keys
+        ]
+
+    # Several grouped fields, DESC order, WHERE, LIMIT and OFFSET
+    expected = sorted(
+        set((f["int_field"], f["str_field"]) for f in lyr if f["real_field"] >= 10),
+        key=lambda x: (-x[0], x[1] is not None, x[1] or ""),
+    )[2:7]
+    with ds.ExecuteSQL(
+        "SELECT int_field, str_field, AVG(real_field) FROM test "
+        "WHERE real_field >= 10 GROUP BY int_field, str_field "
+        "ORDER BY int_field DESC, str_field LIMIT 5 OFFSET 2"
+    ) as sql_lyr:
+        assert sql_lyr.GetFeatureCount() == 5
+        assert [(f["int_field"], f["str_field"]) for f in sql_lyr] == expected
+
+    # Groups without ORDER BY come in no particular order
+    with ds.ExecuteSQL("SELECT int_field FROM test GROUP BY int_field") as sql_lyr:
+        assert sorted(f["int_field"] for f in sql_lyr) == list(range(10))
+
+    with ds.ExecuteSQL("SELECT COUNT(*) FROM test GROUP BY FID") as sql_lyr:
+        assert sql_lyr.GetFeatureCount() == 1000
+
+    with gdal.config_option("OGR_SQL_GROUP_BY_MAX_MEMORY", "1k"):
+        with pytest.raises(Exception, match="OGR_SQL_GROUP_BY_MAX_MEMORY"):
+            with ds.ExecuteSQL("SELECT COUNT(*) FROM test GROUP BY FID") as sql_lyr:
+                sql_lyr.GetNextFeature()
+
+
+@pytest.mark.parametrize(
+    "sql,error",
+    [
+        ("SELECT int_field, str_field FROM test GROUP BY str_field", "GROUP BY"),
+        ("SELECT int_field + 1 FROM test GROUP BY int_field", "Expressions"),
+        ("SELECT COUNT(*) FROM test GROUP BY foo", "Unrecognized field name"),
+        ("SELECT DISTINCT int_field FROM test GROUP BY int_field", "DISTINCT"),
+        (
+            "SELECT int_field FROM test GROUP BY int_field ORDER BY str_field",
+            "ORDER BY",
+        ),
+        (
+            "SELECT COUNT(*) FROM test t1 LEFT JOIN test t2 "
+            "ON t1.int_field = t2.int_field GROUP BY t1.int_field",
+            "JOIN",
+        ),
+    ],
+)
+def test_ogr_sql_group_by_errors(sql, error):
+
+    ds = ogr.GetDriverByName("MEM").CreateDataSource("")
+    lyr = ds.CreateLayer("test")
+    lyr.CreateField(ogr.FieldDefn("int_field", ogr.OFTInteger))
+    lyr.CreateField(ogr.FieldDefn("str_field", ogr.OFTString))
+
+    with pytest.raises(Exception, match=error):
+        ds.ExecuteSQL(sql)
+
+
+###############################################################################
+# Test that a field named like the GROUP keyword can still be used, quoted or
+# not, as GROUP is only a keyword in GROUP BY
+
+
+def test_ogr_sql_group_keyword_as_identifier():
+
+    ds = ogr.GetDriverByName("MEM").CreateDataSource("")
+    lyr = ds.CreateLayer("test")
+    lyr.CreateField(ogr.FieldDefn("group", ogr.OFTInteger))
+    for value in [1, 2, 1]:
+        f = ogr.Feature(lyr.GetLayerDefn())
+        f["group"] = value
+        lyr.CreateFeature(f)
+
+    with ds.ExecuteSQL('SELECT "group" FROM test WHERE "group" = 1') as sql_lyr:
+        assert [f["group"] for f in sql_lyr] == [1, 1]
+
+    with ds.ExecuteSQL("SELECT group FROM test WHERE group = 1") as sql_lyr:
+        assert [f["group"] for f in sql_lyr] == [1, 1]
+
+    for sql in [
+        'SELECT "group", COUNT(*) FROM test GROUP BY "group" ORDER BY "group"',
+        "SELECT group, COUNT(*) FROM test GROUP BY group ORDER BY group",
+        "SELECT group, COUNT(*) FROM test GROUP\nBY group ORDER BY group",
+    ]:
+        with ds.ExecuteSQL(sql) as sql_lyr:
+            assert [(f["group"], f["COUNT_*"]) for f in sql_lyr] == [
+                (1, 2),
+                (2, 1),
+            ]
+
+    lyr.SetAttributeFilter('"group" = 2')
+    assert lyr.GetFeatureCount() == 1
+    lyr.SetAttributeFilter("group = 1")
+    assert lyr.GetFeatureCount() == 2
+    lyr.SetAttributeFilter("group IN (2, 3) OR group > 5")
+    assert lyr.GetFeatureCount() == 1
+    lyr.SetAttributeFilter(None)
+
+
+###############################################################################
+# Test that joins through a hash table return the same result as joins with
+# one attribute filter per feature
+
+
+@pytest.mark.parametrize(
+    "on",
+    [
+        "city.nation_id = nation.id",
+        "nation.name = city.nation_name",
+        "city.nation_id = nation.real_id",
+        "city.nation_id = nation.id AND city.nation_name = nation.name",
+    ],
+)
+def test_ogr_sql_hash_join(on):
+
+    ds = ogr.GetDriverByName("MEM").CreateDataSource("")
+    city = ds.CreateLayer("city")
+    city.CreateField(ogr.FieldDefn("name", ogr.OFTString))
+    city.CreateField(ogr.FieldDefn("nation_id", ogr.OFTInteger))
+    city.CreateField(ogr.FieldDefn("nation_name", ogr.OFTString))
+    for i in range(500):
+        f = ogr.Feature(city.GetLayerDefn())
+        f["name"] = "city%d" % i
+        if i % 11 != 0:
+            f["nation_id"] = i % 60
+            f["nation_name"] = ("NATION%d" if i % 2 else "nation%d") % (i % 60)
+        city.CreateFeature(f)
+
+    nation = ds.CreateLayer("nation")
+    nation.CreateField(ogr.FieldDefn("id", ogr.OFTInteger))
+    nation.CreateField(ogr.FieldDefn("real_id", ogr.OFTReal))
+    nation.CreateField(ogr.FieldDefn("name", ogr.OFTString))
+    for i in range(80):
+        f = ogr.Feature(nation.GetLayerDefn())
+        # Duplicated keys: the first record must be used
+        f["id"] = i % 50
+        f["real_id"] = i % 50
+        f["name"] = "nation%d" % (i % 50)
+        nation.CreateFeature(f)
+
+    sql = (
+        "SELECT city.name, nation.id, nation.real_id, nation.name FROM city "
+        "LEFT JOIN nation ON " + on
+    )
+
+    def get_rows():
+        with ds.ExecuteSQL(sql) as sql_lyr:
+            return [
+                (
+                    f["city.name"],
+                    f["nation.id"],
+                    f["nation.real_id"],
+                    f["nation.name"],
+                )
+                for f in sql_lyr
+            ]
+
+    with gdal.config_option("OGR_SQL_HASH_JOIN_MAX_MEMORY", "0"):
+        expected = get_rows()
+    assert len(expected) == 500
+    assert any(x[1] is not None for x in expected)
+    assert any(x[1] is None for x in expected)
+
+    assert get_rows() == expected
+
+    with gdal.config_option("OGR_SQL_HASH_JOIN_MAX_MEMORY", "1k"):
+        assert get_rows() == expected
+
+
 ###############################################################################
 # Test arithmetic expressions
 
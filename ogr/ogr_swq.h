@@ -406,6 +406,14 @@ typedef struct
     int ascending_flag;
 } swq_order_def;
 
+typedef struct
+{
+    char *table_name;
+    char *field_name;
+    int table_index;
+    int field_index;
+} swq_group_def;
+
 typedef struct
 {
     int secondary_table;
@@ -471,6 +479,10 @@ class CPL_UNSTABLE_API swq_select
 
     swq_expr_node *where_expr = nullptr;
 
+    void PushGroupBy(const char *pszTableName, const char *pszFieldName);
+    int group_by_count = 0;
+    swq_group_def *group_by_defs = nullptr;
+
     void PushOrderBy(const char *pszTableName, const char *pszFieldName,
                      int bAscending);
     int order_specs = 0;
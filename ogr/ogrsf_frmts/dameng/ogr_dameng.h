@@ -33,10 +33,20 @@
 #include "ogrsf_frmts.h"
 #include "cpl_port.h"
 #include "cpl_string.h"
+#include "cpl_worker_thread_pool.h"
 #include "DPI.h"
 #include "DPIext.h"
 #include "DPItypes.h"
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <list>
+#include <map>
+#include <mutex>
+#include <vector>
+
 #define UNDETERMINED_SRID -2
 #define NDCT_IDCLS_PACKAGE 14
 #define NDCT_PKGID_DMGEO2 (NDCT_IDCLS_PACKAGE << 24 | 112)
@@ -59,11 +69,23 @@
 #define NDCT_CLSID_GEO2_ST_GEOGRAPHY (NDCT_IDCLS_PACKAGE << 24 | 129)
 
 #define fetchnum 100000
+#define DEFAULT_FETCH_MEMORY_MB 64
+#define DAMENG_OBJ_SLOT_SIZE 1000
+#define DEFAULT_LOB_CHUNK_SIZE_KB 1024
+#define DEFAULT_STMT_CACHE_SIZE 16
+#define DEFAULT_CONNECTION_POOL_SIZE 8
+#define DEFAULT_CONNECTION_POOL_IDLE_TIMEOUT 300
+#define PARALLEL_SCAN_PARTITIONS_PER_WORKER 4
+#define PARALLEL_SCAN_QUEUE_SIZE 10000
 #define FORCED_INSERT_NUM 1
+#define DEFAULT_INSERT_BATCH_SIZE 1000
 
 extern int ogr_DM_insertnum;
+
+class CPLErrorAccumulator;
 class OGRDAMENGDataSource;
 class OGRDAMENGLayer;
+class swq_expr_node;
 
 typedef enum
 {
@@ -91,6 +113,125 @@ typedef struct
     int bNullable;
 } DMGeomColumnDesc;
 
+/* Catalog description of a table, loaded in bulk by the datasource, or */
+/* from the catalog cache file, instead of table by table. */
+typedef struct
+{
+    CPLString osName;
+    CPLString osType; /* SYSCOLUMNS.TYPE$ */
+    bool bNullable;
+    bool bHasDefault;
+    CPLString osDefault;
+} DMCatalogColumn;
+
+typedef struct
+{
+    CPLString osName;
+    CPLString osGeomType; /* TYPE of the geometry/geography_columns view */
+    int nCoordDimension;
+    int nSRID;
+    bool bGeography;
+} DMCatalogGeomColumn;
+
+typedef struct
+{
+    CPLString osSchemaName;
+    CPLString osTableName;
+    std::vector<DMCatalogColumn> aoColumns;
+    std::vector<DMCatalogGeomColumn> aoGeomColumns;
+} DMCatalogTable;
+
+typedef struct
+{
+    CPLString osWKT;
+    CPLString osAuthName;
+    int nAuthSRID;
+} DMCatalogSRS;
+
+/************************************************************************/
+/*                            OGRDAMENGStats                            */
+/*                                                                      */
+/*      Number, duration (in microseconds), rows and bytes of the       */
+/*      calls made to the server, and of the feature conversions.       */
+/*      What is added to the statistics of a layer is also added to     */
+/*      those of its datasource. Counters may be updated concurrently.  */
+/************************************************************************/
+
+class OGRDAMENGStats
+{
+  public:
+    enum Op
+    {
+        PREPARE = 0,
+        EXECUTE, /* rows and bytes sent as parameters */
+        FETCH,   /* rows and bytes received */
+        COMMIT,
+        DECODE, /* rows into features */
+        ENCODE, /* features into parameters */
+        OP_COUNT
+    };
+
+    explicit OGRDAMENGStats(OGRDAMENGStats *poParentIn = nullptr)
+        : poParent(poParentIn)
+    {
+    }
+
+    void SetParent(OGRDAMENGStats *poParentIn)
+    {
+        poParent = poParentIn;
+    }
+    void Add(Op eOp, GIntBig nMicroSec, GIntBig nRows = 0, GIntBig nBytes = 0);
+    void Reset();
+    bool IsEmpty() const;
+    char **GetMetadata() const;
+    CPLString GetSummary() const;
+
+  private:
+    OGRDAMENGStats(const OGRDAMENGStats &) = delete;
+    OGRDAMENGStats &operator=(const OGRDAMENGStats &) = delete;
+
+    OGRDAMENGStats *poParent = nullptr;
+    std::atomic<GIntBig> anCalls[OP_COUNT] = {};
+    std::atomic<GIntBig> anMicroSec[OP_COUNT] = {};
+    std::atomic<GIntBig> anRows[OP_COUNT] = {};
+    std::atomic<GIntBig> anBytes[OP_COUNT] = {};
+};
+
+/* Adds the time elapsed from its construction to Stop() or its end */
+class OGRDAMENGStatsTimer
+{
+  public:
+    OGRDAMENGStatsTimer(OGRDAMENGStats *poStatsIn, OGRDAMENGStats::Op eOpIn)
+        : poStats(poStatsIn), eOp(eOpIn)
+    {
+        if (poStats != nullptr)
+            tStart = std::chrono::steady_clock::now();
+    }
+    ~OGRDAMENGStatsTimer()
+    {
+        Stop();
+    }
+    void Stop(GIntBig nRows = 0, GIntBig nBytes = 0)
+    {
+        if (poStats == nullptr)
+            return;
+        poStats->Add(eOp,
+                     std::chrono::duration_cast<std::chrono::microseconds>(
+                         std::chrono::steady_clock::now() - tStart)
+                         .count(),
+                     nRows, nBytes);
+        poStats = nullptr;
+    }
+
+  private:
+    OGRDAMENGStatsTimer(const OGRDAMENGStatsTimer &) = delete;
+    OGRDAMENGStatsTimer &operator=(const OGRDAMENGStatsTimer &) = delete;
+
+    OGRDAMENGStats *poStats;
+    OGRDAMENGStats::Op eOp;
+    std::chrono::steady_clock::time_point tStart{};
+};
+
 class CPL_DLL OGRDAMENGConn
 {
   public:
@@ -101,12 +242,38 @@ class CPL_DLL OGRDAMENGConn
     char *pszUserid;
     char *pszPassword;
     char *pszDatabase;
+    char *pszSchemaName = nullptr;
+
+    // Set by the datasource while a (soft) transaction is open, so that
+    // statements stop committing on their own.
+    int bInTransaction = FALSE;
+
+    // Memory budget of the row arrays of one fetching statement, which is
+    // also the cap of the buffers kept around for reuse.
+    size_t nFetchMemory = (size_t)DEFAULT_FETCH_MEMORY_MB * 1024 * 1024;
+
+    // LOB values larger than this are read piecewise, and inserted
+    // geometries larger than this are sent without waiting for the rest
+    // of their batch.
+    size_t nLobChunkSize = (size_t)DEFAULT_LOB_CHUNK_SIZE_KB * 1024;
+
+    // Statistics the statements of the session add to by default, those
+    // of the datasource using it, if any.
+    OGRDAMENGStats *poStats = nullptr;
 
   public:
     OGRDAMENGConn();
     virtual ~OGRDAMENGConn();
     int EstablishConn(const char *pszUserid, const char *pszPassword,
                       const char *pszDatabase, const char *pszSchemaName);
+    DPIRETURN SoftCommit();
+    bool IsAlive();
+    void *AcquireFetchBuffer(size_t nSize, size_t *pnAllocated);
+    void ReleaseFetchBuffer(void *pBuffer, size_t nSize);
+
+  private:
+    std::vector<std::pair<size_t, void *>> m_aoFetchBuffers{};
+    size_t m_nPooledBytes = 0;
 };
 
 typedef struct
@@ -122,6 +289,20 @@ typedef struct
     slength display_size;
 } DmColDesc;
 
+/* Value of one parameter of a single row statement. */
+struct OGRDAMENGParam
+{
+    sdint2 nCType = DSQL_C_NCHAR;
+    slength nInd = 0;
+    sdint8 nValue = 0;
+    double dfValue = 0.0;
+    std::string osValue{};
+    GByte *pabyGser = nullptr;
+    size_t nGserSize = 0;
+    size_t nGserBufSize = 0;
+    dhobj hObj = nullptr;
+};
+
 CPLString OGRDAMENGEscapeColumnName(const char *pszColumnName);
 
 class OGRDAMENGGeomFieldDefn final : public OGRGeomFieldDefn
@@ -196,7 +377,7 @@ class CPL_DLL OGRDAMENGStatement
     CPLErr Prepare(const char *pszStatement);
     CPLErr ExecuteInsert(const char *pszSQLStatement, int nMode);
     CPLErr Execute(const char *pszStatement, int nMode = -1);
-    CPLErr Excute_for_fetchmany(const char *pszStatement);
+    CPLErr Excute_for_fetchmany(const char *pszStatement, int nMaxRows = 0);
     void Clean();
     char **SimpleFetchRow();
     char ***Fetchmany(ulength *rows);
@@ -204,11 +385,64 @@ class CPL_DLL OGRDAMENGStatement
     {
         return nRawColumnCount;
     }
+    // Column descriptors and bound C types of the current result set,
+    // only available after Excute_for_fetchmany().
+    const DmColDesc *GetColDesc(int iCol) const
+    {
+        return coldescs ? &coldescs[iCol] : nullptr;
+    }
+    sdint2 GetColCType(int iCol) const
+    {
+        return col_ctypes ? col_ctypes[iCol] : (sdint2)DSQL_C_NCHAR;
+    }
+    // Length in bytes of an object or BLOB value of a block returned by
+    // Fetchmany(), 0 for other columns and NULL values.
+    int GetValueLength(char ***papapszRows, int iCol, int iRow) const;
+    // Values bound to the '?' markers of the statements run by Execute()
+    // and Excute_for_fetchmany(). Calling either with a null statement
+    // runs the prepared one again with the current values.
+    void ClearParams();
+    void SetDoubleParams(const std::vector<double> &adfParams);
+    void AddNullParam();
+    void AddInt64Param(GIntBig nValue);
+    void AddDoubleParam(double dfValue);
+    void AddStringParam(const char *pszValue);
+    CPLErr AddGeometryParam(const OGRGeometry *poGeom, int nSRSId);
+    // Number of rows Fetchmany() returns at most per call.
+    int GetFetchSize() const
+    {
+        return nFetchSize;
+    }
+    // Double-buffered fetching of the current result set: once enabled,
+    // Fetchmany() hands over the block read by a background job while the
+    // next one is fetched into a second set of buffers.
+    CPLErr EnablePrefetch();
+    void CancelPrefetch();
     int *blob_len;
     int **blob_lens;
     CPLErr Execute_for_insert(OGRDAMENGFeatureDefn *params,
                               OGRFeature *poFeature,
-                              std::map<std::string, int> mymap);
+                              std::map<std::string, int> &mymap);
+    void SetBatchSize(int nBatchSizeIn, int nCommitIntervalIn);
+    // Layout of batched statements other than a plain INSERT, to be set
+    // before the first Execute_for_insert(): markers from nPrimaryParams
+    // on repeat the value of the marker nPrimaryParams before them, and
+    // marker nFIDParam (1-based) receives the FID of the feature.
+    void SetBatchLayout(int nPrimaryParams, int nFIDParam);
+    // Commands run before and after each batch is executed. Their
+    // failure is only reported as a debug message.
+    void SetBatchCommands(const char *pszBefore, const char *pszAfter);
+    CPLErr FlushInsert(bool bCommit);
+    int GetPendingInsertCount() const
+    {
+        return insert_num;
+    }
+    // Statistics the calls of the statement are added to, those of the
+    // session by default.
+    void SetStats(OGRDAMENGStats *poStatsIn)
+    {
+        m_poStats = poStatsIn;
+    }
 
   private:
     OGRDAMENGConn *poConn;
@@ -228,17 +462,134 @@ class CPL_DLL OGRDAMENGStatement
     dhloblctr **lobs;
     dhobjdesc **objdescs;
     char ***papszCurImages;
+    DmColDesc *coldescs = nullptr;
+    sdint2 *col_ctypes = nullptr;
+    int nFetchSize = fetchnum;
+    char **col_bufs = nullptr;
+    size_t *col_buf_sizes = nullptr;
+    std::vector<OGRDAMENGParam> m_aoParams{};
+    int m_nParams = 0;
     int param_nums = 0;
     DmColDesc *paramdescs = nullptr;
-    dhobj **insert_objs;
-    dhobjdesc insert_objdesc;
-    GSERIALIZED ***insert_geovalues;
-    char ***insert_values;
-    int geonum;
-    int valuesnum;
+    dhobj **insert_objs = nullptr;
+    dhobjdesc insert_objdesc = nullptr;
+    GSERIALIZED ***insert_geovalues = nullptr;
+    size_t **insert_geosizes = nullptr;
+    char ***insert_values = nullptr;
+    int *insert_value_width = nullptr;
+    int geonum = 0;
+    int valuesnum = 0;
     slength** col_len = nullptr;
-    size_t gser_length = 0;
     int insert_num = 0;
+    int nBatchSize = FORCED_INSERT_NUM;
+    int nCommitInterval = FORCED_INSERT_NUM;
+    int nUncommittedRows = 0;
+    int m_nPrimaryParams = 0;
+    int m_nFIDParam = 0;
+    std::vector<int> m_anGeomParams{};
+    std::vector<int> m_anValueParams{};
+    CPLString m_osBeforeBatch{};
+    CPLString m_osAfterBatch{};
+    OGRDAMENGStats *m_poStats = nullptr;
+    // Parameter bytes of the buffered rows, and of the bound single row.
+    GIntBig m_nPendingBytes = 0;
+    GIntBig m_nBoundBytes = 0;
+
+    // Second set of fetch buffers, swapped with the bound one by the
+    // prefetching Fetchmany().
+    struct FetchBuffers
+    {
+        char ***results = nullptr;
+        slength **col_len = nullptr;
+        dhobj **objs = nullptr;
+        dhobjdesc **objdescs = nullptr;
+        dhloblctr **lobs = nullptr;
+        int **blob_lens = nullptr;
+        char **col_bufs = nullptr;
+        size_t *col_buf_sizes = nullptr;
+        char ***papszCurImages = nullptr;
+    };
+    FetchBuffers m_sSpareBuffers{};
+    std::unique_ptr<CPLJobQueue> m_poPrefetchQueue{};
+    std::unique_ptr<CPLErrorAccumulator> m_poPrefetchErrors{};
+    bool m_bPrefetchPending = false;
+    char ***m_papapszPrefetched = nullptr;
+    ulength m_nPrefetchedRows = 0;
+
+    CPLErr AllocFetchBuffers();
+    CPLErr BindFetchBuffers();
+    void FreeFetchBuffers();
+    void SwapFetchBuffers();
+    char ***FetchBlock(ulength *rows);
+    CPLErr InitInsertBuffers();
+    void FreeInsertBuffers();
+    void RunBatchCommand(const char *pszCommand);
+    void FreeRowImage(int iCol, int iRow);
+    char *ReadLob(dhloblctr hLob, bool bBinary, slength nLength,
+                  slength *pnRead);
+    void FreeResults();
+    OGRDAMENGParam &NextParam();
+    CPLErr BindParams();
+    void FreeParamObjects();
+};
+
+/************************************************************************/
+/*                        OGRDAMENGParallelScan                         */
+/*                                                                      */
+/*      Reads a layer query over several sessions at once. The FID      */
+/*      space is cut into ranges, which worker jobs of the GDAL thread  */
+/*      pool fetch and decode into bounded queues of features.          */
+/************************************************************************/
+
+class OGRDAMENGParallelScan
+{
+    OGRDAMENGParallelScan(const OGRDAMENGParallelScan &) = delete;
+    OGRDAMENGParallelScan &operator=(const OGRDAMENGParallelScan &) = delete;
+
+    struct Partition
+    {
+        GIntBig nMinFID = 0;
+        GIntBig nMaxFID = 0;
+        bool bDone = false;
+        std::deque<std::unique_ptr<OGRFeature>> apoFeatures{};
+    };
+
+    const OGRDAMENGLayer *poLayer = nullptr;
+    CPLString osSQL{};
+    std::vector<double> adfParams{};
+    bool bOrdered = true;
+    std::vector<OGRDAMENGConn *> apoConns{};
+
+    // In unordered mode, all workers feed the queue of the first partition.
+    std::deque<Partition> aoPartitions{};
+    size_t nMaxQueued = PARALLEL_SCAN_QUEUE_SIZE;
+    std::mutex oMutex{};
+    std::condition_variable oCVFeatures{};
+    std::condition_variable oCVRoom{};
+    int iNextPartition = 0;
+    int iCurPartition = 0;
+    int nDonePartitions = 0;
+    int nRunningWorkers = 0;
+    bool bStop = false;
+    CPLString osError{};
+
+    std::deque<std::unique_ptr<OGRFeature>> apoReady{};
+    std::unique_ptr<CPLJobQueue> poJobQueue{};
+
+    void WorkerJob(OGRDAMENGConn *poConn);
+    bool QueueFeatures(int iPartition,
+                       std::vector<std::unique_ptr<OGRFeature>> &apoFeatures);
+
+  public:
+    OGRDAMENGParallelScan(const OGRDAMENGLayer *poLayerIn,
+                          const char *pszSQL,
+                          const std::vector<double> &adfParamsIn,
+                          bool bOrderedIn);
+    ~OGRDAMENGParallelScan();
+
+    void AddPartition(GIntBig nMinFID, GIntBig nMaxFID);
+    bool Start(int nWorkers);
+    OGRFeature *GetNextFeature();
 };
 
 class OGRDAMENGLayer CPL_NON_FINAL : public OGRLayer
@@ -246,10 +597,12 @@ class OGRDAMENGLayer CPL_NON_FINAL : public OGRLayer
     OGRDAMENGLayer(const OGRDAMENGLayer &) = delete;
     OGRDAMENGLayer &operator=(const OGRDAMENGLayer &) = delete;
 
+    friend class OGRDAMENGParallelScan;
+
   protected:
     OGRDAMENGFeatureDefn *poFeatureDefn = nullptr;
 
-    int iNextShapeId = 0;
+    GIntBig iNextShapeId = 0;
     int iFIDColumn = 0;
     int iGeomColumn = 0;
 
@@ -257,11 +610,14 @@ class OGRDAMENGLayer CPL_NON_FINAL : public OGRLayer
     static GByte *BlobToGByteArray(const char *pszBlob,
                                    int *pnLength);
     static char *GeometryToBlob(const OGRGeometry *);
-    void SetInitialQuery();
+    void SetInitialQuery(const char *pszSQL = nullptr);
+    CPLString BuildSpatialPredicate(OGRDAMENGGeomFieldDefn *poGeomFieldDefn);
 
     OGRDAMENGDataSource *poDS = nullptr;
 
     char *pszQueryStatement = nullptr;
+    // Values of the '?' markers of pszQueryStatement.
+    std::vector<double> m_adfQueryParams{};
 
     OGRDAMENGStatement *poStatement;
     int nResultOffset = 0;
@@ -287,8 +643,41 @@ class OGRDAMENGLayer CPL_NON_FINAL : public OGRLayer
                                 const int *panMapFieldNameToIndex,
                                 const int *panMapFieldNameToGeomIndex,
                                 int iRecord);
+    OGRFeature *DecodeRecord(OGRDAMENGStatement *hStmt, char ***papapszRows,
+                             const int *panMapFieldNameToIndex,
+                             const int *panMapFieldNameToGeomIndex,
+                             int iRecord, GIntBig nFID) const;
+
+    // Set while the current read goes through a parallel scan.
+    std::unique_ptr<OGRDAMENGParallelScan> m_poParallelScan{};
+    virtual OGRDAMENGParallelScan *CreateParallelScan()
+    {
+        return nullptr;
+    }
+
+    // Session of poStatement when it prefetches, see SetInitialQuery().
+    OGRDAMENGConn *m_poPrefetchConn = nullptr;
+
+    // Query of SetNextByIndex(), returning the rows from nIndex on.
+    virtual CPLString BuildPagedQuery(GIntBig nIndex);
+
+    // Last feature read by a query paged on the FID, from which the
+    // next SetNextByIndex() can continue, see BuildPagedQuery().
+    bool m_bPagedByFID = false;
+    GIntBig m_nKeysetIndex = -1;
+    GIntBig m_nKeysetFID = OGRNullFID;
+    CPLString m_osKeysetQuery{};
+    std::vector<double> m_adfKeysetParams{};
+
+    // Calls made by the statements of the layer, also added to those of
+    // the datasource. Mutable as DecodeRecord() is timed.
+    mutable OGRDAMENGStats m_oStats{};
 
     OGRFeature *GetNextRawFeature();
+    int FetchNextRecord();
+    bool CanFillArrowArray() const;
+    int GetNextArrowArray(struct ArrowArrayStream *,
+                          struct ArrowArray *out_array) override;
     OGRDAMENGStatement **stmt = nullptr;
     int col_count;
     ulength rows = 0;
@@ -314,7 +703,7 @@ class OGRDAMENGLayer CPL_NON_FINAL : public OGRLayer
 
     const char *GetFIDColumn() const override;
 
-    //virtual OGRErr SetNextByIndex(GIntBig nIndex) override;
+    OGRErr SetNextByIndex(GIntBig nIndex) override;
 
     OGRDAMENGDataSource *GetDS()
     {
@@ -335,6 +724,7 @@ class OGRDAMENGTableLayer final : public OGRDAMENGLayer
     void BuildWhere();
     CPLString BuildFields();
     void BuildFullQueryStatement();
+    CPLString BuildPagedQuery(GIntBig nIndex) override;
 
     char *pszTableName = nullptr;
     char *pszSchemaName = nullptr;
@@ -355,6 +745,13 @@ class OGRDAMENGTableLayer final : public OGRDAMENGLayer
     CPLString osQuery{};
     CPLString osWHERE{};
 
+    // Set when part of the attribute filter cannot be translated to
+    // DaMeng SQL: the whole filter is then also evaluated by OGR.
+    bool m_bFilterMustBeClientSideEvaluated = false;
+    CPLString BuildFilterValue(const swq_expr_node *poNode) const;
+    CPLString BuildFilterSQL(const swq_expr_node *poNode);
+    CPLString BuildWholeFilterSQL(const swq_expr_node *poNode);
+
     int bLaunderColumnNames = true;
     int bPreservePrecision = true;
     int bCopyActive = false;
@@ -362,6 +759,13 @@ class OGRDAMENGTableLayer final : public OGRDAMENGLayer
     int bFirstInsertion = true;
 
     OGRErr CreateFeatureViaInsert(OGRFeature *poFeature);
+    OGRErr ReadInsertColumns();
+
+    // Columns of the INSERT and MERGE statements, and the batched MERGE
+    // of IUpsertFeature() with the position of the columns in it.
+    std::vector<CPLString> m_aosInsertColumns{};
+    std::unique_ptr<OGRDAMENGStatement> m_poUpsertStatement{};
+    std::map<std::string, int> m_oUpsertMap{};
 
     int bHasWarnedIncompatibleGeom = false;
     void CheckGeomTypeCompatibility(int iGeomField,
@@ -374,11 +778,20 @@ class OGRDAMENGTableLayer final : public OGRDAMENGLayer
     int nForcedGeometryTypeFlags = -1;
     int nForcedCommitCount = 0;
     int nForcedInsert = 0;
-    bool bCreateSpatialIndexFlag = true;
-    CPLString osSpatialIndexType = "GIST";
+    bool bCreateSpatialIndexFlag = false;
+    CPLString osSpatialIndexType = "SPATIAL";
+
+    // Set by DEFERRED_INDEX: the column definition restoring the checks
+    // of the first geometry column, and whether it and the spatial
+    // indexes are still to be created.
+    bool m_bDeferredIndexPending = false;
+    CPLString m_osDeferredGeomColumn{};
     int bInResetReading = false;
     CPLString InsertSQL;
     OGRDAMENGStatement *InsertStatement = nullptr;
+    int nInsertBatchSize = ogr_DM_insertnum;
+    int nInsertCommitInterval = -1;
+    OGRErr FlushPendingInserts();
     int bAutoFIDOnCreateViaCopy = false;
 
     int bDeferredCreation = false;
@@ -398,6 +811,21 @@ class OGRDAMENGTableLayer final : public OGRDAMENGLayer
 
     CPLErr CheckINI(int *checkini);
 
+    OGRDAMENGParallelScan *CreateParallelScan() override;
+
+    /* Prepared FID lookups, updates and deletes, most recently used first */
+    std::list<std::pair<CPLString, std::unique_ptr<OGRDAMENGStatement>>>
+        m_aoStatementCache{};
+    size_t m_nStatementCacheSize = DEFAULT_STMT_CACHE_SIZE;
+    OGRDAMENGStatement *GetPreparedStatement(const CPLString &osSQL);
+    void ClearStatementCache();
+
+    /* Exact count and extents of the whole table, kept until the next */
+    /* write through this datasource. */
+    GIntBig m_nCachedFeatureCount = -1;
+    std::map<int, OGREnvelope> m_oCachedExtents{};
+    GIntBig GetEstimatedFeatureCount();
+
   public:
     OGRDAMENGTableLayer(OGRDAMENGDataSource *,
                     CPLString &osCurrentSchema,
@@ -420,10 +848,12 @@ class OGRDAMENGTableLayer final : public OGRDAMENGLayer
                              const OGRGeometry *poGeom) override;
 
     OGRErr SetAttributeFilter(const char *) override;
+    OGRErr SetIgnoredFields(CSLConstList papszFields) override;
 
     OGRErr ISetFeature(OGRFeature *poFeature) override;
     OGRErr DeleteFeature(GIntBig nFID) override;
     OGRErr ICreateFeature(OGRFeature *poFeature) override;
+    OGRErr IUpsertFeature(OGRFeature *poFeature) override;
 
     virtual OGRErr CreateField(const OGRFieldDefn *poField,
                                int bApproxOK = TRUE) override;
@@ -435,6 +865,7 @@ class OGRDAMENGTableLayer final : public OGRDAMENGLayer
     int TestCapability(const char *) const override;
     OGRErr IGetExtent(int iGeomField, OGREnvelope *psExtent,
                       bool bForce) override;
+    void InvalidateStatistics();
 
     const char *GetTableName()
     {
@@ -457,6 +888,8 @@ class OGRDAMENGTableLayer final : public OGRDAMENGLayer
 
     OGRErr Rename(const char *pszNewName) override;
 
+    OGRErr SyncToDisk() override;
+
     // follow methods are not base class overrides
     void SetLaunderFlag(int bFlag)
     {
@@ -501,6 +934,19 @@ class OGRDAMENGTableLayer final : public OGRDAMENGLayer
     }
 
     void SetDeferredCreation(CPLString osCreateTable);
+    void SetDeferredIndexCreation(const char *pszGeomColumnDefinition);
+    OGRErr RunCreateSpatialIndex(int iGeomField);
+    OGRErr RunDeferredIndexCreation();
+    void CancelDeferredIndexCreation()
+    {
+        m_bDeferredIndexPending = false;
+    }
+
+    void SetInsertBatchSize(int nBatchSizeIn, int nCommitIntervalIn)
+    {
+        nInsertBatchSize = nBatchSizeIn;
+        nInsertCommitInterval = nCommitIntervalIn;
+    }
 
     void ResolveSRID(const OGRDAMENGGeomFieldDefn *poGFldDefn) override;
 };
@@ -584,6 +1030,9 @@ class OGRDAMENGDataSource final : public OGRDataSource
 
     OGRDAMENGTableLayer *poLayerInCopyMode = nullptr;
 
+    OGRErr DoTransactionCommand(const char *pszCommand);
+    OGRErr FlushSoftTransaction();
+
     CPLString osCurrentSchema{};
 
     int nUndefinedSRID = 0;
@@ -596,6 +1045,31 @@ class OGRDAMENGDataSource final : public OGRDataSource
 
     CPLString osDebugLastTransactionCommand{};
 
+    // Sessions of the parallel scans, kept open from one scan to the next.
+    int nParallelScan = 0;
+    bool bParallelScanOrdered = true;
+    bool bPrefetch = false;
+    std::vector<std::unique_ptr<OGRDAMENGConn>> m_apoIdleScanConns{};
+
+    // Calls made by all the sessions of the datasource, reported in the
+    // DAMENG_STATS metadata domain.
+    OGRDAMENGStats m_oStats{};
+    CPLStringList m_aosStatsMD{};
+
+    // Catalog loaded in bulk by Open(), tables keyed by "schema.table".
+    std::map<CPLString, DMCatalogTable> m_oCatalog{};
+    std::map<int, DMCatalogSRS> m_oCatalogSRS{};
+    int m_nGeoConsCheck = -1;
+
+    CPLString GetCatalogVersion();
+    bool LoadGeometryColumnsCatalog();
+    bool LoadColumnsCatalog(
+        const std::vector<std::pair<CPLString, CPLString>> &aoTables);
+    bool LoadSRSCatalog();
+    bool ReadCatalogCache(const char *pszFilename, const CPLString &osVersion);
+    void WriteCatalogCache(const char *pszFilename,
+                           const CPLString &osVersion);
+
   public:
     int bBinaryTimeFormatIsInt8 = false;
     int bUseEscapeStringSyntax = false;
@@ -621,9 +1095,35 @@ class OGRDAMENGDataSource final : public OGRDataSource
         return poSession;
     }
 
+    int GetParallelScanCount() const
+    {
+        return nParallelScan;
+    }
+    bool IsParallelScanOrdered() const
+    {
+        return bParallelScanOrdered;
+    }
+    bool IsPrefetchEnabled() const
+    {
+        return bPrefetch;
+    }
+    OGRDAMENGStats *GetStats()
+    {
+        return &m_oStats;
+    }
+    OGRDAMENGConn *AcquireScanConn();
+    void ReleaseScanConn(OGRDAMENGConn *poConn);
+    void InvalidateLayerStatistics();
+
     int FetchSRSId(const OGRSpatialReference *poSRS);
     OGRSpatialReference *FetchSRS(int nSRSId);
 
+    const DMCatalogTable *GetCatalogTable(const char *pszSchemaName,
+                                          const char *pszTableName) const;
+    void InvalidateCatalogTable(const char *pszSchemaName,
+                                const char *pszTableName);
+    int GetGeoConsCheck();
+
     int Open(const char *,
              int bUpdate,
              int bTestOpen,
@@ -650,6 +1150,19 @@ class OGRDAMENGDataSource final : public OGRDataSource
 
     int TestCapability(const char *) const override;
 
+    OGRErr StartTransaction(int bForce = FALSE) override;
+    OGRErr CommitTransaction() override;
+    OGRErr RollbackTransaction() override;
+
+    OGRErr SoftStartTransaction();
+    OGRErr SoftCommitTransaction();
+    OGRErr SoftRollbackTransaction();
+
+    int IsUserTransactionActive() const
+    {
+        return bUserTransactionActive;
+    }
+
     virtual OGRLayer *ExecuteSQL(const char *pszSQLCommand,
                                  OGRGeometry *poSpatialFilter,
                                  const char *pszDialect) override;
@@ -657,12 +1170,16 @@ class OGRDAMENGDataSource final : public OGRDataSource
 
     virtual const char *GetMetadataItem(const char *pszKey,
                                         const char *pszDomain) override;
+    CSLConstList GetMetadata(const char *pszDomain = "") override;
+    char **GetMetadataDomainList() override;
 };
 
 OGRDAMENGConn CPL_DLL *OGRGetDAMENGConnection(const char *pszUserid,
                                       const char *pszPassword,
                                       const char *pszDatabase,
                                       const char *pszSchemaName);
+void CPL_DLL OGRReleaseDAMENGConnection(OGRDAMENGConn *poConn);
+void OGRDAMENGClearConnectionPool();
 
 CPLString OGRDAMENGCommonLayerGetType(OGRFieldDefn &oField,
                                   bool bPreservePrecision,
@@ -682,7 +1199,16 @@ void OGRDAMENGCommonAppendFieldValue(CPLString &osCommand,
 GSERIALIZED* OGRDAMENGGeoFromHexwkb(const char* pszLEHex,
     size_t* size, OGREnvelope3D sEnvelope);
 
+size_t OGRDAMENGGeometryToGser(const OGRGeometry* poGeom, int nSRSId,
+    GByte** ppabyBuf, size_t* pnBufSize);
+
 GByte* OGRDAMENGGeoToHexwkb(GSERIALIZED* geom,
     int* size);
 
+OGRGeometry* OGRDAMENGGeometryFromGser(const GSERIALIZED* gser,
+    size_t nSize);
+
+size_t OGRDAMENGGserToIsoWkb(const GSERIALIZED* gser, size_t nSize,
+    GByte** ppabyBuf, size_t* pnBufSize);
+
 #endif  // !OGR_DM_H_INCLUDED
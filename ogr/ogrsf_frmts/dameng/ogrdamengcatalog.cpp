@@ -0,0 +1,473 @@
+/******************************************************************************
+ *
+ * Project:  OpenGIS Simple Features Reference Implementation
+ * Purpose:  Bulk loading and caching of the catalog by OGRDAMENGDataSource.
+ * Author:   YiLun Wu, wuyilun@dameng.com
+ *
+ ******************************************************************************
+ * Copyright (c) 2026, YiLun Wu
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#include "ogr_dameng.h"
+#include "cpl_json.h"
+
+#include <algorithm>
+#include <set>
+
+/* Bumped when the layout of the catalog cache file changes */
+#define CATALOG_CACHE_FORMAT_VERSION 1
+
+/* Maximum number of names in one IN (...) list of the catalog queries */
+#define CATALOG_IN_LIST_SIZE 500
+
+/************************************************************************/
+/*                          DMCatalogLiteral()                          */
+/************************************************************************/
+
+static CPLString DMCatalogLiteral(const char *pszValue)
+{
+    CPLString osLiteral("'");
+    osLiteral += CPLString(pszValue).replaceAll('\'', "''");
+    osLiteral += "'";
+    return osLiteral;
+}
+
+/************************************************************************/
+/*                            DMCatalogKey()                            */
+/************************************************************************/
+
+static CPLString DMCatalogKey(const char *pszSchemaName,
+                              const char *pszTableName)
+{
+    return CPLString(pszSchemaName) + "." + pszTableName;
+}
+
+/************************************************************************/
+/*                          DMCatalogEntry()                            */
+/************************************************************************/
+
+static DMCatalogTable &
+DMCatalogEntry(std::map<CPLString, DMCatalogTable> &oCatalog,
+               const char *pszSchemaName, const char *pszTableName)
+{
+    DMCatalogTable &oTable =
+        oCatalog[DMCatalogKey(pszSchemaName, pszTableName)];
+    if (oTable.osTableName.empty())
+    {
+        oTable.osSchemaName = pszSchemaName;
+        oTable.osTableName = pszTableName;
+    }
+    return oTable;
+}
+
+/************************************************************************/
+/*                          GetCatalogTable()                           */
+/*                                                                      */
+/*      Return the bulk loaded description of a table, or nullptr if    */
+/*      it has to be read from the catalog table by table.              */
+/************************************************************************/
+
+const DMCatalogTable *
+OGRDAMENGDataSource::GetCatalogTable(const char *pszSchemaName,
+                                     const char *pszTableName) const
+{
+    const auto oIter =
+        m_oCatalog.find(DMCatalogKey(pszSchemaName, pszTableName));
+    if (oIter == m_oCatalog.end() || oIter->second.aoColumns.empty())
+        return nullptr;
+    return &oIter->second;
+}
+
+/************************************************************************/
+/*                       InvalidateCatalogTable()                       */
+/************************************************************************/
+
+void OGRDAMENGDataSource::InvalidateCatalogTable(const char *pszSchemaName,
+                                                 const char *pszTableName)
+{
+    m_oCatalog.erase(DMCatalogKey(pszSchemaName, pszTableName));
+}
+
+/************************************************************************/
+/*                          GetGeoConsCheck()                           */
+/*                                                                      */
+/*      Value of the GEO2_CONS_CHECK server parameter, which tells      */
+/*      whether geometry types come from the geometry_columns views.    */
+/************************************************************************/
+
+int OGRDAMENGDataSource::GetGeoConsCheck()
+{
+    if (m_nGeoConsCheck >= 0)
+        return m_nGeoConsCheck;
+
+    OGRDAMENGStatement oCommand(poSession);
+    if (oCommand.Execute("SELECT SF_GET_PARA_VALUE(1, 'GEO2_CONS_CHECK')") ==
+        CE_None)
+    {
+        char **papszRow = oCommand.SimpleFetchRow();
+        if (papszRow && papszRow[0])
+            m_nGeoConsCheck = atoi(papszRow[0]);
+    }
+    return m_nGeoConsCheck;
+}
+
+/************************************************************************/
+/*                         GetCatalogVersion()                          */
+/*                                                                      */
+/*      Token that changes whenever a DDL statement runs, an object is  */
+/*      dropped or a SRS is added, used to invalidate the cache file.   */
+/************************************************************************/
+
+CPLString OGRDAMENGDataSource::GetCatalogVersion()
+{
+    OGRDAMENGStatement oCommand(poSession);
+    if (oCommand.Execute(
+            "SELECT MAX(LAST_DDL_TIME), COUNT(*), "
+            "(SELECT COUNT(*) FROM SYSGEO2.SPATIAL_REF_SYS) FROM ALL_OBJECTS") !=
+        CE_None)
+        return CPLString();
+
+    char **papszRow = oCommand.SimpleFetchRow();
+    if (papszRow == nullptr || papszRow[0] == nullptr)
+        return CPLString();
+    return CPLString().Printf("%s|%s|%s", papszRow[0],
+                              papszRow[1] ? papszRow[1] : "",
+                              papszRow[2] ? papszRow[2] : "");
+}
+
+/************************************************************************/
+/*                     LoadGeometryColumnsCatalog()                     */
+/*                                                                      */
+/*      Read the geometry and geography columns of all tables in one    */
+/*      query.                                                          */
+/************************************************************************/
+
+bool OGRDAMENGDataSource::LoadGeometryColumnsCatalog()
+{
+    OGRDAMENGStatement oCommand(poSession);
+    if (oCommand.Execute(
+            "SELECT F_TABLE_SCHEMA, F_TABLE_NAME, F_GEOMETRY_COLUMN, TYPE, "
+            "COORD_DIMENSION, SRID, 0 FROM SYSGEO2.GEOMETRY_COLUMNS "
+            "UNION ALL "
+            "SELECT F_TABLE_SCHEMA, F_TABLE_NAME, F_GEOGRAPHY_COLUMN, TYPE, "
+            "COORD_DIMENSION, SRID, 1 FROM SYSGEO2.GEOGRAPHY_COLUMNS") !=
+        CE_None)
+        return false;
+
+    char **papszRow = nullptr;
+    while ((papszRow = oCommand.SimpleFetchRow()) != nullptr)
+    {
+        if (papszRow[0] == nullptr || papszRow[1] == nullptr ||
+            papszRow[2] == nullptr)
+            continue;
+
+        DMCatalogGeomColumn oGeomColumn;
+        oGeomColumn.osName = papszRow[2];
+        oGeomColumn.osGeomType = papszRow[3] ? papszRow[3] : "";
+        oGeomColumn.nCoordDimension = papszRow[4] ? atoi(papszRow[4]) : 2;
+        oGeomColumn.nSRID = papszRow[5] ? atoi(papszRow[5]) : 0;
+        oGeomColumn.bGeography = papszRow[6] && atoi(papszRow[6]) == 1;
+        DMCatalogEntry(m_oCatalog, papszRow[0], papszRow[1])
+            .aoGeomColumns.push_back(oGeomColumn);
+    }
+    return true;
+}
+
+/************************************************************************/
+/*                         LoadColumnsCatalog()                         */
+/*                                                                      */
+/*      Read the columns of the given (schema, table) pairs, in as few  */
+/*      queries as the length of the IN lists allows.                   */
+/************************************************************************/
+
+bool OGRDAMENGDataSource::LoadColumnsCatalog(
+    const std::vector<std::pair<CPLString, CPLString>> &aoTables)
+{
+    std::set<CPLString> oSetWanted;
+    for (const auto &oTable : aoTables)
+        oSetWanted.insert(
+            DMCatalogKey(oTable.first.c_str(), oTable.second.c_str()));
+
+    OGRDAMENGStatement oCommand(poSession);
+    for (size_t iStart = 0; iStart < aoTables.size();
+         iStart += CATALOG_IN_LIST_SIZE)
+    {
+        const size_t iEnd =
+            std::min(aoTables.size(), iStart + CATALOG_IN_LIST_SIZE);
+        std::set<CPLString> oSetSchemas;
+        std::set<CPLString> oSetTables;
+        for (size_t i = iStart; i < iEnd; i++)
+        {
+            oSetSchemas.insert(DMCatalogLiteral(aoTables[i].first.c_str()));
+            oSetTables.insert(DMCatalogLiteral(aoTables[i].second.c_str()));
+        }
+
+        // The IN lists select a superset of the wanted pairs, which is
+        // filtered below.
+        CPLString osCommand(
+            "SELECT s.NAME, o.NAME, c.NAME, c.TYPE$, c.NULLABLE$, c.DEFVAL "
+            "FROM SYSCOLUMNS c "
+            "JOIN SYSOBJECTS o ON o.ID = c.ID "
+            "JOIN SYSOBJECTS s ON s.ID = o.SCHID AND s.TYPE$ = 'SCH' "
+            "WHERE s.NAME IN (");
+        bool bFirst = true;
+        for (const auto &osSchema : oSetSchemas)
+        {
+            if (!bFirst)
+                osCommand += ", ";
+            osCommand += osSchema;
+            bFirst = false;
+        }
+        osCommand += ") AND o.NAME IN (";
+        bFirst = true;
+        for (const auto &osTable : oSetTables)
+        {
+            if (!bFirst)
+                osCommand += ", ";
+            osCommand += osTable;
+            bFirst = false;
+        }
+        osCommand += ") ORDER BY s.NAME, o.NAME, c.COLID";
+
+        if (oCommand.Execute(osCommand) != CE_None)
+            return false;
+
+        char **papszRow = nullptr;
+        while ((papszRow = oCommand.SimpleFetchRow()) != nullptr)
+        {
+            if (papszRow[0] == nullptr || papszRow[1] == nullptr ||
+                papszRow[2] == nullptr)
+                continue;
+            const CPLString osKey = DMCatalogKey(papszRow[0], papszRow[1]);
+            if (oSetWanted.find(osKey) == oSetWanted.end())
+                continue;
+
+            DMCatalogColumn oColumn;
+            oColumn.osName = papszRow[2];
+            oColumn.osType = papszRow[3] ? papszRow[3] : "";
+            oColumn.bNullable = !(papszRow[4] && EQUAL(papszRow[4], "Y"));
+            oColumn.bHasDefault = papszRow[5] != nullptr;
+            oColumn.osDefault = papszRow[5] ? papszRow[5] : "";
+            DMCatalogEntry(m_oCatalog, papszRow[0], papszRow[1])
+                .aoColumns.push_back(oColumn);
+        }
+    }
+    return true;
+}
+
+/************************************************************************/
+/*                           LoadSRSCatalog()                           */
+/*                                                                      */
+/*      Read the spatial_ref_sys rows of all SRIDs the geometry         */
+/*      columns of the catalog refer to, in one query.                  */
+/************************************************************************/
+
+bool OGRDAMENGDataSource::LoadSRSCatalog()
+{
+    std::set<int> oSetSRID;
+    for (const auto &oTable : m_oCatalog)
+    {
+        for (const auto &oGeomColumn : oTable.second.aoGeomColumns)
+        {
+            if (oGeomColumn.bGeography)
+                oSetSRID.insert(4326);
+            if (oGeomColumn.nSRID > 0)
+                oSetSRID.insert(oGeomColumn.nSRID);
+        }
+    }
+    if (oSetSRID.empty() || !m_bHasSpatialRefSys)
+        return true;
+
+    CPLString osCommand("SELECT srid, srtext, auth_name, auth_srid FROM "
+                        "sysgeo2.spatial_ref_sys WHERE srid IN (");
+    bool bFirst = true;
+    for (int nSRID : oSetSRID)
+    {
+        if (!bFirst)
+            osCommand += ", ";
+        osCommand += CPLSPrintf("%d", nSRID);
+        bFirst = false;
+    }
+    osCommand += ")";
+
+    OGRDAMENGStatement oCommand(poSession);
+    if (oCommand.Execute(osCommand) != CE_None)
+        return false;
+
+    char **papszRow = nullptr;
+    while ((papszRow = oCommand.SimpleFetchRow()) != nullptr)
+    {
+        if (papszRow[0] == nullptr)
+            continue;
+        DMCatalogSRS oSRS;
+        oSRS.osWKT = papszRow[1] ? papszRow[1] : "";
+        oSRS.osAuthName = papszRow[2] ? papszRow[2] : "";
+        oSRS.nAuthSRID = papszRow[3] ? atoi(papszRow[3]) : 0;
+        m_oCatalogSRS[atoi(papszRow[0])] = oSRS;
+    }
+    return true;
+}
+
+/************************************************************************/
+/*                          ReadCatalogCache()                          */
+/*                                                                      */
+/*      Load the catalog from a file written by WriteCatalogCache() for */
+/*      the same session and catalog version.                           */
+/************************************************************************/
+
+bool OGRDAMENGDataSource::ReadCatalogCache(const char *pszFilename,
+                                           const CPLString &osVersion)
+{
+    VSIStatBufL sStat;
+    if (VSIStatL(pszFilename, &sStat) != 0)
+        return false;
+
+    CPLJSONDocument oDoc;
+    if (!oDoc.Load(pszFilename))
+        return false;
+
+    const CPLJSONObject oRoot = oDoc.GetRoot();
+    if (oRoot.GetInteger("format_version") != CATALOG_CACHE_FORMAT_VERSION ||
+        oRoot.GetString("catalog_version") != osVersion ||
+        oRoot.GetString("user") != poSession->pszUserid ||
+        oRoot.GetString("database") != poSession->pszDatabase ||
+        oRoot.GetString("schema") != osCurrentSchema)
+    {
+        CPLDebug("DAMENG", "Catalog cache %s is out of date", pszFilename);
+        return false;
+    }
+
+    m_oCatalog.clear();
+    m_oCatalogSRS.clear();
+    m_nGeoConsCheck = oRoot.GetInteger("geo2_cons_check", -1);
+
+    for (const auto &oTable : oRoot.GetArray("tables"))
+    {
+        DMCatalogTable &oCatalogTable =
+            DMCatalogEntry(m_oCatalog, oTable.GetString("schema").c_str(),
+                           oTable.GetString("table").c_str());
+        for (const auto &oColumn : oTable.GetArray("columns"))
+        {
+            DMCatalogColumn oCatalogColumn;
+            oCatalogColumn.osName = oColumn.GetString("name");
+            oCatalogColumn.osType = oColumn.GetString("type");
+            oCatalogColumn.bNullable = oColumn.GetBool("nullable", true);
+            oCatalogColumn.bHasDefault =
+                oColumn.GetObj("default").IsValid();
+            oCatalogColumn.osDefault = oColumn.GetString("default");
+            oCatalogTable.aoColumns.push_back(oCatalogColumn);
+        }
+        for (const auto &oGeomColumn : oTable.GetArray("geometry_columns"))
+        {
+            DMCatalogGeomColumn oCatalogGeomColumn;
+            oCatalogGeomColumn.osName = oGeomColumn.GetString("name");
+            oCatalogGeomColumn.osGeomType = oGeomColumn.GetString("type");
+            oCatalogGeomColumn.nCoordDimension =
+                oGeomColumn.GetInteger("coord_dimension", 2);
+            oCatalogGeomColumn.nSRID = oGeomColumn.GetInteger("srid");
+            oCatalogGeomColumn.bGeography = oGeomColumn.GetBool("geography");
+            oCatalogTable.aoGeomColumns.push_back(oCatalogGeomColumn);
+        }
+    }
+
+    for (const auto &oSRS : oRoot.GetArray("srs"))
+    {
+        DMCatalogSRS oCatalogSRS;
+        oCatalogSRS.osWKT = oSRS.GetString("srtext");
+        oCatalogSRS.osAuthName = oSRS.GetString("auth_name");
+        oCatalogSRS.nAuthSRID = oSRS.GetInteger("auth_srid");
+        m_oCatalogSRS[oSRS.GetInteger("srid")] = oCatalogSRS;
+    }
+
+    CPLDebug("DAMENG", "Catalog of %d tables read from %s",
+             static_cast<int>(m_oCatalog.size()), pszFilename);
+    return true;
+}
+
+/************************************************************************/
+/*                         WriteCatalogCache()                          */
+/************************************************************************/
+
+void OGRDAMENGDataSource::WriteCatalogCache(const char *pszFilename,
+                                            const CPLString &osVersion)
+{
+    CPLJSONDocument oDoc;
+    CPLJSONObject oRoot = oDoc.GetRoot();
+    oRoot.Add("format_version", CATALOG_CACHE_FORMAT_VERSION);
+    oRoot.Add("catalog_version", osVersion);
+    oRoot.Add("user", poSession->pszUserid);
+    oRoot.Add("database", poSession->pszDatabase);
+    oRoot.Add("schema", osCurrentSchema);
+    oRoot.Add("geo2_cons_check", m_nGeoConsCheck);
+
+    CPLJSONArray oTables;
+    for (const auto &oIter : m_oCatalog)
+    {
+        const auto &oCatalogTable = oIter.second;
+        CPLJSONObject oTable;
+        oTable.Add("schema", oCatalogTable.osSchemaName);
+        oTable.Add("table", oCatalogTable.osTableName);
+
+        CPLJSONArray oColumns;
+        for (const auto &oCatalogColumn : oCatalogTable.aoColumns)
+        {
+            CPLJSONObject oColumn;
+            oColumn.Add("name", oCatalogColumn.osName);
+            oColumn.Add("type", oCatalogColumn.osType);
+            oColumn.Add("nullable", oCatalogColumn.bNullable);
+            if (oCatalogColumn.bHasDefault)
+                oColumn.Add("default", oCatalogColumn.osDefault);
+            oColumns.Add(oColumn);
+        }
+        oTable.Add("columns", oColumns);
+
+        CPLJSONArray oGeomColumns;
+        for (const auto &oCatalogGeomColumn : oCatalogTable.aoGeomColumns)
+        {
+            CPLJSONObject oGeomColumn;
+            oGeomColumn.Add("name", oCatalogGeomColumn.osName);
+            oGeomColumn.Add("type", oCatalogGeomColumn.osGeomType);
+            oGeomColumn.Add("coord_dimension",
+                            oCatalogGeomColumn.nCoordDimension);
+            oGeomColumn.Add("srid", oCatalogGeomColumn.nSRID);
+            oGeomColumn.Add("geography", oCatalogGeomColumn.bGeography);
+            oGeomColumns.Add(oGeomColumn);
+        }
+        oTable.Add("geometry_columns", oGeomColumns);
+        oTables.Add(oTable);
+    }
+    oRoot.Add("tables", oTables);
+
+    CPLJSONArray oSRSArray;
+    for (const auto &oIter : m_oCatalogSRS)
+    {
+        CPLJSONObject oSRS;
+        oSRS.Add("srid", oIter.first);
+        oSRS.Add("srtext", oIter.second.osWKT);
+        oSRS.Add("auth_name", oIter.second.osAuthName);
+        oSRS.Add("auth_srid", oIter.second.nAuthSRID);
+        oSRSArray.Add(oSRS);
+    }
+    oRoot.Add("srs", oSRSArray);
+
+    if (!oDoc.Save(pszFilename))
+        CPLDebug("DAMENG", "Cannot write catalog cache %s", pszFilename);
+}
@@ -29,6 +29,176 @@
 #include "ogr_dameng.h"
 #include "cpl_conv.h"
 
+#include <algorithm>
+#include <chrono>
+
+/************************************************************************/
+/*                          Connection pool                             */
+/*                                                                      */
+/*      With DM_CONNECTION_POOL=YES, sessions released by closed        */
+/*      datasources are kept by the process, and handed out again to    */
+/*      datasources of the same user, database and schema instead of    */
+/*      logging in anew. DM_CONNECTION_POOL_SIZE bounds the number of   */
+/*      idle sessions, and DM_CONNECTION_POOL_IDLE_TIMEOUT (seconds)    */
+/*      how long they are kept.                                         */
+/************************************************************************/
+
+namespace
+{
+struct DMIdleConn
+{
+    OGRDAMENGConn *poConn;
+    std::chrono::steady_clock::time_point tReleased;
+};
+}  // namespace
+
+static std::mutex &GetConnPoolMutex()
+{
+    static std::mutex oMutex;
+    return oMutex;
+}
+
+// Most recently released sessions last.
+static std::vector<DMIdleConn> &GetConnPool()
+{
+    static std::vector<DMIdleConn> aoIdleConns;
+    return aoIdleConns;
+}
+
+static bool DMConnPoolEnabled()
+{
+    return CPLTestBool(CPLGetConfigOption("DM_CONNECTION_POOL", "NO"));
+}
+
+/************************************************************************/
+/*                        DMTakeExpiredConns()                          */
+/*                                                                      */
+/*      Remove the sessions idle for too long, or beyond the pool       */
+/*      size, from the pool. The caller holds the pool mutex and        */
+/*      closes them once it is released.                                */
+/************************************************************************/
+
+static void DMTakeExpiredConns(std::vector<OGRDAMENGConn *> &apoExpired)
+{
+    auto &aoIdleConns = GetConnPool();
+    const double dfTimeout = CPLAtof(
+        CPLGetConfigOption("DM_CONNECTION_POOL_IDLE_TIMEOUT",
+                           CPLSPrintf("%d", DEFAULT_CONNECTION_POOL_IDLE_TIMEOUT)));
+    const size_t nMaxSize = static_cast<size_t>(std::max(
+        0, atoi(CPLGetConfigOption(
+               "DM_CONNECTION_POOL_SIZE",
+               CPLSPrintf("%d", DEFAULT_CONNECTION_POOL_SIZE)))));
+    const auto tNow = std::chrono::steady_clock::now();
+
+    size_t nKept = 0;
+    for (size_t i = 0; i < aoIdleConns.size(); i++)
+    {
+        const double dfIdle = std::chrono::duration<double>(
+                                  tNow - aoIdleConns[i].tReleased)
+                                  .count();
+        if (dfIdle > dfTimeout || aoIdleConns.size() - i > nMaxSize)
+            apoExpired.push_back(aoIdleConns[i].poConn);
+        else
+            aoIdleConns[nKept++] = aoIdleConns[i];
+    }
+    aoIdleConns.resize(nKept);
+}
+
+/************************************************************************/
+/*                       DMBorrowPooledConnection()                     */
+/************************************************************************/
+
+static OGRDAMENGConn *DMBorrowPooledConnection(const char *pszUserid,
+                                               const char *pszPassword,
+                                               const char *pszDatabase,
+                                               const char *pszSchemaName)
+{
+    while (true)
+    {
+        OGRDAMENGConn *poConn = nullptr;
+        std::vector<OGRDAMENGConn *> apoExpired;
+        {
+            std::lock_guard<std::mutex> oLock(GetConnPoolMutex());
+            DMTakeExpiredConns(apoExpired);
+            auto &aoIdleConns = GetConnPool();
+            for (size_t i = aoIdleConns.size(); i > 0; i--)
+            {
+                OGRDAMENGConn *poIdle = aoIdleConns[i - 1].poConn;
+                if (strcmp(poIdle->pszUserid, pszUserid) == 0 &&
+                    strcmp(poIdle->pszPassword, pszPassword) == 0 &&
+                    strcmp(poIdle->pszDatabase, pszDatabase) == 0 &&
+                    strcmp(poIdle->pszSchemaName, pszSchemaName) == 0)
+                {
+                    poConn = poIdle;
+                    aoIdleConns.erase(aoIdleConns.begin() + (i - 1));
+                    break;
+                }
+            }
+        }
+        for (OGRDAMENGConn *poExpired : apoExpired)
+            delete poExpired;
+
+        if (poConn == nullptr)
+            return nullptr;
+        if (poConn->IsAlive())
+        {
+            CPLDebug("DAMENG", "Reusing pooled session of %s@%s",
+                     pszUserid, pszDatabase);
+            return poConn;
+        }
+        CPLDebug("DAMENG", "Dropping dead pooled session of %s@%s",
+                 pszUserid, pszDatabase);
+        delete poConn;
+    }
+}
+
+/************************************************************************/
+/*                      OGRReleaseDAMENGConnection()                    */
+/*                                                                      */
+/*      Give back a session obtained from OGRGetDAMENGConnection().     */
+/*      Its pending work is committed, as when it is closed.            */
+/************************************************************************/
+
+void OGRReleaseDAMENGConnection(OGRDAMENGConn *poConn)
+{
+    if (poConn == nullptr)
+        return;
+    // The statistics belong to the datasource giving the session back.
+    poConn->poStats = nullptr;
+    if (!DMConnPoolEnabled() || !DSQL_SUCCEEDED(dpi_commit(poConn->hCon)))
+    {
+        delete poConn;
+        return;
+    }
+    poConn->bInTransaction = FALSE;
+    poConn->nFetchMemory = (size_t)DEFAULT_FETCH_MEMORY_MB * 1024 * 1024;
+    poConn->nLobChunkSize = (size_t)DEFAULT_LOB_CHUNK_SIZE_KB * 1024;
+
+    std::vector<OGRDAMENGConn *> apoExpired;
+    {
+        std::lock_guard<std::mutex> oLock(GetConnPoolMutex());
+        GetConnPool().push_back({poConn, std::chrono::steady_clock::now()});
+        DMTakeExpiredConns(apoExpired);
+    }
+    for (OGRDAMENGConn *poExpired : apoExpired)
+        delete poExpired;
+}
+
+/************************************************************************/
+/*                    OGRDAMENGClearConnectionPool()                    */
+/************************************************************************/
+
+void OGRDAMENGClearConnectionPool()
+{
+    std::vector<DMIdleConn> aoIdleConns;
+    {
+        std::lock_guard<std::mutex> oLock(GetConnPoolMutex());
+        std::swap(aoIdleConns, GetConnPool());
+    }
+    for (auto &oIdle : aoIdleConns)
+        delete oIdle.poConn;
+}
+
 /************************************************************************/
 /*                          OGRGetDAMENGConnection()                        */
 /************************************************************************/
@@ -40,6 +210,14 @@ OGRDAMENGConn* OGRGetDAMENGConnection(const char* pszUserid,
 {
     OGRDAMENGConn *poConnection;
 
+    if (DMConnPoolEnabled())
+    {
+        poConnection = DMBorrowPooledConnection(pszUserid, pszPassword,
+                                                pszDatabase, pszSchemaName);
+        if (poConnection != nullptr)
+            return poConnection;
+    }
+
     poConnection = new OGRDAMENGConn();
     if (poConnection->EstablishConn(pszUserid, pszPassword, pszDatabase, pszSchemaName))
         return poConnection;
@@ -79,9 +257,99 @@ OGRDAMENGConn::~OGRDAMENGConn()
     dpi_logout(hCon);
     dpi_free_con(hCon);
     dpi_free_env(hEnv);
+    for (auto &oBuffer : m_aoFetchBuffers)
+        CPLFree(oBuffer.second);
     CPLFree(pszUserid);
     CPLFree(pszPassword);
     CPLFree(pszDatabase);
+    CPLFree(pszSchemaName);
+}
+
+/************************************************************************/
+/*                             SoftCommit()                             */
+/*                                                                      */
+/*      Autocommit is turned off, so statements commit explicitly       */
+/*      once done. This is a no-op while the datasource holds a         */
+/*      transaction open.                                               */
+/************************************************************************/
+
+DPIRETURN OGRDAMENGConn::SoftCommit()
+{
+    if (bInTransaction)
+        return DSQL_SUCCESS;
+    OGRDAMENGStatsTimer oTimer(poStats, OGRDAMENGStats::COMMIT);
+    return dpi_commit(hCon);
+}
+
+/************************************************************************/
+/*                              IsAlive()                               */
+/*                                                                      */
+/*      Health check of a pooled session before handing it out again.   */
+/************************************************************************/
+
+bool OGRDAMENGConn::IsAlive()
+{
+    dhstmt hStmt = nullptr;
+    if (!DSQL_SUCCEEDED(dpi_alloc_stmt(hCon, &hStmt)))
+        return false;
+    const DPIRETURN rt = dpi_exec_direct(hStmt, (sdbyte *)"SELECT 1");
+    dpi_free_stmt(hStmt);
+    return DSQL_SUCCEEDED(rt);
+}
+
+/************************************************************************/
+/*                         AcquireFetchBuffer()                         */
+/*                                                                      */
+/*      Return a buffer of at least nSize bytes, reusing the smallest   */
+/*      pooled one that fits and is not wastefully large. The real      */
+/*      size is returned in *pnAllocated and must be passed back to     */
+/*      ReleaseFetchBuffer(). The content is undefined.                 */
+/************************************************************************/
+
+void *OGRDAMENGConn::AcquireFetchBuffer(size_t nSize, size_t *pnAllocated)
+{
+    size_t iBest = m_aoFetchBuffers.size();
+    for (size_t i = 0; i < m_aoFetchBuffers.size(); i++)
+    {
+        const size_t nPooled = m_aoFetchBuffers[i].first;
+        if (nPooled >= nSize && nPooled / 4 <= nSize &&
+            (iBest == m_aoFetchBuffers.size() ||
+             nPooled < m_aoFetchBuffers[iBest].first))
+            iBest = i;
+    }
+
+    if (iBest == m_aoFetchBuffers.size())
+    {
+        *pnAllocated = nSize;
+        return CPLMalloc(nSize);
+    }
+
+    void *pBuffer = m_aoFetchBuffers[iBest].second;
+    *pnAllocated = m_aoFetchBuffers[iBest].first;
+    m_nPooledBytes -= *pnAllocated;
+    m_aoFetchBuffers[iBest] = m_aoFetchBuffers.back();
+    m_aoFetchBuffers.pop_back();
+    return pBuffer;
+}
+
+/************************************************************************/
+/*                         ReleaseFetchBuffer()                         */
+/*                                                                      */
+/*      Give a buffer back to the pool, or free it if that would make   */
+/*      the pool exceed the fetch memory budget.                        */
+/************************************************************************/
+
+void OGRDAMENGConn::ReleaseFetchBuffer(void *pBuffer, size_t nSize)
+{
+    if (pBuffer == nullptr)
+        return;
+    if (m_nPooledBytes + nSize > nFetchMemory)
+    {
+        CPLFree(pBuffer);
+        return;
+    }
+    m_aoFetchBuffers.emplace_back(nSize, pBuffer);
+    m_nPooledBytes += nSize;
 }
 
 /************************************************************************/
@@ -90,7 +358,7 @@ OGRDAMENGConn::~OGRDAMENGConn()
 int OGRDAMENGConn::EstablishConn(const char* pszUseridIn,
                              const char* pszPasswordIn,
                              const char *pszDatabaseIn,
-                             const char *pszSchemaName)
+                             const char *pszSchemaNameIn)
 {
     DPIRETURN rt;
 
@@ -110,10 +378,10 @@ int OGRDAMENGConn::EstablishConn(const char* pszUseridIn,
         return FALSE;
     }
 
-    if (strlen(pszSchemaName))
+    if (strlen(pszSchemaNameIn))
     {
         rt = dpi_set_con_attr(hCon, DSQL_ATTR_CURRENT_SCHEMA,
-                              (sdbyte *)pszSchemaName, (sdint4)strlen(pszSchemaName));
+                              (sdbyte *)pszSchemaNameIn, (sdint4)strlen(pszSchemaNameIn));
         if (!DSQL_SUCCEEDED(rt))
         {
             CPLError(CE_Failure, CPLE_AppDefined, "failed to set con_attr");
@@ -138,6 +406,7 @@ int OGRDAMENGConn::EstablishConn(const char* pszUseridIn,
     pszUserid = CPLStrdup(pszUseridIn);
     pszPassword = CPLStrdup(pszPasswordIn);
     pszDatabase = CPLStrdup(pszDatabaseIn);
+    pszSchemaName = CPLStrdup(pszSchemaNameIn);
 
     return TRUE;
 }
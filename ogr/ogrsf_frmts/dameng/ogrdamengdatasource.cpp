@@ -31,10 +31,11 @@
 #include "cpl_conv.h"
 #include "cpl_string.h"
 #include "cpl_hash_set.h"
+#include <algorithm>
 #include <cctype>
 #include <set>
 
-int ogr_DM_insertnum = FORCED_INSERT_NUM;
+int ogr_DM_insertnum = DEFAULT_INSERT_BATCH_SIZE;
 /*
 OGRDAMENGDataSource()
 */
@@ -55,6 +56,9 @@ OGRDAMENGDataSource::~OGRDAMENGDataSource()
     
     CPLFree(papoLayers);
 
+    if (poSession != nullptr)
+        FlushSoftTransaction();
+
     for (int i = 0; i < nKnownSRID; i++)
     {
         if (papoSRS[i] != nullptr)//
@@ -62,7 +66,10 @@ OGRDAMENGDataSource::~OGRDAMENGDataSource()
     }
     CPLFree(panSRID);
     CPLFree(papoSRS);
-    delete poSession;
+    for (auto &poConn : m_apoIdleScanConns)
+        OGRReleaseDAMENGConnection(poConn.release());
+    m_apoIdleScanConns.clear();
+    OGRReleaseDAMENGConnection(poSession);
 }
 
 typedef struct
@@ -179,6 +186,10 @@ int OGRDAMENGDataSource::Open(const char *pszNewName,
         pszDatabase = CSLFetchNameValueDef(papszOpenOptionsIn, "DBNAME", "");
         pszSchemaName = CSLFetchNameValueDef(papszOpenOptionsIn, "SCHEMA", "");
         const char *pszTables = CSLFetchNameValue(papszOpenOptionsIn, "TABLES");
+        const char *pszInsertNum =
+            CSLFetchNameValue(papszOpenOptionsIn, "INSERTNUM");
+        if (pszInsertNum)
+            ogr_DM_insertnum = std::max(1, atoi(pszInsertNum));
         if (pszSchemaName[0] != '\0')
         {
             osCurrentSchema = pszSchemaName;
@@ -200,7 +211,7 @@ int OGRDAMENGDataSource::Open(const char *pszNewName,
         {
             if (pszUserid[i] == ';')
             {
-                ogr_DM_insertnum = atoi(pszUserid + i + 1);
+                ogr_DM_insertnum = std::max(1, atoi(pszUserid + i + 1));
                 pszUserid[i] = '\0';
                 break;
             }
@@ -236,7 +247,7 @@ int OGRDAMENGDataSource::Open(const char *pszNewName,
         if (pszUserid[i] == '?')
         {
             pszUserid[i++] = '\0';
-            if (strnicmp("SCHEMA", pszUserid + i, 6) == 0)
+            if (EQUALN("SCHEMA", pszUserid + i, 6))
             {
                 if (pszUserid[i + 6] == '=' && pszUserid[i + 6] != '\0')
                 {
@@ -273,6 +284,31 @@ int OGRDAMENGDataSource::Open(const char *pszNewName,
         CSLDestroy(papszTableList);
         return FALSE;
     }
+    poSession->poStats = &m_oStats;
+
+    const char *pszFetchMemory =
+        CSLFetchNameValue(papszOpenOptionsIn, "FETCH_MEMORY");
+    if (pszFetchMemory)
+        poSession->nFetchMemory =
+            (size_t)std::max(1, atoi(pszFetchMemory)) * 1024 * 1024;
+
+    const char *pszLobChunkSize =
+        CSLFetchNameValue(papszOpenOptionsIn, "LOB_CHUNK_SIZE");
+    if (pszLobChunkSize)
+        poSession->nLobChunkSize =
+            (size_t)std::max(1, atoi(pszLobChunkSize)) * 1024;
+
+    const char *pszParallelScan =
+        CSLFetchNameValue(papszOpenOptionsIn, "PARALLEL_SCAN");
+    if (pszParallelScan)
+    {
+        nParallelScan = EQUAL(pszParallelScan, "ALL_CPUS")
+                            ? CPLGetNumCPUs()
+                            : atoi(pszParallelScan);
+    }
+    bParallelScanOrdered = CPLFetchBool(papszOpenOptionsIn,
+                                        "PARALLEL_SCAN_ORDERED", true);
+    bPrefetch = CPLFetchBool(papszOpenOptionsIn, "PREFETCH", false);
 
     bDSUpdate = bUpdate;
 
@@ -285,37 +321,37 @@ int OGRDAMENGDataSource::Open(const char *pszNewName,
     {
         osRegisteredLayers.insert(papoLayers[i]->GetName());
     }
+    /* -------------------------------------------------------------------- */
+    /*      Read the catalog of the spatial tables in bulk, or from the     */
+    /*      cache file if the catalog did not change since it was written.  */
+    /* -------------------------------------------------------------------- */
+    const char *pszCatalogCache =
+        CSLFetchNameValue(papszOpenOptionsIn, "CATALOG_CACHE");
+    CPLString osCatalogVersion;
+    bool bCatalogFromCache = false;
+    if (pszCatalogCache)
+    {
+        osCatalogVersion = GetCatalogVersion();
+        bCatalogFromCache = !osCatalogVersion.empty() &&
+                            ReadCatalogCache(pszCatalogCache, osCatalogVersion);
+    }
+    if (!bCatalogFromCache)
+        LoadGeometryColumnsCatalog();
+
     if (papszTableList == nullptr)
     {
-        OGRDAMENGStatement oGetTbales(poSession);
-        if (oGetTbales.Execute("SELECT DISTINCT F_TABLE_NAME,F_TABLE_SCHEMA "
-                               "FROM SYSGEO2.GEOMETRY_COLUMNS ") == CE_None)
+        for (const auto &oIter : m_oCatalog)
         {
-            char **row = nullptr;
-            while ((row = oGetTbales.SimpleFetchRow()) != nullptr)
+            const DMCatalogTable &oTable = oIter.second;
+            if (oTable.aoGeomColumns.empty())
+                continue;
+            CPLString osTableName;
+            osTableName.Printf("%s.%s", oTable.osSchemaName.c_str(),
+                               oTable.osTableName.c_str());
+            if (CSLFindString(papszTableList, osTableName) == -1 &&
+                CSLFindString(papszTableList, osCurrentSchema) == -1)
             {
-                char tablename[100];
-                snprintf(tablename, sizeof(tablename), "%s.%s", row[1], row[0]);
-                if (CSLFindString(papszTableList, tablename) == -1 &&
-                    CSLFindString(papszTableList, osCurrentSchema) == -1)
-                {
-                    papszTableList = CSLAddString(papszTableList, tablename);
-                }
-            }
-        }
-        if (oGetTbales.Execute("SELECT DISTINCT F_TABLE_NAME,F_TABLE_SCHEMA "
-                               "FROM SYSGEO2.GEOGRAPHY_COLUMNS ") == CE_None)
-        {
-            char **row = nullptr;
-            while ((row = oGetTbales.SimpleFetchRow()) != nullptr)
-            {
-                char tablename[100];
-                snprintf(tablename, sizeof(tablename), "%s.%s", row[1], row[0]);
-                if (CSLFindString(papszTableList, tablename) == -1 &&
-                    CSLFindString(papszTableList, osCurrentSchema) == -1)
-                {
-                    papszTableList = CSLAddString(papszTableList, tablename);
-                }
+                papszTableList = CSLAddString(papszTableList, osTableName);
             }
         }
     }
@@ -375,6 +411,19 @@ int OGRDAMENGDataSource::Open(const char *pszNewName,
         CSLDestroy(papszTableList);
     }
 
+    if (!bCatalogFromCache)
+    {
+        std::vector<std::pair<CPLString, CPLString>> aoCatalogTables;
+        for (int iRecord = 0; iRecord < nTableCount; iRecord++)
+            aoCatalogTables.emplace_back(papsTables[iRecord]->pszSchemaName,
+                                         papsTables[iRecord]->pszTableName);
+        LoadColumnsCatalog(aoCatalogTables);
+        LoadSRSCatalog();
+        GetGeoConsCheck();
+        if (pszCatalogCache && !osCatalogVersion.empty())
+            WriteCatalogCache(pszCatalogCache, osCatalogVersion);
+    }
+
     hSetTables = CPLHashSetNew(OGRDAMENGHashTableEntry, OGRDAMENGEqualTableEntry,
                                OGRDAMENGFreeTableEntry);
     for (int iRecord = 0; iRecord < nTableCount; iRecord++)
@@ -506,6 +555,9 @@ OGRErr OGRDAMENGDataSource::DeleteLayer(int iLayer)
 
     CPLDebug("DAMENG", "DeleteLayer(%s)", osLayerName.c_str());
 
+    InvalidateCatalogTable(osSchemaName, osTableName);
+    // No need to index a table about to be dropped
+    papoLayers[iLayer]->CancelDeferredIndexCreation();
     delete papoLayers[iLayer];
     memmove(papoLayers + iLayer, papoLayers + iLayer + 1,
             sizeof(void *) * (nLayers - iLayer - 1));
@@ -834,23 +886,41 @@ OGRLayer *OGRDAMENGDataSource::ICreateLayer(const char *pszLayerName,
     else
         suffix = "";
 
-    if (eType != wkbNone && EQUAL(pszGeomType, "geography"))
+    /* -------------------------------------------------------------------- */
+    /*      With DEFERRED_INDEX, the geometry column is created without     */
+    /*      its type and SRID checks, which the layer adds together with    */
+    /*      the spatial index once the data is loaded.                      */
+    /* -------------------------------------------------------------------- */
+    const bool bSpatialIndex =
+        eType != wkbNone && CPLFetchBool(papszOptions, "SPATIAL_INDEX", false);
+    const bool bDeferredIndex =
+        eType != wkbNone && CPLFetchBool(papszOptions, "DEFERRED_INDEX", false);
+    CPLString osGeomColumnType;
+    CPLString osGeomChecks;
+    CPLString osDeferredChecks;
+    if (eType != wkbNone)
     {
-        osCommand.Printf("%s ( %s %s identity(1,1), %s SYSGEO2.ST_Geography "
-                         "check(type=%s%s) check(srid = %d) , PRIMARY KEY (%s)",
-                         osCreateTable.c_str(), osFIDColumnNameEscaped.c_str(),
-                         pszSerialType, OGRDAMENGEscapeColumnName(pszGFldName).c_str(),
-                         pszGeometryType, suffix,
-                         nSRSId, osFIDColumnNameEscaped.c_str());
+        osGeomColumnType = EQUAL(pszGeomType, "geography")
+                               ? "SYSGEO2.ST_Geography"
+                               : "SYSGEO2.ST_Geometry";
+        osGeomChecks.Printf("check(type=%s%s) check(srid = %d)",
+                            pszGeometryType, suffix, nSRSId);
+        if (bDeferredIndex)
+        {
+            osDeferredChecks.Printf(
+                "%s %s %s", OGRDAMENGEscapeColumnName(pszGFldName).c_str(),
+                osGeomColumnType.c_str(), osGeomChecks.c_str());
+            osGeomChecks.clear();
+        }
     }
-    else if (eType != wkbNone && !EQUAL(pszGeomType, "geography"))
+
+    if (eType != wkbNone)
     {
-        osCommand.Printf("%s ( %s %s identity(1,1), %s SYSGEO2.ST_Geometry "
-                         "check(type=%s%s) check(srid = %d) , PRIMARY KEY (%s)",
+        osCommand.Printf("%s ( %s %s identity(1,1), %s %s %s , PRIMARY KEY (%s)",
                          osCreateTable.c_str(), osFIDColumnNameEscaped.c_str(),
                          pszSerialType, OGRDAMENGEscapeColumnName(pszGFldName).c_str(),
-                         pszGeometryType, suffix,
-                         nSRSId, osFIDColumnNameEscaped.c_str());
+                         osGeomColumnType.c_str(), osGeomChecks.c_str(),
+                         osFIDColumnNameEscaped.c_str());
     }
     else
     {
@@ -860,8 +930,6 @@ OGRLayer *OGRDAMENGDataSource::ICreateLayer(const char *pszLayerName,
     }
     osCreateTable = osCommand;
 
-    //bool bCreateSpatialIndex = FALSE;
-    //const char *pszSpatialIndexType = "SPGIST";
     osCommand = osCreateTable;
     osCommand += " )";
 
@@ -888,8 +956,21 @@ OGRLayer *OGRDAMENGDataSource::ICreateLayer(const char *pszLayerName,
     poLayer->SetPrecisionFlag(CPLFetchBool(papszOptions, "PRECISION", true));
     //poLayer->SetForcedSRSId(nForcedSRSId);
     poLayer->SetForcedGeometryTypeFlags(ForcedGeometryTypeFlags);
-    //poLayer->SetCreateSpatialIndex(bCreateSpatialIndex, pszSpatialIndexType);
+    poLayer->SetCreateSpatialIndex(bSpatialIndex, "SPATIAL");
     poLayer->SetDeferredCreation(osCreateTable);
+    if (bDeferredIndex)
+        poLayer->SetDeferredIndexCreation(osDeferredChecks);
+    else if (bSpatialIndex)
+        poLayer->RunCreateSpatialIndex(0);
+
+    const char *pszBatchSize = CSLFetchNameValue(papszOptions, "BATCH_SIZE");
+    const char *pszCommitInterval =
+        CSLFetchNameValue(papszOptions, "COMMIT_INTERVAL");
+    const int nBatchSize =
+        pszBatchSize ? std::max(1, atoi(pszBatchSize)) : ogr_DM_insertnum;
+    poLayer->SetInsertBatchSize(
+        nBatchSize, pszCommitInterval ? std::max(0, atoi(pszCommitInterval))
+                                      : -1);
 
     /* HSTORE_COLUMNS existed at a time during GDAL 1.10dev */
     const char *pszHSTOREColumns =
@@ -937,10 +1018,353 @@ int OGRDAMENGDataSource::TestCapability(const char *pszCap) const
         return TRUE;
     else if (EQUAL(pszCap, ODsCRandomLayerWrite))
         return TRUE;
+    else if (EQUAL(pszCap, ODsCTransactions))
+        return TRUE;
     else
         return FALSE;
 }
 
+/************************************************************************/
+/*                         StartTransaction()                           */
+/*                                                                      */
+/* Should only be called by user code. Not driver internals.            */
+/************************************************************************/
+
+OGRErr OGRDAMENGDataSource::StartTransaction(CPL_UNUSED int bForce)
+{
+    if (bUserTransactionActive)
+    {
+        CPLError(CE_Failure, CPLE_AppDefined,
+                 "Transaction already established");
+        return OGRERR_FAILURE;
+    }
+
+    CPLAssert(!bSavePointActive);
+
+    if (nSoftTransactionLevel == 0)
+    {
+        // Make sure that work done before the transaction is not caught
+        // by a later rollback.
+        if (FlushCache(false) != CE_None)
+            return OGRERR_FAILURE;
+        OGRErr eErr = DoTransactionCommand("BEGIN");
+        if (eErr != OGRERR_NONE)
+            return eErr;
+    }
+    else
+    {
+        OGRErr eErr = DoTransactionCommand("SAVEPOINT ogr_savepoint");
+        if (eErr != OGRERR_NONE)
+            return eErr;
+
+        bSavePointActive = TRUE;
+    }
+
+    nSoftTransactionLevel++;
+    bUserTransactionActive = TRUE;
+    poSession->bInTransaction = TRUE;
+
+    return OGRERR_NONE;
+}
+
+/************************************************************************/
+/*                         CommitTransaction()                          */
+/*                                                                      */
+/* Should only be called by user code. Not driver internals.            */
+/************************************************************************/
+
+OGRErr OGRDAMENGDataSource::CommitTransaction()
+{
+    if (!bUserTransactionActive)
+    {
+        CPLError(CE_Failure, CPLE_AppDefined, "Transaction not established");
+        return OGRERR_FAILURE;
+    }
+
+    // Send the inserts still buffered by the layers.
+    if (FlushCache(false) != CE_None)
+    {
+        RollbackTransaction();
+        return OGRERR_FAILURE;
+    }
+
+    nSoftTransactionLevel--;
+    bUserTransactionActive = FALSE;
+    InvalidateLayerStatistics();
+
+    OGRErr eErr;
+    if (bSavePointActive)
+    {
+        CPLAssert(nSoftTransactionLevel > 0);
+        bSavePointActive = FALSE;
+
+        eErr = DoTransactionCommand("RELEASE SAVEPOINT ogr_savepoint");
+    }
+    else
+    {
+        CPLAssert(nSoftTransactionLevel == 0);
+        eErr = DoTransactionCommand("COMMIT");
+
+        // DDL of DEFERRED_INDEX layers waited for the end of the
+        // transaction. The data is committed even if it fails.
+        for (int iLayer = 0; eErr == OGRERR_NONE && iLayer < nLayers;
+             iLayer++)
+            papoLayers[iLayer]->RunDeferredIndexCreation();
+    }
+
+    return eErr;
+}
+
+/************************************************************************/
+/*                        RollbackTransaction()                         */
+/*                                                                      */
+/* Should only be called by user code. Not driver internals.            */
+/************************************************************************/
+
+OGRErr OGRDAMENGDataSource::RollbackTransaction()
+{
+    if (!bUserTransactionActive)
+    {
+        CPLError(CE_Failure, CPLE_AppDefined, "Transaction not established");
+        return OGRERR_FAILURE;
+    }
+
+    FlushCache(false);
+
+    nSoftTransactionLevel--;
+    bUserTransactionActive = FALSE;
+
+    OGRErr eErr;
+    if (bSavePointActive)
+    {
+        CPLAssert(nSoftTransactionLevel > 0);
+        bSavePointActive = FALSE;
+
+        eErr = DoTransactionCommand("ROLLBACK TO SAVEPOINT ogr_savepoint");
+    }
+    else
+    {
+        CPLAssert(nSoftTransactionLevel == 0);
+        eErr = DoTransactionCommand("ROLLBACK");
+    }
+
+    return eErr;
+}
+
+/************************************************************************/
+/*                        SoftStartTransaction()                        */
+/*                                                                      */
+/*      Create a transaction scope.  If we already have a               */
+/*      transaction active this isn't a real transaction, but just      */
+/*      an increment to the scope count.                                */
+/************************************************************************/
+
+OGRErr OGRDAMENGDataSource::SoftStartTransaction()
+
+{
+    nSoftTransactionLevel++;
+
+    OGRErr eErr = OGRERR_NONE;
+    if (nSoftTransactionLevel == 1)
+    {
+        eErr = DoTransactionCommand("BEGIN");
+        poSession->bInTransaction = TRUE;
+    }
+
+    return eErr;
+}
+
+/************************************************************************/
+/*                     SoftCommitTransaction()                          */
+/*                                                                      */
+/*      Commit the current transaction if we are at the outer           */
+/*      scope.                                                          */
+/************************************************************************/
+
+OGRErr OGRDAMENGDataSource::SoftCommitTransaction()
+
+{
+    if (nSoftTransactionLevel <= 0)
+    {
+        CPLAssert(false);
+        return OGRERR_FAILURE;
+    }
+
+    OGRErr eErr = OGRERR_NONE;
+    nSoftTransactionLevel--;
+    if (nSoftTransactionLevel == 0)
+    {
+        CPLAssert(!bSavePointActive);
+
+        eErr = DoTransactionCommand("COMMIT");
+    }
+
+    return eErr;
+}
+
+/************************************************************************/
+/*                  SoftRollbackTransaction()                           */
+/*                                                                      */
+/*      Do a rollback of the current transaction if we are at the 1st   */
+/*      level                                                           */
+/************************************************************************/
+
+OGRErr OGRDAMENGDataSource::SoftRollbackTransaction()
+
+{
+    if (nSoftTransactionLevel <= 0)
+    {
+        CPLAssert(false);
+        return OGRERR_FAILURE;
+    }
+
+    OGRErr eErr = OGRERR_NONE;
+    nSoftTransactionLevel--;
+    if (nSoftTransactionLevel == 0)
+    {
+        CPLAssert(!bSavePointActive);
+
+        InvalidateLayerStatistics();
+        eErr = DoTransactionCommand("ROLLBACK");
+    }
+
+    return eErr;
+}
+
+/************************************************************************/
+/*                        FlushSoftTransaction()                        */
+/*                                                                      */
+/*      Force the unwinding of any active transaction, and its          */
+/*      commit. Should only be used by datasource destructor            */
+/************************************************************************/
+
+OGRErr OGRDAMENGDataSource::FlushSoftTransaction()
+
+{
+    if (nSoftTransactionLevel <= 0)
+        return OGRERR_NONE;
+
+    bSavePointActive = FALSE;
+    bUserTransactionActive = FALSE;
+
+    nSoftTransactionLevel = 0;
+    return DoTransactionCommand("COMMIT");
+}
+
+/************************************************************************/
+/*                        DoTransactionCommand()                        */
+/*                                                                      */
+/*      Autocommit is off on DaMeng connections, so a transaction is    */
+/*      always implicitly open: BEGIN only marks the start of the       */
+/*      scope, COMMIT and ROLLBACK map to the DPI calls, and the        */
+/*      savepoint commands are sent as SQL.                             */
+/************************************************************************/
+
+OGRErr OGRDAMENGDataSource::DoTransactionCommand(const char *pszCommand)
+
+{
+    OGRErr eErr = OGRERR_NONE;
+    DPIRETURN rt = DSQL_SUCCESS;
+
+    osDebugLastTransactionCommand = pszCommand;
+
+    if (EQUAL(pszCommand, "BEGIN"))
+    {
+        return OGRERR_NONE;
+    }
+    else if (EQUAL(pszCommand, "COMMIT"))
+    {
+        OGRDAMENGStatsTimer oTimer(&m_oStats, OGRDAMENGStats::COMMIT);
+        rt = dpi_commit(poSession->hCon);
+        poSession->bInTransaction = FALSE;
+    }
+    else if (EQUAL(pszCommand, "ROLLBACK"))
+    {
+        rt = dpi_rollback(poSession->hCon);
+        poSession->bInTransaction = FALSE;
+    }
+    else if (EQUAL(pszCommand, "RELEASE SAVEPOINT ogr_savepoint"))
+    {
+        // DaMeng has no RELEASE SAVEPOINT: the savepoint is simply
+        // dropped at the end of the enclosing transaction.
+        return OGRERR_NONE;
+    }
+    else
+    {
+        OGRDAMENGStatement oCommand(poSession);
+        if (oCommand.Execute(pszCommand) != CE_None)
+            eErr = OGRERR_FAILURE;
+    }
+
+    if (!DSQL_SUCCEEDED(rt))
+        eErr = OGRERR_FAILURE;
+    if (eErr != OGRERR_NONE)
+    {
+        CPLError(CE_Failure, CPLE_AppDefined, "%s failed", pszCommand);
+    }
+
+    return eErr;
+}
+
+/************************************************************************/
+/*                          AcquireScanConn()                           */
+/*                                                                      */
+/*      Return a session for a parallel scan worker, opening a new one  */
+/*      with the credentials of the main session if none is idle.       */
+/************************************************************************/
+
+OGRDAMENGConn *OGRDAMENGDataSource::AcquireScanConn()
+
+{
+    if (!m_apoIdleScanConns.empty())
+    {
+        OGRDAMENGConn *poConn = m_apoIdleScanConns.back().release();
+        m_apoIdleScanConns.pop_back();
+        poConn->poStats = &m_oStats;
+        return poConn;
+    }
+
+    OGRDAMENGConn *poConn =
+        OGRGetDAMENGConnection(poSession->pszUserid, poSession->pszPassword,
+                               poSession->pszDatabase, osCurrentSchema);
+    if (poConn == nullptr)
+    {
+        CPLDebug("DAMENG", "Cannot open another session for a parallel scan");
+        return nullptr;
+    }
+    // The workers share the fetch memory budget of the datasource.
+    poConn->nFetchMemory =
+        std::max(poSession->nFetchMemory / std::max(1, nParallelScan),
+                 (size_t)1024 * 1024);
+    poConn->nLobChunkSize = poSession->nLobChunkSize;
+    poConn->poStats = &m_oStats;
+    return poConn;
+}
+
+/************************************************************************/
+/*                          ReleaseScanConn()                           */
+/************************************************************************/
+
+void OGRDAMENGDataSource::ReleaseScanConn(OGRDAMENGConn *poConn)
+
+{
+    m_apoIdleScanConns.emplace_back(poConn);
+}
+
+/************************************************************************/
+/*                     InvalidateLayerStatistics()                      */
+/*                                                                      */
+/*      Forget the counts and extents cached by the layers, after a     */
+/*      rollback or a statement that may have changed any table.        */
+/************************************************************************/
+
+void OGRDAMENGDataSource::InvalidateLayerStatistics()
+
+{
+    for (int i = 0; i < nLayers; i++)
+        papoLayers[i]->InvalidateStatistics();
+}
+
 /************************************************************************/
 /*                              GetLayer()                              */
 /************************************************************************/
@@ -1051,6 +1475,33 @@ OGRLayer *OGRDAMENGDataSource::GetLayerByName(const char *pszNameIn)
     return poLayer;
 }
 
+/************************************************************************/
+/*                        OGRDAMENGSRSFromRow()                         */
+/*                                                                      */
+/*      Build the SRS of a spatial_ref_sys row.                         */
+/************************************************************************/
+
+static OGRSpatialReference *OGRDAMENGSRSFromRow(int nId, const char *pszWKT,
+                                                const char *pszAuthName,
+                                                int nAuthSRID)
+{
+    OGRSpatialReference *poSRS = new OGRSpatialReference();
+    poSRS->SetAxisMappingStrategy(OAMS_TRADITIONAL_GIS_ORDER);
+
+    // Try to import first from EPSG code, and then from WKT
+    if (pszAuthName && EQUAL(pszAuthName, "EPSG") && nAuthSRID == nId &&
+        poSRS->importFromEPSG(nId) == OGRERR_NONE)
+    {
+        // do nothing
+    }
+    else if (pszWKT == nullptr || poSRS->importFromWkt(pszWKT) != OGRERR_NONE)
+    {
+        delete poSRS;
+        poSRS = nullptr;
+    }
+    return poSRS;
+}
+
 /************************************************************************/
 /*                              FetchSRS()                              */
 /*                                                                      */
@@ -1075,50 +1526,45 @@ OGRSpatialReference *OGRDAMENGDataSource::FetchSRS(int nId)
     }
 
     /* -------------------------------------------------------------------- */
-    /*      Try looking up in spatial_ref_sys table.                        */
+    /*      Try the rows loaded with the catalog, and then looking up in    */
+    /*      spatial_ref_sys table.                                          */
     /* -------------------------------------------------------------------- */
     CPLString osCommand;
     OGRSpatialReference *poSRS = nullptr;
 
-    OGRDAMENGStatement oCommand(poSession);
-    osCommand.Printf(
-        "SELECT srtext, auth_name, auth_srid FROM sysgeo2.spatial_ref_sys "
-        "WHERE srid = %d",
-        nId);
-    CPLErr rt = oCommand.Execute(osCommand.c_str());
-
-    if (rt == CE_None)
+    const auto oCatalogSRS = m_oCatalogSRS.find(nId);
+    if (oCatalogSRS != m_oCatalogSRS.end())
     {
-        char **result = oCommand.SimpleFetchRow();
-        if (result == nullptr)
-        {
-            CPLError(CE_Failure, CPLE_AppDefined, "Could not fetch SRS");
-        }
-        else
+        poSRS = OGRDAMENGSRSFromRow(nId, oCatalogSRS->second.osWKT.c_str(),
+                                    oCatalogSRS->second.osAuthName.c_str(),
+                                    oCatalogSRS->second.nAuthSRID);
+    }
+    else
+    {
+        OGRDAMENGStatement oCommand(poSession);
+        osCommand.Printf(
+            "SELECT srtext, auth_name, auth_srid FROM sysgeo2.spatial_ref_sys "
+            "WHERE srid = %d",
+            nId);
+        CPLErr rt = oCommand.Execute(osCommand.c_str());
+
+        if (rt == CE_None)
         {
-            const char *pszWKT = result[0];
-            const char *pszAuthName = result[1];
-            const char *pszAuthSRID = result[2];
-            poSRS = new OGRSpatialReference();
-            poSRS->SetAxisMappingStrategy(OAMS_TRADITIONAL_GIS_ORDER);
-
-            // Try to import first from EPSG code, and then from WKT
-            if (pszAuthName && pszAuthSRID && EQUAL(pszAuthName, "EPSG") &&
-                atoi(pszAuthSRID) == nId &&
-                poSRS->importFromEPSG(nId) == OGRERR_NONE)
+            char **result = oCommand.SimpleFetchRow();
+            if (result == nullptr)
             {
-                // do nothing
+                CPLError(CE_Failure, CPLE_AppDefined, "Could not fetch SRS");
             }
-            else if (poSRS->importFromWkt(pszWKT) != OGRERR_NONE)
+            else
             {
-                delete poSRS;
-                poSRS = nullptr;
+                poSRS = OGRDAMENGSRSFromRow(nId, result[0], result[1],
+                                            result[2] ? atoi(result[2]) : 0);
             }
         }
-    }
-    else
-    {
-        CPLError(CE_Failure, CPLE_AppDefined, "Could not fetch SRS!");
+        else
+        {
+            CPLError(CE_Failure, CPLE_AppDefined, "Could not fetch SRS!");
+        }
     }
 
     if (poSRS)
@@ -1189,6 +1635,13 @@ int OGRDAMENGDataSource::FetchSRSId(const OGRSpatialReference *poSRS)
     {
         /* Check that the authority code is integral */
         nAuthorityCode = atoi(oSRS.GetAuthorityCode(nullptr));
+        for (const auto &oCatalogSRS : m_oCatalogSRS)
+        {
+            if (nAuthorityCode > 0 &&
+                oCatalogSRS.second.nAuthSRID == nAuthorityCode &&
+                EQUAL(oCatalogSRS.second.osAuthName.c_str(), pszAuthorityName))
+                return oCatalogSRS.first;
+        }
         if (nAuthorityCode > 0)
         {
             osCommand.Printf("SELECT srid FROM sysgeo2.spatial_ref_sys WHERE "
@@ -1253,6 +1706,8 @@ int OGRDAMENGDataSource::FetchSRSId(const OGRSpatialReference *poSRS)
     /*      Get the current maximum srid in the srs table.                  */
     /* -------------------------------------------------------------------- */
 
+    SoftStartTransaction();
+
     osCommand.Printf("SELECT MAX(srid) FROM sysgeo2.spatial_ref_sys");
     rt = oCommand.Execute(osCommand.c_str());
     int nSRSId = 1;
@@ -1271,6 +1726,8 @@ int OGRDAMENGDataSource::FetchSRSId(const OGRSpatialReference *poSRS)
     if (oSRS.exportToProj4(&pszProj4) != OGRERR_NONE)
     {
         CPLFree(pszProj4);
+        CPLFree(pszWKT);
+        SoftRollbackTransaction();
         return nUndefinedSRID;
     }
 
@@ -1297,6 +1754,14 @@ int OGRDAMENGDataSource::FetchSRSId(const OGRSpatialReference *poSRS)
     pszWKT = nullptr;  // CM:  Added
 
     rt = oCommand.Execute(osCommand.c_str());
+    if (rt != CE_None)
+    {
+        SoftRollbackTransaction();
+        return nUndefinedSRID;
+    }
+
+    if (SoftCommitTransaction() != OGRERR_NONE)
+        return nUndefinedSRID;
 
     return nSRSId;
 }
@@ -1314,10 +1779,57 @@ const char *OGRDAMENGDataSource::GetMetadataItem(const char *pszKey,
     {
         if (EQUAL(pszKey, "bHasLoadTables"))
             return CPLSPrintf("%d", bHasLoadTables);
+        if (EQUAL(pszKey, "nSoftTransactionLevel"))
+            return CPLSPrintf("%d", nSoftTransactionLevel);
+        if (EQUAL(pszKey, "bSavePointActive"))
+            return CPLSPrintf("%d", bSavePointActive);
+        if (EQUAL(pszKey, "bUserTransactionActive"))
+            return CPLSPrintf("%d", bUserTransactionActive);
+        if (EQUAL(pszKey, "osDebugLastTransactionCommand"))
+        {
+            const char *pszRet =
+                CPLSPrintf("%s", osDebugLastTransactionCommand.c_str());
+            osDebugLastTransactionCommand = "";
+            return pszRet;
+        }
+    }
+    if (pszDomain != nullptr && EQUAL(pszDomain, "DAMENG_STATS") &&
+        pszKey != nullptr)
+    {
+        return CSLFetchNameValue(GetMetadata(pszDomain), pszKey);
     }
     return OGRDataSource::GetMetadataItem(pszKey, pszDomain);
 }
 
+/************************************************************************/
+/*                            GetMetadata()                             */
+/*                                                                      */
+/*      The DAMENG_STATS domain reports the calls made to the server    */
+/*      by the datasource and its layers so far.                        */
+/************************************************************************/
+
+CSLConstList OGRDAMENGDataSource::GetMetadata(const char *pszDomain)
+
+{
+    if (pszDomain != nullptr && EQUAL(pszDomain, "DAMENG_STATS"))
+    {
+        m_aosStatsMD.Assign(m_oStats.GetMetadata(), true);
+        return m_aosStatsMD.List();
+    }
+    return OGRDataSource::GetMetadata(pszDomain);
+}
+
+/************************************************************************/
+/*                       GetMetadataDomainList()                        */
+/************************************************************************/
+
+char **OGRDAMENGDataSource::GetMetadataDomainList()
+
+{
+    return BuildMetadataDomainList(OGRDataSource::GetMetadataDomainList(),
+                                   TRUE, "DAMENG_STATS", nullptr);
+}
+
 /************************************************************************/
 /*                             ExecuteSQL()                             */
 /************************************************************************/
@@ -1372,6 +1884,10 @@ OGRLayer *OGRDAMENGDataSource::ExecuteSQL(const char *pszSQLCommand,
         /* For something that is not a select or a select without table, do not */
         /* run under transaction (CREATE DATABASE, VACUUM don't like transactions) */
         CPLErr rt = oCommand.Execute(pszSQLCommand);
+
+        /* The statement may have changed tables not read yet */
+        m_oCatalog.clear();
+        InvalidateLayerStatistics();
         if (rt == CE_None)
         {
             OGRDAMENGResultLayer *poLayer =
@@ -90,6 +90,16 @@ static GDALDataset *OGRDAMENGDriverCreate(const char *pszName,
     return poDS;
 }
 
+/************************************************************************/
+/*                         OGRDAMENGDriverUnload()                      */
+/************************************************************************/
+
+static void OGRDAMENGDriverUnload(CPL_UNUSED GDALDriver *poDriver)
+
+{
+    OGRDAMENGClearConnectionPool();
+}
+
 /************************************************************************/
 /*                           RegisterOGRDAMENG()                            */
 /************************************************************************/
@@ -127,8 +137,27 @@ void RegisterOGRDAMENG()
         "  <Option name='PASSWORD' type='string' description='Password'/>"
         "  <Option name='TABLES' type='string' description='Restricted set of "
         "tables to list (comma separated)'/>"
-        "  <Option name='INSERTNUM' type='boolean' description='Whether all "
-        "tables, including non-spatial ones, should be listed' default='NO'/>"
+        "  <Option name='INSERTNUM' type='int' description='Default number "
+        "of rows sent per batched INSERT' default='1000'/>"
+        "  <Option name='FETCH_MEMORY' type='int' description='Memory budget "
+        "in MB of the row arrays of a query, and of the buffers kept for "
+        "reuse' default='64'/>"
+        "  <Option name='LOB_CHUNK_SIZE' type='int' description='Size in KB "
+        "above which LOB values are read piecewise, and inserted geometries "
+        "are sent on their own' default='1024'/>"
+        "  <Option name='PARALLEL_SCAN' type='string' description='Number "
+        "of sessions reading a table at once, or ALL_CPUS. Requires a FID "
+        "column' default='1'/>"
+        "  <Option name='PARALLEL_SCAN_ORDERED' type='boolean' "
+        "description='Whether a parallel scan returns features in FID "
+        "order' default='YES'/>"
+        "  <Option name='PREFETCH' type='boolean' description='Whether "
+        "the next block of rows of a layer is fetched in the background, "
+        "on a session of its own, while the current one is read' "
+        "default='NO'/>"
+        "  <Option name='CATALOG_CACHE' type='string' description='File "
+        "where the catalog of the tables is cached from one opening to the "
+        "next, until a DDL statement runs'/>"
         "</OpenOptionList>");
 
     poDriver->SetMetadataItem(GDAL_DMD_CREATIONOPTIONLIST,
@@ -161,6 +190,16 @@ void RegisterOGRDAMENG()
         "default='NO'/>"
         "  <Option name='DESCRIPTION' type='string' description='Description "
         "string to put in the all_tab_comments system table'/>"
+        "  <Option name='BATCH_SIZE' type='int' description='Number of rows "
+        "sent per INSERT execution' default='1000'/>"
+        "  <Option name='COMMIT_INTERVAL' type='int' description='Number of "
+        "rows between commits (0 to only commit when the layer is flushed). "
+        "Defaults to BATCH_SIZE'/>"
+        "  <Option name='SPATIAL_INDEX' type='boolean' description='Whether "
+        "to create a spatial index on geometry columns' default='NO'/>"
+        "  <Option name='DEFERRED_INDEX' type='boolean' description='Whether "
+        "to add the geometry checks and the spatial index only when the "
+        "layer is flushed or closed, after a bulk load' default='NO'/>"
         "</LayerCreationOptionList>");
 
     poDriver->SetMetadataItem(GDAL_DMD_CREATIONFIELDDATATYPES,
@@ -177,6 +216,7 @@ void RegisterOGRDAMENG()
     poDriver->SetMetadataItem(GDAL_DCAP_CREATE, "YES");
     poDriver->pfnOpen = OGRDAMENGDriverOpen;
     poDriver->pfnCreate = OGRDAMENGDriverCreate;
+    poDriver->pfnUnloadDriver = OGRDAMENGDriverUnload;
 
     GetGDALDriverManager()->RegisterDriver(poDriver);
 }
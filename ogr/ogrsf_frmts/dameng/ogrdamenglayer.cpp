@@ -29,6 +29,13 @@
 #include "ogr_dameng.h"
 #include "cpl_conv.h"
 #include "ogr_p.h"
+#include "ograrrowarrayhelper.h"
+#include "ogrlayerarrow.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <limits>
+#include <vector>
 
 
 /************************************************************************/
@@ -58,6 +65,11 @@ OGRDAMENGLayer::~OGRDAMENGLayer()
         CPLDebug("DAMENG", "%lld features read on layer '%s'.", m_nFeaturesRead,
                  poFeatureDefn->GetName());
     }
+    if (!m_oStats.IsEmpty() && poFeatureDefn != nullptr)
+    {
+        CPLDebug("DAMENG", "Layer '%s': %s", poFeatureDefn->GetName(),
+                 m_oStats.GetSummary().c_str());
+    }
     OGRDAMENGLayer::ResetReading();
 
     CPLFree(pszFIDColumn);
@@ -65,6 +77,8 @@ OGRDAMENGLayer::~OGRDAMENGLayer()
 
     if (poStatement != nullptr)
         delete poStatement;
+    if (m_poPrefetchConn != nullptr)
+        poDS->ReleaseScanConn(m_poPrefetchConn);
 
     if (poFeatureDefn != nullptr)
         poFeatureDefn->Release();
@@ -84,7 +98,119 @@ void OGRDAMENGLayer::ResetReading()
 {
     GetLayerDefn();
 
+    m_poParallelScan.reset();
+    // Do not leave a block being fetched in the background.
+    if (poStatement != nullptr)
+        poStatement->CancelPrefetch();
     iNextShapeId = 0;
+    m_bPagedByFID = false;
+}
+
+/************************************************************************/
+/*                     OGRDAMENGValueAsInteger64()                      */
+/*                                                                      */
+/*      Helpers reading a fetched value according to the C type its     */
+/*      column was bound with (see Excute_for_fetchmany()).             */
+/************************************************************************/
+
+static GIntBig OGRDAMENGValueAsInteger64(sdint2 nCType, const char *pabyData)
+{
+    switch (nCType)
+    {
+        case DSQL_C_SLONG:
+            return *(const sdint4 *)pabyData;
+        case DSQL_C_SBIGINT:
+            return *(const sdint8 *)pabyData;
+        case DSQL_C_DOUBLE:
+            return (GIntBig)*(const double *)pabyData;
+        default:
+            return CPLAtoGIntBig(pabyData);
+    }
+}
+
+/************************************************************************/
+/*                       OGRDAMENGValueAsDouble()                       */
+/************************************************************************/
+
+static double OGRDAMENGValueAsDouble(sdint2 nCType, const char *pabyData)
+{
+    switch (nCType)
+    {
+        case DSQL_C_SLONG:
+            return *(const sdint4 *)pabyData;
+        case DSQL_C_SBIGINT:
+            return (double)*(const sdint8 *)pabyData;
+        case DSQL_C_DOUBLE:
+            return *(const double *)pabyData;
+        default:
+            return CPLStrtod(pabyData, nullptr);
+    }
+}
+
+/************************************************************************/
+/*                      OGRDAMENGValueAsDateTime()                      */
+/************************************************************************/
+
+static bool OGRDAMENGValueAsDateTime(sdint2 nCType, const char *pabyData,
+                                     OGRField *psField)
+{
+    if (nCType == DSQL_C_TIMESTAMP)
+    {
+        const dpi_timestamp_t *psTS = (const dpi_timestamp_t *)pabyData;
+        psField->Date.Year = (GInt16)psTS->year;
+        psField->Date.Month = (GByte)psTS->month;
+        psField->Date.Day = (GByte)psTS->day;
+        psField->Date.Hour = (GByte)psTS->hour;
+        psField->Date.Minute = (GByte)psTS->minute;
+        psField->Date.Second = psTS->second + psTS->fraction * 1e-9f;
+        psField->Date.TZFlag = 0;
+        psField->Date.Reserved = 0;
+        return true;
+    }
+    if (nCType == DSQL_C_NCHAR)
+        return OGRParseDate(pabyData, psField, 0) == TRUE;
+    return false;
+}
+
+/************************************************************************/
+/*                       OGRDAMENGValueAsBinary()                       */
+/*                                                                      */
+/*      Bytes of a binary value: those read from a LOB, whose length    */
+/*      is nLength, or the hexadecimal image of BINARY and VARBINARY    */
+/*      values, decoded into abyBuffer.                                 */
+/************************************************************************/
+
+static const GByte *OGRDAMENGValueAsBinary(sdint2 nCType, const char *pabyData,
+                                           int nLength,
+                                           std::vector<GByte> &abyBuffer,
+                                           size_t *pnSize)
+{
+    if (nCType != DSQL_C_NCHAR)
+    {
+        *pnSize = nLength > 0 ? static_cast<size_t>(nLength)
+                              : strlen(pabyData);
+        return reinterpret_cast<const GByte *>(pabyData);
+    }
+
+    if (pabyData[0] == '0' && (pabyData[1] == 'x' || pabyData[1] == 'X'))
+        pabyData += 2;
+    const auto HexValue = [](char ch)
+    {
+        if (ch >= '0' && ch <= '9')
+            return ch - '0';
+        if (ch >= 'a' && ch <= 'f')
+            return ch - 'a' + 10;
+        if (ch >= 'A' && ch <= 'F')
+            return ch - 'A' + 10;
+        return 0;
+    };
+    const size_t nHexLength = strlen(pabyData);
+    abyBuffer.resize(nHexLength / 2);
+    for (size_t i = 0; i < abyBuffer.size(); i++)
+        abyBuffer[i] = static_cast<GByte>(HexValue(pabyData[2 * i]) * 16 +
+                                          HexValue(pabyData[2 * i + 1]));
+    *pnSize = abyBuffer.size();
+    return abyBuffer.data();
 }
 
 /************************************************************************/
@@ -99,39 +225,52 @@ OGRFeature *OGRDAMENGLayer::RecordToFeature(OGRDAMENGStatement *hStmt,
                                         const int *panMapFieldNameToGeomIndex,
                                         int iRecord)
 {
+    m_nFeaturesRead++;
+    return DecodeRecord(hStmt, result, panMapFieldNameToIndex,
+                        panMapFieldNameToGeomIndex, iRecord, iNextShapeId);
+}
+
+/************************************************************************/
+/*                            DecodeRecord()                            */
+/*                                                                      */
+/*      Build a feature from one row of a block returned by             */
+/*      Fetchmany(). It does not touch the reading state of the layer,  */
+/*      so that the parallel scan can call it from its workers.         */
+/************************************************************************/
+
+OGRFeature *OGRDAMENGLayer::DecodeRecord(OGRDAMENGStatement *hStmt,
+                                         char ***papapszRows,
+                                         const int *panMapFieldNameToIndex,
+                                         const int *panMapFieldNameToGeomIndex,
+                                         int iRecord, GIntBig nFID) const
+{
+    OGRDAMENGStatsTimer oTimer(&m_oStats, OGRDAMENGStats::DECODE);
     OGRFeature *poFeature = new OGRFeature(poFeatureDefn);
-    sdint2 rs_deci = 0;
-    ulength rs_size = 0;
-    sdint2 rs_null = 0;
-    sdint2 rs_type = 0;
-    sdint2 rs_name_len = 0;
-    sdint2 name_max = 200;
-    DPIRETURN rt;
 
-    poFeature->SetFID(iNextShapeId);
-    m_nFeaturesRead++;
+    poFeature->SetFID(nFID);
     /* -------------------------------------------------------------------- */
     /*      Handle FID.                                                     */
     /* -------------------------------------------------------------------- */
 
     for (int iField = 0; iField < hStmt->GetColCount(); iField++)
     {
-        sdbyte pszFieldName[200];
-        rt = dpi_desc_column(*hStmt->GetStatement(), (sdint2)iField + 1,
-                             pszFieldName, name_max, &rs_name_len, &rs_type,
-                             &rs_size, &rs_deci, &rs_null);
-        if (!DSQL_SUCCEEDED(rt))
+        const DmColDesc *psColDesc = hStmt->GetColDesc(iField);
+        if (psColDesc == nullptr)
         {
             CPLError(CE_Failure, CPLE_AppDefined,
-                     "Error!");
+                     "DAMENG: layer %s: cannot get the description of "
+                     "column %d of the result set",
+                     poFeatureDefn->GetName(), iField);
+            delete poFeature;
             return NULL;
         }
-        char *pabyData = result[iField][iRecord];
-        if (pszFIDColumn != nullptr &&
-            EQUAL((const char *)pszFieldName, pszFIDColumn))
+        const char *pszFieldName = (const char *)psColDesc->name;
+        const sdint2 nCType = hStmt->GetColCType(iField);
+        char *pabyData = papapszRows[iField][iRecord];
+        if (pszFIDColumn != nullptr && EQUAL(pszFieldName, pszFIDColumn))
         {
             if (pabyData)
-                poFeature->SetFID(CPLAtoGIntBig(pabyData));
+                poFeature->SetFID(OGRDAMENGValueAsInteger64(nCType, pabyData));
             else
                 continue;
         }
@@ -151,22 +290,19 @@ OGRFeature *OGRDAMENGLayer::RecordToFeature(OGRDAMENGStatement *hStmt,
             (poGeomFieldDefn->eDAMENGGeoType == GEOM_TYPE_GEOMETRY ||
              poGeomFieldDefn->eDAMENGGeoType == GEOM_TYPE_GEOGRAPHY))
         {
-            if (STARTS_WITH_CI((const char *)pszFieldName,
-                               "DMGEO2.ST_AsBinary"))
+            if (STARTS_WITH_CI(pszFieldName, "DMGEO2.ST_AsBinary"))
             {
                 CPLError(CE_Failure, CPLE_AppDefined,
                          "We cannot handle binary type!");
                 return NULL;
             }
-            else if (STARTS_WITH_CI((const char *)pszFieldName,
-                                    "DMGEO2.ST_AsEWKB"))
+            else if (STARTS_WITH_CI(pszFieldName, "DMGEO2.ST_AsEWKB"))
             {
                 CPLError(CE_Failure, CPLE_AppDefined,
                          "We cannot handle binary type!");
                 return NULL;
             }
-            else if (STARTS_WITH_CI((const char *)pszFieldName,
-                                    "DMGEO2.ST_ASTEXT"))
+            else if (STARTS_WITH_CI(pszFieldName, "DMGEO2.ST_ASTEXT"))
             {
                 /* Handle WKT */
                 const char *pszWKT = pabyData;
@@ -195,26 +331,25 @@ OGRFeature *OGRDAMENGLayer::RecordToFeature(OGRDAMENGStatement *hStmt,
                     poGeomFieldDefn->eDAMENGGeoType == GEOM_TYPE_GEOGRAPHY)
                 {
                     OGRGeometry *poGeometry = nullptr;
-                    pabyData = result[iField][iRecord];
+                    pabyData = papapszRows[iField][iRecord];
                     if (pabyData)
                     {
-                        int length;
-                        GByte *pabyEWKB = OGRDAMENGGeoToHexwkb((GSERIALIZED *)pabyData, &length);
-                        if (!pabyEWKB)
+                        const int nSize = hStmt->GetValueLength(
+                            papapszRows, iField, iRecord);
+                        if (nSize > 0)
+                            poGeometry = OGRDAMENGGeometryFromGser(
+                                (const GSERIALIZED *)pabyData, nSize);
+                        if (poGeometry == nullptr)
                         {
                             CPLError(CE_Failure, CPLE_AppDefined,
                                 "DAMENG:Invalid Input Geometry Data!");
+                            delete poFeature;
                             return NULL;
                         }
-                        poGeometry = OGRGeometryFromEWKB(pabyEWKB, length, nullptr, false);
-                        CPLFree(pabyEWKB);
-                        if (poGeometry != nullptr)
-                        {
-                            poGeometry->assignSpatialReference(
-                                poGeomFieldDefn->GetSpatialRef());
-                            poFeature->SetGeomFieldDirectly(iOGRGeomField,
-                                                            poGeometry);
-                        }
+                        poGeometry->assignSpatialReference(
+                            poGeomFieldDefn->GetSpatialRef());
+                        poFeature->SetGeomFieldDirectly(iOGRGeomField,
+                                                        poGeometry);
                         continue;
                     }
                     else
@@ -233,14 +368,52 @@ OGRFeature *OGRDAMENGLayer::RecordToFeature(OGRDAMENGStatement *hStmt,
 
         if (iOGRField < 0)
             continue;
-        pabyData = result[iField][iRecord];
-        if (!pabyData || strlen(pabyData) == 0)
+        pabyData = papapszRows[iField][iRecord];
+        if (!pabyData || (nCType == DSQL_C_NCHAR && pabyData[0] == '\0'))
         {
             poFeature->SetFieldNull(iOGRField);
             continue;
         }
-        poFeature->SetField(iOGRField, pabyData);
+        if (poFeatureDefn->GetFieldDefnUnsafe(iOGRField)->GetType() ==
+            OFTBinary)
+        {
+            std::vector<GByte> abyBuffer;
+            size_t nSize = 0;
+            const GByte *pabyBytes = OGRDAMENGValueAsBinary(
+                nCType, pabyData,
+                hStmt->GetValueLength(papapszRows, iField, iRecord),
+                abyBuffer, &nSize);
+            poFeature->SetField(iOGRField, static_cast<int>(nSize),
+                                pabyBytes);
+            continue;
+        }
+        switch (nCType)
+        {
+            case DSQL_C_SLONG:
+                poFeature->SetField(iOGRField, *(const sdint4 *)pabyData);
+                break;
+            case DSQL_C_SBIGINT:
+                poFeature->SetField(iOGRField,
+                                    (GIntBig) * (const sdint8 *)pabyData);
+                break;
+            case DSQL_C_DOUBLE:
+                poFeature->SetField(iOGRField, *(const double *)pabyData);
+                break;
+            case DSQL_C_TIMESTAMP:
+            {
+                const dpi_timestamp_t *psTS =
+                    (const dpi_timestamp_t *)pabyData;
+                poFeature->SetField(iOGRField, psTS->year, psTS->month,
+                                    psTS->day, psTS->hour, psTS->minute,
+                                    psTS->second + psTS->fraction * 1e-9f);
+                break;
+            }
+            default:
+                poFeature->SetField(iOGRField, pabyData);
+                break;
+        }
     }
+    oTimer.Stop(1);
     return poFeature;
 }
 
@@ -329,19 +502,91 @@ void OGRDAMENGLayer::CreateMapFromFieldNameToIndex(OGRDAMENGStatement *hStmt,
     }
 }
 
+/************************************************************************/
+/*                       BuildSpatialPredicate()                        */
+/*                                                                      */
+/*      Build a predicate keeping the rows whose geometry intersects    */
+/*      the envelope of the spatial filter, and set m_adfQueryParams    */
+/*      to the envelope bound to it. DMGEO2.ST_Intersects() compares    */
+/*      the bounding boxes first, through the spatial index when there  */
+/*      is one. A filter geometry that is not a rectangle must still    */
+/*      be refined with FilterGeometry() on the fetched features.       */
+/************************************************************************/
+
+CPLString
+OGRDAMENGLayer::BuildSpatialPredicate(OGRDAMENGGeomFieldDefn *poGeomFieldDefn)
+{
+    OGREnvelope sEnvelope;
+    constexpr double NEG_INF = -std::numeric_limits<double>::infinity();
+    constexpr double POS_INF = std::numeric_limits<double>::infinity();
+
+    m_poFilterGeom->getEnvelope(&sEnvelope);
+    if (poGeomFieldDefn->eDAMENGGeoType == GEOM_TYPE_GEOGRAPHY)
+    {
+        if (sEnvelope.MinX < -180.0)
+            sEnvelope.MinX = -180.0;
+        if (sEnvelope.MinY < -90.0)
+            sEnvelope.MinY = -90.0;
+        if (sEnvelope.MaxX > 180.0)
+            sEnvelope.MaxX = 180.0;
+        if (sEnvelope.MaxY > 90.0)
+            sEnvelope.MaxY = 90.0;
+    }
+    if (sEnvelope.MinX == NEG_INF)
+    {
+        sEnvelope.MinX = -DBL_MAX;
+        sEnvelope.MinY = -DBL_MAX;
+    }
+    if (sEnvelope.MaxX == POS_INF)
+    {
+        sEnvelope.MaxX = DBL_MAX;
+        sEnvelope.MaxY = DBL_MAX;
+    }
+    if (poGeomFieldDefn->nSRSId < 0)
+        poGeomFieldDefn->nSRSId = 0;
+
+    m_adfQueryParams = {sEnvelope.MinX, sEnvelope.MinY, sEnvelope.MaxX,
+                        sEnvelope.MaxY};
+
+    CPLString osPredicate;
+    osPredicate.Printf(
+        "DMGEO2.ST_Intersects(%s, DMGEO2.ST_MakeEnvelope(?, ?, ?, ?, %d))",
+        OGRDAMENGEscapeColumnName(poGeomFieldDefn->GetNameRef()).c_str(),
+        poGeomFieldDefn->nSRSId);
+    return osPredicate;
+}
+
 /************************************************************************/
 /*                     SetInitialQuery()                          */
 /************************************************************************/
 
-void OGRDAMENGLayer::SetInitialQuery()
+void OGRDAMENGLayer::SetInitialQuery(const char *pszSQL)
 {
-    OGRDAMENGConn *hDAMENGConn = poDS->GetDAMENGConn();
+    // A prefetching statement runs on a session of its own, which the
+    // background fetches never share with the caller. Other sessions do
+    // not see the changes of the current transaction though.
+    const bool bPrefetch = poDS->IsPrefetchEnabled() &&
+                           !poDS->GetDAMENGConn()->bInTransaction;
+    if (poStatement != nullptr && !bPrefetch && m_poPrefetchConn != nullptr)
+    {
+        delete poStatement;
+        poStatement = nullptr;
+        poDS->ReleaseScanConn(m_poPrefetchConn);
+        m_poPrefetchConn = nullptr;
+    }
+    if (poStatement == nullptr && bPrefetch)
+        m_poPrefetchConn = poDS->AcquireScanConn();
     if (poStatement == NULL)
-        poStatement = new OGRDAMENGStatement(hDAMENGConn);
+    {
+        poStatement = new OGRDAMENGStatement(
+            m_poPrefetchConn ? m_poPrefetchConn : poDS->GetDAMENGConn());
+        poStatement->SetStats(&m_oStats);
+    }
     CPLString osCommand;
 
     CPLAssert(pszQueryStatement != nullptr);
-    osCommand.Printf("%s", pszQueryStatement);
+    osCommand.Printf("%s", pszSQL ? pszSQL : pszQueryStatement);
+    poStatement->SetDoubleParams(m_adfQueryParams);
     CPLErr rt = poStatement->Excute_for_fetchmany(osCommand.c_str());
 
     if (!DSQL_SUCCEEDED(rt))
@@ -349,6 +594,12 @@ void OGRDAMENGLayer::SetInitialQuery()
         CPLError(CE_Failure, CPLE_AppDefined,
                  "DAMENG:Execute command failure!");
     }
+    else if (m_poPrefetchConn != nullptr &&
+             poStatement->EnablePrefetch() != CE_None)
+    {
+        CPLDebug("DAMENG", "Cannot prefetch the rows of %s.",
+                 poFeatureDefn->GetName());
+    }
 
     CreateMapFromFieldNameToIndex(poStatement, poFeatureDefn,
                                   m_panMapFieldNameToIndex,
@@ -358,108 +609,544 @@ void OGRDAMENGLayer::SetInitialQuery()
 }
 
 /************************************************************************/
-/*                         GetNextRawFeature()                          */
+/*                          FetchNextRecord()                           */
+/*                                                                      */
+/*      Advance to the next record of the result set, running the       */
+/*      query and fetching the next block of rows as needed. Returns    */
+/*      the index of the record in the current block, or -1 once the    */
+/*      result set is exhausted.                                        */
 /************************************************************************/
 
-OGRFeature *OGRDAMENGLayer::GetNextRawFeature()
+int OGRDAMENGLayer::FetchNextRecord()
 
 {
-    OGRFeature *poFeature = nullptr;
     if (iNextShapeId == 0)
     {
         SetInitialQuery();
         result = poStatement->Fetchmany(&rows);
         total_rows = rows;
-        if (rows < fetchnum)
-            isfetchall = 1;
-    }
-    if (rows > 0)
-    {
-        poFeature = RecordToFeature(poStatement, m_panMapFieldNameToIndex,
-                                    m_panMapFieldNameToGeomIndex,
-                                    (int)(total_rows - rows));
-        rows--;
+        isfetchall = rows < (ulength)poStatement->GetFetchSize() ? 1 : 0;
     }
-    else if (isfetchall == 0)
+    else if (rows == 0 && isfetchall == 0)
     {
         result = poStatement->Fetchmany(&rows);
         total_rows = rows;
-        if (rows < fetchnum)
+        if (rows < (ulength)poStatement->GetFetchSize())
             isfetchall = 1;
-        if (rows == 0)
-        {
-            poFeature = nullptr;
-            poStatement->Clean();
-        }
-        else
+    }
+
+    if (rows == 0 || result == nullptr)
+    {
+        rows = 0;
+        poStatement->Clean();
+        return -1;
+    }
+
+    const int iRecord = (int)(total_rows - rows);
+    rows--;
+    return iRecord;
+}
+
+/************************************************************************/
+/*                         GetNextRawFeature()                          */
+/************************************************************************/
+
+OGRFeature *OGRDAMENGLayer::GetNextRawFeature()
+
+{
+    OGRFeature *poFeature = nullptr;
+    if (iNextShapeId == 0 && m_poParallelScan == nullptr)
+        m_poParallelScan.reset(CreateParallelScan());
+
+    if (m_poParallelScan != nullptr)
+    {
+        poFeature = m_poParallelScan->GetNextFeature();
+        if (poFeature != nullptr)
+            m_nFeaturesRead++;
+    }
+    else
+    {
+        const int iRecord = FetchNextRecord();
+        if (iRecord >= 0)
         {
             poFeature = RecordToFeature(poStatement, m_panMapFieldNameToIndex,
                                         m_panMapFieldNameToGeomIndex,
-                                        (int)(total_rows - rows));
-            rows--;
+                                        iRecord);
+            if (m_bPagedByFID && poFeature != nullptr)
+            {
+                m_nKeysetIndex = iNextShapeId;
+                m_nKeysetFID = poFeature->GetFID();
+            }
         }
     }
-    else
-    {
-        poFeature = nullptr;
-        poStatement->Clean();
-    }
     nResultOffset++;
     iNextShapeId++;
     return poFeature;
 }
-//
-///************************************************************************/
-///*                           SetNextByIndex()                           */
-///************************************************************************/
-//
-//OGRErr OGRDAMENGLayer::SetNextByIndex(GIntBig nIndex)
-//
-//{
-//    GetLayerDefn();
-//
-//    if (!TestCapability(OLCFastSetNextByIndex))
-//        return OGRLayer::SetNextByIndex(nIndex);
-//
-//    if (nIndex == iNextShapeId)
-//    {
-//        return OGRERR_NONE;
-//    }
-//
-//    if (nIndex < 0)
-//    {
-//        CPLError(CE_Failure, CPLE_AppDefined, "Invalid index");
-//        return OGRERR_FAILURE;
-//    }
-//
-//    if (nIndex == 0)
-//    {
-//        ResetReading();
-//        return OGRERR_NONE;
-//    }
-//
-//    sdint2 nParams;
-//    CPLString osCommand;
-//    DPIRETURN rt;
-//    rt = dpi_number_params(poStatement->GetStatement(), &nParams);
-//    SetInitialQuery();
-//
-//    poStatement->SimpleFetchRow();
-//    if (!DSQL_SUCCEEDED(rt) || nParams != 1)
-//    {
-//        CPLError(CE_Failure, CPLE_AppDefined,
-//                 "Attempt to read feature at invalid index (" CPL_FRMT_GIB ").",
-//                 nIndex);
-//        iNextShapeId = 0;
-//
-//        return OGRERR_FAILURE;
-//    }
-//
-//    nResultOffset = 0;
-//    iNextShapeId = (int)nIndex;
-//
-//    return OGRERR_NONE;
-//}
+
+/************************************************************************/
+/*                         CanFillArrowArray()                          */
+/*                                                                      */
+/*      Whether GetNextArrowArray() can fill batches straight from      */
+/*      the fetch buffers, given the stream options and field types.    */
+/************************************************************************/
+
+bool OGRDAMENGLayer::CanFillArrowArray() const
+
+{
+    const char *pszGeomEncoding =
+        m_aosArrowArrayStreamOptions.FetchNameValue("GEOMETRY_ENCODING");
+    if (pszGeomEncoding != nullptr && !EQUAL(pszGeomEncoding, "WKB"))
+        return false;
+    if (m_aosArrowArrayStreamOptions.FetchBool(GAS_OPT_DATETIME_AS_STRING,
+                                               false))
+        return false;
+
+    for (int i = 0; i < poFeatureDefn->GetFieldCount(); i++)
+    {
+        const OGRFieldDefn *poFieldDefn = poFeatureDefn->GetFieldDefn(i);
+        switch (poFieldDefn->GetType())
+        {
+            case OFTInteger:
+            case OFTInteger64:
+            case OFTReal:
+            case OFTString:
+            case OFTBinary:
+            case OFTDate:
+            case OFTTime:
+            case OFTDateTime:
+                break;
+            default:
+                return false;
+        }
+        if (!poFieldDefn->GetDomainName().empty())
+            return false;
+    }
+    return true;
+}
+
+/************************************************************************/
+/*                         GetNextArrowArray()                          */
+/*                                                                      */
+/*      Fill an Arrow batch directly from the Fetchmany() buffers,      */
+/*      without going through one OGRFeature per row. Falls back to     */
+/*      the generic implementation when filters must be evaluated       */
+/*      on the client side.                                             */
+/************************************************************************/
+
+int OGRDAMENGLayer::GetNextArrowArray(struct ArrowArrayStream *stream,
+                                      struct ArrowArray *out_array)
+
+{
+    if (pszQueryStatement == nullptr)
+        ResetReading();
+
+    // A parallel scan hands out decoded features: batches are then built
+    // by the generic implementation.
+    if (iNextShapeId == 0 && m_poParallelScan == nullptr)
+        m_poParallelScan.reset(CreateParallelScan());
+
+    if (m_poParallelScan != nullptr ||
+        !TestCapability(OLCFastGetArrowStream) || !CanFillArrowArray())
+        return OGRLayer::GetNextArrowArray(stream, out_array);
+
+    OGRArrowArrayHelper sHelper(poDS, poFeatureDefn,
+                                m_aosArrowArrayStreamOptions, out_array);
+    if (out_array->release == nullptr)
+        return ENOMEM;
+
+    struct tm brokenDown;
+    memset(&brokenDown, 0, sizeof(brokenDown));
+
+    GByte *pabyWKB = nullptr;
+    size_t nWKBBufSize = 0;
+    std::vector<GByte> abyBinary;
+    int errorErrno = EIO;
+
+    /* Column kinds, resolved once the query has been run */
+    enum
+    {
+        COL_NONE,
+        COL_GSER,
+        COL_WKT
+    };
+    std::vector<int> anGeomKind;
+    std::vector<bool> abIsFIDColumn;
+
+    int iFeat = 0;
+    while (iFeat < sHelper.m_nMaxBatchSize)
+    {
+        const int iRecord = FetchNextRecord();
+        if (iRecord < 0)
+        {
+            nResultOffset++;
+            iNextShapeId++;
+            break;
+        }
+
+        const int nColumns = poStatement->GetColCount();
+        if (anGeomKind.empty())
+        {
+            anGeomKind.resize(nColumns, COL_NONE);
+            abIsFIDColumn.resize(nColumns, false);
+            for (int iCol = 0; iCol < nColumns; iCol++)
+            {
+                const DmColDesc *psColDesc = poStatement->GetColDesc(iCol);
+                if (psColDesc == nullptr)
+                {
+                    CPLError(CE_Failure, CPLE_AppDefined,
+                             "DAMENG: layer %s: cannot get the description "
+                             "of column %d of the result set",
+                             poFeatureDefn->GetName(), iCol);
+                    goto error;
+                }
+                const char *pszName = (const char *)psColDesc->name;
+                abIsFIDColumn[iCol] =
+                    pszFIDColumn != nullptr && EQUAL(pszName, pszFIDColumn);
+
+                const int iGeomField = m_panMapFieldNameToGeomIndex
+                                           ? m_panMapFieldNameToGeomIndex[iCol]
+                                           : -1;
+                if (iGeomField < 0)
+                    continue;
+                const OGRDAMENGGeomFieldDefn *poGeomFieldDefn =
+                    poFeatureDefn->GetGeomFieldDefn(iGeomField);
+                if (poGeomFieldDefn->eDAMENGGeoType != GEOM_TYPE_GEOMETRY &&
+                    poGeomFieldDefn->eDAMENGGeoType != GEOM_TYPE_GEOGRAPHY)
+                    continue;
+                if (STARTS_WITH_CI(pszName, "DMGEO2.ST_AsBinary") ||
+                    STARTS_WITH_CI(pszName, "DMGEO2.ST_AsEWKB"))
+                {
+                    CPLError(CE_Failure, CPLE_AppDefined,
+                             "We cannot handle binary type!");
+                    goto error;
+                }
+                anGeomKind[iCol] =
+                    STARTS_WITH_CI(pszName, "DMGEO2.ST_ASTEXT") ? COL_WKT
+                                                                : COL_GSER;
+            }
+        }
+
+        GIntBig nFID = iNextShapeId;
+        nResultOffset++;
+        iNextShapeId++;
+        m_nFeaturesRead++;
+
+        for (int iCol = 0; iCol < nColumns; iCol++)
+        {
+            const char *pszValue = result[iCol][iRecord];
+            const sdint2 nCType = poStatement->GetColCType(iCol);
+            if (abIsFIDColumn[iCol] && pszValue != nullptr)
+                nFID = OGRDAMENGValueAsInteger64(nCType, pszValue);
+
+            /* ---------------------------------------------------------- */
+            /*      Geometry column, as ISO WKB.                          */
+            /* ---------------------------------------------------------- */
+            const int iGeomField = m_panMapFieldNameToGeomIndex
+                                       ? m_panMapFieldNameToGeomIndex[iCol]
+                                       : -1;
+            if (iGeomField >= 0)
+            {
+                const int iArrowField =
+                    sHelper.m_mapOGRGeomFieldToArrowField[iGeomField];
+                if (iArrowField < 0)
+                    continue;
+
+                size_t nWKBSize = 0;
+                if (pszValue != nullptr && anGeomKind[iCol] == COL_GSER)
+                {
+                    const int nGserSize =
+                        poStatement->GetValueLength(result, iCol, iRecord);
+                    if (nGserSize > 0)
+                        nWKBSize = OGRDAMENGGserToIsoWkb(
+                            (const GSERIALIZED *)pszValue, nGserSize,
+                            &pabyWKB, &nWKBBufSize);
+                    if (nWKBSize == 0)
+                    {
+                        CPLError(CE_Failure, CPLE_AppDefined,
+                                 "DAMENG:Invalid Input Geometry Data!");
+                        goto error;
+                    }
+                }
+                else if (pszValue != nullptr && anGeomKind[iCol] == COL_WKT)
+                {
+                    OGRGeometry *poGeometry = nullptr;
+                    OGRGeometryFactory::createFromWkt(pszValue, nullptr,
+                                                      &poGeometry);
+                    if (poGeometry != nullptr)
+                    {
+                        nWKBSize = poGeometry->WkbSize();
+                        if (nWKBSize > nWKBBufSize)
+                        {
+                            CPLFree(pabyWKB);
+                            pabyWKB = (GByte *)CPLMalloc(nWKBSize);
+                            nWKBBufSize = nWKBSize;
+                        }
+                        poGeometry->exportToWkb(wkbNDR, pabyWKB,
+                                                wkbVariantIso);
+                        delete poGeometry;
+                    }
+                }
+
+                if (nWKBSize == 0)
+                {
+                    if (!sHelper.SetNull(iArrowField, iFeat))
+                    {
+                        errorErrno = ENOMEM;
+                        goto error;
+                    }
+                    continue;
+                }
+                GByte *pabyOut =
+                    sHelper.GetPtrForStringOrBinary(iArrowField, iFeat,
+                                                    nWKBSize);
+                if (pabyOut == nullptr)
+                {
+                    errorErrno = ENOMEM;
+                    goto error;
+                }
+                memcpy(pabyOut, pabyWKB, nWKBSize);
+                continue;
+            }
+
+            /* ---------------------------------------------------------- */
+            /*      Regular field, from its native value or string image. */
+            /* ---------------------------------------------------------- */
+            const int iField =
+                m_panMapFieldNameToIndex ? m_panMapFieldNameToIndex[iCol] : -1;
+            if (iField < 0)
+                continue;
+            const int iArrowField = sHelper.m_mapOGRFieldToArrowField[iField];
+            if (iArrowField < 0)
+                continue;
+            auto psArray = out_array->children[iArrowField];
+            const OGRFieldDefn *poFieldDefn =
+                poFeatureDefn->GetFieldDefnUnsafe(iField);
+
+            OGRField sField;
+            const bool bIsTemporal = poFieldDefn->GetType() == OFTDate ||
+                                     poFieldDefn->GetType() == OFTTime ||
+                                     poFieldDefn->GetType() == OFTDateTime;
+            if (pszValue == nullptr ||
+                (nCType == DSQL_C_NCHAR && pszValue[0] == '\0') ||
+                (bIsTemporal &&
+                 !OGRDAMENGValueAsDateTime(nCType, pszValue, &sField)))
+            {
+                if (!sHelper.SetNull(iArrowField, iFeat))
+                {
+                    errorErrno = ENOMEM;
+                    goto error;
+                }
+                continue;
+            }
+
+            switch (poFieldDefn->GetType())
+            {
+                case OFTInteger:
+                {
+                    if (poFieldDefn->GetSubType() == OFSTBoolean &&
+                        nCType != DSQL_C_NCHAR)
+                    {
+                        if (OGRDAMENGValueAsInteger64(nCType, pszValue) != 0)
+                            sHelper.SetBoolOn(psArray, iFeat);
+                        break;
+                    }
+                    if (poFieldDefn->GetSubType() == OFSTBoolean)
+                    {
+                        if (EQUAL(pszValue, "1") || EQUAL(pszValue, "true") ||
+                            EQUAL(pszValue, "on") || EQUAL(pszValue, "yes") ||
+                            (!EQUAL(pszValue, "0") &&
+                             !EQUAL(pszValue, "false") &&
+                             !EQUAL(pszValue, "off") &&
+                             !EQUAL(pszValue, "no") &&
+                             CPLGetValueType(pszValue) != CPL_VALUE_STRING))
+                            sHelper.SetBoolOn(psArray, iFeat);
+                        break;
+                    }
+                    const GIntBig nVal =
+                        OGRDAMENGValueAsInteger64(nCType, pszValue);
+                    if (poFieldDefn->GetSubType() == OFSTInt16)
+                    {
+                        sHelper.SetInt16(
+                            psArray, iFeat,
+                            (int16_t)std::clamp<GIntBig>(nVal, INT16_MIN,
+                                                         INT16_MAX));
+                    }
+                    else
+                    {
+                        sHelper.SetInt32(
+                            psArray, iFeat,
+                            (int32_t)std::clamp<GIntBig>(nVal, INT_MIN,
+                                                         INT_MAX));
+                    }
+                    break;
+                }
+
+                case OFTInteger64:
+                    sHelper.SetInt64(
+                        psArray, iFeat,
+                        OGRDAMENGValueAsInteger64(nCType, pszValue));
+                    break;
+
+                case OFTReal:
+                {
+                    const double dfVal =
+                        OGRDAMENGValueAsDouble(nCType, pszValue);
+                    if (poFieldDefn->GetSubType() == OFSTFloat32)
+                        sHelper.SetFloat(psArray, iFeat, (float)dfVal);
+                    else
+                        sHelper.SetDouble(psArray, iFeat, dfVal);
+                    break;
+                }
+
+                case OFTString:
+                {
+                    if (nCType == DSQL_C_SLONG || nCType == DSQL_C_SBIGINT)
+                        pszValue = CPLSPrintf(
+                            CPL_FRMT_GIB,
+                            OGRDAMENGValueAsInteger64(nCType, pszValue));
+                    else if (nCType == DSQL_C_DOUBLE)
+                        pszValue = CPLSPrintf(
+                            "%.15g", OGRDAMENGValueAsDouble(nCType, pszValue));
+                    else if (nCType == DSQL_C_TIMESTAMP &&
+                             OGRDAMENGValueAsDateTime(nCType, pszValue,
+                                                      &sField))
+                        pszValue = CPLSPrintf(
+                            "%04d/%02d/%02d %02d:%02d:%06.3f",
+                            sField.Date.Year, sField.Date.Month,
+                            sField.Date.Day, sField.Date.Hour,
+                            sField.Date.Minute, sField.Date.Second);
+                    const size_t nLen = strlen(pszValue);
+                    GByte *pabyOut =
+                        sHelper.GetPtrForStringOrBinary(iArrowField, iFeat,
+                                                        nLen);
+                    if (pabyOut == nullptr)
+                    {
+                        errorErrno = ENOMEM;
+                        goto error;
+                    }
+                    memcpy(pabyOut, pszValue, nLen);
+                    break;
+                }
+
+                case OFTBinary:
+                {
+                    size_t nSize = 0;
+                    const GByte *pabyBytes = OGRDAMENGValueAsBinary(
+                        nCType, pszValue,
+                        poStatement->GetValueLength(result, iCol, iRecord),
+                        abyBinary, &nSize);
+                    GByte *pabyOut =
+                        sHelper.GetPtrForStringOrBinary(iArrowField, iFeat,
+                                                        nSize);
+                    if (pabyOut == nullptr)
+                    {
+                        errorErrno = ENOMEM;
+                        goto error;
+                    }
+                    if (nSize > 0)
+                        memcpy(pabyOut, pabyBytes, nSize);
+                    break;
+                }
+
+                case OFTDate:
+                    sHelper.SetDate(psArray, iFeat, brokenDown, sField);
+                    break;
+
+                case OFTTime:
+                    sHelper.SetInt32(
+                        psArray, iFeat,
+                        sField.Date.Hour * 3600000 +
+                            sField.Date.Minute * 60000 +
+                            (int)(sField.Date.Second * 1000 + 0.5f));
+                    break;
+
+                case OFTDateTime:
+                    sHelper.SetDateTime(psArray, iFeat, brokenDown,
+                                        sHelper.m_anTZFlags[iField], sField);
+                    break;
+
+                default:
+                    break;
+            }
+        }
+
+        if (sHelper.m_panFIDValues)
+            sHelper.m_panFIDValues[iFeat] = nFID;
+        iFeat++;
+    }
+
+    CPLFree(pabyWKB);
+    if (iFeat == 0)
+    {
+        sHelper.ClearArray();
+        return 0;
+    }
+    sHelper.Shrink(iFeat);
+    return 0;
+
+error:
+    CPLFree(pabyWKB);
+    sHelper.ClearArray();
+    return errorErrno;
+}
+
+/************************************************************************/
+/*                          BuildPagedQuery()                           */
+/*                                                                      */
+/*      Query returning the rows of the current one from nIndex on,     */
+/*      skipped by the server.                                          */
+/************************************************************************/
+
+CPLString OGRDAMENGLayer::BuildPagedQuery(GIntBig nIndex)
+
+{
+    CPLString osCommand;
+    osCommand.Printf("SELECT * FROM (%s) AS ogrdamengpage OFFSET " CPL_FRMT_GIB
+                     " ROWS",
+                     pszQueryStatement, nIndex);
+    return osCommand;
+}
+
+/************************************************************************/
+/*                           SetNextByIndex()                           */
+/*                                                                      */
+/*      Run a query starting at nIndex, so that reading any page costs  */
+/*      one execution instead of fetching all the preceding rows.       */
+/************************************************************************/
+
+OGRErr OGRDAMENGLayer::SetNextByIndex(GIntBig nIndex)
+
+{
+    GetLayerDefn();
+
+    // Same result as OGRLayer::SetNextByIndex(), without querying the server.
+    if (nIndex < 0)
+        return OGRERR_NON_EXISTING_FEATURE;
+
+    if (!TestCapability(OLCFastSetNextByIndex))
+        return OGRLayer::SetNextByIndex(nIndex);
+
+    ResetReading();
+    if (pszQueryStatement == nullptr)
+        return OGRERR_FAILURE;
+
+    const CPLString osCommand = BuildPagedQuery(nIndex);
+    SetInitialQuery(osCommand.c_str());
+    result = poStatement->Fetchmany(&rows);
+    total_rows = rows;
+    isfetchall = rows < (ulength)poStatement->GetFetchSize() ? 1 : 0;
+    iNextShapeId = nIndex;
+
+    if (rows == 0 || result == nullptr)
+    {
+        rows = 0;
+        isfetchall = 1;
+        poStatement->Clean();
+        return nIndex == 0 ? OGRERR_NONE : OGRERR_NON_EXISTING_FEATURE;
+    }
+    return OGRERR_NONE;
+}
 
 /************************************************************************/
 /*                        BlobToGByteArray()                           */
@@ -627,10 +1314,8 @@ OGRErr OGRDAMENGLayer::IGetExtent(int iGeomField, OGREnvelope *psExtent,
             OGRERR_NONE)
             return OGRERR_NONE;
     }
-    if (iGeomField == 0)
-        return OGRLayer::GetExtent(psExtent, bForce);
-    else
-        return OGRLayer::GetExtent(iGeomField, psExtent, bForce);
+    // The public GetExtent() would come back here.
+    return OGRLayer::IGetExtent(iGeomField, psExtent, bForce);
 }
 
 /************************************************************************/
@@ -643,15 +1328,17 @@ OGRErr OGRDAMENGLayer::RunGetExtentRequest(OGREnvelope &sExtent,
                                        int bErrorAsDebug)
 {
     OGRDAMENGConn *hDAMENGConn = poDS->GetDAMENGConn();
-    OGRDAMENGStatement *hStmt = new OGRDAMENGStatement(hDAMENGConn);
-    CPLErr eErr = hStmt->Execute(osCommand);
-    if (!hStmt || eErr)
+    OGRDAMENGStatement oStmt(hDAMENGConn);
+    CPLErr eErr = oStmt.Execute(osCommand);
+    char **papszRow = eErr == CE_None ? oStmt.SimpleFetchRow() : nullptr;
+    if (papszRow == nullptr || papszRow[0] == nullptr ||
+        papszRow[0][0] == '\0')
     {
         CPLDebug("DAMENG", "Unable to get extent by DMGEO2");
         return OGRERR_FAILURE;
     }
 
-    char *pszBox = hStmt->SimpleFetchRow()[0];
+    char *pszBox = papszRow[0];
     char *ptr, *ptrEndParenthesis;
     char szVals[64 * 6 + 6];
 
@@ -661,8 +1348,11 @@ OGRErr OGRDAMENGLayer::RunGetExtentRequest(OGREnvelope &sExtent,
     if (ptr == nullptr || (ptrEndParenthesis = strchr(ptr, ')')) == nullptr ||
         ptrEndParenthesis - ptr > static_cast<int>(sizeof(szVals) - 1))
     {
-        CPLError(CE_Failure, CPLE_IllegalArg, "Bad extent representation: '%s'",
-                 pszBox);
+        if (bErrorAsDebug)
+            CPLDebug("DAMENG", "Bad extent representation: '%s'", pszBox);
+        else
+            CPLError(CE_Failure, CPLE_IllegalArg,
+                     "Bad extent representation: '%s'", pszBox);
         return OGRERR_FAILURE;
     }
 
@@ -670,6 +1360,11 @@ OGRErr OGRDAMENGLayer::RunGetExtentRequest(OGREnvelope &sExtent,
     szVals[ptrEndParenthesis - ptr] = '\0';
 
     char **papszTokens = CSLTokenizeString2(szVals, " ,", CSLT_HONOURSTRINGS);
+    if (CSLCount(papszTokens) < 4)
+    {
+        CSLDestroy(papszTokens);
+        return OGRERR_FAILURE;
+    }
 
     sExtent.MinX = CPLAtof(papszTokens[0]);
     sExtent.MinY = CPLAtof(papszTokens[1]);
@@ -677,7 +1372,6 @@ OGRErr OGRDAMENGLayer::RunGetExtentRequest(OGREnvelope &sExtent,
     sExtent.MaxY = CPLAtof(papszTokens[3]);
 
     CSLDestroy(papszTokens);
-    hStmt->Clean();
 
     return OGRERR_NONE;
 }
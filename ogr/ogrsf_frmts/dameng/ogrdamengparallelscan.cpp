@@ -0,0 +1,319 @@
+/******************************************************************************
+ *
+ * Project:  OpenGIS Simple Features Reference Implementation
+ * Purpose:  Implements OGRDAMENGParallelScan class.
+ * Author:   YiLun Wu, wuyilun@dameng.com
+ *
+ ******************************************************************************
+ * Copyright (c) 2026, YiLun Wu
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#include "ogr_dameng.h"
+#include "gdal_thread_pool.h"
+
+/* Number of decoded features a worker hands over at once */
+#define PARALLEL_SCAN_CHUNK_SIZE 256
+
+/************************************************************************/
+/*                        OGRDAMENGParallelScan()                       */
+/*                                                                      */
+/*      pszSQL must select the rows of one FID range, given by its two  */
+/*      first parameters, which adfParamsIn follow.                     */
+/************************************************************************/
+
+OGRDAMENGParallelScan::OGRDAMENGParallelScan(
+    const OGRDAMENGLayer *poLayerIn, const char *pszSQL,
+    const std::vector<double> &adfParamsIn, bool bOrderedIn)
+    : poLayer(poLayerIn), osSQL(pszSQL), adfParams(adfParamsIn),
+      bOrdered(bOrderedIn)
+{
+}
+
+/************************************************************************/
+/*                       ~OGRDAMENGParallelScan()                       */
+/************************************************************************/
+
+OGRDAMENGParallelScan::~OGRDAMENGParallelScan()
+
+{
+    {
+        std::lock_guard<std::mutex> oLock(oMutex);
+        bStop = true;
+    }
+    oCVRoom.notify_all();
+    if (poJobQueue)
+        poJobQueue->WaitCompletion();
+
+    for (OGRDAMENGConn *poConn : apoConns)
+        poLayer->poDS->ReleaseScanConn(poConn);
+}
+
+/************************************************************************/
+/*                            AddPartition()                            */
+/************************************************************************/
+
+void OGRDAMENGParallelScan::AddPartition(GIntBig nMinFID, GIntBig nMaxFID)
+
+{
+    aoPartitions.emplace_back();
+    aoPartitions.back().nMinFID = nMinFID;
+    aoPartitions.back().nMaxFID = nMaxFID;
+}
+
+/************************************************************************/
+/*                               Start()                                */
+/*                                                                      */
+/*      Open the sessions and submit one job per session. Returns       */
+/*      false if less than two sessions could be used, in which case    */
+/*      the caller should read the layer sequentially.                  */
+/************************************************************************/
+
+bool OGRDAMENGParallelScan::Start(int nWorkers)
+
+{
+    if (aoPartitions.empty())
+        return false;
+
+    nWorkers = std::min(nWorkers, static_cast<int>(aoPartitions.size()));
+    for (int i = 0; i < nWorkers; i++)
+    {
+        OGRDAMENGConn *poConn = poLayer->poDS->AcquireScanConn();
+        if (poConn == nullptr)
+            break;
+        apoConns.push_back(poConn);
+    }
+    if (apoConns.size() < 2)
+        return false;
+
+    CPLWorkerThreadPool *poPool =
+        GDALGetGlobalThreadPool(static_cast<int>(apoConns.size()));
+    if (poPool == nullptr)
+        return false;
+    poJobQueue = poPool->CreateJobQueue();
+
+    // Workers of an ordered scan each fill their own partition.
+    if (bOrdered)
+        nMaxQueued = std::max<size_t>(
+            PARALLEL_SCAN_QUEUE_SIZE / apoConns.size(),
+            PARALLEL_SCAN_CHUNK_SIZE);
+
+    for (OGRDAMENGConn *poConn : apoConns)
+    {
+        {
+            std::lock_guard<std::mutex> oLock(oMutex);
+            nRunningWorkers++;
+        }
+        if (!poJobQueue->SubmitJob([this, poConn]() { WorkerJob(poConn); }))
+        {
+            std::lock_guard<std::mutex> oLock(oMutex);
+            nRunningWorkers--;
+        }
+    }
+
+    std::lock_guard<std::mutex> oLock(oMutex);
+    return nRunningWorkers > 0;
+}
+
+/************************************************************************/
+/*                           QueueFeatures()                            */
+/*                                                                      */
+/*      Move decoded features to the queue of their partition, waiting  */
+/*      for room. Returns false once the scan is being stopped.         */
+/************************************************************************/
+
+bool OGRDAMENGParallelScan::QueueFeatures(
+    int iPartition, std::vector<std::unique_ptr<OGRFeature>> &apoFeatures)
+
+{
+    if (apoFeatures.empty())
+        return true;
+
+    std::unique_lock<std::mutex> oLock(oMutex);
+    Partition &oQueue = aoPartitions[bOrdered ? iPartition : 0];
+    oCVRoom.wait(oLock, [this, &oQueue]()
+                 { return bStop || oQueue.apoFeatures.size() < nMaxQueued; });
+    if (bStop)
+        return false;
+
+    for (auto &poFeature : apoFeatures)
+        oQueue.apoFeatures.push_back(std::move(poFeature));
+    apoFeatures.clear();
+    oLock.unlock();
+    oCVFeatures.notify_one();
+    return true;
+}
+
+/************************************************************************/
+/*                             WorkerJob()                              */
+/*                                                                      */
+/*      Take the next pending FID range, run the query on the session   */
+/*      of the job, and decode the rows, until no range is left.        */
+/************************************************************************/
+
+void OGRDAMENGParallelScan::WorkerJob(OGRDAMENGConn *poConn)
+
+{
+    OGRDAMENGStatement oStatement(poConn);
+    oStatement.SetStats(&poLayer->m_oStats);
+    int *panMapFieldNameToIndex = nullptr;
+    int *panMapFieldNameToGeomIndex = nullptr;
+    std::vector<std::unique_ptr<OGRFeature>> apoFeatures;
+    CPLString osJobError;
+    bool bExecuted = false;
+
+    while (true)
+    {
+        int iPartition = 0;
+        {
+            std::lock_guard<std::mutex> oLock(oMutex);
+            if (bStop || iNextPartition == static_cast<int>(aoPartitions.size()))
+                break;
+            iPartition = iNextPartition++;
+        }
+
+        oStatement.ClearParams();
+        oStatement.AddInt64Param(aoPartitions[iPartition].nMinFID);
+        oStatement.AddInt64Param(aoPartitions[iPartition].nMaxFID);
+        for (double dfParam : adfParams)
+            oStatement.AddDoubleParam(dfParam);
+
+        // The statement is prepared by the first range, then re-executed.
+        if (oStatement.Excute_for_fetchmany(bExecuted ? nullptr : osSQL.c_str()) !=
+            CE_None)
+        {
+            osJobError.Printf("DAMENG: parallel scan query failed: %s",
+                              osSQL.c_str());
+            break;
+        }
+        if (!bExecuted)
+        {
+            OGRDAMENGLayer::CreateMapFromFieldNameToIndex(
+                &oStatement, poLayer->poFeatureDefn, panMapFieldNameToIndex,
+                panMapFieldNameToGeomIndex);
+            bExecuted = true;
+        }
+
+        bool bMoreRows = true;
+        bool bStopped = false;
+        while (bMoreRows && !bStopped)
+        {
+            ulength nRows = 0;
+            char ***papapszRows = oStatement.Fetchmany(&nRows);
+            if (papapszRows == nullptr || nRows == 0)
+                break;
+            bMoreRows = nRows == (ulength)oStatement.GetFetchSize();
+
+            for (ulength iRow = 0; iRow < nRows && !bStopped; iRow++)
+            {
+                OGRFeature *poFeature = poLayer->DecodeRecord(
+                    &oStatement, papapszRows, panMapFieldNameToIndex,
+                    panMapFieldNameToGeomIndex, static_cast<int>(iRow),
+                    OGRNullFID);
+                if (poFeature != nullptr)
+                    apoFeatures.emplace_back(poFeature);
+                if (apoFeatures.size() == PARALLEL_SCAN_CHUNK_SIZE)
+                    bStopped = !QueueFeatures(iPartition, apoFeatures);
+            }
+        }
+        if (bStopped || !QueueFeatures(iPartition, apoFeatures))
+            break;
+
+        {
+            std::lock_guard<std::mutex> oLock(oMutex);
+            aoPartitions[iPartition].bDone = true;
+            nDonePartitions++;
+        }
+        oCVFeatures.notify_one();
+    }
+
+    CPLFree(panMapFieldNameToIndex);
+    CPLFree(panMapFieldNameToGeomIndex);
+
+    {
+        std::lock_guard<std::mutex> oLock(oMutex);
+        if (!osJobError.empty() && osError.empty())
+            osError = osJobError;
+        nRunningWorkers--;
+    }
+    oCVFeatures.notify_one();
+}
+
+/************************************************************************/
+/*                           GetNextFeature()                           */
+/*                                                                      */
+/*      Hand out the next decoded feature, in FID order when the scan   */
+/*      is ordered. Returns nullptr at the end of the scan or on error. */
+/************************************************************************/
+
+OGRFeature *OGRDAMENGParallelScan::GetNextFeature()
+
+{
+    if (apoReady.empty())
+    {
+        const int nPartitions = static_cast<int>(aoPartitions.size());
+        std::unique_lock<std::mutex> oLock(oMutex);
+        while (true)
+        {
+            if (!osError.empty())
+            {
+                CPLError(CE_Failure, CPLE_AppDefined, "%s", osError.c_str());
+                osError.clear();
+                iCurPartition = nPartitions;
+                bStop = true;
+                oLock.unlock();
+                oCVRoom.notify_all();
+                return nullptr;
+            }
+            if (iCurPartition == nPartitions)
+                return nullptr;
+
+            Partition &oQueue = aoPartitions[bOrdered ? iCurPartition : 0];
+            if (!oQueue.apoFeatures.empty())
+            {
+                apoReady.swap(oQueue.apoFeatures);
+                break;
+            }
+            if (bOrdered && oQueue.bDone)
+            {
+                iCurPartition++;
+                continue;
+            }
+            if (!bOrdered && nDonePartitions == nPartitions)
+            {
+                iCurPartition = nPartitions;
+                continue;
+            }
+            if (nRunningWorkers == 0)
+            {
+                // Workers were stopped before the end of the scan.
+                iCurPartition = nPartitions;
+                return nullptr;
+            }
+            oCVFeatures.wait(oLock);
+        }
+        oLock.unlock();
+        oCVRoom.notify_all();
+    }
+
+    OGRFeature *poFeature = apoReady.front().release();
+    apoReady.pop_front();
+    return poFeature;
+}
@@ -38,6 +38,7 @@ OGRDAMENGResultLayer::OGRDAMENGResultLayer(OGRDAMENGDataSource *poDSIn,
                                    OGRDAMENGStatement *hInitialResultIn) : pszRawStatement(CPLStrdup(pszRawQueryIn))
 {
     poDS = poDSIn;
+    m_oStats.SetParent(poDS->GetStats());
 
     iNextShapeId = 0;
 
@@ -147,6 +148,7 @@ GIntBig OGRDAMENGResultLayer::GetFeatureCount(int bForce)
     osCommand.Printf("SELECT count(*) FROM (%s) AS ogrdamengcount",
                      pszQueryStatement);
 
+    oCommand.SetDoubleParams(m_adfQueryParams);
     CPLErr rt = oCommand.Execute(osCommand.c_str());
     hResult = oCommand.SimpleFetchRow();
     if (rt == CE_None && hResult != nullptr)
@@ -166,16 +168,19 @@ int OGRDAMENGResultLayer::TestCapability(const char *pszCap) const
 {
     GetLayerDefn();
 
+    // No OLCFastSetNextByIndex: without a FID column, nothing guarantees
+    // that paged queries return the rows in the order of a full read.
     if (EQUAL(pszCap, OLCFastFeatureCount) ||
-        EQUAL(pszCap, OLCFastSetNextByIndex))
+        EQUAL(pszCap, OLCFastGetArrowStream))
     {
         OGRDAMENGGeomFieldDefn *poGeomFieldDefn = nullptr;
         if (poFeatureDefn->GetGeomFieldCount() > 0)
             poGeomFieldDefn =
                 poFeatureDefn->GetGeomFieldDefn(m_iGeomFieldFilter);
         return (m_poFilterGeom == nullptr || poGeomFieldDefn == nullptr ||
-                poGeomFieldDefn->eDAMENGGeoType == GEOM_TYPE_GEOMETRY ||
-                poGeomFieldDefn->eDAMENGGeoType == GEOM_TYPE_GEOGRAPHY) &&
+                (m_bFilterIsEnvelope &&
+                 (poGeomFieldDefn->eDAMENGGeoType == GEOM_TYPE_GEOMETRY ||
+                  poGeomFieldDefn->eDAMENGGeoType == GEOM_TYPE_GEOGRAPHY))) &&
                m_poAttrQuery == nullptr;
     }
     else if (EQUAL(pszCap, OLCFastSpatialFilter))
@@ -224,8 +229,9 @@ OGRFeature *OGRDAMENGResultLayer::GetNextFeature()
             return nullptr;
 
         if ((m_poFilterGeom == nullptr || poGeomFieldDefn == nullptr ||
-             poGeomFieldDefn->eDAMENGGeoType == GEOM_TYPE_GEOMETRY ||
-             poGeomFieldDefn->eDAMENGGeoType == GEOM_TYPE_GEOGRAPHY ||
+             (m_bFilterIsEnvelope &&
+              (poGeomFieldDefn->eDAMENGGeoType == GEOM_TYPE_GEOMETRY ||
+               poGeomFieldDefn->eDAMENGGeoType == GEOM_TYPE_GEOGRAPHY)) ||
              FilterGeometry(poFeature->GetGeomFieldRef(m_iGeomFieldFilter))) &&
             (m_poAttrQuery == nullptr || m_poAttrQuery->Evaluate(poFeature)))
             return poFeature;
@@ -259,31 +265,15 @@ OGRErr OGRDAMENGResultLayer::ISetSpatialFilter(int iGeomField,
         poFeatureDefn->GetGeomFieldDefn(m_iGeomFieldFilter);
     if (InstallFilter(poGeomIn))
     {
-        if (poGeomFieldDefn->eDAMENGGeoType == GEOM_TYPE_GEOMETRY)
+        if (poGeomFieldDefn->eDAMENGGeoType == GEOM_TYPE_GEOMETRY ||
+            poGeomFieldDefn->eDAMENGGeoType == GEOM_TYPE_GEOGRAPHY)
         {
+            m_adfQueryParams.clear();
             if (m_poFilterGeom != nullptr)
             {
-                char szBox3D_1[128];
-                char szBox3D_2[128];
-                char szBox3D_3[128];
-                char szBox3D_4[128];
-                OGREnvelope sEnvelope;
-
-                m_poFilterGeom->getEnvelope(&sEnvelope);
-                CPLsnprintf(szBox3D_1, sizeof(szBox3D_1), "%.18g %.18g",
-                            sEnvelope.MinX, sEnvelope.MinY);
-                CPLsnprintf(szBox3D_2, sizeof(szBox3D_2), "%.18g %.18g",
-                            sEnvelope.MinX, sEnvelope.MaxY);
-                CPLsnprintf(szBox3D_3, sizeof(szBox3D_2), "%.18g %.18g",
-                            sEnvelope.MaxX, sEnvelope.MaxY);
-                CPLsnprintf(szBox3D_4, sizeof(szBox3D_2), "%.18g %.18g",
-                            sEnvelope.MaxX, sEnvelope.MinY);
-                osWHERE.Printf("WHERE "
-                               "DMGEO2.ST_BOXCONTAINS(dmgeo2.st_geomfromtext('"
-                               "POLYGON(( %s, %s, %s, %s, %s))'), %s);",
-                               szBox3D_1, szBox3D_2, szBox3D_3, szBox3D_4,
-                               szBox3D_1, OGRDAMENGEscapeColumnName(poGeomFieldDefn->GetNameRef())
-                                    .c_str());
+                osWHERE.Printf(
+                    "WHERE %s",
+                    BuildSpatialPredicate(poGeomFieldDefn).c_str());
             }
             else
             {
@@ -28,12 +28,16 @@
 
 #include "ogr_dameng.h"
 #include "cpl_conv.h"
+#include "cpl_error_internal.h"
+#include "gdal_thread_pool.h"
 #include <ogr_p.h>
+#include <algorithm>
 
 OGRDAMENGStatement::OGRDAMENGStatement(OGRDAMENGConn *poConnIn)
 
 {
     poConn = poConnIn;
+    m_poStats = poConn ? poConn->poStats : nullptr;
     hStatement = nullptr;
     result = nullptr;
     papszCurImage = nullptr;
@@ -57,36 +61,51 @@ OGRDAMENGStatement::~OGRDAMENGStatement()
 
 {
     Clean();
+    for (auto &sParam : m_aoParams)
+        CPLFree(sParam.pabyGser);
 }
 
 void OGRDAMENGStatement::Clean()
 
 {
     DPIRETURN rt;
-    if (insert_num > 0)
+    CancelPrefetch();
+    if (paramdescs != nullptr)
     {
-        rt = dpi_set_stmt_attr(hStatement, DSQL_ATTR_PARAMSET_SIZE,
-                               (dpointer)insert_num, 0);
-        rt = dpi_exec(hStatement);
+        FlushInsert(true);
+        FreeInsertBuffers();
+    }
+    rt = poConn->SoftCommit();
+    if (pszCommandText)
+        CPLFree(pszCommandText);
+    pszCommandText = nullptr;
+    FreeResults();
+    FreeParamObjects();
+
+    if (hStatement)
+    {
+        rt = dpi_free_stmt(hStatement);
         if (!DSQL_SUCCEEDED(rt))
         {
             CPLError(CE_Failure, CPLE_AppDefined,
-                     "failed to exectue");
-            return;
-        }
-        for (int iparam = 0; iparam < geonum; iparam++)
-        {
-            for (int num = 0; num < insert_num; num++)
-            {
-                CPLFree(insert_geovalues[iparam][num]);
-            }
+                     "failed to free stmt");
         }
-        insert_num = 0;
+        hStatement = nullptr;
     }
-    rt = dpi_commit((poConn->hCon));
-    if (pszCommandText)
-        CPLFree(pszCommandText);
-    pszCommandText = nullptr;
+}
+
+/************************************************************************/
+/*                             FreeResults()                            */
+/*                                                                      */
+/*      Release the buffers bound to the columns of the last result     */
+/*      set, keeping the prepared statement.                            */
+/************************************************************************/
+
+void OGRDAMENGStatement::FreeResults()
+
+{
+    DPIRETURN rt;
+    CancelPrefetch();
     if (is_fectmany == 0)
     {
         if (result)
@@ -132,73 +151,25 @@ void OGRDAMENGStatement::Clean()
     }
     else
     {
-        if (results)
-        {
-            for (int col = 0; results[col] != nullptr; col++)
-            {
-
-                if (object_index[col])
-                {
-                    for (int row = 0; row < fetchnum; row++)
-                    {
-                        if (results[col][row])
-                            CPLFree(results[col][row]);
-                        rt = dpi_free_obj(objs[col][row]);
-                        if (!DSQL_SUCCEEDED(rt))
-                        {
-                            CPLError(CE_Failure, CPLE_AppDefined,
-                                     "failed to free obj");
-                        }
-                        dpi_free_obj_desc(objdescs[col][row]);
-                        if (!DSQL_SUCCEEDED(rt))
-                        {
-                            CPLError(CE_Failure, CPLE_AppDefined,
-                                     "failed to free objdesc");
-                        }
-                    }
-                }
-                else if (lob_index[col])
-                {
-                    for (int row = 0; row < fetchnum; row++)
-                    {
-                        if (results[col][row])
-                            CPLFree(results[col][row]);
-                        rt = dpi_free_lob_locator(lobs[col][row]);
-                        if (!DSQL_SUCCEEDED(rt))
-                        {
-                            CPLError(CE_Failure, CPLE_AppDefined,
-                                     "failed to free lob");
-                        }
-                    }
-                }
-                else
-                {
-                    if (results[col][0])
-                        CPLFree(results[col][0]);
-                }
-                CPLFree(results[col]);
-                CPLFree(col_len[col]);
-                CPLFree(objs[col]);
-                CPLFree(objdescs[col]);
-                CPLFree(lobs[col]);
-                CPLFree(blob_lens[col]);
-                if (papszCurImages && papszCurImages[col])
-                    CPLFree(papszCurImages[col]);
-            }
-            CPLFree(results);
-            CPLFree(col_len);
-            CPLFree(objs);
-            CPLFree(objdescs);
-            CPLFree(lobs);
-            CPLFree(blob_lens);
-            if (papszCurImages)
-                CPLFree(papszCurImages);
-        }
+        // Both sets of buffers when prefetching.
+        FreeFetchBuffers();
+        SwapFetchBuffers();
+        FreeFetchBuffers();
+        m_poPrefetchQueue.reset();
     }
     if (object_index)
         CPLFree(object_index);
     if (lob_index)
         CPLFree(lob_index);
+    CPLFree(coldescs);
+    CPLFree(col_ctypes);
+    CPLFree(col_bufs);
+    CPLFree(col_buf_sizes);
+    coldescs = nullptr;
+    col_ctypes = nullptr;
+    col_bufs = nullptr;
+    col_buf_sizes = nullptr;
+    nFetchSize = fetchnum;
     object_index = nullptr;
     objdesc = nullptr;
     obj = nullptr;
@@ -214,17 +185,88 @@ void OGRDAMENGStatement::Clean()
     col_len = nullptr;
     papszCurImages = nullptr;
     papszCurImage = nullptr;
+}
 
-    if (hStatement)
+/************************************************************************/
+/*                          FreeFetchBuffers()                          */
+/*                                                                      */
+/*      Release the current set of fetch buffers.                       */
+/************************************************************************/
+
+void OGRDAMENGStatement::FreeFetchBuffers()
+
+{
+    DPIRETURN rt;
+    if (results)
     {
-        rt = dpi_free_stmt(hStatement);
-        if (!DSQL_SUCCEEDED(rt))
+        for (int col = 0; results[col] != nullptr; col++)
         {
-            CPLError(CE_Failure, CPLE_AppDefined,
-                     "failed to free stmt");
+            // A set whose allocation failed part-way has no arrays for
+            // the last columns.
+            if (object_index[col] && objs[col] != nullptr)
+            {
+                for (int row = 0; row < nFetchSize; row++)
+                {
+                    FreeRowImage(col, row);
+                    rt = dpi_free_obj(objs[col][row]);
+                    if (!DSQL_SUCCEEDED(rt))
+                    {
+                        CPLError(CE_Failure, CPLE_AppDefined,
+                                 "failed to free obj");
+                    }
+                    dpi_free_obj_desc(objdescs[col][row]);
+                    if (!DSQL_SUCCEEDED(rt))
+                    {
+                        CPLError(CE_Failure, CPLE_AppDefined,
+                                 "failed to free objdesc");
+                    }
+                }
+            }
+            else if (lob_index[col] && lobs[col] != nullptr)
+            {
+                for (int row = 0; row < nFetchSize; row++)
+                {
+                    FreeRowImage(col, row);
+                    rt = dpi_free_lob_locator(lobs[col][row]);
+                    if (!DSQL_SUCCEEDED(rt))
+                    {
+                        CPLError(CE_Failure, CPLE_AppDefined,
+                                 "failed to free lob");
+                    }
+                }
+            }
+            if (col_bufs)
+                poConn->ReleaseFetchBuffer(col_bufs[col],
+                                           col_buf_sizes[col]);
+            CPLFree(results[col]);
+            CPLFree(col_len[col]);
+            CPLFree(objs[col]);
+            CPLFree(objdescs[col]);
+            CPLFree(lobs[col]);
+            CPLFree(blob_lens[col]);
+            if (papszCurImages && papszCurImages[col])
+                CPLFree(papszCurImages[col]);
         }
-        hStatement = nullptr;
+        CPLFree(results);
+        CPLFree(col_len);
+        CPLFree(objs);
+        CPLFree(objdescs);
+        CPLFree(lobs);
+        CPLFree(blob_lens);
+        if (papszCurImages)
+            CPLFree(papszCurImages);
     }
+    CPLFree(col_bufs);
+    CPLFree(col_buf_sizes);
+    results = nullptr;
+    col_len = nullptr;
+    objs = nullptr;
+    objdescs = nullptr;
+    lobs = nullptr;
+    blob_lens = nullptr;
+    col_bufs = nullptr;
+    col_buf_sizes = nullptr;
+    papszCurImages = nullptr;
 }
 
 CPLErr OGRDAMENGStatement::Prepare(const char *pszSQLstatement)
@@ -269,7 +311,10 @@ CPLErr OGRDAMENGStatement::Prepare(const char *pszSQLstatement)
         }
     }
 
-    rt = dpi_prepare(hStatement, (sdbyte *)pszCommandText);
+    {
+        OGRDAMENGStatsTimer oTimer(m_poStats, OGRDAMENGStats::PREPARE);
+        rt = dpi_prepare(hStatement, (sdbyte *)pszCommandText);
+    }
     if (!DSQL_SUCCEEDED(rt))
     {
         CPLError(CE_Failure, CPLE_AppDefined, "failed to prepare, %s",
@@ -279,128 +324,410 @@ CPLErr OGRDAMENGStatement::Prepare(const char *pszSQLstatement)
     return CE_None;
 }
 
-CPLErr OGRDAMENGStatement::Execute_for_insert(OGRDAMENGFeatureDefn* params,
-                                          OGRFeature *poFeature,
-                                          std::map<std::string, int> mymap)
+/************************************************************************/
+/*                            SetBatchSize()                            */
+/*                                                                      */
+/*      Must be called before the first Execute_for_insert(), as the    */
+/*      parameter arrays are allocated and bound only once.             */
+/************************************************************************/
+
+void OGRDAMENGStatement::SetBatchSize(int nBatchSizeIn, int nCommitIntervalIn)
+{
+    if (paramdescs != nullptr)
+    {
+        CPLDebug("DAMENG", "SetBatchSize() ignored: parameters already bound");
+        return;
+    }
+    nBatchSize = std::max(1, nBatchSizeIn);
+    nCommitInterval = std::max(0, nCommitIntervalIn);
+}
+
+/************************************************************************/
+/*                           SetBatchLayout()                           */
+/************************************************************************/
+
+void OGRDAMENGStatement::SetBatchLayout(int nPrimaryParams, int nFIDParam)
+{
+    if (paramdescs != nullptr)
+    {
+        CPLDebug("DAMENG",
+                 "SetBatchLayout() ignored: parameters already bound");
+        return;
+    }
+    m_nPrimaryParams = std::max(0, nPrimaryParams);
+    m_nFIDParam = std::max(0, nFIDParam);
+}
+
+/************************************************************************/
+/*                          SetBatchCommands()                          */
+/************************************************************************/
+
+void OGRDAMENGStatement::SetBatchCommands(const char *pszBefore,
+                                          const char *pszAfter)
+{
+    m_osBeforeBatch = pszBefore ? pszBefore : "";
+    m_osAfterBatch = pszAfter ? pszAfter : "";
+}
+
+/************************************************************************/
+/*                          InitInsertBuffers()                         */
+/*                                                                      */
+/*      Describe the parameters of the prepared INSERT, allocate one    */
+/*      column-wise array of nBatchSize slots per parameter and bind    */
+/*      them, so that a whole batch is sent with a single dpi_exec().   */
+/*      Repeated markers, see SetBatchLayout(), are bound to the        */
+/*      arrays of the marker they repeat.                               */
+/************************************************************************/
+
+CPLErr OGRDAMENGStatement::InitInsertBuffers()
 {
     DPIRETURN rt;
-    int i = 0;
-    int bind_flag = 0;
-    if (paramdescs == nullptr)
+
+    rt = dpi_set_stmt_attr(hStatement, DSQL_ATTR_PARAMSET_SIZE,
+                           (dpointer)(size_t)nBatchSize, 0);
+    if (!DSQL_SUCCEEDED(rt))
     {
-        bind_flag = 1;
-        rt = dpi_set_stmt_attr(hStatement, DSQL_ATTR_PARAMSET_SIZE,
-                               (void *)FORCED_INSERT_NUM, 0);
+        CPLError(CE_Failure, CPLE_AppDefined,
+                 "failed to set stmt paramset size");
+        return CE_Failure;
+    }
+
+    rt = dpi_number_params(hStatement, (udint2 *)&param_nums);
+    if (!DSQL_SUCCEEDED(rt))
+    {
+        CPLError(CE_Failure, CPLE_AppDefined,
+                 "failed to get params numbers");
+        return CE_Failure;
+    }
+    const int nPrimary = m_nPrimaryParams > 0
+                             ? std::min(m_nPrimaryParams, param_nums)
+                             : param_nums;
+    m_anGeomParams.clear();
+    m_anValueParams.clear();
+    paramdescs = (DmColDesc *)CPLCalloc(sizeof(DmColDesc), param_nums);
+    for (udint2 iparam = 0; iparam < nPrimary; iparam++)
+    {
+        rt = dpi_desc_param(
+            hStatement, iparam + 1, &paramdescs[iparam].sql_type,
+            &paramdescs[iparam].prec, &paramdescs[iparam].scale,
+            &paramdescs[iparam].nullable);
         if (!DSQL_SUCCEEDED(rt))
         {
             CPLError(CE_Failure, CPLE_AppDefined,
-                     "failed to set stmt paramset size");
+                     "failed to get param desc");
             return CE_Failure;
         }
+        if (paramdescs[iparam].sql_type == DSQL_CLASS)
+            m_anGeomParams.push_back(iparam);
+        else
+            m_anValueParams.push_back(iparam);
+    }
 
-        rt = dpi_number_params(hStatement, (udint2 *)&param_nums);
+    geonum = static_cast<int>(m_anGeomParams.size());
+    valuesnum = static_cast<int>(m_anValueParams.size());
+
+    insert_objs = (dhobj **)CPLCalloc(sizeof(dhobj *), std::max(1, geonum));
+    insert_geovalues = (GSERIALIZED ***)CPLCalloc(sizeof(GSERIALIZED **),
+                                                  std::max(1, geonum));
+    insert_geosizes =
+        (size_t **)CPLCalloc(sizeof(size_t *), std::max(1, geonum));
+    if (geonum > 0)
+    {
+        dhdesc hdesc_param;
+        sdint4 val_len;
+        rt = dpi_get_stmt_attr(hStatement, DSQL_ATTR_IMP_PARAM_DESC,
+                               (dpointer)&hdesc_param, 0, &val_len);
+        rt = dpi_get_desc_field(hdesc_param, (sdint2)(m_anGeomParams[0] + 1),
+                                DSQL_DESC_OBJ_DESCRIPTOR, &insert_objdesc,
+                                sizeof(dhobjdesc), NULL);
         if (!DSQL_SUCCEEDED(rt))
         {
             CPLError(CE_Failure, CPLE_AppDefined,
-                     "failed to get params numbers");
+                     "failed to get geometry desc");
             return CE_Failure;
         }
-        paramdescs = (DmColDesc *)CPLCalloc(sizeof(DmColDesc), param_nums);
-        for (udint2 iparam = 0; iparam < param_nums; iparam++)
+    }
+    for (int iparam = 0; iparam < geonum; iparam++)
+    {
+        insert_objs[iparam] = (dhobj *)CPLCalloc(sizeof(dhobj), nBatchSize);
+        insert_geovalues[iparam] =
+            (GSERIALIZED **)CPLCalloc(sizeof(GSERIALIZED *), nBatchSize);
+        insert_geosizes[iparam] =
+            (size_t *)CPLCalloc(sizeof(size_t), nBatchSize);
+        for (int num = 0; num < nBatchSize; num++)
         {
-            rt = dpi_desc_param(
-                hStatement, iparam + 1, &paramdescs[iparam].sql_type,
-                &paramdescs[iparam].prec, &paramdescs[iparam].scale,
-                &paramdescs[iparam].nullable);
-            if (paramdescs[iparam].sql_type == DSQL_CLASS)
-                i++;
+            rt = dpi_alloc_obj((poConn->hCon), &insert_objs[iparam][num]);
+            if (!DSQL_SUCCEEDED(rt))
+            {
+                CPLError(CE_Failure, CPLE_AppDefined, "failed to alloc obj");
+                return CE_Failure;
+            }
+            rt = dpi_bind_obj_desc(insert_objs[iparam][num], insert_objdesc);
             if (!DSQL_SUCCEEDED(rt))
             {
                 CPLError(CE_Failure, CPLE_AppDefined,
-                         "failed to get param desc");
+                         "failed to bind obj desc");
                 return CE_Failure;
             }
         }
+    }
 
-        geonum = i;
-        insert_objs = (dhobj **)CPLCalloc(sizeof(dhobj *), i);
-        for (int num = 0; num < i; num++)
+    /* -------------------------------------------------------------------- */
+    /*      Size each value slot from the declared precision rather than    */
+    /*      a flat 8192 bytes, as the arrays are now nBatchSize deep.       */
+    /* -------------------------------------------------------------------- */
+    insert_values = (char ***)CPLCalloc(sizeof(char **), std::max(1, valuesnum));
+    insert_value_width = (int *)CPLCalloc(sizeof(int), std::max(1, valuesnum));
+    for (int iparam = 0; iparam < valuesnum; iparam++)
+    {
+        const DmColDesc *psDesc = &paramdescs[m_anValueParams[iparam]];
+        GUIntBig nWidth = static_cast<GUIntBig>(psDesc->prec) * 4 + 1;
+        nWidth = std::max<GUIntBig>(nWidth, 64);
+        nWidth = std::min<GUIntBig>(nWidth, 8192);
+        insert_value_width[iparam] = static_cast<int>(nWidth);
+
+        insert_values[iparam] = (char **)CPLCalloc(sizeof(char *), nBatchSize);
+        char *data = (char *)CPLCalloc(static_cast<size_t>(nWidth), nBatchSize);
+        for (int num = 0; num < nBatchSize; num++)
         {
-            insert_objs[num] =
-                (dhobj *)CPLCalloc(sizeof(dhobj), FORCED_INSERT_NUM);
+            insert_values[iparam][num] = data + nWidth * num;
         }
-        if (i > 0)
+    }
+
+    /* -------------------------------------------------------------------- */
+    /*      Bind every marker, a repeated one to the arrays of its source.  */
+    /* -------------------------------------------------------------------- */
+    for (int iMarker = 0; iMarker < param_nums; iMarker++)
+    {
+        const int iSource = iMarker % nPrimary;
+        const DmColDesc *psDesc = &paramdescs[iSource];
+        const auto oGeomIter = std::find(m_anGeomParams.begin(),
+                                         m_anGeomParams.end(), iSource);
+        if (oGeomIter != m_anGeomParams.end())
         {
-            dhdesc hdesc_param;
-            sdint4 val_len;
-            rt = dpi_get_stmt_attr(hStatement, DSQL_ATTR_IMP_PARAM_DESC,
-                                   (dpointer)&hdesc_param, 0, &val_len);
-            rt = dpi_get_desc_field(hdesc_param, (sdint2)1,
-                                    DSQL_DESC_OBJ_DESCRIPTOR, &insert_objdesc,
-                                    sizeof(dhobjdesc), NULL);
-            if (!DSQL_SUCCEEDED(rt))
+            const int iparam =
+                static_cast<int>(oGeomIter - m_anGeomParams.begin());
+            rt = dpi_bind_param(hStatement, (udint2)(iMarker + 1),
+                                DSQL_PARAM_INPUT, DSQL_C_CLASS, DSQL_CLASS,
+                                psDesc->prec, psDesc->scale,
+                                &insert_objs[iparam][0], sizeof(dhobj), NULL);
+        }
+        else
+        {
+            const int iparam = static_cast<int>(
+                std::find(m_anValueParams.begin(), m_anValueParams.end(),
+                          iSource) -
+                m_anValueParams.begin());
+            rt = dpi_bind_param(hStatement, (udint2)(iMarker + 1),
+                                DSQL_PARAM_INPUT, DSQL_C_NCHAR,
+                                psDesc->sql_type, psDesc->prec, psDesc->scale,
+                                insert_values[iparam][0],
+                                insert_value_width[iparam], NULL);
+        }
+        if (!DSQL_SUCCEEDED(rt))
+        {
+            CPLError(CE_Failure, CPLE_AppDefined, "failed to bind param");
+            return CE_Failure;
+        }
+    }
+    return CE_None;
+}
+
+/************************************************************************/
+/*                          FreeInsertBuffers()                         */
+/************************************************************************/
+
+void OGRDAMENGStatement::FreeInsertBuffers()
+{
+    if (paramdescs == nullptr)
+        return;
+
+    for (int iparam = 0; iparam < geonum; iparam++)
+    {
+        if (insert_geovalues && insert_geovalues[iparam])
+        {
+            for (int num = 0; num < nBatchSize; num++)
+                CPLFree(insert_geovalues[iparam][num]);
+            CPLFree(insert_geovalues[iparam]);
+        }
+        if (insert_geosizes)
+            CPLFree(insert_geosizes[iparam]);
+        if (insert_objs && insert_objs[iparam])
+        {
+            for (int num = 0; num < nBatchSize; num++)
             {
-                CPLError(CE_Failure, CPLE_AppDefined,
-                         "failed to get geometry desc");
-                return CE_Failure;
+                if (insert_objs[iparam][num])
+                    dpi_free_obj(insert_objs[iparam][num]);
             }
+            CPLFree(insert_objs[iparam]);
+        }
+    }
+    CPLFree(insert_geovalues);
+    CPLFree(insert_geosizes);
+    CPLFree(insert_objs);
+
+    for (int iparam = 0; iparam < valuesnum; iparam++)
+    {
+        if (insert_values && insert_values[iparam])
+        {
+            CPLFree(insert_values[iparam][0]);
+            CPLFree(insert_values[iparam]);
+        }
+    }
+    CPLFree(insert_values);
+    CPLFree(insert_value_width);
+    CPLFree(paramdescs);
+
+    insert_geovalues = nullptr;
+    insert_geosizes = nullptr;
+    insert_objs = nullptr;
+    insert_values = nullptr;
+    insert_value_width = nullptr;
+    paramdescs = nullptr;
+    param_nums = 0;
+    geonum = 0;
+    valuesnum = 0;
+    insert_num = 0;
+    m_anGeomParams.clear();
+    m_anValueParams.clear();
+}
+
+/************************************************************************/
+/*                          RunBatchCommand()                           */
+/************************************************************************/
+
+void OGRDAMENGStatement::RunBatchCommand(const char *pszCommand)
+{
+    if (pszCommand == nullptr || pszCommand[0] == '\0')
+        return;
+
+    dhstmt hCommand = nullptr;
+    DPIRETURN rt = dpi_alloc_stmt(poConn->hCon, &hCommand);
+    if (DSQL_SUCCEEDED(rt))
+    {
+        OGRDAMENGStatsTimer oTimer(m_poStats, OGRDAMENGStats::EXECUTE);
+        rt = dpi_exec_direct(hCommand, (sdbyte *)pszCommand);
+    }
+    if (!DSQL_SUCCEEDED(rt))
+        CPLDebug("DAMENG", "%s failed", pszCommand);
+    if (hCommand != nullptr)
+        dpi_free_stmt(hCommand);
+}
+
+/************************************************************************/
+/*                             FlushInsert()                            */
+/*                                                                      */
+/*      Send the rows buffered so far with one dpi_exec(), and commit   */
+/*      if the commit interval is reached or bCommit is set.            */
+/************************************************************************/
+
+CPLErr OGRDAMENGStatement::FlushInsert(bool bCommit)
+{
+    DPIRETURN rt;
+    CPLErr eErr = CE_None;
+
+    if (insert_num > 0)
+    {
+        RunBatchCommand(m_osBeforeBatch);
+        rt = dpi_set_stmt_attr(hStatement, DSQL_ATTR_PARAMSET_SIZE,
+                               (dpointer)(size_t)insert_num, 0);
+        if (DSQL_SUCCEEDED(rt))
+        {
+            OGRDAMENGStatsTimer oTimer(m_poStats, OGRDAMENGStats::EXECUTE);
+            rt = dpi_exec(hStatement);
+            oTimer.Stop(insert_num, m_nPendingBytes);
+        }
+        RunBatchCommand(m_osAfterBatch);
+        if (!DSQL_SUCCEEDED(rt))
+        {
+            CPLError(CE_Failure, CPLE_AppDefined,
+                     "failed to execute batch of %d rows", insert_num);
+            eErr = CE_Failure;
+        }
+        else
+        {
+            nUncommittedRows += insert_num;
         }
-        for (int iparam = 0; iparam < i; iparam++)
+        // The geometry buffers of each slot are kept for the next batch,
+        // but for those of large geometries.
+        for (int num = 0; num < geonum; num++)
         {
-            for (int num = 0; num < FORCED_INSERT_NUM; num++)
+            for (int iSlot = 0; iSlot < insert_num; iSlot++)
             {
-                rt = dpi_alloc_obj((poConn->hCon), &insert_objs[iparam][num]);
-                if (!DSQL_SUCCEEDED(rt))
+                if (insert_geosizes[num][iSlot] > poConn->nLobChunkSize)
                 {
-                    CPLError(CE_Failure, CPLE_AppDefined,
-                             "failed to alloc obj");
-                    return CE_Failure;
-                }
-                rt =
-                    dpi_bind_obj_desc(insert_objs[iparam][num], insert_objdesc);
-                if (!DSQL_SUCCEEDED(rt))
-                {
-                    CPLError(CE_Failure, CPLE_AppDefined,
-                             "failed to bind obj desc");
-                    return CE_Failure;
+                    CPLFree(insert_geovalues[num][iSlot]);
+                    insert_geovalues[num][iSlot] = nullptr;
+                    insert_geosizes[num][iSlot] = 0;
                 }
             }
         }
-        insert_geovalues =
-            (GSERIALIZED ***)CPLCalloc(sizeof(GSERIALIZED **), i);
-        for (int iparam = 0; iparam < i; iparam++)
+        insert_num = 0;
+        m_nPendingBytes = 0;
+    }
+
+    if (nUncommittedRows > 0 &&
+        (bCommit ||
+         (nCommitInterval > 0 && nUncommittedRows >= nCommitInterval)))
+    {
+        rt = poConn->SoftCommit();
+        if (!DSQL_SUCCEEDED(rt))
         {
-            insert_geovalues[iparam] = (GSERIALIZED **)CPLCalloc(
-                sizeof(GSERIALIZED *), FORCED_INSERT_NUM);
+            CPLError(CE_Failure, CPLE_AppDefined, "failed to commit");
+            eErr = CE_Failure;
         }
+        nUncommittedRows = 0;
+    }
+    return eErr;
+}
 
-        valuesnum = param_nums - i;
-        insert_values = (char ***)CPLCalloc(sizeof(char **), valuesnum);
-        for (int iparam = 0; iparam < valuesnum; iparam++)
+/************************************************************************/
+/*                          Execute_for_insert()                        */
+/*                                                                      */
+/*      Copy one feature into the next slot of the parameter arrays.    */
+/*      The batch is executed once nBatchSize rows are buffered, or     */
+/*      after a geometry larger than the LOB chunk size; any remainder  */
+/*      is sent by FlushInsert().                                       */
+/************************************************************************/
+
+CPLErr OGRDAMENGStatement::Execute_for_insert(OGRDAMENGFeatureDefn *params,
+                                              OGRFeature *poFeature,
+                                              std::map<std::string, int> &mymap)
+{
+    DPIRETURN rt;
+    int i = 0;
+    bool bLargeGeometry = false;
+    if (paramdescs == nullptr)
+    {
+        if (InitInsertBuffers() != CE_None)
         {
-            insert_values[iparam] =
-                (char **)CPLCalloc(sizeof(char *), FORCED_INSERT_NUM);
-            char *date = (char *)CPLMalloc(8192 * FORCED_INSERT_NUM);
-            for (int num = 0; num < FORCED_INSERT_NUM; num++)
-            {
-                insert_values[iparam][num] = date + 8192 * num;
-            }
+            FreeInsertBuffers();
+            return CE_Failure;
         }
     }
-    i = 0;
+
+    OGRDAMENGStatsTimer oTimer(m_poStats, OGRDAMENGStats::ENCODE);
+
     for (udint2 num = 0; num < geonum; num++)
     {
-
-        OGRDAMENGGeomFieldDefn *poGeomFieldDefn = params->GetGeomFieldDefn(i);
-        OGRGeometry *poGeom = poFeature->GetGeomFieldRef(i);
+        size_t nGserLength = 0;
+        OGRDAMENGGeomFieldDefn *poGeomFieldDefn =
+            i < params->GetGeomFieldCount() ? params->GetGeomFieldDefn(i)
+                                            : nullptr;
         char s[100];
-        strncpy(s, poGeomFieldDefn->GetNameRef(), 100);
-        if (mymap[s] == num + 1 && poGeom != nullptr)
+        if (poGeomFieldDefn != nullptr)
         {
-            if (i < params->GetGeomFieldCount())
-                i++;
-            if (poGeomFieldDefn->eDAMENGGeoType == GEOM_TYPE_GEOGRAPHY ||
-                poGeomFieldDefn->eDAMENGGeoType == GEOM_TYPE_GEOMETRY)
+            strncpy(s, poGeomFieldDefn->GetNameRef(), 100);
+            s[99] = '\0';
+        }
+        if (poGeomFieldDefn != nullptr && mymap[s] == m_anGeomParams[num] + 1)
+        {
+            OGRGeometry *poGeom = poFeature->GetGeomFieldRef(i);
+            i++;
+            if (poGeom != nullptr &&
+                (poGeomFieldDefn->eDAMENGGeoType == GEOM_TYPE_GEOGRAPHY ||
+                 poGeomFieldDefn->eDAMENGGeoType == GEOM_TYPE_GEOMETRY) &&
+                !CPLTestBool(CPLGetConfigOption("DM_USE_TEXT", "NO")))
             {
                 poGeom->closeRings();
                 poGeom->set3D(poGeomFieldDefn->GeometryTypeFlags &
@@ -408,191 +735,339 @@ CPLErr OGRDAMENGStatement::Execute_for_insert(OGRDAMENGFeatureDefn* params,
                 poGeom->setMeasured(poGeomFieldDefn->GeometryTypeFlags &
                                     OGRGeometry::OGR_G_MEASURED);
 
-                int nSRSId = poGeomFieldDefn->nSRSId;
-
-                if (!CPLTestBool(CPLGetConfigOption("DM_USE_TEXT", "NO")))
-                {
-                    OGREnvelope3D Envelope;
-                    poGeom->getEnvelope(&Envelope);
-                    char *pszHexEWKB =
-                        OGRGeometryToHexEWKB(poGeom, nSRSId, 3, 3);
-                    insert_geovalues[num][insert_num] =
-                        OGRDAMENGGeoFromHexwkb(pszHexEWKB, &gser_length, Envelope);
-                    CPLFree(pszHexEWKB);
-                    rt = dpi_set_obj_val(
-                        insert_objs[num][insert_num], 1, DSQL_C_BINARY,
-                        insert_geovalues[num][insert_num], gser_length);
-                    if (!DSQL_SUCCEEDED(rt))
-                    {
-                        CPLError(CE_Failure, CPLE_AppDefined,
-                                 "failed to set obj val");
-                        return CE_Failure;
-                    }
-                    if (bind_flag == 1)
-                    {
-                        rt = dpi_bind_param(
-                            hStatement, num + 1, DSQL_PARAM_INPUT, DSQL_C_CLASS,
-                            DSQL_CLASS, paramdescs[num].prec,
-                            paramdescs[num].scale, &insert_objs[num][0],
-                            sizeof(dhobj), NULL);
-                        if (!DSQL_SUCCEEDED(rt))
-                        {
-                            CPLError(CE_Failure, CPLE_AppDefined,
-                                     "failed to bind param");
-                            return CE_Failure;
-                        }
-                    }
-                }
+                // Serialize straight into this slot's buffer, which is
+                // reused from one batch to the next.
+                GByte *pabyBuf = (GByte *)insert_geovalues[num][insert_num];
+                nGserLength = OGRDAMENGGeometryToGser(
+                    poGeom, poGeomFieldDefn->nSRSId, &pabyBuf,
+                    &insert_geosizes[num][insert_num]);
+                insert_geovalues[num][insert_num] = (GSERIALIZED *)pabyBuf;
+                if (nGserLength == 0)
+                    return CE_Failure;
+                m_nPendingBytes += static_cast<GIntBig>(nGserLength);
+                if (nGserLength > poConn->nLobChunkSize)
+                    bLargeGeometry = true;
             }
         }
-        else
+        rt = dpi_set_obj_val(insert_objs[num][insert_num], 1, DSQL_C_BINARY,
+                             nGserLength ? insert_geovalues[num][insert_num]
+                                         : nullptr,
+                             static_cast<udint4>(nGserLength));
+        if (!DSQL_SUCCEEDED(rt))
         {
-            rt = dpi_set_obj_val(insert_objs[num][insert_num], 1, DSQL_C_BINARY,
-                                 nullptr, 0);
-            if (!DSQL_SUCCEEDED(rt))
-            {
-                CPLError(CE_Failure, CPLE_AppDefined,
-                         "failed to set obj val");
-                return CE_Failure;
-            }
-            if (bind_flag == 1)
-            {
-                rt = dpi_bind_param(hStatement, num + 1, DSQL_PARAM_INPUT,
-                                    DSQL_C_CLASS, DSQL_CLASS,
-                                    paramdescs[num].prec, paramdescs[num].scale,
-                                    &insert_objs[num][0], sizeof(dhobj), NULL);
-                if (!DSQL_SUCCEEDED(rt))
-                {
-                    CPLError(CE_Failure, CPLE_AppDefined,
-                             "failed to bind param");
-                    return CE_Failure;
-                }
-            }
+            CPLError(CE_Failure, CPLE_AppDefined, "failed to set obj val");
+            return CE_Failure;
         }
     }
     i = 0;
     for (int num = 0; num < valuesnum; num++)
     {
-
+        char *pszSlot = insert_values[num][insert_num];
+        const size_t nWidth = static_cast<size_t>(insert_value_width[num]);
+        if (m_anValueParams[num] + 1 == m_nFIDParam)
+        {
+            snprintf(pszSlot, nWidth, CPL_FRMT_GIB, poFeature->GetFID());
+            continue;
+        }
         const OGRFeatureDefn *poFeatureDefn = poFeature->GetDefnRef();
+        if (i >= poFeatureDefn->GetFieldCount())
+        {
+            pszSlot[0] = '\0';
+            continue;
+        }
         OGRFieldType nOGRFieldType = poFeatureDefn->GetFieldDefn(i)->GetType();
         char s[100];
         strncpy(s, poFeatureDefn->GetFieldDefn(i)->GetNameRef(), 100);
-        if (mymap[strToupper(s)] == num + geonum + 1)
+        s[99] = '\0';
+        if (mymap[strToupper(s)] == m_anValueParams[num] + 1)
         {
-
-            strncpy(insert_values[num][insert_num],
-                    poFeature->GetFieldAsString(i), 8192);
-            if (i < params->GetFieldCount())
-                i++;
+            const char *pszValue = poFeature->GetFieldAsString(i);
+            if (strlen(pszValue) >= nWidth)
+            {
+                CPLError(CE_Warning, CPLE_AppDefined,
+                         "Value of field %s truncated to %d bytes", s,
+                         static_cast<int>(nWidth) - 1);
+            }
+            CPLStrlcpy(pszSlot, pszValue, nWidth);
             // Check if date is NULL: 0000-00-00
             if (nOGRFieldType == OFTDate)
             {
-                if (STARTS_WITH_CI(insert_values[num][insert_num], "0000"))
-                {
-                    strncpy(insert_values[num][insert_num], "NULL", 8192);
-                }
+                if (STARTS_WITH_CI(pszSlot, "0000"))
+                    CPLStrlcpy(pszSlot, "NULL", nWidth);
             }
             else if (nOGRFieldType == OFTReal)
             {
                 //Check for special values. They need to be quoted.
                 double dfVal = poFeature->GetFieldAsDouble(i);
                 if (std::isnan(dfVal))
-                    strncpy(insert_values[num][insert_num], "'NaN'", 8192);
-            }
-            if (bind_flag == 1)
-            {
-                rt = dpi_bind_param(hStatement, (udint2)(num + geonum + 1),
-                                    DSQL_PARAM_INPUT, DSQL_C_NCHAR,
-                                    paramdescs[num + geonum].sql_type,
-                                    paramdescs[num + geonum].prec,
-                                    paramdescs[num + geonum].scale,
-                                    insert_values[num][0], 8192, NULL);
-                if (!DSQL_SUCCEEDED(rt))
-                {
-                    CPLError(CE_Failure, CPLE_AppDefined,
-                             "failed to bind param");
-                    return CE_Failure;
-                }
+                    CPLStrlcpy(pszSlot, "'NaN'", nWidth);
             }
+            if (i < params->GetFieldCount())
+                i++;
         }
         else
         {
-            strncpy(insert_values[num][insert_num], "", 8192);
-            if (bind_flag == 1)
-            {
-                rt = dpi_bind_param(hStatement, (udint2)(num + geonum + 1),
-                                    DSQL_PARAM_INPUT, DSQL_C_NCHAR,
-                                    paramdescs[num + geonum].sql_type,
-                                    paramdescs[num + geonum].prec,
-                                    paramdescs[num + geonum].scale,
-                                    insert_values[num][0], 8192, NULL);
-                if (!DSQL_SUCCEEDED(rt))
-                {
-                    CPLError(CE_Failure, CPLE_AppDefined,
-                             "failed to bind param");
-                    return CE_Failure;
-                }
-            }
+            pszSlot[0] = '\0';
         }
     }
+
+    for (int num = 0; num < valuesnum; num++)
+        m_nPendingBytes +=
+            static_cast<GIntBig>(strlen(insert_values[num][insert_num]));
+    oTimer.Stop(1);
+
     insert_num++;
-    if (insert_num < FORCED_INSERT_NUM)
+    // A large geometry is sent right away, so that a batch of them does
+    // not pile up in memory.
+    if (insert_num < nBatchSize && !bLargeGeometry)
         return CE_None;
-    rt = dpi_exec(hStatement);
+    return FlushInsert(false);
+}
+
+CPLErr OGRDAMENGStatement::ExecuteInsert(const char *pszSQLStatement, int nMode)
+{
+    DPIRETURN rt;
+
+    rt = dpi_alloc_stmt((poConn->hCon), &hStatement);
+    if (!DSQL_SUCCEEDED(rt))
+    {
+        CPLError(CE_Failure, CPLE_AppDefined,
+                 "failed to alloc statement");
+        return CE_Failure;
+    }
+    {
+        OGRDAMENGStatsTimer oTimer(m_poStats, OGRDAMENGStats::EXECUTE);
+        rt = dpi_exec_direct(hStatement, (sdbyte *)pszSQLStatement);
+    }
     if (!DSQL_SUCCEEDED(rt))
     {
         CPLError(CE_Failure, CPLE_AppDefined,
                  "failed to exectue");
         return CE_Failure;
     }
-    rt = dpi_commit((poConn->hCon));
+
+    sdint8 row_count;
+    rt = dpi_row_count(hStatement, &row_count);
     if (!DSQL_SUCCEEDED(rt))
     {
         CPLError(CE_Failure, CPLE_AppDefined,
-                 "failed to commit");
+                 "failed to get row_count");
         return CE_Failure;
     }
-    insert_num = 0;
-    for (int iparam = 0; iparam < geonum; iparam++)
+    return CE_None;
+}
+
+/************************************************************************/
+/*                              NextParam()                             */
+/*                                                                      */
+/*      Return the slot of the next parameter. Slots are kept from one  */
+/*      execution to the next, with their geometry buffer and object.   */
+/************************************************************************/
+
+OGRDAMENGParam &OGRDAMENGStatement::NextParam()
+{
+    if (m_nParams == (int)m_aoParams.size())
+        m_aoParams.emplace_back();
+    OGRDAMENGParam &sParam = m_aoParams[m_nParams++];
+    sParam.nInd = 0;
+    return sParam;
+}
+
+/************************************************************************/
+/*                             ClearParams()                            */
+/*                                                                      */
+/*      Forget the values of the previous execution. The geometry       */
+/*      buffers of the slots are kept for the next one, unless they     */
+/*      grew past the LOB chunk size for an unusually large geometry.   */
+/************************************************************************/
+
+void OGRDAMENGStatement::ClearParams()
+{
+    for (int i = 0; i < m_nParams; i++)
+    {
+        OGRDAMENGParam &sParam = m_aoParams[i];
+        if (sParam.nGserBufSize > poConn->nLobChunkSize)
+        {
+            CPLFree(sParam.pabyGser);
+            sParam.pabyGser = nullptr;
+            sParam.nGserBufSize = 0;
+        }
+    }
+    m_nParams = 0;
+}
+
+void OGRDAMENGStatement::SetDoubleParams(const std::vector<double> &adfParams)
+{
+    ClearParams();
+    for (double dfValue : adfParams)
+        AddDoubleParam(dfValue);
+}
+
+void OGRDAMENGStatement::AddNullParam()
+{
+    OGRDAMENGParam &sParam = NextParam();
+    sParam.nCType = DSQL_C_NCHAR;
+    sParam.nInd = DSQL_NULL_DATA;
+}
+
+void OGRDAMENGStatement::AddInt64Param(GIntBig nValue)
+{
+    OGRDAMENGParam &sParam = NextParam();
+    sParam.nCType = DSQL_C_SBIGINT;
+    sParam.nValue = nValue;
+}
+
+void OGRDAMENGStatement::AddDoubleParam(double dfValue)
+{
+    OGRDAMENGParam &sParam = NextParam();
+    sParam.nCType = DSQL_C_DOUBLE;
+    sParam.dfValue = dfValue;
+}
+
+void OGRDAMENGStatement::AddStringParam(const char *pszValue)
+{
+    OGRDAMENGParam &sParam = NextParam();
+    sParam.nCType = DSQL_C_NCHAR;
+    sParam.osValue = pszValue;
+}
+
+/************************************************************************/
+/*                          AddGeometryParam()                          */
+/*                                                                      */
+/*      Add a geometry parameter, sent as a DMGEO2 object holding its   */
+/*      GSERIALIZED form. A null geometry is bound as NULL.             */
+/************************************************************************/
+
+CPLErr OGRDAMENGStatement::AddGeometryParam(const OGRGeometry *poGeom,
+                                            int nSRSId)
+{
+    OGRDAMENGParam &sParam = NextParam();
+    sParam.nCType = DSQL_C_CLASS;
+    sParam.nGserSize = 0;
+    if (poGeom == nullptr)
     {
-        for (int num = 0; num < FORCED_INSERT_NUM; num++)
+        sParam.nInd = DSQL_NULL_DATA;
+        return CE_None;
+    }
+    sParam.nGserSize = OGRDAMENGGeometryToGser(
+        poGeom, nSRSId, &sParam.pabyGser, &sParam.nGserBufSize);
+    return sParam.nGserSize ? CE_None : CE_Failure;
+}
+
+/************************************************************************/
+/*                             BindParams()                             */
+/************************************************************************/
+
+CPLErr OGRDAMENGStatement::BindParams()
+{
+    DPIRETURN rt;
+    dhdesc hdesc_param = nullptr;
+
+    m_nBoundBytes = 0;
+    for (int i = 0; i < m_nParams; i++)
+    {
+        OGRDAMENGParam &sParam = m_aoParams[i];
+        const bool bNull = sParam.nInd == DSQL_NULL_DATA;
+        dpointer pBuffer = nullptr;
+        slength nBufLen = 0;
+        sdint2 nSQLType = DSQL_VARCHAR;
+        ulength nPrec = 0;
+        slength *pnInd = &sParam.nInd;
+
+        if (sParam.nCType == DSQL_C_SBIGINT)
+        {
+            pBuffer = &sParam.nValue;
+            nBufLen = sParam.nInd = sizeof(sParam.nValue);
+            nSQLType = DSQL_BIGINT;
+        }
+        else if (sParam.nCType == DSQL_C_DOUBLE)
+        {
+            pBuffer = &sParam.dfValue;
+            nBufLen = sParam.nInd = sizeof(sParam.dfValue);
+            nSQLType = DSQL_DOUBLE;
+        }
+        else if (sParam.nCType == DSQL_C_CLASS)
+        {
+            if (sParam.hObj == nullptr)
+            {
+                dhobjdesc hObjDesc = nullptr;
+                sdint4 val_len;
+                if (hdesc_param == nullptr)
+                    dpi_get_stmt_attr(hStatement, DSQL_ATTR_IMP_PARAM_DESC,
+                                      (dpointer)&hdesc_param, 0, &val_len);
+                rt = dpi_get_desc_field(hdesc_param, (sdint2)(i + 1),
+                                        DSQL_DESC_OBJ_DESCRIPTOR, &hObjDesc,
+                                        sizeof(dhobjdesc), NULL);
+                if (DSQL_SUCCEEDED(rt))
+                    rt = dpi_alloc_obj((poConn->hCon), &sParam.hObj);
+                if (DSQL_SUCCEEDED(rt))
+                    rt = dpi_bind_obj_desc(sParam.hObj, hObjDesc);
+                if (!DSQL_SUCCEEDED(rt))
+                {
+                    CPLError(CE_Failure, CPLE_AppDefined,
+                             "failed to alloc geometry parameter");
+                    return CE_Failure;
+                }
+            }
+            if (!bNull)
+            {
+                rt = dpi_set_obj_val(sParam.hObj, 1, DSQL_C_BINARY,
+                                     sParam.pabyGser,
+                                     static_cast<udint4>(sParam.nGserSize));
+                if (!DSQL_SUCCEEDED(rt))
+                {
+                    CPLError(CE_Failure, CPLE_AppDefined,
+                             "failed to set obj val");
+                    return CE_Failure;
+                }
+                pnInd = nullptr;
+            }
+            pBuffer = &sParam.hObj;
+            nBufLen = sizeof(dhobj);
+            nSQLType = DSQL_CLASS;
+        }
+        else
         {
-            CPLFree(insert_geovalues[iparam][num]);
+            pBuffer = (dpointer)sParam.osValue.c_str();
+            nBufLen = (slength)sParam.osValue.size() + 1;
+            nPrec = std::max<ulength>(1, sParam.osValue.size());
+            if (!bNull)
+                sParam.nInd = (slength)sParam.osValue.size();
         }
-    }
+        if (bNull)
+            sParam.nInd = DSQL_NULL_DATA;
+        else if (sParam.nCType == DSQL_C_CLASS)
+            m_nBoundBytes += static_cast<GIntBig>(sParam.nGserSize);
+        else
+            m_nBoundBytes += static_cast<GIntBig>(nBufLen);
 
+        rt = dpi_bind_param(hStatement, (udint2)(i + 1), DSQL_PARAM_INPUT,
+                            sParam.nCType, nSQLType, nPrec, 0, pBuffer,
+                            nBufLen, pnInd);
+        if (!DSQL_SUCCEEDED(rt))
+        {
+            CPLError(CE_Failure, CPLE_AppDefined, "failed to bind param");
+            return CE_Failure;
+        }
+    }
     return CE_None;
 }
 
-CPLErr OGRDAMENGStatement::ExecuteInsert(const char *pszSQLStatement, int nMode)
-{
-    DPIRETURN rt;
-
-    rt = dpi_alloc_stmt((poConn->hCon), &hStatement);
-    if (!DSQL_SUCCEEDED(rt))
-    {
-        CPLError(CE_Failure, CPLE_AppDefined,
-                 "failed to alloc statement");
-        return CE_Failure;
-    }
-    rt = dpi_exec_direct(hStatement, (sdbyte *)pszSQLStatement);
-    if (!DSQL_SUCCEEDED(rt))
-    {
-        CPLError(CE_Failure, CPLE_AppDefined,
-                 "failed to exectue");
-        return CE_Failure;
-    }
+/************************************************************************/
+/*                          FreeParamObjects()                          */
+/*                                                                      */
+/*      Free the objects of the geometry parameters, which belong to    */
+/*      the statement handle they were bound to.                        */
+/************************************************************************/
 
-    sdint8 row_count;
-    rt = dpi_row_count(hStatement, &row_count);
-    if (!DSQL_SUCCEEDED(rt))
+void OGRDAMENGStatement::FreeParamObjects()
+{
+    for (auto &sParam : m_aoParams)
     {
-        CPLError(CE_Failure, CPLE_AppDefined,
-                 "failed to get row_count");
-        return CE_Failure;
+        if (sParam.hObj != nullptr)
+            dpi_free_obj(sParam.hObj);
+        sParam.hObj = nullptr;
     }
-    return CE_None;
 }
 
 CPLErr OGRDAMENGStatement::Execute(const char *pszSQLStatement, int nMode)
@@ -605,6 +1080,12 @@ CPLErr OGRDAMENGStatement::Execute(const char *pszSQLStatement, int nMode)
         if (eErr != CE_None)
             return eErr;
     }
+    else if (hStatement != nullptr)
+    {
+        // Running the prepared statement again, with new parameters.
+        FreeResults();
+        dpi_close_cursor(hStatement);
+    }
 
     if (hStatement == nullptr)
     {
@@ -613,6 +1094,9 @@ CPLErr OGRDAMENGStatement::Execute(const char *pszSQLStatement, int nMode)
         return CE_Failure;
     }
 
+    if (BindParams() != CE_None)
+        return CE_Failure;
+
     sdint2 column_count;
     rt = dpi_number_columns(hStatement, &column_count);
     if (!DSQL_SUCCEEDED(rt))
@@ -630,9 +1114,11 @@ CPLErr OGRDAMENGStatement::Execute(const char *pszSQLStatement, int nMode)
 
     int bSelect = (nStmtType == DSQL_DIAG_FUNC_CODE_SELECT);
 
+    OGRDAMENGStatsTimer oTimer(m_poStats, OGRDAMENGStats::EXECUTE);
     rt = dpi_exec(hStatement);
     if (!DSQL_SUCCEEDED(rt))
     {
+        oTimer.Stop(0, m_nBoundBytes);
         CPLError(CE_Failure, CPLE_AppDefined,
                  "failed to exectue");
         return CE_Failure;
@@ -642,6 +1128,8 @@ CPLErr OGRDAMENGStatement::Execute(const char *pszSQLStatement, int nMode)
     {
         sdint8 row_count;
         rt = dpi_row_count(hStatement, &row_count);
+        oTimer.Stop(DSQL_SUCCEEDED(rt) ? static_cast<GIntBig>(row_count) : 0,
+                    m_nBoundBytes);
         if (!DSQL_SUCCEEDED(rt))
         {
             CPLError(CE_Failure, CPLE_AppDefined,
@@ -650,6 +1138,7 @@ CPLErr OGRDAMENGStatement::Execute(const char *pszSQLStatement, int nMode)
         }
         return CE_None;
     }
+    oTimer.Stop(0, m_nBoundBytes);
 
     nRawColumnCount = column_count;
     object_index = (int *)CPLCalloc(sizeof(int), column_count);
@@ -767,7 +1256,62 @@ CPLErr OGRDAMENGStatement::Execute(const char *pszSQLStatement, int nMode)
     return CE_None;
 }
 
-CPLErr OGRDAMENGStatement::Excute_for_fetchmany(const char *pszSQLStatement)
+/************************************************************************/
+/*                        DMFixedColumnCType()                          */
+/*                                                                      */
+/*      C type a fixed size column is fetched as, or 0 if the column    */
+/*      is fetched as a string image.                                   */
+/************************************************************************/
+
+static sdint2 DMFixedColumnCType(sdint2 nSQLType, int *pnEltSize)
+{
+    switch (nSQLType)
+    {
+        case DSQL_TINYINT:
+        case DSQL_SMALLINT:
+        case DSQL_INT:
+            *pnEltSize = (int)sizeof(sdint4);
+            return DSQL_C_SLONG;
+        case DSQL_BIGINT:
+            *pnEltSize = (int)sizeof(sdint8);
+            return DSQL_C_SBIGINT;
+        case DSQL_FLOAT:
+        case DSQL_DOUBLE:
+            *pnEltSize = (int)sizeof(double);
+            return DSQL_C_DOUBLE;
+        case DSQL_DATE:
+        case DSQL_TIMESTAMP:
+            *pnEltSize = (int)sizeof(dpi_timestamp_t);
+            return DSQL_C_TIMESTAMP;
+        default:
+            break;
+    }
+    *pnEltSize = 0;
+    return 0;
+}
+
+/************************************************************************/
+/*                       DMStringBufferWidth()                          */
+/************************************************************************/
+
+static int DMStringBufferWidth(const DmColDesc &coldesc)
+{
+    if (coldesc.prec > 0)
+        return (int)coldesc.display_size + 3 + 2;
+    return 256 + 2;
+}
+
+/************************************************************************/
+/*                       Excute_for_fetchmany()                         */
+/*                                                                      */
+/*      Execute a query and bind its columns to row arrays. The number  */
+/*      of rows fetched at once is derived from the estimated row       */
+/*      width and the fetch memory budget of the connection, and is     */
+/*      capped by nMaxRows when the caller knows it needs only a few.   */
+/************************************************************************/
+
+CPLErr OGRDAMENGStatement::Excute_for_fetchmany(const char *pszSQLStatement,
+                                                int nMaxRows)
 {
     DPIRETURN rt;
 
@@ -777,6 +1321,12 @@ CPLErr OGRDAMENGStatement::Excute_for_fetchmany(const char *pszSQLStatement)
         if (eErr != CE_None)
             return eErr;
     }
+    else if (hStatement != nullptr)
+    {
+        // Running the prepared statement again, with new parameters.
+        FreeResults();
+        dpi_close_cursor(hStatement);
+    }
 
     if (hStatement == nullptr)
     {
@@ -785,6 +1335,9 @@ CPLErr OGRDAMENGStatement::Excute_for_fetchmany(const char *pszSQLStatement)
         return CE_Failure;
     }
 
+    if (BindParams() != CE_None)
+        return CE_Failure;
+
     sdint2 column_count;
     rt = dpi_number_columns(hStatement, &column_count);
     if (!DSQL_SUCCEEDED(rt))
@@ -794,8 +1347,6 @@ CPLErr OGRDAMENGStatement::Excute_for_fetchmany(const char *pszSQLStatement)
         return CE_Failure;
     }
 
-    rt = dpi_set_stmt_attr(hStatement, DSQL_ATTR_ROW_ARRAY_SIZE,
-                           (void *)fetchnum, 0);
     sdint4 nStmtType;
     slength len;
     rt = dpi_set_stmt_attr(hStatement, DSQL_ATTR_CURSOR_TYPE,
@@ -806,9 +1357,11 @@ CPLErr OGRDAMENGStatement::Excute_for_fetchmany(const char *pszSQLStatement)
 
     int bSelect = (nStmtType == DSQL_DIAG_FUNC_CODE_SELECT);
 
+    OGRDAMENGStatsTimer oTimer(m_poStats, OGRDAMENGStats::EXECUTE);
     rt = dpi_exec(hStatement);
     if (!DSQL_SUCCEEDED(rt))
     {
+        oTimer.Stop(0, m_nBoundBytes);
         CPLError(CE_Failure, CPLE_AppDefined,
                  "failed to exectue");
         return CE_Failure;
@@ -818,6 +1371,8 @@ CPLErr OGRDAMENGStatement::Excute_for_fetchmany(const char *pszSQLStatement)
     {
         sdint8 row_count;
         rt = dpi_row_count(hStatement, &row_count);
+        oTimer.Stop(DSQL_SUCCEEDED(rt) ? static_cast<GIntBig>(row_count) : 0,
+                    m_nBoundBytes);
         if (!DSQL_SUCCEEDED(rt))
         {
             CPLError(CE_Failure, CPLE_AppDefined,
@@ -826,25 +1381,13 @@ CPLErr OGRDAMENGStatement::Excute_for_fetchmany(const char *pszSQLStatement)
         }
         return CE_None;
     }
+    oTimer.Stop(0, m_nBoundBytes);
     is_fectmany = 1;
     nRawColumnCount = column_count;
     object_index = (int *)CPLCalloc(sizeof(int), column_count);
     lob_index = (int *)CPLCalloc(sizeof(int), column_count);
-    results = (char ***)CPLCalloc(sizeof(char **), column_count + 1);
-    lobs = (dhloblctr **)CPLCalloc(sizeof(dhloblctr *), column_count);
-    objs = (dhobj **)CPLCalloc(sizeof(dhobj *), column_count);
-    blob_lens = (int **)CPLCalloc(sizeof(int *), column_count);
-    col_len = (slength**)CPLCalloc(sizeof(slength*), column_count + 1);
-    objdescs = (dhobjdesc **)CPLCalloc(sizeof(dhobjdesc *), column_count);
-    for (int i = 0; i < column_count; i++)
-    {
-        results[i] = (char **)CPLCalloc(sizeof(char *), fetchnum);
-        col_len[i] = (slength*)CPLCalloc(sizeof(slength), fetchnum);
-        blob_lens[i] = (int *)CPLCalloc(sizeof(int), fetchnum);
-        lobs[i] = (dhloblctr *)CPLCalloc(sizeof(dhloblctr), fetchnum);
-        objs[i] = (dhobj *)CPLCalloc(sizeof(dhobj), fetchnum);
-        objdescs[i] = (dhobjdesc *)CPLCalloc(sizeof(dhobjdesc), fetchnum);
-    }
+    coldescs = (DmColDesc *)CPLCalloc(sizeof(DmColDesc), column_count);
+    col_ctypes = (sdint2 *)CPLCalloc(sizeof(sdint2), column_count);
 
     dhdesc hdesc_col;
     sdint4 val_len;
@@ -857,9 +1400,14 @@ CPLErr OGRDAMENGStatement::Excute_for_fetchmany(const char *pszSQLStatement)
         return CE_Failure;
     }
 
+    /* -------------------------------------------------------------------- */
+    /*      Describe the columns and estimate how many bytes one row        */
+    /*      takes in the bound arrays, to size them from the budget.       */
+    /* -------------------------------------------------------------------- */
+    size_t nRowWidth = 0;
     for (int iParam = 0; iParam < nRawColumnCount; iParam++)
     {
-        DmColDesc coldesc;
+        DmColDesc &coldesc = coldescs[iParam];
         rt = dpi_desc_column(hStatement, (sdint2)iParam + 1, coldesc.name,
                              sizeof(coldesc.name), &coldesc.nameLen,
                              &coldesc.sql_type, &coldesc.prec, &coldesc.scale,
@@ -871,8 +1419,110 @@ CPLErr OGRDAMENGStatement::Excute_for_fetchmany(const char *pszSQLStatement)
             return CE_Failure;
         }
 
+        nRowWidth += sizeof(slength) + 2 * sizeof(char *);
+        int nEltSize = 0;
+        if (coldesc.sql_type == DSQL_CLASS)
+        {
+            nRowWidth += sizeof(dhobj) + DAMENG_OBJ_SLOT_SIZE;
+        }
+        else if (coldesc.sql_type == DSQL_BLOB ||
+                 coldesc.sql_type == DSQL_CLOB)
+        {
+            // LOB values are read into buffers of their own size, assume
+            // they are about as large as a geometry.
+            nRowWidth +=
+                sizeof(dhloblctr) + sizeof(int) + DAMENG_OBJ_SLOT_SIZE;
+        }
+        else if (DMFixedColumnCType(coldesc.sql_type, &nEltSize) != 0)
+        {
+            nRowWidth += nEltSize;
+        }
+        else
+        {
+            rt = dpi_get_desc_field(
+                hdesc_col, (sdint2)iParam + 1, DSQL_DESC_DISPLAY_SIZE,
+                (dpointer)&coldesc.display_size, 0, &val_len);
+            if (!DSQL_SUCCEEDED(rt))
+            {
+                CPLError(CE_Failure, CPLE_AppDefined,
+                         "failed to get col display_size");
+                return CE_Failure;
+            }
+            nRowWidth += DMStringBufferWidth(coldesc);
+        }
+    }
+
+    nFetchSize = (int)std::min<size_t>(
+        fetchnum, poConn->nFetchMemory / std::max<size_t>(nRowWidth, 1));
+    if (nMaxRows > 0)
+        nFetchSize = std::min(nFetchSize, nMaxRows);
+    nFetchSize = std::max(nFetchSize, 1);
+    CPLDebug("DAMENG", "Fetching %d rows of about %d bytes at once",
+             nFetchSize, (int)nRowWidth);
+
+    rt = dpi_set_stmt_attr(hStatement, DSQL_ATTR_ROW_ARRAY_SIZE,
+                           (dpointer)(size_t)nFetchSize, 0);
+    if (!DSQL_SUCCEEDED(rt))
+    {
+        CPLError(CE_Failure, CPLE_AppDefined,
+                 "failed to set row array size");
+        return CE_Failure;
+    }
+
+    return AllocFetchBuffers();
+}
+
+/************************************************************************/
+/*                          AllocFetchBuffers()                         */
+/*                                                                      */
+/*      Allocate the arrays a block of nFetchSize rows is read into,    */
+/*      and bind them to the columns. Value arrays come from the pool   */
+/*      of the connection so that re-running a query reuses them.       */
+/************************************************************************/
+
+CPLErr OGRDAMENGStatement::AllocFetchBuffers()
+{
+    DPIRETURN rt;
+    const int column_count = nRawColumnCount;
+
+    dhdesc hdesc_col;
+    sdint4 val_len;
+    rt = dpi_get_stmt_attr(hStatement, DSQL_ATTR_IMP_ROW_DESC,
+                           (dpointer)&hdesc_col, 0, &val_len);
+    if (!DSQL_SUCCEEDED(rt))
+    {
+        CPLError(CE_Failure, CPLE_AppDefined,
+                 "failed to get row_desc");
+        return CE_Failure;
+    }
+
+    results = (char ***)CPLCalloc(sizeof(char **), column_count + 1);
+    lobs = (dhloblctr **)CPLCalloc(sizeof(dhloblctr *), column_count);
+    objs = (dhobj **)CPLCalloc(sizeof(dhobj *), column_count);
+    blob_lens = (int **)CPLCalloc(sizeof(int *), column_count);
+    col_len = (slength**)CPLCalloc(sizeof(slength*), column_count + 1);
+    objdescs = (dhobjdesc **)CPLCalloc(sizeof(dhobjdesc *), column_count);
+    col_bufs = (char **)CPLCalloc(sizeof(char *), column_count);
+    col_buf_sizes = (size_t *)CPLCalloc(sizeof(size_t), column_count);
+    for (int i = 0; i < column_count; i++)
+    {
+        results[i] = (char **)CPLCalloc(sizeof(char *), nFetchSize);
+        col_len[i] = (slength*)CPLCalloc(sizeof(slength), nFetchSize);
+    }
+
+    for (int iParam = 0; iParam < nRawColumnCount; iParam++)
+    {
+        DmColDesc &coldesc = coldescs[iParam];
+        int nEltSize = 0;
+        const sdint2 nFixedCType =
+            DMFixedColumnCType(coldesc.sql_type, &nEltSize);
+
         if (coldesc.sql_type == DSQL_CLASS)
         {
+            objs[iParam] = (dhobj *)CPLCalloc(sizeof(dhobj), nFetchSize);
+            objdescs[iParam] =
+                (dhobjdesc *)CPLCalloc(sizeof(dhobjdesc), nFetchSize);
+            blob_lens[iParam] = (int *)CPLCalloc(sizeof(int), nFetchSize);
             rt = dpi_get_desc_field(
                 hdesc_col, (sdint2)iParam + 1, DSQL_DESC_OBJ_DESCRIPTOR,
                 &(objdescs[iParam][0]), sizeof(dhobjdesc), NULL);
@@ -882,7 +1532,7 @@ CPLErr OGRDAMENGStatement::Excute_for_fetchmany(const char *pszSQLStatement)
                          "failed to get object descriptor");
                 return CE_Failure;
             }
-            for (int i = 0; i < fetchnum; i++)
+            for (int i = 0; i < nFetchSize; i++)
             {
                 rt = dpi_alloc_obj((poConn->hCon), &(objs[iParam][i]));
 
@@ -902,15 +1552,21 @@ CPLErr OGRDAMENGStatement::Excute_for_fetchmany(const char *pszSQLStatement)
                 }
             }
 
-            rt = dpi_bind_col(hStatement, (udint2)iParam + 1, DSQL_C_CLASS,
-                              &objs[iParam][0], sizeof(objs[iParam][0]), &col_len[iParam][0]);
+            // Object values up to DAMENG_OBJ_SLOT_SIZE bytes are read into
+            // slots of a single block, see FetchBlock().
+            col_bufs[iParam] = (char *)poConn->AcquireFetchBuffer(
+                (size_t)nFetchSize * DAMENG_OBJ_SLOT_SIZE,
+                &col_buf_sizes[iParam]);
 
             object_index[iParam] = 1;
             lob_index[iParam] = 0;
+            col_ctypes[iParam] = DSQL_C_CLASS;
         }
         else if (coldesc.sql_type == DSQL_BLOB || coldesc.sql_type == DSQL_CLOB)
         {
-            for (int i = 0; i < fetchnum; i++)
+            lobs[iParam] = (dhloblctr *)CPLCalloc(sizeof(dhloblctr), nFetchSize);
+            blob_lens[iParam] = (int *)CPLCalloc(sizeof(int), nFetchSize);
+            for (int i = 0; i < nFetchSize; i++)
             {
                 rt = dpi_alloc_lob_locator(hStatement, &(lobs[iParam][i]));
                 if (!DSQL_SUCCEEDED(rt))
@@ -920,54 +1576,166 @@ CPLErr OGRDAMENGStatement::Excute_for_fetchmany(const char *pszSQLStatement)
                     return CE_Failure;
                 }
             }
-            rt = dpi_bind_col(hStatement, (udint2)iParam + 1, DSQL_C_LOB_HANDLE,
-                              &lobs[iParam][0], sizeof(lobs[iParam][0]), &col_len[iParam][0]);
             if (coldesc.sql_type == DSQL_BLOB)
                 lob_index[iParam] = 2;
             else
                 lob_index[iParam] = 1;
             object_index[iParam] = 0;
+            col_ctypes[iParam] = DSQL_C_LOB_HANDLE;
         }
         else
         {
-            rt = dpi_get_desc_field(
-                hdesc_col, (sdint2)iParam + 1, DSQL_DESC_DISPLAY_SIZE,
-                (dpointer)&coldesc.display_size, 0, &val_len);
-            if (!DSQL_SUCCEEDED(rt))
-            {
-                CPLError(CE_Failure, CPLE_AppDefined,
-                         "failed to get col display_size");
-                return CE_Failure;
-            }
-
-            int nbufwidth = 256;
-
-            if (coldesc.prec > 0)
-                nbufwidth = (int)coldesc.display_size + 3;
-            char *date = (char *)CPLMalloc((nbufwidth + 2) * fetchnum);
-            memset(date, 0, (nbufwidth + 2) * fetchnum);
-            for (int i = 0; i < fetchnum; i++)
-            {
-                //results[i][iParam] = (char*)CPLMalloc(nbufwidth + 2);
-                results[iParam][i] = date + i * (nbufwidth + 2);
-            }
-            rt = dpi_bind_col(
-                hStatement, (udint2)iParam + 1, DSQL_C_NCHAR,
-                (dpointer)results[iParam][0] /*results[0][iParam]*/,
-                nbufwidth + 2, &col_len[iParam][0]);
-            if (!DSQL_SUCCEEDED(rt))
-            {
-                CPLError(CE_Failure, CPLE_AppDefined,
-                         "failed to bind col");
-                return CE_Failure;
-            }
+            /* Fixed size types are fetched in their native representation, */
+            /* so that reading them does not go through a string image. */
+            const sdint2 nCType = nFixedCType != 0 ? nFixedCType
+                                                   : (sdint2)DSQL_C_NCHAR;
+            if (nFixedCType == 0)
+                nEltSize = DMStringBufferWidth(coldesc);
+
+            char *values = (char *)poConn->AcquireFetchBuffer(
+                (size_t)nEltSize * nFetchSize, &col_buf_sizes[iParam]);
+            col_bufs[iParam] = values;
+            for (int i = 0; i < nFetchSize; i++)
+                results[iParam][i] = values + (size_t)i * nEltSize;
             object_index[iParam] = 0;
             lob_index[iParam] = 0;
+            col_ctypes[iParam] = nCType;
+        }
+    }
+    return BindFetchBuffers();
+}
+
+/************************************************************************/
+/*                          BindFetchBuffers()                          */
+/*                                                                      */
+/*      Bind the current set of fetch buffers to the columns, so that   */
+/*      the next dpi_fetch() reads into them.                           */
+/************************************************************************/
+
+CPLErr OGRDAMENGStatement::BindFetchBuffers()
+{
+    for (int iParam = 0; iParam < nRawColumnCount; iParam++)
+    {
+        DPIRETURN rt;
+        if (object_index[iParam])
+        {
+            rt = dpi_bind_col(hStatement, (udint2)iParam + 1, DSQL_C_CLASS,
+                              &objs[iParam][0], sizeof(objs[iParam][0]),
+                              &col_len[iParam][0]);
+        }
+        else if (lob_index[iParam])
+        {
+            rt = dpi_bind_col(hStatement, (udint2)iParam + 1,
+                              DSQL_C_LOB_HANDLE, &lobs[iParam][0],
+                              sizeof(lobs[iParam][0]), &col_len[iParam][0]);
         }
+        else
+        {
+            int nEltSize = 0;
+            if (DMFixedColumnCType(coldescs[iParam].sql_type, &nEltSize) == 0)
+                nEltSize = DMStringBufferWidth(coldescs[iParam]);
+            rt = dpi_bind_col(hStatement, (udint2)iParam + 1,
+                              col_ctypes[iParam], (dpointer)col_bufs[iParam],
+                              nEltSize, &col_len[iParam][0]);
+        }
+        if (!DSQL_SUCCEEDED(rt))
+        {
+            CPLError(CE_Failure, CPLE_AppDefined,
+                     "failed to bind col");
+            return CE_Failure;
+        }
+    }
+    return CE_None;
+}
+
+/************************************************************************/
+/*                          SwapFetchBuffers()                          */
+/************************************************************************/
+
+void OGRDAMENGStatement::SwapFetchBuffers()
+{
+    std::swap(results, m_sSpareBuffers.results);
+    std::swap(col_len, m_sSpareBuffers.col_len);
+    std::swap(objs, m_sSpareBuffers.objs);
+    std::swap(objdescs, m_sSpareBuffers.objdescs);
+    std::swap(lobs, m_sSpareBuffers.lobs);
+    std::swap(blob_lens, m_sSpareBuffers.blob_lens);
+    std::swap(col_bufs, m_sSpareBuffers.col_bufs);
+    std::swap(col_buf_sizes, m_sSpareBuffers.col_buf_sizes);
+    std::swap(papszCurImages, m_sSpareBuffers.papszCurImages);
+}
+
+/************************************************************************/
+/*                           EnablePrefetch()                           */
+/*                                                                      */
+/*      Allocate the second set of buffers of the current result set,   */
+/*      and read its following blocks in the background. The fetches   */
+/*      run on the session of the statement while the caller decodes   */
+/*      the previous block, so nothing else may use that session        */
+/*      meanwhile.                                                      */
+/************************************************************************/
+
+CPLErr OGRDAMENGStatement::EnablePrefetch()
+{
+    if (is_fectmany == 0 || results == nullptr)
+        return CE_Failure;
+    if (m_poPrefetchQueue != nullptr)
+        return CE_None;
+
+    CPLWorkerThreadPool *poPool = GDALGetGlobalThreadPool(1);
+    if (poPool == nullptr)
+        return CE_Failure;
+
+    SwapFetchBuffers();
+    if (AllocFetchBuffers() != CE_None)
+    {
+        FreeFetchBuffers();
+        SwapFetchBuffers();
+        BindFetchBuffers();
+        return CE_Failure;
     }
+    m_poPrefetchQueue = poPool->CreateJobQueue();
     return CE_None;
 }
 
+/************************************************************************/
+/*                           CancelPrefetch()                           */
+/*                                                                      */
+/*      Wait for the block being fetched in the background, if any,     */
+/*      and drop it. The result set must be executed again before       */
+/*      reading further.                                                */
+/************************************************************************/
+
+void OGRDAMENGStatement::CancelPrefetch()
+{
+    if (!m_bPrefetchPending)
+        return;
+    m_poPrefetchQueue->WaitCompletion();
+    m_bPrefetchPending = false;
+    m_papapszPrefetched = nullptr;
+    m_nPrefetchedRows = 0;
+}
+
+/************************************************************************/
+/*                            FreeRowImage()                            */
+/*                                                                      */
+/*      Free the value read for an object or LOB row, unless it lives   */
+/*      in the pooled block of the column.                              */
+/************************************************************************/
+
+void OGRDAMENGStatement::FreeRowImage(int iCol, int iRow)
+{
+    char *pszImage = results[iCol][iRow];
+    results[iCol][iRow] = nullptr;
+    if (pszImage == nullptr)
+        return;
+    const char *pszBlock = col_bufs ? col_bufs[iCol] : nullptr;
+    if (pszBlock != nullptr && pszImage >= pszBlock &&
+        pszImage < pszBlock + col_buf_sizes[iCol])
+        return;
+    CPLFree(pszImage);
+}
+
 char **OGRDAMENGStatement::SimpleFetchRow()
 {
     int i;
@@ -977,7 +1745,11 @@ char **OGRDAMENGStatement::SimpleFetchRow()
         papszCurImage = (char **)CPLCalloc(sizeof(char *), nRawColumnCount + 1);
     }
     ulength rows;
-    rt = dpi_fetch(hStatement, &rows);
+    {
+        OGRDAMENGStatsTimer oTimer(m_poStats, OGRDAMENGStats::FETCH);
+        rt = dpi_fetch(hStatement, &rows);
+        oTimer.Stop(rt == DSQL_NO_DATA ? 0 : 1);
+    }
     if (rt == DSQL_NO_DATA)
         return nullptr;
 
@@ -990,24 +1762,187 @@ char **OGRDAMENGStatement::SimpleFetchRow()
     return papszCurImage;
 }
 
+/************************************************************************/
+/*                               ReadLob()                              */
+/*                                                                      */
+/*      Read the nLength bytes (characters for a CLOB) of a LOB into a  */
+/*      new buffer, NUL terminated, and its byte size into *pnRead.     */
+/*      Values above the LOB chunk size are read one chunk per call,    */
+/*      so that the client library does not stage the whole of them.    */
+/************************************************************************/
+
+char *OGRDAMENGStatement::ReadLob(dhloblctr hLob, bool bBinary,
+                                  slength nLength, slength *pnRead)
+{
+    const sdint2 nCType = bBinary ? DSQL_C_BINARY : DSQL_C_NCHAR;
+    const slength nChunk = static_cast<slength>(
+        std::min<size_t>(poConn->nLobChunkSize, INT_MAX));
+    DPIRETURN rt;
+    *pnRead = 0;
+
+    if (nLength <= nChunk)
+    {
+        char *pabyValue = (char *)CPLMalloc(nLength + 3);
+        rt = dpi_lob_read(hLob, 1, nCType, 0, pabyValue, nLength + 1, pnRead);
+        if (!DSQL_SUCCEEDED(rt))
+        {
+            CPLFree(pabyValue);
+            return nullptr;
+        }
+        return pabyValue;
+    }
+
+    // The length of a CLOB is in characters, and a character may take
+    // several bytes. The buffer holds one chunk at its widest plus one
+    // byte per remaining character, so that single byte text is read
+    // without reallocation, and grows only for wider characters.
+    const size_t nCharSize = bBinary ? 1 : 4;
+    size_t nAlloc = static_cast<size_t>(nLength) +
+                    static_cast<size_t>(nChunk) * (nCharSize - 1) + 3;
+    char *pabyValue = (char *)VSI_MALLOC_VERBOSE(nAlloc);
+    if (pabyValue == nullptr)
+        return nullptr;
+    size_t nDone = 0;
+    for (slength nPos = 1; nPos <= nLength; nPos += nChunk)
+    {
+        const slength nToRead = std::min(nChunk, nLength - nPos + 1);
+        const size_t nRoom =
+            static_cast<size_t>(nToRead) * nCharSize + 1 +
+            static_cast<size_t>(nLength - nPos + 1 - nToRead);
+        if (nDone + nRoom > nAlloc)
+        {
+            nAlloc = std::max(nDone + nRoom, nAlloc + nAlloc / 2);
+            char *pabyNew = (char *)VSI_REALLOC_VERBOSE(pabyValue, nAlloc);
+            if (pabyNew == nullptr)
+            {
+                CPLFree(pabyValue);
+                return nullptr;
+            }
+            pabyValue = pabyNew;
+        }
+        slength nGot = 0;
+        rt = dpi_lob_read(hLob, static_cast<ulength>(nPos), nCType, nToRead,
+                          pabyValue + nDone,
+                          static_cast<slength>(nAlloc - nDone), &nGot);
+        if (rt == DSQL_NO_DATA || (DSQL_SUCCEEDED(rt) && nGot <= 0))
+        {
+            CPLError(CE_Warning, CPLE_AppDefined,
+                     "LOB value truncated: " CPL_FRMT_GUIB " bytes read "
+                     "of a value of " CPL_FRMT_GIB " %s",
+                     static_cast<GUIntBig>(nDone),
+                     static_cast<GIntBig>(nLength),
+                     bBinary ? "bytes" : "characters");
+            break;
+        }
+        if (!DSQL_SUCCEEDED(rt))
+        {
+            CPLFree(pabyValue);
+            return nullptr;
+        }
+        nDone += static_cast<size_t>(nGot);
+    }
+    pabyValue[nDone] = '\0';
+    *pnRead = static_cast<slength>(nDone);
+    return pabyValue;
+}
+
+/************************************************************************/
+/*                           GetValueLength()                           */
+/*                                                                      */
+/*      Length in bytes of an object or BLOB value of a block returned  */
+/*      by Fetchmany(), which may be the one of the spare buffers when  */
+/*      prefetching. Returns 0 for other columns and NULL values.       */
+/************************************************************************/
+
+int OGRDAMENGStatement::GetValueLength(char ***papapszRows, int iCol,
+                                       int iRow) const
+{
+    int **panLengths = blob_lens;
+    if (papapszRows != nullptr &&
+        papapszRows == m_sSpareBuffers.papszCurImages)
+        panLengths = m_sSpareBuffers.blob_lens;
+    if (panLengths == nullptr || iCol < 0 || iCol >= nRawColumnCount ||
+        panLengths[iCol] == nullptr || iRow < 0 || iRow >= nFetchSize)
+        return 0;
+    return panLengths[iCol][iRow];
+}
+
+/************************************************************************/
+/*                             Fetchmany()                              */
+/*                                                                      */
+/*      Return the next block of rows of the result set, and their      */
+/*      number in *rows. When prefetching, the block was read by the    */
+/*      job submitted by the previous call, and the read of the next    */
+/*      one is submitted before returning.                              */
+/************************************************************************/
+
 char ***OGRDAMENGStatement::Fetchmany(ulength *rows)
+{
+    if (m_poPrefetchQueue == nullptr)
+        return FetchBlock(rows);
+
+    char ***papapszRows = nullptr;
+    if (m_bPrefetchPending)
+    {
+        m_poPrefetchQueue->WaitCompletion();
+        m_bPrefetchPending = false;
+        m_poPrefetchErrors->ReplayErrors();
+        papapszRows = m_papapszPrefetched;
+        *rows = m_nPrefetchedRows;
+    }
+    else
+    {
+        papapszRows = FetchBlock(rows);
+    }
+
+    // A short block is the last one.
+    if (papapszRows == nullptr || *rows < (ulength)nFetchSize)
+        return papapszRows;
+
+    // The caller reads the block from the spare set while the next one
+    // is fetched into the buffers it used until now.
+    SwapFetchBuffers();
+    if (BindFetchBuffers() != CE_None)
+        return papapszRows;
+
+    m_poPrefetchErrors = std::make_unique<CPLErrorAccumulator>();
+    m_bPrefetchPending = m_poPrefetchQueue->SubmitJob(
+        [this]()
+        {
+            auto oAccumulator = m_poPrefetchErrors->InstallForCurrentScope();
+            CPL_IGNORE_RET_VAL(oAccumulator);
+            m_papapszPrefetched = FetchBlock(&m_nPrefetchedRows);
+        });
+    return papapszRows;
+}
+
+/************************************************************************/
+/*                             FetchBlock()                             */
+/*                                                                      */
+/*      Fetch the next block of rows into the current set of buffers.   */
+/************************************************************************/
+
+char ***OGRDAMENGStatement::FetchBlock(ulength *rows)
 {
     DPIRETURN rt = 0;
     ulength row = 0;
+    GIntBig nBytes = 0;
 
+    // Object and LOB values are read from the server one by one, so they
+    // are timed with the fetch.
+    OGRDAMENGStatsTimer oTimer(m_poStats, OGRDAMENGStats::FETCH);
     rt = dpi_fetch(hStatement, &row);
     *rows = row;
     if (!DSQL_SUCCEEDED(rt))
         return nullptr;
 
-
     if (papszCurImages == nullptr)
     {
         papszCurImages =
             (char ***)CPLCalloc(sizeof(char **), nRawColumnCount + 1);
         for (int i = 0; i < nRawColumnCount; i++)
         {
-            papszCurImages[i] = (char **)CPLCalloc(sizeof(char *), fetchnum);
+            papszCurImages[i] = (char **)CPLCalloc(sizeof(char *), nFetchSize);
         }
     }
 
@@ -1017,7 +1952,11 @@ char ***OGRDAMENGStatement::Fetchmany(ulength *rows)
         {
             for (int num = 0; num < *rows; num++)
             {
-                papszCurImages[i][num] = results[i][num];
+                papszCurImages[i][num] = col_len[i][num] == DSQL_NULL_DATA
+                                             ? nullptr
+                                             : results[i][num];
+                if (col_len[i][num] > 0)
+                    nBytes += static_cast<GIntBig>(col_len[i][num]);
             }
         }
         else if (object_index[i] == 1)
@@ -1031,26 +1970,21 @@ char ***OGRDAMENGStatement::Fetchmany(ulength *rows)
                 {
                     CPLError(CE_Debug, CPLE_AppDefined,
                              "failed to get object len or object is empty");
-                    if (results[i][num])
-                    {
-                        CPLFree(results[i][num]);
-                    }
-                    results[i][num] = nullptr;
+                    FreeRowImage((int)i, num);
                     papszCurImages[i][num] = nullptr;
+                    blob_lens[i][num] = 0;
                     continue;
                 }
-                if (!results[i][num])
+                FreeRowImage((int)i, num);
+                if (real_len > DAMENG_OBJ_SLOT_SIZE)
                 {
-                    results[i][num] = (char *)CPLMalloc(1000);
-                }
-                if (real_len > 1000)
-                {
-                    CPLFree(results[i][num]);
                     results[i][num] = (char *)CPLMalloc(real_len);
                 }
                 else
                 {
-                    real_len = 1000;
+                    results[i][num] =
+                        col_bufs[i] + (size_t)num * DAMENG_OBJ_SLOT_SIZE;
+                    real_len = DAMENG_OBJ_SLOT_SIZE;
                 }
                 rt = dpi_get_obj_val((dhobj)objs[i][num], 1, DSQL_C_BINARY,
                                      results[i][num], (udint4)real_len,
@@ -1061,6 +1995,9 @@ char ***OGRDAMENGStatement::Fetchmany(ulength *rows)
                              "failed to get object value");
                     return nullptr;
                 }
+                nBytes += static_cast<GIntBig>(val_len);
+                // Only the bytes that fitted in the buffer are valid.
+                blob_lens[i][num] = (int)std::min(val_len, real_len);
                 papszCurImages[i][num] = results[i][num];
             }
         }
@@ -1074,41 +2011,28 @@ char ***OGRDAMENGStatement::Fetchmany(ulength *rows)
                 {
                     CPLError(CE_Debug, CPLE_AppDefined,
                              "failed to get lob len or lob is empty");
-                    if (results[i][num])
-                    {
-                        CPLFree(results[i][num]);
-                    }
-                    results[i][num] = nullptr;
+                    FreeRowImage((int)i, num);
                     papszCurImages[i][num] = nullptr;
                     continue;
                 }
-                if (results[i][num])
-                {
-                    CPLFree(results[i][num]);
-                }
-                char *objvalue = (char *)CPLMalloc(real_len + 3);
-                if (lob_index[i] == 2)
-                {
-                    rt = dpi_lob_read((dhloblctr)lobs[i][num], 1, DSQL_C_BINARY,
-                                      0, objvalue, real_len + 1, &val_len);
-                    blob_lens[i][num] = (int)val_len;
-                }
-                else
-                {
-                    rt = dpi_lob_read((dhloblctr)lobs[i][num], 1, DSQL_C_NCHAR,
-                                      0, objvalue, real_len + 1, &val_len);
-                }
-                if (!DSQL_SUCCEEDED(rt))
+                FreeRowImage((int)i, num);
+                char *objvalue = ReadLob((dhloblctr)lobs[i][num],
+                                         lob_index[i] == 2, real_len, &val_len);
+                if (objvalue == nullptr)
                 {
                     CPLError(CE_Failure, CPLE_AppDefined,
                              "failed to get object value");
                     return nullptr;
                 }
+                if (lob_index[i] == 2)
+                    blob_lens[i][num] = (int)val_len;
+                nBytes += static_cast<GIntBig>(val_len);
                 results[i][num] = objvalue;
                 papszCurImages[i][num] = results[i][num];
             }
         }
     }
 
+    oTimer.Stop(static_cast<GIntBig>(row), nBytes);
     return papszCurImages;
 }
@@ -27,7 +27,11 @@
  ****************************************************************************/
 
 #include "ogr_dameng.h"
+#include "ogr_swq.h"
 #include <ogr_p.h>
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
 #include <chrono>
 #include <condition_variable>
 #include <mutex>
@@ -139,6 +143,7 @@ OGRDAMENGTableLayer::OGRDAMENGTableLayer(OGRDAMENGDataSource* poDSIn,
         : nullptr)
 {
     poDS = poDSIn;
+    m_oStats.SetParent(poDS->GetStats());
     pszQueryStatement = nullptr;
 
     CPLString osDefnName;
@@ -165,6 +170,10 @@ OGRDAMENGTableLayer::OGRDAMENGTableLayer(OGRDAMENGDataSource* poDSIn,
     SetDescription(poFeatureDefn->GetName());
     poFeatureDefn->Reference();
 
+    m_nStatementCacheSize = static_cast<size_t>(std::max(
+        0, atoi(CPLGetConfigOption("DM_STMT_CACHE_SIZE",
+                                   CPLSPrintf("%d", DEFAULT_STMT_CACHE_SIZE)))));
+
     if (pszDescriptionIn != nullptr && !EQUAL(pszDescriptionIn, ""))
     {
         OGRLayer::SetMetadataItem("DESCRIPTION", pszDescriptionIn);
@@ -178,14 +187,24 @@ OGRDAMENGTableLayer::OGRDAMENGTableLayer(OGRDAMENGDataSource* poDSIn,
 OGRDAMENGTableLayer::~OGRDAMENGTableLayer()
 
 {
+    FlushPendingInserts();
+    if (InsertStatement)
+        delete InsertStatement;
+    m_poUpsertStatement.reset();
+    RunDeferredIndexCreation();
+    if (m_bDeferredIndexPending)
+    {
+        CPLError(CE_Warning, CPLE_AppDefined,
+            "Layer %s closed in a transaction: its geometry checks and "
+            "spatial indexes were not created", GetName());
+    }
+    ClearStatementCache();
     CPLFree(pszSqlTableName);
     CPLFree(pszTableName);
     CPLFree(pszSqlGeomParentTableName);
     CPLFree(pszSchemaName);
     CPLFree(m_pszTableDescription);
     CPLFree(pszGeomColForced);
-    if (InsertStatement)
-        delete InsertStatement;
     CSLDestroy(papszOverrideColumnTypes);
 }
 
@@ -371,114 +390,130 @@ int OGRDAMENGTableLayer::ReadTableDefinition()
         return bTableDefinitionValid;
     bTableDefinitionValid = FALSE;
 
-    /* -------------------------------------------------------------------- */
-    /*      Get the OID of the table.                                       */
-    /* -------------------------------------------------------------------- */
-
     CPLString osCommand;
     OGRDAMENGStatement oCommand(hDAMENGConn);
-    osCommand.Printf("SELECT id FROM SYSOBJECTS  "
-        "WHERE NAME = '%s' AND SCHID = ( "
-        "SELECT id FROM SYSOBJECTS WHERE TYPE$ = 'SCH' AND NAME = '%s')",
-        pszTableName, pszSchemaName);
-    CPLErr eErr = oCommand.Execute(osCommand);
-    if (eErr != CE_None)
+    CPLErr eErr = CE_None;
+    char** hResult = nullptr;
+
+    /* -------------------------------------------------------------------- */
+    /*      Take the columns loaded in bulk with the catalog if the table   */
+    /*      was part of it.                                                 */
+    /* -------------------------------------------------------------------- */
+    const DMCatalogTable* psCatalogTable =
+        poDS->GetCatalogTable(pszSchemaName, pszTableName);
+    std::vector<DMCatalogColumn> aoColumns;
+    if (psCatalogTable)
     {
-        CPLDebug("DM", "Could not Get the OID of the table %s",
-            pszTableName);
-        return FALSE;
+        aoColumns = psCatalogTable->aoColumns;
     }
-    unsigned int nTableOID = 0;
-    char** hResult = oCommand.SimpleFetchRow();
-
-    if (hResult)
+    else
     {
-        if (hResult[0])
+        /* ---------------------------------------------------------------- */
+        /*      Get the OID of the table.                                   */
+        /* ---------------------------------------------------------------- */
+        osCommand.Printf("SELECT id FROM SYSOBJECTS  "
+            "WHERE NAME = '%s' AND SCHID = ( "
+            "SELECT id FROM SYSOBJECTS WHERE TYPE$ = 'SCH' AND NAME = '%s')",
+            pszTableName, pszSchemaName);
+        eErr = oCommand.Execute(osCommand);
+        if (eErr != CE_None)
         {
-            nTableOID = static_cast<unsigned>(CPLAtoGIntBig(hResult[0]));
-            if (oCommand.SimpleFetchRow())
+            CPLDebug("DM", "Could not Get the OID of the table %s",
+                pszTableName);
+            return FALSE;
+        }
+        unsigned int nTableOID = 0;
+        hResult = oCommand.SimpleFetchRow();
+
+        if (hResult)
+        {
+            if (hResult[0])
             {
-                CPLDebug("DM", "Could not retrieve table oid for %s",
-                    pszTableName);
-                return FALSE;
+                nTableOID = static_cast<unsigned>(CPLAtoGIntBig(hResult[0]));
+                if (oCommand.SimpleFetchRow())
+                {
+                    CPLDebug("DM", "Could not retrieve table oid for %s",
+                        pszTableName);
+                    return FALSE;
+                }
             }
         }
+        else
+        {
+            return FALSE;
+        }
+
+        /* ---------------------------------------------------------------- */
+        /*      Fire off commands to get back the columns of the table.     */
+        /* ---------------------------------------------------------------- */
+        osCommand.Printf(
+            "SELECT c.NAME, c.TYPE$, c.NULLABLE$, c.DEFVAL "
+            "FROM SYSCOLUMNS c "
+            "WHERE c.ID = %u "
+            "ORDER BY c.COLID",
+            nTableOID);
+
+        eErr = oCommand.Execute(osCommand);
+        hResult = eErr == CE_None ? oCommand.SimpleFetchRow() : nullptr;
+        for (; hResult; hResult = oCommand.SimpleFetchRow())
+        {
+            DMCatalogColumn oColumn;
+            oColumn.osName = hResult[0] ? hResult[0] : "";
+            oColumn.osType = hResult[1] ? hResult[1] : "";
+            oColumn.bNullable = !(hResult[2] && EQUAL(hResult[2], "Y"));
+            oColumn.bHasDefault = hResult[3] != nullptr;
+            oColumn.osDefault = hResult[3] ? hResult[3] : "";
+            aoColumns.push_back(oColumn);
+        }
     }
-    else
+    if (aoColumns.empty())
     {
-        return FALSE;
+        CPLError(CE_Failure, CPLE_AppDefined,
+            "Fire off commands to get back the columns of the table "
+            "Failed!");
+        return bTableDefinitionValid;
     }
 
     /* -------------------------------------------------------------------- */
-    /*      Identify the integer primary key.                               */
+    /*      Identify the integer primary key: the first integer column.    */
     /* -------------------------------------------------------------------- */
-
-    const char* pszTypnameEqualAnyClause =
-        "ANY('INT', 'BIGINT', 'SMALLINT', 'INTEGER')";
-
-    osCommand.Printf("SELECT c.NAME, c.COLID, c.TYPE$ "
-        "FROM SYSCOLUMNS c "
-        "JOIN SYSOBJECTS o ON o.ID = c.ID "
-        "WHERE c.ID = %u AND c.TYPE$ = %s "
-        "ORDER BY c.COLID",
-        nTableOID, pszTypnameEqualAnyClause);
-
-    eErr = oCommand.Execute(osCommand);
-    hResult = oCommand.SimpleFetchRow();
-
-    if (hResult)
+    int nIntegerColumns = 0;
+    for (const auto& oColumn : aoColumns)
     {
-        if (hResult[0])
+        if (!EQUAL(oColumn.osType, "INT") && !EQUAL(oColumn.osType, "BIGINT") &&
+            !EQUAL(oColumn.osType, "SMALLINT") &&
+            !EQUAL(oColumn.osType, "INTEGER"))
+            continue;
+        if (nIntegerColumns++ == 0)
         {
-            osPrimaryKey.Printf("%s", hResult[0]);
-            const char* pszFIDType = hResult[2];
+            osPrimaryKey = oColumn.osName;
             CPLDebug("DM", "Primary key name (FID): %s, type : %s",
-                osPrimaryKey.c_str(), pszFIDType);
-            if (oCommand.SimpleFetchRow())
-                CPLError(CE_Warning, CPLE_AppDefined,
-                    "Multi-column primary key in \'%s\' detected but not "
-                    "supported.",
-                    pszTableName);
+                osPrimaryKey.c_str(), oColumn.osType.c_str());
+        }
+        else if (nIntegerColumns == 2)
+        {
+            CPLError(CE_Warning, CPLE_AppDefined,
+                "Multi-column primary key in \'%s\' detected but not "
+                "supported.",
+                pszTableName);
         }
     }
-    else
+    if (nIntegerColumns == 0)
     {
         CPLError(CE_Failure, CPLE_AppDefined,
             "Identify the integer primary key Failed");
     }
 
-    /* -------------------------------------------------------------------- */
-    /*      Fire off commands to get back the columns of the table.         */
-    /* -------------------------------------------------------------------- */
-    osCommand.Printf(
-        "SELECT c.NAME, c.TYPE$, c.NULLABLE$, c.DEFVAL, i.UNIQUENESS "
-        "FROM SYSCOLUMNS c "
-        "JOIN SYSOBJECTS o ON o.ID = c.ID "
-        "LEFT JOIN "
-        "USER_INDEXES i ON i.TABLE_NAME = c.NAME "
-        "WHERE c.ID = %u "
-        "ORDER BY c.COLID",
-        nTableOID);
-
-    eErr = oCommand.Execute(osCommand);
-    hResult = oCommand.SimpleFetchRow();
-    if (!hResult || eErr != CE_None)
-    {
-        CPLError(CE_Failure, CPLE_AppDefined,
-            "Fire off commands to get back the columns of the table "
-            "Failed!");
-        return bTableDefinitionValid;
-    }
-
     /* -------------------------------------------------------------------- */
     /*      Parse the returned table information.                           */
     /* -------------------------------------------------------------------- */
     int typid = 0;
-    for (int iRecord = 0; hResult; iRecord++)
+    for (const auto& oColumn : aoColumns)
     {
-        OGRFieldDefn oField(hResult[0], OFTString);
-        const char* type = hResult[1];
-        typid = atoi(type + 5);
+        OGRFieldDefn oField(oColumn.osName, OFTString);
+        const char* type = oColumn.osType.c_str();
+        /* Object types are CLASSnnn */
+        typid = strlen(type) > 5 ? atoi(type + 5) : 0;
         const char* pszType;
         if (typid >= NDCT_CLSID_GEO2_ST_GEOMETRY &&
             typid <= NDCT_CLSID_GEO2_ST_TIN)
@@ -487,20 +522,16 @@ int OGRDAMENGTableLayer::ReadTableDefinition()
             pszType = "geography";
         else
             pszType = type;
-        const char* pszNotNull = hResult[2];
-        const char* pszDefault = hResult[3];
-        const char* pszIsUnique = hResult[4] ? nullptr : hResult[4];
-        if (pszNotNull && EQUAL(pszNotNull, "Y"))
+        const char* pszDefault =
+            oColumn.bHasDefault ? oColumn.osDefault.c_str() : nullptr;
+        if (!oColumn.bNullable)
             oField.SetNullable(FALSE);
-        if (pszIsUnique && EQUAL(pszIsUnique, "UNIQUE"))
-            oField.SetUnique(TRUE);
 
         if (EQUAL(oField.GetNameRef(), osPrimaryKey))
         {
             pszFIDColumn = CPLStrdup(oField.GetNameRef());
             CPLDebug("DM", "Using column '%s' as FID for table '%s'",
                 pszFIDColumn, pszTableName);
-            hResult = oCommand.SimpleFetchRow();
             continue;
         }
         else if (EQUAL(pszType, "geometry") || EQUAL(pszType, "geography"))
@@ -539,7 +570,6 @@ int OGRDAMENGTableLayer::ReadTableDefinition()
                     InitGeomField(poGeomFieldDefn);
                 }
             }
-            hResult = oCommand.SimpleFetchRow();
             continue;
         }
 
@@ -547,7 +577,6 @@ int OGRDAMENGTableLayer::ReadTableDefinition()
             oField.SetDefault(pszDefault);
 
         poFeatureDefn->AddFieldDefn(&oField);
-        hResult = oCommand.SimpleFetchRow();
     }
     bTableDefinitionValid = TRUE;
 
@@ -573,30 +602,64 @@ int OGRDAMENGTableLayer::ReadTableDefinition()
         const bool bHasGeometry =
             (poGeomFieldDefn->eDAMENGGeoType == GEOM_TYPE_GEOMETRY);
 
+        /* Description from the catalog loaded in bulk, if any */
+        const DMCatalogGeomColumn* psCatalogGeom = nullptr;
+        for (size_t i = 0; psCatalogTable &&
+                           i < psCatalogTable->aoGeomColumns.size(); i++)
+        {
+            const auto& oGeomColumn = psCatalogTable->aoGeomColumns[i];
+            if (oGeomColumn.bGeography == !bHasGeometry &&
+                EQUAL(oGeomColumn.osName, poGeomFieldDefn->GetNameRef()))
+                psCatalogGeom = &oGeomColumn;
+        }
+
         while (bGoOn)
         {
             eErr = CheckINI(&checkINI);
-            osCommand.Printf("SELECT type, coord_dimension, srid FROM %s WHERE "
-                "f_table_name = '%s'",
-                (bHasGeometry) ? "sysgeo2.geometry_columns"
-                : "sysgeo2.geography_columns",
-                pszTableName);
+            CPLString osGeomType;
+            int dim = 0;
+            int nSRSId = 0;
+            bool bFound = false;
+            if (psCatalogGeom)
+            {
+                osGeomType = psCatalogGeom->osGeomType;
+                dim = psCatalogGeom->nCoordDimension;
+                nSRSId = psCatalogGeom->nSRID;
+                bFound = true;
+            }
+            else
+            {
+                osCommand.Printf("SELECT type, coord_dimension, srid FROM %s WHERE "
+                    "f_table_name = '%s'",
+                    (bHasGeometry) ? "sysgeo2.geometry_columns"
+                    : "sysgeo2.geography_columns",
+                    pszTableName);
 
-            osCommand += CPLString().Printf(
-                " AND %s='%s'",
-                (bHasGeometry) ? "f_geometry_column" : "f_geography_column",
-                poGeomFieldDefn->GetNameRef());
+                osCommand += CPLString().Printf(
+                    " AND %s='%s'",
+                    (bHasGeometry) ? "f_geometry_column" : "f_geography_column",
+                    poGeomFieldDefn->GetNameRef());
 
-            osCommand +=
-                CPLString().Printf(" AND f_table_schema = '%s'", pszSchemaName);
+                osCommand +=
+                    CPLString().Printf(" AND f_table_schema = '%s'", pszSchemaName);
 
-            eErr = oCommand.Execute(osCommand);
-            hResult = oCommand.SimpleFetchRow();
+                eErr = oCommand.Execute(osCommand);
+                hResult = oCommand.SimpleFetchRow();
+                if (hResult && hResult[0] && !oCommand.SimpleFetchRow())
+                {
+                    osGeomType = hResult[0];
+                    dim = atoi(hResult[1]);
+                    nSRSId = atoi(hResult[2]);
+                    bFound = true;
+                }
+            }
 
-            if (hResult && hResult[0] && !oCommand.SimpleFetchRow())
+            if (bFound)
             {
-                const char* pszType = hResult[0] + 3;
-                int dim = atoi(hResult[1]);
+                /* Strip the ST_ prefix */
+                const char* pszType = osGeomType.size() > 3
+                                          ? osGeomType.c_str() + 3
+                                          : "GEOMETRY";
                 bool bHasM = pszType[strlen(pszType) - 1] == 'M';
                 int GeometryTypeFlags = 0;
                 if (dim == 3)
@@ -610,10 +673,13 @@ int OGRDAMENGTableLayer::ReadTableDefinition()
                     GeometryTypeFlags |=
                     OGRGeometry::OGR_G_3D | OGRGeometry::OGR_G_MEASURED;
 
-                int nSRSId = atoi(hResult[2]);
-
                 poGeomFieldDefn->GeometryTypeFlags = GeometryTypeFlags;
-                if (nSRSId == 0)
+                if (nSRSId == 0 && psCatalogGeom)
+                {
+                    /* Probed from the values by ResolveSRID() when needed */
+                    nSRSId = UNDETERMINED_SRID;
+                }
+                else if (nSRSId == 0)
                 {
                     osCommand.Printf("SELECT DMGEO2.ST_SRID(\"%s\") FROM \"%s\".\"%s\" LIMIT 1",
                         poGeomFieldDefn->GetNameRef(), pszSchemaName, pszTableName);
@@ -750,6 +816,7 @@ void OGRDAMENGTableLayer::BuildWhere()
 
 {
     osWHERE = "";
+    m_adfQueryParams.clear();
     OGRDAMENGGeomFieldDefn* poGeomFieldDefn = nullptr;
     if (poFeatureDefn->GetGeomFieldCount() != 0)
         poGeomFieldDefn =
@@ -759,51 +826,8 @@ void OGRDAMENGTableLayer::BuildWhere()
         (poGeomFieldDefn->eDAMENGGeoType == GEOM_TYPE_GEOMETRY ||
             poGeomFieldDefn->eDAMENGGeoType == GEOM_TYPE_GEOGRAPHY))
     {
-        char szBox3D_1[128];
-        char szBox3D_2[128];
-        char szBox3D_3[128];
-        char szBox3D_4[128];
-        OGREnvelope sEnvelope;
-        constexpr double NEG_INF = -std::numeric_limits<double>::infinity();
-        constexpr double POS_INF = std::numeric_limits<double>::infinity();
-
-        m_poFilterGeom->getEnvelope(&sEnvelope);
-        if (poGeomFieldDefn->eDAMENGGeoType == GEOM_TYPE_GEOGRAPHY)
-        {
-            if (sEnvelope.MinX < -180.0)
-                sEnvelope.MinX = -180.0;
-            if (sEnvelope.MinY < -90.0)
-                sEnvelope.MinY = -90.0;
-            if (sEnvelope.MaxX > 180.0)
-                sEnvelope.MaxX = 180.0;
-            if (sEnvelope.MaxY > 90.0)
-                sEnvelope.MaxY = 90.0;
-        }
-        if (sEnvelope.MinX == NEG_INF)
-        {
-            sEnvelope.MinX = -DBL_MAX;
-            sEnvelope.MinY = -DBL_MAX;
-        }
-        if (sEnvelope.MaxX == POS_INF)
-        {
-            sEnvelope.MaxX = DBL_MAX;
-            sEnvelope.MaxY = DBL_MAX;
-        }
-
-        CPLsnprintf(szBox3D_1, sizeof(szBox3D_1), "%.18g %.18g", sEnvelope.MinX,
-            sEnvelope.MinY);
-        CPLsnprintf(szBox3D_2, sizeof(szBox3D_2), "%.18g %.18g", sEnvelope.MinX,
-            sEnvelope.MaxY);
-        CPLsnprintf(szBox3D_3, sizeof(szBox3D_2), "%.18g %.18g", sEnvelope.MaxX,
-            sEnvelope.MaxY);
-        CPLsnprintf(szBox3D_4, sizeof(szBox3D_1), "%.18g %.18g", sEnvelope.MaxX,
-            sEnvelope.MinY);
-        if (poGeomFieldDefn->nSRSId < 0)
-            poGeomFieldDefn->nSRSId = 0;
-        osWHERE.Printf("WHERE DMGEO2.ST_CoveredBy"
-            "(%s, DMGEO2.ST_GEOMFROMTEXT('SRID=%d;POLYGON((%s, %s, %s, %s, %s))')) ",
-            OGRDAMENGEscapeColumnName(poGeomFieldDefn->GetNameRef()).c_str(), poGeomFieldDefn->nSRSId,
-            szBox3D_1, szBox3D_2, szBox3D_3, szBox3D_4, szBox3D_1);
+        osWHERE.Printf("WHERE %s ",
+                       BuildSpatialPredicate(poGeomFieldDefn).c_str());
     }
 
     if (!osQuery.empty())
@@ -823,6 +847,9 @@ void OGRDAMENGTableLayer::BuildWhere()
 
 /************************************************************************/
 /*                      BuildFullQueryStatement()                       */
+/*                                                                      */
+/*      With a FID column, features are read in the FID order, which    */
+/*      is the one of the pages of SetNextByIndex().                    */
 /************************************************************************/
 
 void OGRDAMENGTableLayer::BuildFullQueryStatement()
@@ -831,17 +858,68 @@ void OGRDAMENGTableLayer::BuildFullQueryStatement()
     CPLString osFields = BuildFields();
     if (osFields == "")
         osFields = " * ";
+    CPLString osOrderBy;
+    if (pszFIDColumn != nullptr)
+        osOrderBy.Printf(" ORDER BY %s",
+            OGRDAMENGEscapeColumnName(pszFIDColumn).c_str());
     if (pszQueryStatement != nullptr)
     {
         CPLFree(pszQueryStatement);
         pszQueryStatement = nullptr;
     }
-    pszQueryStatement = static_cast<char*>(CPLMalloc(
-        osFields.size() + osWHERE.size() + strlen(pszSqlTableName) + 40));
-    snprintf(pszQueryStatement,
-        osFields.size() + osWHERE.size() + strlen(pszSqlTableName) + 40,
-        "SELECT %s FROM %s %s", osFields.c_str(), pszSqlTableName,
-        osWHERE.c_str());
+    const size_t nLen = osFields.size() + osWHERE.size() +
+        strlen(pszSqlTableName) + osOrderBy.size() + 40;
+    pszQueryStatement = static_cast<char*>(CPLMalloc(nLen));
+    snprintf(pszQueryStatement, nLen, "SELECT %s FROM %s %s%s",
+        osFields.c_str(), pszSqlTableName, osWHERE.c_str(),
+        osOrderBy.c_str());
+}
+
+/************************************************************************/
+/*                          BuildPagedQuery()                           */
+/*                                                                      */
+/*      With a FID column, pages follow the FID order and continue      */
+/*      from the last feature read by the previous page when possible   */
+/*      (keyset paging), so that the server does not skip all the       */
+/*      preceding rows again.                                           */
+/************************************************************************/
+
+CPLString OGRDAMENGTableLayer::BuildPagedQuery(GIntBig nIndex)
+
+{
+    if (pszFIDColumn == nullptr)
+        return OGRDAMENGLayer::BuildPagedQuery(nIndex);
+
+    if (m_osKeysetQuery != pszQueryStatement ||
+        m_adfKeysetParams != m_adfQueryParams)
+    {
+        m_osKeysetQuery = pszQueryStatement;
+        m_adfKeysetParams = m_adfQueryParams;
+        m_nKeysetIndex = -1;
+    }
+
+    CPLString osFields = BuildFields();
+    if (osFields == "")
+        osFields = " * ";
+    CPLString osWhereFID = osWHERE;
+    GIntBig nOffset = nIndex;
+    if (m_nKeysetIndex >= 0 && m_nKeysetIndex < nIndex)
+    {
+        osWhereFID += osWHERE.empty() ? "WHERE " : " AND ";
+        osWhereFID += CPLSPrintf(
+            "%s > " CPL_FRMT_GIB,
+            OGRDAMENGEscapeColumnName(pszFIDColumn).c_str(), m_nKeysetFID);
+        nOffset = nIndex - m_nKeysetIndex - 1;
+    }
+    m_bPagedByFID = true;
+
+    CPLString osCommand;
+    osCommand.Printf("SELECT %s FROM %s %s ORDER BY %s OFFSET " CPL_FRMT_GIB
+                     " ROWS",
+                     osFields.c_str(), pszSqlTableName, osWhereFID.c_str(),
+                     OGRDAMENGEscapeColumnName(pszFIDColumn).c_str(),
+                     nOffset);
+    return osCommand;
 }
 
 /************************************************************************/
@@ -855,6 +933,7 @@ void OGRDAMENGTableLayer::ResetReading()
         return;
     bInResetReading = TRUE;
 
+    FlushPendingInserts();
     BuildFullQueryStatement();
 
     OGRDAMENGLayer::ResetReading();
@@ -885,13 +964,18 @@ OGRFeature* OGRDAMENGTableLayer::GetNextFeature()
             return nullptr;
 
         /* We just have to look if there is a geometry filter */
-        /* If there's a geometry column, the spatial filter */
-        /* is already taken into account in the select request */
-        /* The attribute filter is always taken into account by the select request */
-        if (m_poFilterGeom == nullptr || poGeomFieldDefn == nullptr ||
-            poGeomFieldDefn->eDAMENGGeoType == GEOM_TYPE_GEOMETRY ||
-            poGeomFieldDefn->eDAMENGGeoType == GEOM_TYPE_GEOGRAPHY ||
-            FilterGeometry(poFeature->GetGeomFieldRef(m_iGeomFieldFilter)))
+        /* If there's a geometry column, the envelope of the spatial */
+        /* filter is already taken into account in the select request, */
+        /* which is exact when the filter is a rectangle */
+        /* The attribute filter is taken into account by the select request */
+        /* unless part of it could not be translated */
+        if ((m_poFilterGeom == nullptr || poGeomFieldDefn == nullptr ||
+             (m_bFilterIsEnvelope &&
+              (poGeomFieldDefn->eDAMENGGeoType == GEOM_TYPE_GEOMETRY ||
+               poGeomFieldDefn->eDAMENGGeoType == GEOM_TYPE_GEOGRAPHY)) ||
+             FilterGeometry(poFeature->GetGeomFieldRef(m_iGeomFieldFilter))) &&
+            (m_poAttrQuery == nullptr || !m_bFilterMustBeClientSideEvaluated ||
+             m_poAttrQuery->Evaluate(poFeature)))
         {
             if (iFIDAsRegularColumnIndex >= 0)
             {
@@ -905,6 +989,110 @@ OGRFeature* OGRDAMENGTableLayer::GetNextFeature()
     }
 }
 
+/************************************************************************/
+/*                         CreateParallelScan()                         */
+/*                                                                      */
+/*      Set up a parallel scan of the current query when requested by   */
+/*      the PARALLEL_SCAN open option. The FID range of the table is     */
+/*      cut into several ranges per session. Returns nullptr when the   */
+/*      layer must be read sequentially.                                */
+/************************************************************************/
+
+OGRDAMENGParallelScan* OGRDAMENGTableLayer::CreateParallelScan()
+
+{
+    const int nWorkers = poDS->GetParallelScanCount();
+    if (nWorkers < 2 || pszQueryStatement == nullptr)
+        return nullptr;
+
+    poFeatureDefn->GetFieldCount();
+    if (pszFIDColumn == nullptr)
+    {
+        CPLDebug("DAMENG", "%s has no FID column: no parallel scan.",
+            pszSqlTableName);
+        return nullptr;
+    }
+    // Other sessions do not see the changes of the current transaction.
+    if (poDS->GetDAMENGConn()->bInTransaction)
+    {
+        CPLDebug("DAMENG", "Transaction in progress: no parallel scan.");
+        return nullptr;
+    }
+
+    // Workers must not run catalog queries on the main session.
+    for (int i = 0; i < poFeatureDefn->GetGeomFieldCount(); i++)
+        poFeatureDefn->GetGeomFieldDefn(i)->GetSpatialRef();
+
+    const CPLString osFIDColumn = OGRDAMENGEscapeColumnName(pszFIDColumn);
+    CPLString osCommand;
+    osCommand.Printf("SELECT MIN(%s), MAX(%s) FROM %s", osFIDColumn.c_str(),
+        osFIDColumn.c_str(), pszSqlTableName);
+
+    GIntBig nMinFID = 0;
+    GIntBig nMaxFID = -1;
+    {
+        OGRDAMENGStatement oCommand(poDS->GetDAMENGConn());
+        if (oCommand.Execute(osCommand) != CE_None)
+            return nullptr;
+        char** papszRow = oCommand.SimpleFetchRow();
+        if (papszRow == nullptr || papszRow[0] == nullptr ||
+            papszRow[1] == nullptr || papszRow[0][0] == '\0')
+            return nullptr;
+        nMinFID = CPLAtoGIntBig(papszRow[0]);
+        nMaxFID = CPLAtoGIntBig(papszRow[1]);
+    }
+    if (nMaxFID < nMinFID)
+        return nullptr;
+
+    /* -------------------------------------------------------------------- */
+    /*      Query of one FID range. The parameters of osWHERE follow the    */
+    /*      bounds of the range.                                            */
+    /* -------------------------------------------------------------------- */
+    CPLString osFields = BuildFields();
+    if (osFields == "")
+        osFields = " * ";
+    CPLString osSQL;
+    osSQL.Printf("SELECT %s FROM %s WHERE %s BETWEEN ? AND ?",
+        osFields.c_str(), pszSqlTableName, osFIDColumn.c_str());
+    if (!osWHERE.empty())
+    {
+        osSQL += " AND (";
+        osSQL += osWHERE.substr(strlen("WHERE "));
+        osSQL += ")";
+    }
+    const bool bOrdered = poDS->IsParallelScanOrdered();
+    if (bOrdered)
+        osSQL += " ORDER BY " + osFIDColumn;
+
+    auto poScan = std::make_unique<OGRDAMENGParallelScan>(
+        this, osSQL, m_adfQueryParams, bOrdered);
+
+    const GUIntBig nSpan =
+        static_cast<GUIntBig>(nMaxFID) - static_cast<GUIntBig>(nMinFID);
+    GUIntBig nPartitions =
+        static_cast<GUIntBig>(nWorkers) * PARALLEL_SCAN_PARTITIONS_PER_WORKER;
+    if (nSpan < nPartitions)
+        nPartitions = nSpan + 1;
+    const GUIntBig nStep = nSpan / nPartitions + 1;
+    for (GUIntBig i = 0; i < nPartitions; i++)
+    {
+        const GUIntBig nOffset = i * nStep;
+        if (nOffset > nSpan)
+            break;
+        const GUIntBig nLast = std::min(nSpan, nOffset + nStep - 1);
+        poScan->AddPartition(
+            static_cast<GIntBig>(static_cast<GUIntBig>(nMinFID) + nOffset),
+            static_cast<GIntBig>(static_cast<GUIntBig>(nMinFID) + nLast));
+    }
+
+    if (!poScan->Start(nWorkers))
+        return nullptr;
+
+    CPLDebug("DAMENG", "Parallel scan of %s over up to %d sessions.",
+        pszSqlTableName, nWorkers);
+    return poScan.release();
+}
+
 /************************************************************************/
 /*                            BuildFields()                             */
 /*                                                                      */
@@ -920,16 +1108,26 @@ CPLString OGRDAMENGTableLayer::BuildFields()
 
     poFeatureDefn->GetFieldCount();
 
-    if (pszFIDColumn != nullptr &&
-        poFeatureDefn->GetFieldIndex(pszFIDColumn) == -1)
+    if (pszFIDColumn != nullptr)
     {
-        osFieldList += OGRDAMENGEscapeColumnName(pszFIDColumn);
+        const int iFIDField = poFeatureDefn->GetFieldIndex(pszFIDColumn);
+        if (iFIDField == -1 ||
+            poFeatureDefn->GetFieldDefn(iFIDField)->IsIgnored())
+            osFieldList += OGRDAMENGEscapeColumnName(pszFIDColumn);
     }
 
     for (i = 0; i < poFeatureDefn->GetGeomFieldCount(); i++)
     {
         OGRDAMENGGeomFieldDefn* poGeomFieldDefn =
             poFeatureDefn->GetGeomFieldDefn(i);
+
+        /* An ignored geometry is still needed when the spatial filter is */
+        /* not fully evaluated by the server */
+        if (poGeomFieldDefn->IsIgnored() &&
+            !(i == m_iGeomFieldFilter && m_poFilterGeom != nullptr &&
+              !m_bFilterIsEnvelope))
+            continue;
+
         CPLString osEscapedGeom =
             OGRDAMENGEscapeColumnName(poGeomFieldDefn->GetNameRef()).c_str();
 
@@ -974,6 +1172,9 @@ CPLString OGRDAMENGTableLayer::BuildFields()
 
     for (i = 0; i < poFeatureDefn->GetFieldCount(); i++)
     {
+        if (poFeatureDefn->GetFieldDefn(i)->IsIgnored())
+            continue;
+
         const char* pszName = poFeatureDefn->GetFieldDefn(i)->GetNameRef();
 
         if (!osFieldList.empty())
@@ -985,20 +1186,345 @@ CPLString OGRDAMENGTableLayer::BuildFields()
     return osFieldList;
 }
 
+/************************************************************************/
+/*                          SetIgnoredFields()                          */
+/*                                                                      */
+/*      Ignored fields are left out of the SELECT list, so that the     */
+/*      fetch buffers are sized for the remaining columns only.         */
+/************************************************************************/
+
+OGRErr OGRDAMENGTableLayer::SetIgnoredFields(CSLConstList papszFields)
+
+{
+    poFeatureDefn->GetFieldCount();
+
+    const OGRErr eErr = OGRDAMENGLayer::SetIgnoredFields(papszFields);
+    if (eErr != OGRERR_NONE)
+        return eErr;
+
+    ResetReading();
+    return OGRERR_NONE;
+}
+
+/************************************************************************/
+/*                          BuildFilterValue()                          */
+/*                                                                      */
+/*      DaMeng SQL of an operand of the attribute filter: a column of   */
+/*      the table or a constant. Returns an empty string otherwise.     */
+/************************************************************************/
+
+CPLString OGRDAMENGTableLayer::BuildFilterValue(const swq_expr_node* poNode) const
+
+{
+    if (poNode->eNodeType == SNT_COLUMN)
+    {
+        if (poNode->table_index != 0)
+            return CPLString();
+        const int nFieldCount = poFeatureDefn->GetFieldCount();
+        if (poNode->field_index >= 0 && poNode->field_index < nFieldCount)
+            return OGRDAMENGEscapeColumnName(
+                poFeatureDefn->GetFieldDefn(poNode->field_index)->GetNameRef());
+        if (poNode->field_index == nFieldCount + SPF_FID &&
+            pszFIDColumn != nullptr)
+            return OGRDAMENGEscapeColumnName(pszFIDColumn);
+        return CPLString();
+    }
+
+    if (poNode->eNodeType != SNT_CONSTANT)
+        return CPLString();
+    if (poNode->is_null || poNode->field_type == SWQ_NULL)
+        return "NULL";
+
+    switch (poNode->field_type)
+    {
+        case SWQ_INTEGER:
+        case SWQ_INTEGER64:
+        case SWQ_BOOLEAN:
+            return CPLSPrintf(CPL_FRMT_GIB,
+                static_cast<GIntBig>(poNode->int_value));
+
+        case SWQ_FLOAT:
+            if (!std::isfinite(poNode->float_value))
+                return CPLString();
+            return CPLSPrintf("%.17g", poNode->float_value);
+
+        case SWQ_STRING:
+            return swq_expr_node::Quote(poNode->string_value);
+
+        case SWQ_DATE:
+        case SWQ_TIME:
+        case SWQ_TIMESTAMP:
+        {
+            // Date literals of OGR SQL are like '2024/01/31 12:00:00'.
+            OGRField sField;
+            if (!OGRParseDate(poNode->string_value, &sField, 0) ||
+                sField.Date.TZFlag > 1)
+                return CPLString();
+            const float fSecond = sField.Date.Second;
+            CPLString osSecond =
+                fSecond == static_cast<int>(fSecond)
+                ? CPLString(CPLSPrintf("%02d", static_cast<int>(fSecond)))
+                : CPLString(CPLSPrintf("%06.3f", fSecond));
+            if (poNode->field_type == SWQ_DATE)
+                return CPLSPrintf("DATE '%04d-%02d-%02d'", sField.Date.Year,
+                    sField.Date.Month, sField.Date.Day);
+            if (poNode->field_type == SWQ_TIME)
+                return CPLSPrintf("TIME '%02d:%02d:%s'", sField.Date.Hour,
+                    sField.Date.Minute, osSecond.c_str());
+            return CPLSPrintf("TIMESTAMP '%04d-%02d-%02d %02d:%02d:%s'",
+                sField.Date.Year, sField.Date.Month, sField.Date.Day,
+                sField.Date.Hour, sField.Date.Minute, osSecond.c_str());
+        }
+
+        default:
+            return CPLString();
+    }
+}
+
+/************************************************************************/
+/*                       DMIsCaseFreeComparison()                       */
+/*                                                                      */
+/*      Whether poNode tests the equality of one column with string     */
+/*      constants without letters, like '123'. Case cannot change the   */
+/*      result then, and the column can be compared as it is, which     */
+/*      lets the server use a plain index on it.                        */
+/************************************************************************/
+
+static bool DMIsCaseFreeComparison(const swq_expr_node* poNode)
+
+{
+    if (poNode->nOperation != SWQ_EQ && poNode->nOperation != SWQ_NE &&
+        poNode->nOperation != SWQ_IN)
+        return false;
+
+    int nColumns = 0;
+    for (int i = 0; i < poNode->nSubExprCount; i++)
+    {
+        const swq_expr_node* poSubExpr = poNode->papoSubExpr[i];
+        if (poSubExpr->eNodeType == SNT_COLUMN)
+        {
+            nColumns++;
+            continue;
+        }
+        if (poSubExpr->is_null)
+            continue;
+        if (poSubExpr->field_type != SWQ_STRING)
+            return false;
+        for (const char* pszIter = poSubExpr->string_value; *pszIter;
+             ++pszIter)
+        {
+            const unsigned char ch = static_cast<unsigned char>(*pszIter);
+            if (ch > 127 || isalpha(ch))
+                return false;
+        }
+    }
+    return nColumns == 1;
+}
+
+/************************************************************************/
+/*                           BuildFilterSQL()                           */
+/*                                                                      */
+/*      Translate the parsed OGR SQL attribute filter to DaMeng SQL.    */
+/*      A branch of an AND that cannot be translated is left out and    */
+/*      m_bFilterMustBeClientSideEvaluated is set: the server then      */
+/*      returns a superset of the features, filtered again by OGR.      */
+/************************************************************************/
+
+CPLString OGRDAMENGTableLayer::BuildFilterSQL(const swq_expr_node* poNode)
+
+{
+    if (poNode->eNodeType == SNT_OPERATION && poNode->nOperation == SWQ_AND &&
+        poNode->nSubExprCount == 2)
+    {
+        const CPLString osFilter1 = BuildFilterSQL(poNode->papoSubExpr[0]);
+        const CPLString osFilter2 = BuildFilterSQL(poNode->papoSubExpr[1]);
+        if (!osFilter1.empty() && !osFilter2.empty())
+            return "(" + osFilter1 + " AND " + osFilter2 + ")";
+        return osFilter1.empty() ? osFilter2 : osFilter1;
+    }
+
+    if (poNode->eNodeType == SNT_OPERATION && poNode->nOperation == SWQ_OR &&
+        poNode->nSubExprCount == 2)
+    {
+        const CPLString osFilter1 = BuildWholeFilterSQL(poNode->papoSubExpr[0]);
+        const CPLString osFilter2 = BuildWholeFilterSQL(poNode->papoSubExpr[1]);
+        if (!osFilter1.empty() && !osFilter2.empty())
+            return "(" + osFilter1 + " OR " + osFilter2 + ")";
+    }
+    else if (poNode->eNodeType == SNT_OPERATION &&
+             poNode->nOperation == SWQ_NOT && poNode->nSubExprCount == 1)
+    {
+        const CPLString osFilter = BuildWholeFilterSQL(poNode->papoSubExpr[0]);
+        if (!osFilter.empty())
+            return "(NOT " + osFilter + ")";
+    }
+    else if (poNode->eNodeType == SNT_OPERATION && poNode->nSubExprCount >= 1)
+    {
+        std::vector<CPLString> aosValues;
+        bool bHasStringOperand = false;
+        for (int i = 0; i < poNode->nSubExprCount; i++)
+        {
+            aosValues.push_back(BuildFilterValue(poNode->papoSubExpr[i]));
+            if (aosValues.back().empty())
+            {
+                m_bFilterMustBeClientSideEvaluated = true;
+                return CPLString();
+            }
+            if (poNode->papoSubExpr[i]->field_type == SWQ_STRING)
+                bHasStringOperand = true;
+        }
+
+        // OGR SQL compares strings without regard to case, DaMeng does not.
+        // LOWER() rather than UPPER() keeps the order of strcasecmp() for
+        // the characters between 'Z' and 'a', like '_'. ASCII constants
+        // are lowered here, so that a function index on LOWER(col) can
+        // serve the comparison: a plain index on the column cannot.
+        if (bHasStringOperand &&
+            (poNode->nOperation == SWQ_EQ || poNode->nOperation == SWQ_NE ||
+             poNode->nOperation == SWQ_GE || poNode->nOperation == SWQ_LE ||
+             poNode->nOperation == SWQ_LT || poNode->nOperation == SWQ_GT ||
+             poNode->nOperation == SWQ_BETWEEN ||
+             poNode->nOperation == SWQ_IN) &&
+            !DMIsCaseFreeComparison(poNode))
+        {
+            for (int i = 0; i < poNode->nSubExprCount; i++)
+            {
+                const swq_expr_node* poSubExpr = poNode->papoSubExpr[i];
+                if (poSubExpr->eNodeType == SNT_CONSTANT &&
+                    poSubExpr->field_type == SWQ_STRING &&
+                    !poSubExpr->is_null && CPLIsASCII(poSubExpr->string_value,
+                                                      static_cast<size_t>(-1)))
+                {
+                    aosValues[i] = swq_expr_node::Quote(
+                        CPLString(poSubExpr->string_value).tolower());
+                }
+                else if (aosValues[i] != "NULL")
+                {
+                    aosValues[i] = "LOWER(" + aosValues[i] + ")";
+                }
+            }
+        }
+
+        const char* pszOperator = nullptr;
+        switch (poNode->nOperation)
+        {
+            case SWQ_EQ: pszOperator = "="; break;
+            case SWQ_NE: pszOperator = "<>"; break;
+            case SWQ_GE: pszOperator = ">="; break;
+            case SWQ_LE: pszOperator = "<="; break;
+            case SWQ_LT: pszOperator = "<"; break;
+            case SWQ_GT: pszOperator = ">"; break;
+            default: break;
+        }
+        if (pszOperator != nullptr && aosValues.size() == 2)
+            return "(" + aosValues[0] + " " + pszOperator + " " +
+                aosValues[1] + ")";
+
+        if ((poNode->nOperation == SWQ_LIKE ||
+             poNode->nOperation == SWQ_ILIKE) &&
+            (aosValues.size() == 2 || aosValues.size() == 3))
+        {
+            // DaMeng has no ILIKE.
+            CPLString osRet;
+            if (poNode->nOperation == SWQ_ILIKE ||
+                CPLTestBool(
+                    CPLGetConfigOption("OGR_SQL_LIKE_AS_ILIKE", "FALSE")))
+                osRet = "(UPPER(" + aosValues[0] + ") LIKE UPPER(" +
+                    aosValues[1] + ")";
+            else
+                osRet = "(" + aosValues[0] + " LIKE " + aosValues[1];
+            if (aosValues.size() == 3)
+                osRet += " ESCAPE " + aosValues[2];
+            return osRet + ")";
+        }
+
+        if (poNode->nOperation == SWQ_ISNULL && aosValues.size() == 1)
+            return "(" + aosValues[0] + " IS NULL)";
+
+        if (poNode->nOperation == SWQ_BETWEEN && aosValues.size() == 3)
+            return "(" + aosValues[0] + " BETWEEN " + aosValues[1] + " AND " +
+                aosValues[2] + ")";
+
+        if (poNode->nOperation == SWQ_IN && aosValues.size() >= 2)
+        {
+            CPLString osRet = "(" + aosValues[0] + " IN (";
+            for (size_t i = 1; i < aosValues.size(); i++)
+            {
+                if (i > 1)
+                    osRet += ", ";
+                osRet += aosValues[i];
+            }
+            return osRet + "))";
+        }
+    }
+
+    m_bFilterMustBeClientSideEvaluated = true;
+    return CPLString();
+}
+
+/************************************************************************/
+/*                        BuildWholeFilterSQL()                         */
+/*                                                                      */
+/*      Same as BuildFilterSQL(), for the operands of OR and NOT which  */
+/*      must be translated entirely, or not at all.                     */
+/************************************************************************/
+
+CPLString OGRDAMENGTableLayer::BuildWholeFilterSQL(const swq_expr_node* poNode)
+
+{
+    const bool bClientSide = m_bFilterMustBeClientSideEvaluated;
+    m_bFilterMustBeClientSideEvaluated = false;
+    CPLString osFilter = BuildFilterSQL(poNode);
+    if (m_bFilterMustBeClientSideEvaluated)
+        osFilter.clear();
+    m_bFilterMustBeClientSideEvaluated =
+        bClientSide || m_bFilterMustBeClientSideEvaluated;
+    return osFilter;
+}
+
 /************************************************************************/
 /*                         SetAttributeFilter()                         */
+/*                                                                      */
+/*      Filters parsed by OGR SQL are translated to DaMeng SQL, see     */
+/*      BuildFilterSQL(). Others, like those using DaMeng functions,    */
+/*      are passed as they are to the server.                           */
 /************************************************************************/
 
 OGRErr OGRDAMENGTableLayer::SetAttributeFilter(const char* pszQuery)
 
 {
-    CPLFree(m_pszAttrQueryString);
-    m_pszAttrQueryString = (pszQuery) ? CPLStrdup(pszQuery) : nullptr;
+    GetLayerDefn()->GetFieldCount();
+
+    CPLPushErrorHandler(CPLQuietErrorHandler);
+    const OGRErr eErr = OGRLayer::SetAttributeFilter(pszQuery);
+    CPLPopErrorHandler();
+    CPLErrorReset();
 
-    if (pszQuery == nullptr)
+    m_bFilterMustBeClientSideEvaluated = false;
+    if (pszQuery == nullptr || pszQuery[0] == '\0')
+    {
         osQuery = "";
-    else
+    }
+    else if (eErr != OGRERR_NONE || m_poAttrQuery == nullptr)
+    {
+        CPLDebug("DAMENG", "Attribute filter not understood by OGR SQL, "
+            "passed as it is to the server.");
         osQuery = pszQuery;
+    }
+    else
+    {
+        swq_expr_node* poNode =
+            static_cast<swq_expr_node*>(m_poAttrQuery->GetSWQExpr());
+        osQuery = BuildFilterSQL(poNode);
+        if (osQuery.empty())
+            CPLDebug("DAMENG", "Attribute filter evaluated on client side.");
+        else if (m_bFilterMustBeClientSideEvaluated)
+            CPLDebug("DAMENG", "Only part of the attribute filter is "
+                "evaluated on server side: %s", osQuery.c_str());
+        else
+            CPLDebug("DAMENG", "Attribute filter evaluated on server side: %s",
+                osQuery.c_str());
+    }
 
     BuildWhere();
 
@@ -1007,6 +1533,61 @@ OGRErr OGRDAMENGTableLayer::SetAttributeFilter(const char* pszQuery)
     return OGRERR_NONE;
 }
 
+/************************************************************************/
+/*                        GetPreparedStatement()                        */
+/*                                                                      */
+/*      Return a prepared statement for the given parameterized SQL,    */
+/*      from the layer cache when possible. The least recently used     */
+/*      statement is dropped once the cache is full.                    */
+/************************************************************************/
+
+OGRDAMENGStatement* OGRDAMENGTableLayer::GetPreparedStatement(
+    const CPLString& osSQL)
+{
+    for (auto oIter = m_aoStatementCache.begin();
+        oIter != m_aoStatementCache.end(); ++oIter)
+    {
+        if (oIter->first == osSQL)
+        {
+            if (oIter != m_aoStatementCache.begin())
+                m_aoStatementCache.splice(m_aoStatementCache.begin(),
+                    m_aoStatementCache, oIter);
+            return m_aoStatementCache.front().second.get();
+        }
+    }
+
+    auto poStatement =
+        std::make_unique<OGRDAMENGStatement>(poDS->GetDAMENGConn());
+    poStatement->SetStats(&m_oStats);
+    if (poStatement->Prepare(osSQL) != CE_None)
+        return nullptr;
+
+    if (m_nStatementCacheSize == 0)
+    {
+        // Caching disabled: keep only the statement in use.
+        m_aoStatementCache.clear();
+    }
+    else
+    {
+        while (m_aoStatementCache.size() >= m_nStatementCacheSize)
+            m_aoStatementCache.pop_back();
+    }
+    m_aoStatementCache.emplace_front(osSQL, std::move(poStatement));
+    return m_aoStatementCache.front().second.get();
+}
+
+/************************************************************************/
+/*                        ClearStatementCache()                         */
+/*                                                                      */
+/*      Must be called whenever the table definition changes, as the    */
+/*      cached statements were prepared against the former columns.     */
+/************************************************************************/
+
+void OGRDAMENGTableLayer::ClearStatementCache()
+{
+    m_aoStatementCache.clear();
+}
+
 /************************************************************************/
 /*                           DeleteFeature()                            */
 /************************************************************************/
@@ -1015,11 +1596,14 @@ OGRErr OGRDAMENGTableLayer::DeleteFeature(GIntBig nFID)
 
 {
     OGRDAMENGConn* hDAMENGConn = poDS->GetDAMENGConn();
-    OGRDAMENGStatement oCommand(hDAMENGConn);
     CPLString osCommand;
 
     GetLayerDefn()->GetFieldCount();
 
+    if (FlushPendingInserts() != OGRERR_NONE)
+        return OGRERR_FAILURE;
+
+    InvalidateStatistics();
     bAutoFIDOnCreateViaCopy = FALSE;
 
     /* -------------------------------------------------------------------- */
@@ -1039,19 +1623,24 @@ OGRErr OGRDAMENGTableLayer::DeleteFeature(GIntBig nFID)
     /* -------------------------------------------------------------------- */
     /*      Form the statement to drop the record.                          */
     /* -------------------------------------------------------------------- */
-    osCommand.Printf("DELETE FROM %s WHERE %s = " CPL_FRMT_GIB, pszSqlTableName,
-        OGRDAMENGEscapeColumnName(pszFIDColumn).c_str(), nFID);
+    osCommand.Printf("DELETE FROM %s WHERE %s = ?", pszSqlTableName,
+        OGRDAMENGEscapeColumnName(pszFIDColumn).c_str());
+
+    OGRDAMENGStatement* poCommand = GetPreparedStatement(osCommand);
+    if (poCommand == nullptr)
+        return OGRERR_FAILURE;
 
     /* -------------------------------------------------------------------- */
     /*      Execute the delete.                                             */
     /* -------------------------------------------------------------------- */
     CPLErr rt;
     OGRErr eErr;
-    sdint8 d_rows;
+    sdint8 d_rows = 0;
 
-    rt = oCommand.Execute(osCommand.c_str());
-    dpi_row_count(*(oCommand.GetStatement()), &d_rows);
-    if (!DSQL_SUCCEEDED(rt))
+    poCommand->ClearParams();
+    poCommand->AddInt64Param(nFID);
+    rt = poCommand->Execute(nullptr);
+    if (rt != CE_None)
     {
         CPLError(CE_Failure, CPLE_AppDefined,
             "DeleteFeature() DELETE statement failed.");
@@ -1059,11 +1648,13 @@ OGRErr OGRDAMENGTableLayer::DeleteFeature(GIntBig nFID)
     }
     else
     {
+        dpi_row_count(*(poCommand->GetStatement()), &d_rows);
         if (d_rows == 0)
             eErr = OGRERR_NON_EXISTING_FEATURE;
         else
             eErr = OGRERR_NONE;
     }
+    hDAMENGConn->SoftCommit();
 
     return eErr;
 }
@@ -1075,18 +1666,9 @@ OGRErr OGRDAMENGTableLayer::DeleteFeature(GIntBig nFID)
 CPLErr OGRDAMENGTableLayer::CheckINI(int* checkini)
 
 {
-    OGRDAMENGConn* hDAMENGConn = poDS->GetDAMENGConn();
-    OGRDAMENGStatement oCommand(hDAMENGConn);
-    CPLString osCommand;
-
-    osCommand.Printf("SELECT SF_GET_PARA_VALUE(1, 'GEO2_CONS_CHECK')");
-    CPLErr eErr = oCommand.Execute(osCommand);
-    if (eErr == CE_None)
-    {
-        char** hResult = oCommand.SimpleFetchRow();
-        *checkini = atoi(hResult[0]);
-    }
-    return eErr;
+    /* The server parameter is read once per datasource */
+    *checkini = poDS->GetGeoConsCheck();
+    return *checkini < 0 ? CE_Failure : CE_None;
 }
 /************************************************************************/
 /*                             ISetFeature()                             */
@@ -1097,7 +1679,6 @@ CPLErr OGRDAMENGTableLayer::CheckINI(int* checkini)
 OGRErr OGRDAMENGTableLayer::ISetFeature(OGRFeature* poFeature)
 {
     OGRDAMENGConn* hDAMENGConn = poDS->GetDAMENGConn();
-    OGRDAMENGStatement oCommand(hDAMENGConn);
     CPLString osCommand;
     sdint8 row = 0;
     int i = 0;
@@ -1106,6 +1687,11 @@ OGRErr OGRDAMENGTableLayer::ISetFeature(OGRFeature* poFeature)
 
     GetLayerDefn()->GetFieldCount();
 
+    if (FlushPendingInserts() != OGRERR_NONE)
+        return OGRERR_FAILURE;
+
+    InvalidateStatistics();
+
     if (nullptr == poFeature)
     {
         CPLError(CE_Failure, CPLE_AppDefined,
@@ -1142,52 +1728,93 @@ OGRErr OGRDAMENGTableLayer::ISetFeature(OGRFeature* poFeature)
     }
 
     /* -------------------------------------------------------------------- */
-    /*      Form the UPDATE command.                                        */
+    /*      Form the UPDATE command. Values are bound as parameters, so     */
+    /*      the command text only depends on the set of updated fields     */
+    /*      and can be prepared once.                                       */
     /* -------------------------------------------------------------------- */
+    const bool bUseText =
+        CPLTestBool(CPLGetConfigOption("DM_USE_TEXT", "NO"));
+
     osCommand.Printf("UPDATE %s SET ", pszSqlTableName);
 
-    /* Set the geometry */
     for (i = 0; i < poFeatureDefn->GetGeomFieldCount(); i++)
     {
         OGRDAMENGGeomFieldDefn* poGeomFieldDefn =
             poFeatureDefn->GetGeomFieldDefn(i);
-        OGRGeometry* poGeom = poFeature->GetGeomFieldRef(i);
-        if (poGeomFieldDefn->eDAMENGGeoType == GEOM_TYPE_WKB)
+        if (poGeomFieldDefn->eDAMENGGeoType != GEOM_TYPE_WKB &&
+            poGeomFieldDefn->eDAMENGGeoType != GEOM_TYPE_GEOGRAPHY &&
+            poGeomFieldDefn->eDAMENGGeoType != GEOM_TYPE_GEOMETRY)
+            continue;
+
+        if (bNeedComma)
+            osCommand += ", ";
+        else
+            bNeedComma = TRUE;
+
+        osCommand +=
+            OGRDAMENGEscapeColumnName(poGeomFieldDefn->GetNameRef()).c_str();
+        if (poGeomFieldDefn->eDAMENGGeoType != GEOM_TYPE_WKB && bUseText)
         {
-            if (bNeedComma)
-                osCommand += ", ";
+            if (poGeomFieldDefn->eDAMENGGeoType == GEOM_TYPE_GEOGRAPHY)
+                osCommand += " = DMGEO2.ST_GeographyFromText(?)";
             else
-                bNeedComma = TRUE;
+                osCommand += " = DMGEO2.ST_GeomFromEWKT(?)";
+        }
+        else
+            osCommand += " = ?";
+    }
 
-            osCommand +=
-                OGRDAMENGEscapeColumnName(poGeomFieldDefn->GetNameRef()).c_str();
-            osCommand += " = ";
-            if (poGeom != nullptr)
-            {
-                char* pszBytea = GeometryToBlob(poGeom);
+    for (i = 0; i < poFeatureDefn->GetFieldCount(); i++)
+    {
+        if (iFIDAsRegularColumnIndex == i)
+            continue;
+        if (!poFeature->IsFieldSet(i))
+            continue;
 
-                if (pszBytea != nullptr)
-                {
-                    osCommand = osCommand + "'" + pszBytea + "'";
-                    CPLFree(pszBytea);
-                }
-                else
-                    osCommand += "NULL";
-            }
+        if (bNeedComma)
+            osCommand += ", ";
+        else
+            bNeedComma = TRUE;
+
+        osCommand = osCommand +
+            OGRDAMENGEscapeColumnName(
+                poFeatureDefn->GetFieldDefn(i)->GetNameRef()).c_str() +
+            " = ?";
+    }
+    if (!bNeedComma)  // nothing to do
+        return OGRERR_NONE;
+
+    /* Add the WHERE clause */
+    osCommand += " WHERE ";
+    osCommand = osCommand + OGRDAMENGEscapeColumnName(pszFIDColumn).c_str() + " = ?";
+
+    OGRDAMENGStatement* poCommand = GetPreparedStatement(osCommand);
+    if (poCommand == nullptr)
+        return OGRERR_FAILURE;
+
+    /* -------------------------------------------------------------------- */
+    /*      Bind the values, in the order of the markers above.             */
+    /* -------------------------------------------------------------------- */
+    poCommand->ClearParams();
+
+    for (i = 0; i < poFeatureDefn->GetGeomFieldCount(); i++)
+    {
+        OGRDAMENGGeomFieldDefn* poGeomFieldDefn =
+            poFeatureDefn->GetGeomFieldDefn(i);
+        OGRGeometry* poGeom = poFeature->GetGeomFieldRef(i);
+        if (poGeomFieldDefn->eDAMENGGeoType == GEOM_TYPE_WKB)
+        {
+            char* pszBytea =
+                poGeom != nullptr ? GeometryToBlob(poGeom) : nullptr;
+            if (pszBytea != nullptr)
+                poCommand->AddStringParam(pszBytea);
             else
-                osCommand += "NULL";
+                poCommand->AddNullParam();
+            CPLFree(pszBytea);
         }
         else if (poGeomFieldDefn->eDAMENGGeoType == GEOM_TYPE_GEOGRAPHY ||
             poGeomFieldDefn->eDAMENGGeoType == GEOM_TYPE_GEOMETRY)
         {
-            if (bNeedComma)
-                osCommand += ", ";
-            else
-                bNeedComma = TRUE;
-
-            osCommand +=
-                OGRDAMENGEscapeColumnName(poGeomFieldDefn->GetNameRef()).c_str();
-            osCommand += " = ";
             if (poGeom != nullptr)
             {
                 poGeom->closeRings();
@@ -1197,22 +1824,16 @@ OGRErr OGRDAMENGTableLayer::ISetFeature(OGRFeature* poFeature)
                     OGRGeometry::OGR_G_MEASURED);
             }
 
-            if (!CPLTestBool(CPLGetConfigOption("DM_USE_TEXT", "NO")))
+            if (!bUseText)
             {
-                if (poGeom != nullptr)
+                if (poCommand->AddGeometryParam(
+                        poGeom, poGeomFieldDefn->nSRSId) != CE_None)
                 {
-                    char* pszHexEWKB = OGRGeometryToHexEWKB(
-                        poGeom, poGeomFieldDefn->nSRSId, 3, 3);
-                    if (poGeomFieldDefn->eDAMENGGeoType == GEOM_TYPE_GEOGRAPHY)
-                        osCommand += CPLString().Printf(
-                            "DMGEO2.ST_GEOGFROMEWKB('%s')", pszHexEWKB);
-                    else
-                        osCommand += CPLString().Printf(
-                            "DMGEO2.ST_GEOMFROMEWKB('%s')", pszHexEWKB);
-                    CPLFree(pszHexEWKB);
+                    CPLError(CE_Failure, CPLE_AppDefined,
+                        "Cannot encode geometry of feature " CPL_FRMT_GIB,
+                        poFeature->GetFID());
+                    return OGRERR_FAILURE;
                 }
-                else
-                    osCommand += "NULL";
             }
             else
             {
@@ -1221,23 +1842,14 @@ OGRErr OGRDAMENGTableLayer::ISetFeature(OGRFeature* poFeature)
                 if (poGeom != nullptr)
                     poGeom->exportToWkt(&pszWKT, wkbVariantIso);
 
-                int nSRSId = poGeomFieldDefn->nSRSId;
                 if (pszWKT != nullptr)
                 {
-                    if (poGeomFieldDefn->eDAMENGGeoType == GEOM_TYPE_GEOGRAPHY)
-                        osCommand += CPLString().Printf(
-                            "DMGEO2.ST_GeographyFromText('SRID=%d;%s') ",
-                            nSRSId, pszWKT);
-                    else
-                    {
-                        osCommand += CPLString().Printf(
-                            "DMGEO2.ST_GeomFromEWKT('SRID=%d;%s') ", nSRSId,
-                            pszWKT);
-                    }
+                    poCommand->AddStringParam(CPLSPrintf(
+                        "SRID=%d;%s", poGeomFieldDefn->nSRSId, pszWKT));
                     CPLFree(pszWKT);
                 }
                 else
-                    osCommand += "NULL";
+                    poCommand->AddNullParam();
             }
         }
     }
@@ -1249,79 +1861,55 @@ OGRErr OGRDAMENGTableLayer::ISetFeature(OGRFeature* poFeature)
         if (!poFeature->IsFieldSet(i))
             continue;
 
-        if (bNeedComma)
-            osCommand += ", ";
-        else
-            bNeedComma = TRUE;
-
-        osCommand =
-            osCommand + OGRDAMENGEscapeColumnName(poFeatureDefn->GetFieldDefn(i)->GetNameRef()).c_str() + " = ";
-
         if (poFeature->IsFieldNull(i))
         {
-            osCommand += "NULL";
+            poCommand->AddNullParam();
+            continue;
+        }
+
+        const OGRFieldDefn* poFieldDefn = poFeatureDefn->GetFieldDefn(i);
+        const OGRFieldType eType = poFieldDefn->GetType();
+        if (eType == OFTInteger || eType == OFTInteger64)
+        {
+            if (poFieldDefn->GetSubType() == OFSTBoolean)
+                poCommand->AddInt64Param(poFeature->GetFieldAsInteger(i) ? 1
+                                                                        : 0);
+            else
+                poCommand->AddInt64Param(poFeature->GetFieldAsInteger64(i));
+        }
+        else if (eType == OFTReal)
+        {
+            // Special values are sent as text, as they used to be quoted.
+            const double dfVal = poFeature->GetFieldAsDouble(i);
+            if (std::isnan(dfVal))
+                poCommand->AddStringParam("NaN");
+            else if (std::isinf(dfVal))
+                poCommand->AddStringParam(dfVal > 0 ? "Infinity"
+                                                    : "-Infinity");
+            else
+                poCommand->AddDoubleParam(dfVal);
         }
         else
         {
-            // Flag indicating NULL or not-a-date date value
-            // e.g. 0000-00-00 - there is no year 0
-            bool bIsDateNull = false;
-
             const char* pszStrValue = poFeature->GetFieldAsString(i);
 
-            // Check if date is NULL: 0000-00-00
-            if (poFeatureDefn->GetFieldDefn(i)->GetType() == OFTDate)
-            {
-                if (STARTS_WITH_CI(pszStrValue, "0000"))
-                {
-                    pszStrValue = "NULL";
-                    bIsDateNull = true;
-                }
-            }
-            else if (poFeatureDefn->GetFieldDefn(i)->GetType() == OFTReal)
-            {
-                // Check for special values. They need to be quoted.
-                double dfVal = poFeature->GetFieldAsDouble(i);
-                if (std::isnan(dfVal))
-                    pszStrValue = "'NaN'";
-                else if (std::isinf(dfVal))
-                    pszStrValue = (dfVal > 0) ? "'Infinity'" : "'-Infinity'";
-            }
-            else if ((poFeatureDefn->GetFieldDefn(i)->GetType() == OFTInteger ||
-                poFeatureDefn->GetFieldDefn(i)->GetType() == OFTInteger64) &&
-                poFeatureDefn->GetFieldDefn(i)->GetSubType() == OFSTBoolean)
-                pszStrValue = poFeature->GetFieldAsInteger(i) ? "'t'" : "'f'";
-
-
-            if (poFeatureDefn->GetFieldDefn(i)->GetType() != OFTInteger &&
-                poFeatureDefn->GetFieldDefn(i)->GetType() != OFTInteger64 &&
-                poFeatureDefn->GetFieldDefn(i)->GetType() != OFTReal &&
-                !bIsDateNull)
-            {
-                OGRDAMENGCommonAppendFieldValue(osCommand, poFeature, i);
-            }
+            // Check if date is NULL: 0000-00-00 - there is no year 0
+            if (eType == OFTDate && STARTS_WITH_CI(pszStrValue, "0000"))
+                poCommand->AddNullParam();
             else
-            {
-                osCommand += pszStrValue;
-            }
+                poCommand->AddStringParam(pszStrValue);
         }
     }
-    if (!bNeedComma)  // nothing to do
-        return OGRERR_NONE;
 
-    /* Add the WHERE clause */
-    osCommand += " WHERE ";
-    osCommand = osCommand + OGRDAMENGEscapeColumnName(pszFIDColumn).c_str() + " =  ";
-    osCommand += CPLString().Printf(CPL_FRMT_GIB, poFeature->GetFID());
+    poCommand->AddInt64Param(poFeature->GetFID());
 
     /* -------------------------------------------------------------------- */
     /*      Execute the update.                                             */
     /* -------------------------------------------------------------------- */
-    CPLErr rt = oCommand.Execute(osCommand);
-
-    dpi_row_count(*(oCommand.GetStatement()), &row);
-    if (!DSQL_SUCCEEDED(rt))
+    CPLErr rt = poCommand->Execute(nullptr);
+    if (rt != CE_None)
     {
+        hDAMENGConn->SoftCommit();
         CPLError(CE_Failure, CPLE_AppDefined,
             "UPDATE command for feature " CPL_FRMT_GIB
             " failed.\nCommand: %s",
@@ -1329,6 +1917,8 @@ OGRErr OGRDAMENGTableLayer::ISetFeature(OGRFeature* poFeature)
 
         return OGRERR_FAILURE;
     }
+    dpi_row_count(*(poCommand->GetStatement()), &row);
+    hDAMENGConn->SoftCommit();
     if (row == 0)
         eErr = OGRERR_NON_EXISTING_FEATURE;
     else
@@ -1344,6 +1934,7 @@ OGRErr OGRDAMENGTableLayer::ISetFeature(OGRFeature* poFeature)
 OGRErr OGRDAMENGTableLayer::ICreateFeature(OGRFeature* poFeature)
 {
     GetLayerDefn()->GetFieldCount();
+    InvalidateStatistics();
 
     if (nullptr == poFeature)
     {
@@ -1425,6 +2016,45 @@ CPLString OGRDAMENGEscapeColumnName(const char* pszColumnName)
     return osStr;
 }
 
+/************************************************************************/
+/*                         ReadInsertColumns()                          */
+/*                                                                      */
+/*      List the columns written by INSERT and MERGE statements, that   */
+/*      is all columns but the first one, the FID. mymap gives their    */
+/*      1-based position in that list.                                  */
+/************************************************************************/
+
+OGRErr OGRDAMENGTableLayer::ReadInsertColumns()
+
+{
+    if (!m_aosInsertColumns.empty())
+        return OGRERR_NONE;
+
+    OGRDAMENGStatement oCommand(poDS->GetDAMENGConn());
+    CPLString sql;
+    sql.Printf("SELECT NAME FROM SYSCOLUMNS WHERE ID = ("
+        "SELECT o.id FROM SYSOBJECTS o JOIN DBA_TABLES t ON "
+        "o.NAME = t.TABLE_NAME WHERE o.NAME = '%s' AND t.OWNER = "
+        "'%s' AND TYPE$='SCHOBJ' LIMIT 1) ORDER BY COLID; ",
+        pszTableName, pszSchemaName);
+    CPLErr eErr = oCommand.Execute(sql);
+    if (eErr != CE_None)
+    {
+        CPLError(CE_Failure, CPLE_AppDefined, "Can't find columns' name");
+        return OGRERR_FAILURE;
+    }
+    char** hResult = oCommand.SimpleFetchRow();
+    hResult = oCommand.SimpleFetchRow();  //skip ogc_fid
+    int num = 1;
+    while (hResult)
+    {
+        m_aosInsertColumns.push_back(hResult[0]);
+        mymap.insert(std::make_pair(hResult[0], num++));
+        hResult = oCommand.SimpleFetchRow();
+    }
+    return OGRERR_NONE;
+}
+
 /************************************************************************/
 /*                       CreateFeatureViaInsert()                       */
 /************************************************************************/
@@ -1433,56 +2063,199 @@ OGRErr OGRDAMENGTableLayer::CreateFeatureViaInsert(OGRFeature* poFeature)
 
 {
     OGRDAMENGConn* hDAMENGConn = poDS->GetDAMENGConn();
-    OGRDAMENGStatement oCommand(hDAMENGConn);
-    int bNeedComma = FALSE;
     CPLString sql;
-    int num = 1;
     /* -------------------------------------------------------------------- */
     /*      Form the INSERT command.                                        */
     /* -------------------------------------------------------------------- */
     if (InsertStatement == nullptr)
     {
-
-        sql.Printf("SELECT NAME FROM SYSCOLUMNS WHERE ID = ("
-            "SELECT o.id FROM SYSOBJECTS o JOIN DBA_TABLES t ON "
-            "o.NAME = t.TABLE_NAME WHERE o.NAME = '%s' AND t.OWNER = "
-            "'%s' AND TYPE$='SCHOBJ' LIMIT 1) ORDER BY COLID; ",
-            pszTableName, pszSchemaName);
-        CPLErr eErr = oCommand.Execute(sql);
-        if (eErr != CE_None)
-        {
-            CPLError(CE_Failure, CPLE_AppDefined, "Can't find columns' name");
+        if (ReadInsertColumns() != OGRERR_NONE)
             return OGRERR_FAILURE;
-        }
-        char** hResult = oCommand.SimpleFetchRow();
-        hResult = oCommand.SimpleFetchRow();  //skip ogc_fid
+
         InsertStatement = new OGRDAMENGStatement(hDAMENGConn);
+        InsertStatement->SetStats(&m_oStats);
         InsertSQL += " INSERT INTO ";
         InsertSQL += pszSqlTableName;
         InsertSQL += "(";
         sql = ") VALUES(";
-        while (hResult)
+        for (size_t i = 0; i < m_aosInsertColumns.size(); i++)
         {
-            if (!bNeedComma)
-                bNeedComma = TRUE;
-            else
+            if (i > 0)
             {
                 InsertSQL += ", ";
                 sql += ",";
             }
             InsertSQL += "\"";
-            InsertSQL += hResult[0];
+            InsertSQL += m_aosInsertColumns[i];
             InsertSQL += "\"";
-            mymap.insert(std::make_pair(hResult[0], num++));
             sql += "?";
-            hResult = oCommand.SimpleFetchRow();
         }
         InsertSQL = InsertSQL + sql + ");";
+        InsertStatement->SetBatchSize(nInsertBatchSize,
+            nInsertCommitInterval < 0 ? nInsertBatchSize
+            : nInsertCommitInterval);
         InsertStatement->Prepare(InsertSQL);
     }
+
+    // Upserts buffered so far are sent first, to keep the order of writes.
+    if (m_poUpsertStatement != nullptr &&
+        m_poUpsertStatement->FlushInsert(false) != CE_None)
+        return OGRERR_FAILURE;
+
     CPLErr eErr =
         InsertStatement->Execute_for_insert(poFeatureDefn, poFeature, mymap);
 
+    return eErr == CE_None ? OGRERR_NONE : OGRERR_FAILURE;
+}
+
+/************************************************************************/
+/*                           IUpsertFeature()                           */
+/*                                                                      */
+/*      Update the row of the FID of the feature, or insert it with     */
+/*      that FID. Rows are buffered like CreateFeature() does, and      */
+/*      each batch is sent as one MERGE statement bound to arrays.      */
+/************************************************************************/
+
+OGRErr OGRDAMENGTableLayer::IUpsertFeature(OGRFeature* poFeature)
+
+{
+    GetLayerDefn()->GetFieldCount();
+    InvalidateStatistics();
+
+    if (nullptr == poFeature)
+    {
+        CPLError(CE_Failure, CPLE_AppDefined,
+            "NULL pointer to OGRFeature passed to UpsertFeature().");
+        return OGRERR_FAILURE;
+    }
+
+    if (pszFIDColumn == nullptr)
+    {
+        CPLError(CE_Failure, CPLE_AppDefined,
+            "Unable to upsert features in tables without\n"
+            "a recognised FID column.");
+        return OGRERR_FAILURE;
+    }
+
+    /* In case the FID column has also been created as a regular field */
+    if (iFIDAsRegularColumnIndex >= 0 && poFeature->GetFID() == OGRNullFID &&
+        poFeature->IsFieldSetAndNotNull(iFIDAsRegularColumnIndex))
+    {
+        poFeature->SetFID(
+            poFeature->GetFieldAsInteger64(iFIDAsRegularColumnIndex));
+    }
+    if (poFeature->GetFID() == OGRNullFID)
+    {
+        CPLError(CE_Failure, CPLE_AppDefined,
+            "FID required on features given to UpsertFeature().");
+        return OGRERR_FAILURE;
+    }
+    if (iFIDAsRegularColumnIndex >= 0 &&
+        (!poFeature->IsFieldSetAndNotNull(iFIDAsRegularColumnIndex) ||
+         poFeature->GetFieldAsInteger64(iFIDAsRegularColumnIndex) !=
+             poFeature->GetFID()))
+    {
+        CPLError(CE_Failure, CPLE_AppDefined,
+            "Inconsistent values of FID and field of same name");
+        return OGRERR_FAILURE;
+    }
+
+    /* -------------------------------------------------------------------- */
+    /*      Form the MERGE command. Its first marker is the FID, then come  */
+    /*      the columns in the order of the INSERT, and the VALUES of the   */
+    /*      WHEN NOT MATCHED branch repeat all of them.                     */
+    /* -------------------------------------------------------------------- */
+    if (m_poUpsertStatement == nullptr)
+    {
+        if (ReadInsertColumns() != OGRERR_NONE)
+            return OGRERR_FAILURE;
+
+        const CPLString osFIDColumn = OGRDAMENGEscapeColumnName(pszFIDColumn);
+        CPLString osSet;
+        CPLString osColumns(osFIDColumn);
+        CPLString osValues("?");
+        for (size_t i = 0; i < m_aosInsertColumns.size(); i++)
+        {
+            const CPLString osColumn =
+                OGRDAMENGEscapeColumnName(m_aosInsertColumns[i]);
+            if (i > 0)
+                osSet += ", ";
+            osSet += osColumn + " = ?";
+            osColumns += ", " + osColumn;
+            osValues += ", ?";
+        }
+
+        CPLString osSQL;
+        osSQL.Printf("MERGE INTO %s USING DUAL ON (%s = ?)", pszSqlTableName,
+            osFIDColumn.c_str());
+        if (!osSet.empty())
+            osSQL += " WHEN MATCHED THEN UPDATE SET " + osSet;
+        osSQL += " WHEN NOT MATCHED THEN INSERT (" + osColumns + ") VALUES (" +
+            osValues + ")";
+
+        for (const auto& oIter : mymap)
+            m_oUpsertMap[oIter.first] = oIter.second + 1;
+
+        m_poUpsertStatement =
+            std::make_unique<OGRDAMENGStatement>(poDS->GetDAMENGConn());
+        m_poUpsertStatement->SetStats(&m_oStats);
+        m_poUpsertStatement->SetBatchSize(nInsertBatchSize,
+            nInsertCommitInterval < 0 ? nInsertBatchSize
+            : nInsertCommitInterval);
+        m_poUpsertStatement->SetBatchLayout(
+            static_cast<int>(m_aosInsertColumns.size()) + 1, 1);
+        // Inserting the FID needs explicit values in its identity column.
+        m_poUpsertStatement->SetBatchCommands(
+            CPLSPrintf("SET IDENTITY_INSERT %s ON", pszSqlTableName),
+            CPLSPrintf("SET IDENTITY_INSERT %s OFF", pszSqlTableName));
+        if (m_poUpsertStatement->Prepare(osSQL) != CE_None)
+        {
+            m_poUpsertStatement.reset();
+            return OGRERR_FAILURE;
+        }
+    }
+
+    // Inserts buffered so far are sent first, to keep the order of writes.
+    if (InsertStatement != nullptr &&
+        InsertStatement->FlushInsert(false) != CE_None)
+        return OGRERR_FAILURE;
+
+    CPLErr eErr = m_poUpsertStatement->Execute_for_insert(
+        poFeatureDefn, poFeature, m_oUpsertMap);
+    return eErr == CE_None ? OGRERR_NONE : OGRERR_FAILURE;
+}
+
+/************************************************************************/
+/*                        FlushPendingInserts()                         */
+/*                                                                      */
+/*      Send the partial batches buffered by CreateFeatureViaInsert()   */
+/*      and IUpsertFeature() and commit them, so that they are visible  */
+/*      to the next statement.                                          */
+/************************************************************************/
+
+OGRErr OGRDAMENGTableLayer::FlushPendingInserts()
+
+{
+    OGRErr eErr = OGRERR_NONE;
+    if (InsertStatement != nullptr &&
+        InsertStatement->FlushInsert(true) != CE_None)
+        eErr = OGRERR_FAILURE;
+    if (m_poUpsertStatement != nullptr &&
+        m_poUpsertStatement->FlushInsert(true) != CE_None)
+        eErr = OGRERR_FAILURE;
+    return eErr;
+}
+
+/************************************************************************/
+/*                             SyncToDisk()                             */
+/************************************************************************/
+
+OGRErr OGRDAMENGTableLayer::SyncToDisk()
+
+{
+    OGRErr eErr = FlushPendingInserts();
+    if (eErr == OGRERR_NONE)
+        eErr = RunDeferredIndexCreation();
     return eErr;
 }
 
@@ -1501,7 +2274,7 @@ int OGRDAMENGTableLayer::TestCapability(const char* pszCap) const
             EQUAL(pszCap, OLCAlterGeomFieldDefn) || EQUAL(pszCap, OLCRename))
             return TRUE;
         else if (EQUAL(pszCap, OLCRandomWrite) || EQUAL(pszCap, OLCUpdateFeature) ||
-            EQUAL(pszCap, OLCDeleteFeature))
+            EQUAL(pszCap, OLCDeleteFeature) || EQUAL(pszCap, OLCUpsertFeature))
         {
             GetLayerDefn()->GetFieldCount();
             return pszFIDColumn != nullptr;
@@ -1516,8 +2289,22 @@ int OGRDAMENGTableLayer::TestCapability(const char* pszCap) const
     else if (EQUAL(pszCap, OLCFastFeatureCount) ||
         EQUAL(pszCap, OLCFastSetNextByIndex))
     {
+        // Pages follow the FID order: without a FID column, the order
+        // of the rows may change from one query to the next.
+        if (EQUAL(pszCap, OLCFastSetNextByIndex))
+        {
+            GetLayerDefn()->GetFieldCount();
+            if (pszFIDColumn == nullptr)
+                return FALSE;
+        }
+        if (m_bFilterMustBeClientSideEvaluated)
+            return FALSE;
         if (m_poFilterGeom == nullptr)
             return TRUE;
+        // Only the envelope of other filter geometries is evaluated
+        // by the server.
+        if (!m_bFilterIsEnvelope)
+            return FALSE;
         OGRDAMENGGeomFieldDefn* poGeomFieldDefn = nullptr;
         if (poFeatureDefn->GetGeomFieldCount() > 0)
             poGeomFieldDefn =
@@ -1527,6 +2314,9 @@ int OGRDAMENGTableLayer::TestCapability(const char* pszCap) const
                 poGeomFieldDefn->eDAMENGGeoType == GEOM_TYPE_GEOGRAPHY));
     }
 
+    else if (EQUAL(pszCap, OLCIgnoreFields))
+        return TRUE;
+
     else if (EQUAL(pszCap, OLCFastSpatialFilter))
     {
         OGRDAMENGGeomFieldDefn* poGeomFieldDefn = nullptr;
@@ -1538,6 +2328,23 @@ int OGRDAMENGTableLayer::TestCapability(const char* pszCap) const
                 poGeomFieldDefn->eDAMENGGeoType == GEOM_TYPE_GEOGRAPHY));
     }
 
+    else if (EQUAL(pszCap, OLCFastGetArrowStream))
+    {
+        if (m_bFilterMustBeClientSideEvaluated)
+            return FALSE;
+        if (m_poFilterGeom == nullptr)
+            return TRUE;
+        if (!m_bFilterIsEnvelope)
+            return FALSE;
+        OGRDAMENGGeomFieldDefn* poGeomFieldDefn = nullptr;
+        if (poFeatureDefn->GetGeomFieldCount() > 0)
+            poGeomFieldDefn =
+            poFeatureDefn->GetGeomFieldDefn(m_iGeomFieldFilter);
+        return poGeomFieldDefn == nullptr ||
+            ((poGeomFieldDefn->eDAMENGGeoType == GEOM_TYPE_GEOMETRY ||
+                poGeomFieldDefn->eDAMENGGeoType == GEOM_TYPE_GEOGRAPHY));
+    }
+
     else if (EQUAL(pszCap, OLCFastGetExtent) ||
         EQUAL(pszCap, OLCFastGetExtent3D))
     {
@@ -1578,6 +2385,7 @@ OGRErr OGRDAMENGTableLayer::CreateField(const OGRFieldDefn* poFieldIn,
     OGRFieldDefn oField(poFieldIn);
 
     GetLayerDefn()->GetFieldCount();
+    ClearStatementCache();
 
     if (pszFIDColumn != nullptr && EQUAL(oField.GetNameRef(), pszFIDColumn) &&
         oField.GetType() != OFTInteger && oField.GetType() != OFTInteger64)
@@ -1702,6 +2510,7 @@ OGRErr OGRDAMENGTableLayer::CreateGeomField(const OGRGeomFieldDefn* poGeomFieldI
             "Cannot create geometry field of type wkbNone");
         return OGRERR_FAILURE;
     }
+    ClearStatementCache();
 
     // Check if GEOMETRY_NAME layer creation option was set, but no initial
     // column was created in ICreateLayer()
@@ -1767,6 +2576,9 @@ OGRErr OGRDAMENGTableLayer::CreateGeomField(const OGRGeomFieldDefn* poGeomFieldI
 
     poFeatureDefn->AddGeomFieldDefn(std::move(poGeomField));
 
+    if (bCreateSpatialIndexFlag && !m_bDeferredIndexPending)
+        return RunCreateSpatialIndex(poFeatureDefn->GetGeomFieldCount() - 1);
+
     return OGRERR_NONE;
 }
 
@@ -1782,6 +2594,7 @@ OGRErr OGRDAMENGTableLayer::DeleteField(int iField)
     CPLString osCommand;
 
     GetLayerDefn()->GetFieldCount();
+    ClearStatementCache();
 
     if (iField < 0 || iField >= poFeatureDefn->GetFieldCount())
     {
@@ -1816,6 +2629,7 @@ OGRErr OGRDAMENGTableLayer::AlterFieldDefn(int iField,
     CPLString osCommand;
 
     GetLayerDefn()->GetFieldCount();
+    ClearStatementCache();
 
     if (iField < 0 || iField >= poFeatureDefn->GetFieldCount())
     {
@@ -1994,6 +2808,8 @@ OGRFeature* OGRDAMENGTableLayer::GetFeature(GIntBig nFeatureId)
 {
     GetLayerDefn()->GetFieldCount();
 
+    FlushPendingInserts();
+
     if (pszFIDColumn == nullptr)
         return OGRLayer::GetFeature(nFeatureId);
 
@@ -2001,32 +2817,37 @@ OGRFeature* OGRDAMENGTableLayer::GetFeature(GIntBig nFeatureId)
     /*      Issue query for a single record.                                */
     /* -------------------------------------------------------------------- */
     OGRFeature* poFeature = nullptr;
-    OGRDAMENGConn* hDAMENGConn = poDS->GetDAMENGConn();
-    OGRDAMENGStatement oCommand(hDAMENGConn);
     CPLErr eErr;
     CPLString osFieldList = BuildFields();
     CPLString osCommand;
 
-    osCommand.Printf("SELECT %s FROM %s WHERE %s = " CPL_FRMT_GIB,
+    osCommand.Printf("SELECT %s FROM %s WHERE %s = ?",
         osFieldList.c_str(), pszSqlTableName,
-        OGRDAMENGEscapeColumnName(pszFIDColumn).c_str(), nFeatureId);
+        OGRDAMENGEscapeColumnName(pszFIDColumn).c_str());
+
+    OGRDAMENGStatement* poCommand = GetPreparedStatement(osCommand);
+    if (poCommand == nullptr)
+        return nullptr;
+    poCommand->ClearParams();
+    poCommand->AddInt64Param(nFeatureId);
 
-    eErr = oCommand.Excute_for_fetchmany(osCommand);
+    // Two rows are enough to tell a unique FID from a duplicated one.
+    eErr = poCommand->Excute_for_fetchmany(nullptr, 2);
     if (eErr == CE_None)
     {
         sdint8 g_rows = 0;
         DPIRETURN rt;
-        rt = dpi_row_count(*(oCommand.GetStatement()), &g_rows);
+        rt = dpi_row_count(*(poCommand->GetStatement()), &g_rows);
 
         if (g_rows > 0)
         {
-            result = oCommand.Fetchmany((ulength*)&g_rows);
+            result = poCommand->Fetchmany((ulength*)&g_rows);
             int* panTempMapFieldNameToIndex = nullptr;
             int* panTempMapFieldNameToGeomIndex = nullptr;
-            CreateMapFromFieldNameToIndex(&oCommand, poFeatureDefn,
+            CreateMapFromFieldNameToIndex(poCommand, poFeatureDefn,
                 panTempMapFieldNameToIndex,
                 panTempMapFieldNameToGeomIndex);
-            poFeature = RecordToFeature(&oCommand, panTempMapFieldNameToIndex,
+            poFeature = RecordToFeature(poCommand, panTempMapFieldNameToIndex,
                 panTempMapFieldNameToGeomIndex, 0);
             CPLFree(panTempMapFieldNameToIndex);
             CPLFree(panTempMapFieldNameToGeomIndex);
@@ -2094,35 +2915,92 @@ OGRFeature* OGRDAMENGTableLayer::GetFeature(GIntBig nFeatureId)
 
 /************************************************************************/
 /*                          GetFeatureCount()                           */
+/*                                                                      */
+/*      The count of the whole table is cached until the next write,    */
+/*      and estimated from the table statistics when bForce is FALSE.   */
+/*      Rows written by other sessions meanwhile are not accounted for. */
 /************************************************************************/
 
 GIntBig OGRDAMENGTableLayer::GetFeatureCount(int bForce)
 
 {
-    /* -------------------------------------------------------------------- */
-    /*      In theory it might be wise to cache this result, but it         */
-    /*      won't be trivial to work out the lifetime of the value.         */
-    /*      After all someone else could be adding records from another     */
-    /*      application when working against a database.                    */
-    /* -------------------------------------------------------------------- */
+    if (TestCapability(OLCFastFeatureCount) == FALSE)
+        return OGRDAMENGLayer::GetFeatureCount(bForce);
+
+    const bool bWholeTable = osWHERE.empty();
+    if (bWholeTable && m_nCachedFeatureCount >= 0)
+        return m_nCachedFeatureCount;
+    if (bWholeTable && !bForce)
+    {
+        const GIntBig nEstimated = GetEstimatedFeatureCount();
+        if (nEstimated >= 0)
+            return nEstimated;
+    }
+
     OGRDAMENGConn* hDAMENGConn = poDS->GetDAMENGConn();
     OGRDAMENGStatement oCommand(hDAMENGConn);
     CPLString osCommand;
     GIntBig nCount = 0;
 
+    FlushPendingInserts();
+
     osCommand.Printf("SELECT count(*) FROM %s %s", pszSqlTableName,
         osWHERE.c_str());
 
+    oCommand.SetDoubleParams(m_adfQueryParams);
     CPLErr rt = oCommand.Execute(osCommand);
     char** hResult = oCommand.SimpleFetchRow();
     if (hResult != nullptr && DSQL_SUCCEEDED(rt))
+    {
         nCount = CPLAtoGIntBig(hResult[0]);
+        if (bWholeTable)
+            m_nCachedFeatureCount = nCount;
+    }
     else
         CPLDebug("DM", "%s; failed.", osCommand.c_str());
 
     return nCount;
 }
 
+/************************************************************************/
+/*                      GetEstimatedFeatureCount()                      */
+/*                                                                      */
+/*      Row count of the table as of its last statistics gathering, or  */
+/*      -1 if statistics were never gathered.                           */
+/************************************************************************/
+
+GIntBig OGRDAMENGTableLayer::GetEstimatedFeatureCount()
+
+{
+    OGRDAMENGStatement oCommand(poDS->GetDAMENGConn());
+    CPLString osCommand;
+    osCommand.Printf("SELECT NUM_ROWS FROM ALL_TABLES WHERE OWNER = '%s' "
+                     "AND TABLE_NAME = '%s'",
+                     CPLString(pszSchemaName).replaceAll('\'', "''").c_str(),
+                     CPLString(pszTableName).replaceAll('\'', "''").c_str());
+    if (oCommand.Execute(osCommand) != CE_None)
+        return -1;
+    char** papszRow = oCommand.SimpleFetchRow();
+    if (papszRow == nullptr || papszRow[0] == nullptr ||
+        papszRow[0][0] == '\0')
+        return -1;
+    return CPLAtoGIntBig(papszRow[0]);
+}
+
+/************************************************************************/
+/*                        InvalidateStatistics()                        */
+/*                                                                      */
+/*      Forget the cached count and extents, after the table changed.   */
+/************************************************************************/
+
+void OGRDAMENGTableLayer::InvalidateStatistics()
+
+{
+    m_nCachedFeatureCount = -1;
+    m_oCachedExtents.clear();
+    m_nKeysetIndex = -1;
+}
+
 /************************************************************************/
 /*                             ResolveSRID()                            */
 /************************************************************************/
@@ -2273,10 +3151,11 @@ void OGRDAMENGTableLayer::SetOverrideColumnTypes(const char* pszOverrideColumnTy
 }
 
 /************************************************************************/
-/*                             GetExtent()                              */
+/*                             IGetExtent()                             */
 /*                                                                      */
 /*      For DMGEO2 use internal ST_EstimatedExtent(geometry) function   */
-/*      if bForce == 0                                                  */
+/*      if bForce == 0. The extent of the whole table is cached until   */
+/*      the next write.                                                 */
 /************************************************************************/
 
 OGRErr OGRDAMENGTableLayer::IGetExtent(int iGeomField, OGREnvelope* psExtent,
@@ -2298,11 +3177,22 @@ OGRErr OGRDAMENGTableLayer::IGetExtent(int iGeomField, OGREnvelope* psExtent,
     OGRDAMENGGeomFieldDefn* poGeomFieldDefn =
         poFeatureDefn->GetGeomFieldDefn(iGeomField);
 
+    const auto oIter = m_oCachedExtents.find(iGeomField);
+    if (oIter != m_oCachedExtents.end())
+    {
+        *psExtent = oIter->second;
+        return OGRERR_NONE;
+    }
+
     if (bForce == 0 && poGeomFieldDefn->eDAMENGGeoType != GEOM_TYPE_GEOGRAPHY)
     {
         osCommand.Printf(
-            "SELECT DMGEO2.ST_EstimatedExtent(%s, %s, %s).ST_ASTEXT",
-            pszSchemaName, pszTableName, poGeomFieldDefn->GetNameRef());
+            "SELECT DMGEO2.ST_EstimatedExtent('%s', '%s', '%s').ST_ASTEXT",
+            CPLString(pszSchemaName).replaceAll('\'', "''").c_str(),
+            CPLString(pszTableName).replaceAll('\'', "''").c_str(),
+            CPLString(poGeomFieldDefn->GetNameRef())
+                .replaceAll('\'', "''")
+                .c_str());
         if (RunGetExtentRequest(*psExtent, bForce, osCommand, TRUE) ==
             OGRERR_NONE)
             return OGRERR_NONE;
@@ -2312,7 +3202,14 @@ OGRErr OGRDAMENGTableLayer::IGetExtent(int iGeomField, OGREnvelope* psExtent,
             "Unable to get estimated extent by DMGEO2. Trying real extent.");
     }
 
-    return OGRLayer::GetExtent(psExtent, bForce);
+    FlushPendingInserts();
+    const OGRErr eErr =
+        OGRDAMENGLayer::IGetExtent(iGeomField, psExtent, bForce);
+    // Without filters, even the extent computed by reading the features
+    // is the one of the whole table.
+    if (eErr == OGRERR_NONE && osWHERE.empty() && m_poAttrQuery == nullptr)
+        m_oCachedExtents[iGeomField] = *psExtent;
+    return eErr;
 }
 
 /************************************************************************/
@@ -2322,6 +3219,7 @@ OGRErr OGRDAMENGTableLayer::IGetExtent(int iGeomField, OGREnvelope* psExtent,
 OGRErr OGRDAMENGTableLayer::Rename(const char* pszNewName)
 {
     ResetReading();
+    ClearStatementCache();
 
     char* pszNewSqlTableName = CPLStrdup(OGRDAMENGEscapeColumnName(pszNewName));
     OGRDAMENGConn* hDAMENGConn = poDS->GetDAMENGConn();
@@ -2362,3 +3260,98 @@ void OGRDAMENGTableLayer::SetDeferredCreation(CPLString osCreateTableIn)
 {
     osCreateTable = osCreateTableIn;
 }
+
+/************************************************************************/
+/*                      SetDeferredIndexCreation()                      */
+/*                                                                      */
+/*      The first geometry column was created without its checks.       */
+/*      pszGeomColumnDefinition restores them, and is applied with      */
+/*      the spatial indexes by RunDeferredIndexCreation().              */
+/************************************************************************/
+
+void OGRDAMENGTableLayer::SetDeferredIndexCreation(
+    const char* pszGeomColumnDefinition)
+{
+    m_bDeferredIndexPending = true;
+    m_osDeferredGeomColumn =
+        pszGeomColumnDefinition ? pszGeomColumnDefinition : "";
+}
+
+/************************************************************************/
+/*                       RunCreateSpatialIndex()                        */
+/************************************************************************/
+
+OGRErr OGRDAMENGTableLayer::RunCreateSpatialIndex(int iGeomField)
+{
+    OGRDAMENGGeomFieldDefn* poGeomField =
+        poFeatureDefn->GetGeomFieldDefn(iGeomField);
+    if (poGeomField == nullptr)
+        return OGRERR_FAILURE;
+    if (poGeomField->eDAMENGGeoType != GEOM_TYPE_GEOMETRY)
+    {
+        CPLDebug("DAMENG", "No spatial index on geography column %s",
+            poGeomField->GetNameRef());
+        return OGRERR_NONE;
+    }
+
+    OGRDAMENGStatement oCommand(poDS->GetDAMENGConn());
+    CPLString osCommand;
+    osCommand.Printf("CREATE SPATIAL INDEX %s ON %s(%s)",
+        OGRDAMENGEscapeColumnName(CPLSPrintf("%s_%s_sidx", pszTableName,
+            poGeomField->GetNameRef())).c_str(),
+        pszSqlTableName,
+        OGRDAMENGEscapeColumnName(poGeomField->GetNameRef()).c_str());
+    if (oCommand.Execute(osCommand) != CE_None)
+    {
+        CPLError(CE_Failure, CPLE_AppDefined, "%s failed",
+            osCommand.c_str());
+        return OGRERR_FAILURE;
+    }
+    return OGRERR_NONE;
+}
+
+/************************************************************************/
+/*                      RunDeferredIndexCreation()                      */
+/*                                                                      */
+/*      Restore the checks of the geometry column and build the         */
+/*      spatial indexes in one pass over the loaded rows. As DDL        */
+/*      commits, this waits for the end of a user transaction.          */
+/************************************************************************/
+
+OGRErr OGRDAMENGTableLayer::RunDeferredIndexCreation()
+{
+    if (!m_bDeferredIndexPending)
+        return OGRERR_NONE;
+    if (poDS->IsUserTransactionActive())
+    {
+        CPLDebug("DAMENG",
+            "Index creation of %s deferred until the transaction ends",
+            GetName());
+        return OGRERR_NONE;
+    }
+    m_bDeferredIndexPending = false;
+
+    OGRErr eErr = OGRERR_NONE;
+    if (!m_osDeferredGeomColumn.empty())
+    {
+        OGRDAMENGStatement oCommand(poDS->GetDAMENGConn());
+        CPLString osCommand;
+        osCommand.Printf("ALTER TABLE %s MODIFY %s", pszSqlTableName,
+            m_osDeferredGeomColumn.c_str());
+        if (oCommand.Execute(osCommand) != CE_None)
+        {
+            CPLError(CE_Failure, CPLE_AppDefined,
+                "Cannot add the geometry checks of %s: %s", GetName(),
+                osCommand.c_str());
+            eErr = OGRERR_FAILURE;
+        }
+    }
+
+    for (int i = 0; bCreateSpatialIndexFlag &&
+                    i < poFeatureDefn->GetGeomFieldCount(); i++)
+    {
+        if (RunCreateSpatialIndex(i) != OGRERR_NONE)
+            eErr = OGRERR_FAILURE;
+    }
+    return eErr;
+}
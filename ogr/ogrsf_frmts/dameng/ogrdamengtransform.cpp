@@ -1330,6 +1330,452 @@ GSERIALIZED* OGRDAMENGGeoFromHexwkb(const char* pszLEHex, size_t* size, OGREnvel
     return result;
 }
 
+/************************************************************************/
+/*      Direct OGRGeometry -> GSERIALIZED encoding.                     */
+/*                                                                      */
+/*      Produces the same layout as gserialized_from_wkb(), but walks   */
+/*      the OGRGeometry tree instead of a hex EWKB string, and writes   */
+/*      into a buffer owned by the caller that is reused across rows.   */
+/************************************************************************/
+
+static GUInt32 gser_type_from_geometry(const OGRGeometry* poGeom)
+{
+    switch (wkbFlatten(poGeom->getGeometryType()))
+    {
+    case wkbPoint:
+        return DM_POINT;
+    case wkbLineString:
+        return DM_LINE;
+    case wkbPolygon:
+        return DM_POLYGON;
+    case wkbMultiPoint:
+        return DM_MULTIPOINT;
+    case wkbMultiLineString:
+        return DM_MULTILINE;
+    case wkbMultiPolygon:
+        return DM_MULTIPOLYGON;
+    case wkbGeometryCollection:
+        return DM_COLLECTION;
+    case wkbCircularString:
+        return DM_CIRCSTRING;
+    case wkbCompoundCurve:
+        return DM_COMPOUND;
+    case wkbCurvePolygon:
+        return DM_CURVEPOLY;
+    case wkbMultiCurve:
+        return DM_MULTICURVE;
+    case wkbMultiSurface:
+        return DM_MULTISURFACE;
+    case wkbPolyhedralSurface:
+        return DM_POLYHEDRALSURFACE;
+    case wkbTIN:
+        return DM_TIN;
+    case wkbTriangle:
+        return DM_TRIANGLE;
+    default:
+        break;
+    }
+    return 0;
+}
+
+/* Running bbox of the encoder; OGREnvelope3D has no M range. */
+typedef struct
+{
+    OGREnvelope3D env;
+    double MinM;
+    double MaxM;
+} gser_box;
+
+/* Number of sub-geometries serialized after a collection-like head. */
+static int gser_sub_count(const OGRGeometry* poGeom, GUInt32 type)
+{
+    switch (type)
+    {
+    case DM_CURVEPOLY:
+    {
+        const OGRCurvePolygon* poCP = poGeom->toCurvePolygon();
+        return poCP->getExteriorRingCurve() == NULL
+            ? 0 : 1 + poCP->getNumInteriorRings();
+    }
+    case DM_COMPOUND:
+        return poGeom->toCompoundCurve()->getNumCurves();
+    case DM_POLYHEDRALSURFACE:
+    case DM_TIN:
+        return poGeom->toPolyhedralSurface()->getNumGeometries();
+    default:
+        return poGeom->toGeometryCollection()->getNumGeometries();
+    }
+}
+
+static const OGRGeometry* gser_sub_geometry(const OGRGeometry* poGeom,
+    GUInt32 type, int i)
+{
+    switch (type)
+    {
+    case DM_CURVEPOLY:
+    {
+        const OGRCurvePolygon* poCP = poGeom->toCurvePolygon();
+        return i == 0 ? poCP->getExteriorRingCurve()
+            : poCP->getInteriorRingCurve(i - 1);
+    }
+    case DM_COMPOUND:
+        return poGeom->toCompoundCurve()->getCurve(i);
+    case DM_POLYHEDRALSURFACE:
+    case DM_TIN:
+        return poGeom->toPolyhedralSurface()->getGeometryRef(i);
+    default:
+        return poGeom->toGeometryCollection()->getGeometryRef(i);
+    }
+}
+
+static GInt8 gser_point_is_empty(const OGRPoint* poPoint)
+{
+    /* POINT(NaN NaN) is serialized as POINT EMPTY, as in the WKB path. */
+    return poPoint->IsEmpty() ||
+        (isnan(poPoint->getX()) && isnan(poPoint->getY()));
+}
+
+/**
+* Exact serialized size of the body of poGeom, without the GSERIALIZED
+* head and bbox. Only point counts are read, no ordinates.
+*/
+static size_t gser_size_from_geometry(const OGRGeometry* poGeom, int ndims,
+    int depth)
+{
+    const size_t ptsize = ndims * DOUBLE_SIZE;
+    size_t size = 2 * INT_SIZE; /* Type number and count. */
+    GUInt32 type = gser_type_from_geometry(poGeom);
+
+    switch (type)
+    {
+    case DM_POINT:
+        if (!gser_point_is_empty(poGeom->toPoint()))
+            size += ptsize;
+        return size;
+    case DM_LINE:
+    case DM_CIRCSTRING:
+        return size + poGeom->toSimpleCurve()->getNumPoints() * ptsize;
+    case DM_TRIANGLE:
+    {
+        const OGRCurve* poRing = poGeom->toPolygon()->getExteriorRingCurve();
+        if (poRing != NULL)
+            size += poRing->getNumPoints() * ptsize;
+        return size;
+    }
+    case DM_POLYGON:
+    {
+        const OGRPolygon* poPoly = poGeom->toPolygon();
+        const int nrings = poPoly->getExteriorRing() == NULL
+            ? 0 : 1 + poPoly->getNumInteriorRings();
+        size += nrings * INT_SIZE;
+        if (nrings % 2)
+            size += INT_SIZE; /* Padding to double alignment. */
+        for (int i = 0; i < nrings; i++)
+        {
+            const OGRLinearRing* poRing = i == 0 ? poPoly->getExteriorRing()
+                : poPoly->getInteriorRing(i - 1);
+            size += poRing->getNumPoints() * ptsize;
+        }
+        return size;
+    }
+    case 0:
+        return 0;
+    default:
+    {
+        if (depth >= MAX_DEPTH)
+            return 0;
+        const int ngeoms = gser_sub_count(poGeom, type);
+        for (int i = 0; i < ngeoms; i++)
+        {
+            const size_t subsize = gser_size_from_geometry(
+                gser_sub_geometry(poGeom, type, i), ndims, depth + 1);
+            if (subsize == 0)
+                return 0;
+            size += subsize;
+        }
+        return size;
+    }
+    }
+}
+
+/**
+* Copy the ordinates of a simple curve to loc and widen the envelope
+* with them while they are still in cache.
+*/
+static GByte* gser_points_from_curve(const OGRSimpleCurve* poCurve,
+    GByte* loc, wkb_info* info, gser_box* psBox)
+{
+    const int npoints = poCurve->getNumPoints();
+    const int stride = info->ndims * DOUBLE_SIZE;
+
+    if (npoints == 0)
+        return loc;
+
+    poCurve->getPoints(loc, stride, loc + DOUBLE_SIZE, stride,
+        info->has_z ? loc + 2 * DOUBLE_SIZE : NULL, stride,
+        info->has_m ? loc + (2 + info->has_z) * DOUBLE_SIZE : NULL, stride);
+
+    for (int i = 0; i < npoints; i++)
+    {
+        double xyz[4];
+        memcpy(xyz, loc + i * stride, stride);
+        if (xyz[0] < psBox->env.MinX) psBox->env.MinX = xyz[0];
+        if (xyz[0] > psBox->env.MaxX) psBox->env.MaxX = xyz[0];
+        if (xyz[1] < psBox->env.MinY) psBox->env.MinY = xyz[1];
+        if (xyz[1] > psBox->env.MaxY) psBox->env.MaxY = xyz[1];
+        if (info->has_z)
+        {
+            if (xyz[2] < psBox->env.MinZ) psBox->env.MinZ = xyz[2];
+            if (xyz[2] > psBox->env.MaxZ) psBox->env.MaxZ = xyz[2];
+        }
+        if (info->has_m)
+        {
+            const double m = xyz[2 + info->has_z];
+            if (m < psBox->MinM) psBox->MinM = m;
+            if (m > psBox->MaxM) psBox->MaxM = m;
+        }
+    }
+    return loc + (size_t)npoints * stride;
+}
+
+static GByte* gser_from_geometry(const OGRGeometry* poGeom, GByte* loc,
+    wkb_info* info, gser_box* psBox, int depth)
+{
+    const size_t ptsize = info->ndims * DOUBLE_SIZE;
+    GUInt32 type = gser_type_from_geometry(poGeom);
+
+    switch (type)
+    {
+    case DM_POINT:
+    {
+        const OGRPoint* poPoint = poGeom->toPoint();
+        if (gser_point_is_empty(poPoint))
+            return gser_head_from_wkb_state(loc, DM_POINT, 0);
+
+        double xyzm[4];
+        int n = 0;
+        xyzm[n++] = poPoint->getX();
+        xyzm[n++] = poPoint->getY();
+        if (info->has_z)
+            xyzm[n++] = poPoint->getZ();
+        if (info->has_m)
+            xyzm[n++] = poPoint->getM();
+
+        loc = gser_head_from_wkb_state(loc, DM_POINT, 1);
+        memcpy(loc, xyzm, ptsize);
+        psBox->env.Merge(xyzm[0], xyzm[1], info->has_z ? xyzm[2] : 0.0);
+        if (info->has_m)
+        {
+            if (xyzm[n - 1] < psBox->MinM) psBox->MinM = xyzm[n - 1];
+            if (xyzm[n - 1] > psBox->MaxM) psBox->MaxM = xyzm[n - 1];
+        }
+        return loc + ptsize;
+    }
+    case DM_LINE:
+    case DM_CIRCSTRING:
+    {
+        const OGRSimpleCurve* poCurve = poGeom->toSimpleCurve();
+        const int npoints = poCurve->getNumPoints();
+        if (type == DM_LINE && npoints == 1)
+        {
+            CPLError(CE_Failure, CPLE_AppDefined, "must have at least two points");
+            return NULL;
+        }
+        if (type == DM_CIRCSTRING && npoints > 0)
+        {
+            if (npoints < 3)
+            {
+                CPLError(CE_Failure, CPLE_AppDefined,
+                    "must have at least three points");
+                return NULL;
+            }
+            if (!(npoints % 2))
+            {
+                CPLError(CE_Failure, CPLE_AppDefined,
+                    "must have an odd number of points");
+                return NULL;
+            }
+        }
+        loc = gser_head_from_wkb_state(loc, type, npoints);
+        return gser_points_from_curve(poCurve, loc, info, psBox);
+    }
+    case DM_TRIANGLE:
+    {
+        const OGRCurve* poRing = poGeom->toPolygon()->getExteriorRingCurve();
+        if (poRing == NULL || poRing->getNumPoints() < 4)
+        {
+            CPLError(CE_Failure, CPLE_AppDefined, "must have at least four points");
+            return NULL;
+        }
+        const OGRSimpleCurve* poCurve = poRing->toSimpleCurve();
+        loc = gser_head_from_wkb_state(loc, DM_TRIANGLE, poCurve->getNumPoints());
+        GByte* ptstart = loc;
+        loc = gser_points_from_curve(poCurve, loc, info, psBox);
+        if (memcmp(ptstart, loc - ptsize, (2 + info->has_z) * DOUBLE_SIZE))
+        {
+            CPLError(CE_Failure, CPLE_AppDefined, "must have closed rings");
+            return NULL;
+        }
+        return loc;
+    }
+    case DM_POLYGON:
+    {
+        const OGRPolygon* poPoly = poGeom->toPolygon();
+        const int nrings = poPoly->getExteriorRing() == NULL
+            ? 0 : 1 + poPoly->getNumInteriorRings();
+
+        loc = gser_head_from_wkb_state(loc, DM_POLYGON, nrings);
+
+        /* Write in the npoints per ring. */
+        for (int i = 0; i < nrings; i++)
+        {
+            const OGRLinearRing* poRing = i == 0 ? poPoly->getExteriorRing()
+                : poPoly->getInteriorRing(i - 1);
+            GUInt32 npoints = poRing->getNumPoints();
+            if (npoints < 4)
+            {
+                CPLError(CE_Failure, CPLE_AppDefined,
+                    "must have at least four points in each ring");
+                return NULL;
+            }
+            memcpy(loc, &npoints, sizeof(GUInt32));
+            loc += sizeof(GUInt32);
+        }
+
+        /* Add in padding if necessary to remain double aligned. */
+        if (nrings % 2)
+        {
+            memset(loc, 0, sizeof(GUInt32));
+            loc += sizeof(GUInt32);
+        }
+
+        /* Copy in the ordinates. */
+        for (int i = 0; i < nrings; i++)
+        {
+            const OGRLinearRing* poRing = i == 0 ? poPoly->getExteriorRing()
+                : poPoly->getInteriorRing(i - 1);
+            GByte* ptstart = loc;
+            loc = gser_points_from_curve(poRing, loc, info, psBox);
+            if (memcmp(ptstart, loc - ptsize, (2 + info->has_z) * DOUBLE_SIZE))
+            {
+                CPLError(CE_Failure, CPLE_AppDefined, "must have closed rings");
+                return NULL;
+            }
+        }
+        return loc;
+    }
+    case 0:
+        CPLError(CE_Failure, CPLE_AppDefined, "Unsupported geometry type");
+        return NULL;
+    default:
+    {
+        if (depth >= MAX_DEPTH)
+        {
+            CPLError(CE_Failure, CPLE_AppDefined,
+                "Geometry has too many chained collections");
+            return NULL;
+        }
+        const int ngeoms = gser_sub_count(poGeom, type);
+        loc = gser_head_from_wkb_state(loc, type, ngeoms);
+        for (int i = 0; i < ngeoms && loc != NULL; i++)
+            loc = gser_from_geometry(gser_sub_geometry(poGeom, type, i), loc,
+                info, psBox, depth + 1);
+        return loc;
+    }
+    }
+}
+
+/************************************************************************/
+/*                       OGRDAMENGGeometryToGser()                      */
+/*                                                                      */
+/*      Serialize poGeom into *ppabyBuf, growing it (and *pnBufSize)    */
+/*      when it is too small. Returns the serialized size, or 0 on      */
+/*      failure. The bbox is accumulated while the ordinates are        */
+/*      copied, so the geometry is only walked once.                    */
+/************************************************************************/
+
+size_t OGRDAMENGGeometryToGser(const OGRGeometry* poGeom, int nSRSId,
+    GByte** ppabyBuf, size_t* pnBufSize)
+{
+    wkb_info info;
+    gser_box sBox;
+    GSERIALIZED* g;
+    GByte* body;
+    GByte* end;
+    size_t boxsize;
+    size_t bodysize;
+    size_t size;
+    int srid;
+
+    if (poGeom == NULL)
+        return 0;
+
+    memset(&info, 0, sizeof(info));
+    info.has_z = poGeom->Is3D() ? 1 : 0;
+    info.has_m = poGeom->IsMeasured() ? 1 : 0;
+    info.ndims = 2 + info.has_z + info.has_m;
+
+    bodysize = gser_size_from_geometry(poGeom, info.ndims, 1);
+    if (bodysize == 0)
+    {
+        CPLError(CE_Failure, CPLE_AppDefined,
+            "Unsupported geometry type or too many chained collections");
+        return 0;
+    }
+
+    /* Room is reserved for a bbox; it is dropped afterwards if unused. */
+    boxsize = 2 * info.ndims * FLOAT_SIZE;
+    sBox.MinM = DBL_MAX;
+    sBox.MaxM = -DBL_MAX;
+    if (*ppabyBuf == NULL || *pnBufSize < 8 + boxsize + bodysize)
+    {
+        *pnBufSize = 8 + boxsize + bodysize;
+        *ppabyBuf = (GByte*)CPLRealloc(*ppabyBuf, *pnBufSize);
+    }
+
+    body = *ppabyBuf + 8 + boxsize;
+    end = gser_from_geometry(poGeom, body, &info, &sBox, 1);
+    if (end == NULL)
+        return 0;
+
+    g = (GSERIALIZED*)(*ppabyBuf);
+    g->gflags = 0;
+    DM_SET_Z(g->gflags, info.has_z);
+    DM_SET_M(g->gflags, info.has_m);
+    DM_SET_VERSION(g->gflags, 1);
+
+    srid = nSRSId > 0 ? clamp_srid(nSRSId) : 0;
+    g->srid[0] = (GByte)((srid & 0x001F0000) >> 16);
+    g->srid[1] = (GByte)((srid & 0x0000FF00) >> 8);
+    g->srid[2] = (GByte)((srid & 0x000000FF));
+
+    /* Same rule as get_wkb_info_from_wkb(): no box for degenerate extents. */
+    if (sBox.env.IsInit() && sBox.env.MaxX != sBox.env.MinX &&
+        sBox.env.MaxY != sBox.env.MinY)
+    {
+        GByte* box = *ppabyBuf + 8;
+        DM_SET_BBOX(g->gflags, 1);
+        box += gser_from_gbox(&sBox.env, box, info.has_z, info.has_m);
+        if (info.has_m)
+        {
+            /* The reader expects the M range after X, Y and Z. */
+            float m[2];
+            m[0] = next_float_down(sBox.MinM);
+            m[1] = next_float_up(sBox.MaxM);
+            memcpy(box, m, sizeof(m));
+        }
+    }
+    else
+    {
+        memmove(*ppabyBuf + 8, body, end - body);
+        end -= boxsize;
+    }
+
+    size = (size_t)(end - *ppabyBuf);
+    DM_SIZE_SET(g->size, size);
+    return size;
+}
+
 static GUInt32 get_wkb_type(GByte type, GByte has_z, GByte has_m, GByte has_srid)
 {
     GUInt32 wkb_type = 0;
@@ -2087,3 +2533,554 @@ GByte* OGRDAMENGGeoToHexwkb(GSERIALIZED* geom,
 
     return wkb;
 }
+
+/************************************************************************/
+/*      Direct GSERIALIZED -> OGRGeometry / ISO WKB decoding.           */
+/*                                                                      */
+/*      Reads the serialized point arrays in place instead of going     */
+/*      through a freshly allocated EWKB buffer.                        */
+/************************************************************************/
+
+typedef struct
+{
+    const GByte* pos;        /* Current parse position */
+    const GByte* end;        /* End of the serialized geometry */
+    GInt8 has_z;
+    GInt8 has_m;
+    GInt8 ndims;
+    int depth;
+    /* Scratch arrays used to de-interleave XYZ/XYM/XYZM point lists. */
+    OGRRawPoint* xy;
+    double* z;
+    double* m;
+    GUInt32 scratch_size;
+} gser_reader;
+
+static GInt8 gser_read_check(gser_reader* reader, size_t next)
+{
+    if (next > (size_t)(reader->end - reader->pos))
+    {
+        CPLError(CE_Failure, CPLE_AppDefined,
+            "GSERIALIZED structure does not match expected size!");
+        return TRUE;
+    }
+    return FALSE;
+}
+
+static GUInt32 gser_read_uint32(gser_reader* reader)
+{
+    GUInt32 value;
+    memcpy(&value, reader->pos, INT_SIZE);
+    reader->pos += INT_SIZE;
+    return value;
+}
+
+/**
+* Set up the reader on the body of gser: validates the header against
+* nSize (0 to trust the size stored in the header) and skips the
+* extended flags and bbox.
+*/
+static CPLErr gser_reader_init(gser_reader* reader, const GSERIALIZED* gser,
+    size_t nSize)
+{
+    memset(reader, 0, sizeof(gser_reader));
+    if (nSize != 0 && nSize < 8)
+    {
+        CPLError(CE_Failure, CPLE_AppDefined,
+            "DAMENG:Invalid Input Geometry Data!");
+        return CE_Failure;
+    }
+
+    /* The size in the header must not exceed the bytes actually read. */
+    const size_t gsize = gser->size >> 2;
+    if (gsize < 8 || (nSize != 0 && gsize > nSize))
+    {
+        CPLError(CE_Failure, CPLE_AppDefined,
+            "DAMENG:Invalid Input Geometry Data!");
+        return CE_Failure;
+    }
+
+    reader->has_z = DM_GET_Z(gser->gflags);
+    reader->has_m = DM_GET_M(gser->gflags);
+    reader->ndims = 2 + reader->has_z + reader->has_m;
+    reader->pos = gser->data;
+    reader->end = (const GByte*)gser + gsize;
+
+    if (DM_GET_EXTENDED(gser->gflags))
+        reader->pos += sizeof(size_t);
+
+    if (DM_GET_BBOX(gser->gflags))
+    {
+        if (DM_GET_GEODETIC(gser->gflags))
+            reader->pos += 3 * 2 * sizeof(float);
+        else
+            reader->pos += (2 + reader->has_z + reader->has_m) * 2 * sizeof(float);
+    }
+
+    if (reader->pos > reader->end)
+    {
+        CPLError(CE_Failure, CPLE_AppDefined,
+            "DAMENG:Invalid Input Geometry Data!");
+        return CE_Failure;
+    }
+    return CE_None;
+}
+
+static void gser_reader_free(gser_reader* reader)
+{
+    CPLFree(reader->xy);
+    CPLFree(reader->z);
+    CPLFree(reader->m);
+}
+
+/**
+* Copy npoints serialized points into poCurve. 2D point lists have the
+* OGRRawPoint layout and are copied in one go; the others are split into
+* the reader's scratch arrays first.
+*/
+static GInt8 gser_points_to_curve(gser_reader* reader, GUInt32 npoints,
+    OGRSimpleCurve* poCurve)
+{
+    const size_t ptsize = reader->ndims * DOUBLE_SIZE;
+
+    if (npoints > INT_MAX / ptsize || gser_read_check(reader, npoints * ptsize))
+        return FALSE;
+
+    if (reader->ndims == 2)
+    {
+        poCurve->setPoints((int)npoints, (const OGRRawPoint*)reader->pos);
+    }
+    else
+    {
+        GUInt32 i;
+
+        if (npoints > reader->scratch_size)
+        {
+            reader->xy = (OGRRawPoint*)CPLRealloc(reader->xy,
+                npoints * sizeof(OGRRawPoint));
+            reader->z = (double*)CPLRealloc(reader->z, npoints * sizeof(double));
+            reader->m = (double*)CPLRealloc(reader->m, npoints * sizeof(double));
+            reader->scratch_size = npoints;
+        }
+        for (i = 0; i < npoints; i++)
+        {
+            double xyzm[4];
+            memcpy(xyzm, reader->pos + i * ptsize, ptsize);
+            reader->xy[i].x = xyzm[0];
+            reader->xy[i].y = xyzm[1];
+            if (reader->has_z)
+                reader->z[i] = xyzm[2];
+            if (reader->has_m)
+                reader->m[i] = xyzm[2 + reader->has_z];
+        }
+        if (reader->has_z && reader->has_m)
+            poCurve->setPoints((int)npoints, reader->xy, reader->z, reader->m);
+        else if (reader->has_z)
+            poCurve->setPoints((int)npoints, reader->xy, reader->z);
+        else
+            poCurve->setPointsM((int)npoints, reader->xy, reader->m);
+    }
+    reader->pos += npoints * ptsize;
+    return TRUE;
+}
+
+static OGRGeometry* gser_to_geometry(gser_reader* reader, int parent_type);
+
+static OGRGeometry* gser_collection_to_geometry(gser_reader* reader,
+    GUInt32 type, GUInt32 ngeoms)
+{
+    OGRGeometry* poGeom;
+    GUInt32 i;
+
+    if (reader->depth >= MAX_DEPTH)
+    {
+        CPLError(CE_Failure, CPLE_AppDefined,
+            "Geometry has too many chained collections");
+        return NULL;
+    }
+
+    switch (type)
+    {
+    case DM_MULTIPOINT: poGeom = new OGRMultiPoint(); break;
+    case DM_MULTILINE: poGeom = new OGRMultiLineString(); break;
+    case DM_MULTIPOLYGON: poGeom = new OGRMultiPolygon(); break;
+    case DM_COMPOUND: poGeom = new OGRCompoundCurve(); break;
+    case DM_CURVEPOLY: poGeom = new OGRCurvePolygon(); break;
+    case DM_MULTICURVE: poGeom = new OGRMultiCurve(); break;
+    case DM_MULTISURFACE: poGeom = new OGRMultiSurface(); break;
+    case DM_POLYHEDRALSURFACE: poGeom = new OGRPolyhedralSurface(); break;
+    case DM_TIN: poGeom = new OGRTriangulatedSurface(); break;
+    default: poGeom = new OGRGeometryCollection(); break;
+    }
+
+    reader->depth++;
+    for (i = 0; i < ngeoms; i++)
+    {
+        OGRGeometry* poSub = gser_to_geometry(reader, type);
+        OGRErr eErr;
+
+        if (poSub == NULL)
+        {
+            delete poGeom;
+            return NULL;
+        }
+
+        if (type == DM_COMPOUND)
+            eErr = poGeom->toCompoundCurve()->addCurveDirectly(poSub->toCurve());
+        else if (type == DM_CURVEPOLY)
+            eErr = poGeom->toCurvePolygon()->addRingDirectly(poSub->toCurve());
+        else if (type == DM_POLYHEDRALSURFACE || type == DM_TIN)
+            eErr = poGeom->toPolyhedralSurface()->addGeometryDirectly(poSub);
+        else
+            eErr = poGeom->toGeometryCollection()->addGeometryDirectly(poSub);
+
+        if (eErr != OGRERR_NONE)
+        {
+            CPLError(CE_Failure, CPLE_AppDefined,
+                "DAMENG:Invalid Input Geometry Data!");
+            delete poSub;
+            delete poGeom;
+            return NULL;
+        }
+    }
+    reader->depth--;
+    return poGeom;
+}
+
+static OGRGeometry* gser_to_geometry(gser_reader* reader, int parent_type)
+{
+    GUInt32 type;
+    GUInt32 count;
+
+    if (gser_read_check(reader, 2 * INT_SIZE))
+        return NULL;
+    type = gser_read_uint32(reader);
+    count = gser_read_uint32(reader);
+
+    if (parent_type && !collection_allows_subtype(parent_type, type))
+    {
+        CPLError(CE_Failure, CPLE_AppDefined,
+            "DAMENG:Invalid Input Geometry Data!");
+        return NULL;
+    }
+
+    switch (type)
+    {
+    case DM_POINT:
+    {
+        OGRPoint* poPoint = new OGRPoint();
+        if (count > 0)
+        {
+            double xyzm[4];
+            if (gser_read_check(reader, reader->ndims * DOUBLE_SIZE))
+            {
+                delete poPoint;
+                return NULL;
+            }
+            memcpy(xyzm, reader->pos, reader->ndims * DOUBLE_SIZE);
+            reader->pos += reader->ndims * DOUBLE_SIZE;
+            poPoint->setX(xyzm[0]);
+            poPoint->setY(xyzm[1]);
+            if (reader->has_z)
+                poPoint->setZ(xyzm[2]);
+            if (reader->has_m)
+                poPoint->setM(xyzm[2 + reader->has_z]);
+        }
+        return poPoint;
+    }
+    case DM_LINE:
+    case DM_CIRCSTRING:
+    {
+        OGRSimpleCurve* poCurve;
+        if (type == DM_LINE)
+            poCurve = new OGRLineString();
+        else
+            poCurve = new OGRCircularString();
+        if (!gser_points_to_curve(reader, count, poCurve))
+        {
+            delete poCurve;
+            return NULL;
+        }
+        return poCurve;
+    }
+    case DM_TRIANGLE:
+    {
+        OGRTriangle* poTriangle = new OGRTriangle();
+        if (count > 0)
+        {
+            OGRLinearRing* poRing = new OGRLinearRing();
+            if (!gser_points_to_curve(reader, count, poRing) ||
+                poTriangle->addRingDirectly(poRing) != OGRERR_NONE)
+            {
+                CPLError(CE_Failure, CPLE_AppDefined,
+                    "DAMENG:Invalid Input Geometry Data!");
+                delete poRing;
+                delete poTriangle;
+                return NULL;
+            }
+        }
+        return poTriangle;
+    }
+    case DM_POLYGON:
+    {
+        OGRPolygon* poPoly = new OGRPolygon();
+        const GByte* npoints_ptr = reader->pos;
+        GUInt32 i;
+
+        /* Ring sizes, then padding back to double alignment. */
+        if (count > (size_t)(reader->end - reader->pos) / INT_SIZE ||
+            gser_read_check(reader, count * INT_SIZE + ((count % 2) ? INT_SIZE : 0)))
+        {
+            delete poPoly;
+            return NULL;
+        }
+        reader->pos += count * INT_SIZE + ((count % 2) ? INT_SIZE : 0);
+
+        for (i = 0; i < count; i++)
+        {
+            OGRLinearRing* poRing = new OGRLinearRing();
+            GUInt32 npoints;
+
+            memcpy(&npoints, npoints_ptr + i * INT_SIZE, INT_SIZE);
+            if (!gser_points_to_curve(reader, npoints, poRing))
+            {
+                delete poRing;
+                delete poPoly;
+                return NULL;
+            }
+            poPoly->addRingDirectly(poRing);
+        }
+        return poPoly;
+    }
+    case DM_MULTIPOINT:
+    case DM_MULTILINE:
+    case DM_MULTIPOLYGON:
+    case DM_COMPOUND:
+    case DM_CURVEPOLY:
+    case DM_MULTICURVE:
+    case DM_MULTISURFACE:
+    case DM_POLYHEDRALSURFACE:
+    case DM_TIN:
+    case DM_COLLECTION:
+        return gser_collection_to_geometry(reader, type, count);
+    default:
+        CPLError(CE_Failure, CPLE_AppDefined, "Unsupported geometry type");
+        return NULL;
+    }
+}
+
+/************************************************************************/
+/*                      OGRDAMENGGeometryFromGser()                     */
+/*                                                                      */
+/*      Build an OGRGeometry straight from a GSERIALIZED value. nSize   */
+/*      is the size of the buffer, or 0 to rely on the header.          */
+/************************************************************************/
+
+OGRGeometry* OGRDAMENGGeometryFromGser(const GSERIALIZED* gser, size_t nSize)
+{
+    gser_reader reader;
+    OGRGeometry* poGeom;
+
+    if (gser == NULL || gser_reader_init(&reader, gser, nSize) != CE_None)
+        return NULL;
+
+    poGeom = gser_to_geometry(&reader, 0);
+    gser_reader_free(&reader);
+
+    /* Empty parts carry no ordinates, so set the dimension explicitly. */
+    if (poGeom != NULL && reader.has_z)
+        poGeom->set3D(TRUE);
+    if (poGeom != NULL && reader.has_m)
+        poGeom->setMeasured(TRUE);
+    return poGeom;
+}
+
+static GByte* iso_wkb_header(GByte* buf, GUInt32 type, GInt8 has_z,
+    GInt8 has_m, GUInt32 count)
+{
+    GUInt32 wkb_type = get_wkb_type((GByte)type, 0, 0, 0);
+
+    if (has_z)
+        wkb_type += 1000;
+    if (has_m)
+        wkb_type += 2000;
+
+    buf = endian_to_wkb_buf(buf);
+    memcpy(buf, &wkb_type, INT_SIZE);
+    buf += INT_SIZE;
+    memcpy(buf, &count, INT_SIZE);
+    return buf + INT_SIZE;
+}
+
+/**
+* Write the ISO WKB of the geometry at reader->pos to buf, or only
+* compute its size when buf is NULL. Returns the number of bytes, or 0
+* when the serialized form is invalid.
+*/
+static size_t gser_to_iso_wkb(gser_reader* reader, GByte* buf, int parent_type)
+{
+    const size_t ptsize = reader->ndims * DOUBLE_SIZE;
+    const size_t headsize = BYTE_SIZE + 2 * INT_SIZE;
+    GUInt32 type;
+    GUInt32 count;
+    GUInt32 i;
+
+    if (gser_read_check(reader, 2 * INT_SIZE))
+        return 0;
+    type = gser_read_uint32(reader);
+    count = gser_read_uint32(reader);
+
+    if (parent_type && !collection_allows_subtype(parent_type, type))
+    {
+        CPLError(CE_Failure, CPLE_AppDefined,
+            "DAMENG:Invalid Input Geometry Data!");
+        return 0;
+    }
+
+    switch (type)
+    {
+    case DM_POINT:
+    {
+        /* ISO WKB has no count for points; POINT EMPTY is all NaN. */
+        const size_t size = BYTE_SIZE + INT_SIZE + ptsize;
+        if (count > 0 && gser_read_check(reader, ptsize))
+            return 0;
+        if (buf)
+        {
+            GByte* loc = iso_wkb_header(buf, type, reader->has_z,
+                reader->has_m, 0) - INT_SIZE;
+            if (count > 0)
+                memcpy(loc, reader->pos, ptsize);
+            else
+                for (i = 0; i < (GUInt32)reader->ndims; i++)
+                    loc = double_nan_to_wkb_buf(loc);
+        }
+        if (count > 0)
+            reader->pos += ptsize;
+        return size;
+    }
+    case DM_LINE:
+    case DM_CIRCSTRING:
+    case DM_TRIANGLE:
+    {
+        /* A triangle is serialized as its ring, without a ring count. */
+        const size_t ringhead = (type == DM_TRIANGLE && count > 0) ? INT_SIZE : 0;
+        if (count > INT_MAX / ptsize || gser_read_check(reader, count * ptsize))
+            return 0;
+        if (buf)
+        {
+            GByte* loc = iso_wkb_header(buf, type, reader->has_z,
+                reader->has_m, ringhead ? 1 : count);
+            if (ringhead)
+            {
+                memcpy(loc, &count, INT_SIZE);
+                loc += INT_SIZE;
+            }
+            memcpy(loc, reader->pos, count * ptsize);
+        }
+        reader->pos += count * ptsize;
+        return headsize + ringhead + count * ptsize;
+    }
+    case DM_POLYGON:
+    {
+        const GByte* npoints_ptr = reader->pos;
+        size_t size = headsize;
+        GByte* loc = buf ? iso_wkb_header(buf, type, reader->has_z,
+            reader->has_m, count) : NULL;
+
+        if (count > (size_t)(reader->end - reader->pos) / INT_SIZE ||
+            gser_read_check(reader, count * INT_SIZE + ((count % 2) ? INT_SIZE : 0)))
+            return 0;
+        reader->pos += count * INT_SIZE + ((count % 2) ? INT_SIZE : 0);
+
+        for (i = 0; i < count; i++)
+        {
+            GUInt32 npoints;
+            memcpy(&npoints, npoints_ptr + i * INT_SIZE, INT_SIZE);
+            if (npoints > INT_MAX / ptsize ||
+                gser_read_check(reader, npoints * ptsize))
+                return 0;
+            if (loc)
+            {
+                memcpy(loc, &npoints, INT_SIZE);
+                memcpy(loc + INT_SIZE, reader->pos, npoints * ptsize);
+                loc += INT_SIZE + npoints * ptsize;
+            }
+            reader->pos += npoints * ptsize;
+            size += INT_SIZE + npoints * ptsize;
+        }
+        return size;
+    }
+    case DM_MULTIPOINT:
+    case DM_MULTILINE:
+    case DM_MULTIPOLYGON:
+    case DM_COMPOUND:
+    case DM_CURVEPOLY:
+    case DM_MULTICURVE:
+    case DM_MULTISURFACE:
+    case DM_POLYHEDRALSURFACE:
+    case DM_TIN:
+    case DM_COLLECTION:
+    {
+        size_t size = headsize;
+
+        if (reader->depth >= MAX_DEPTH)
+        {
+            CPLError(CE_Failure, CPLE_AppDefined,
+                "Geometry has too many chained collections");
+            return 0;
+        }
+        if (buf)
+            iso_wkb_header(buf, type, reader->has_z, reader->has_m, count);
+
+        reader->depth++;
+        for (i = 0; i < count; i++)
+        {
+            const size_t subsize = gser_to_iso_wkb(reader,
+                buf ? buf + size : NULL, type);
+            if (subsize == 0)
+                return 0;
+            size += subsize;
+        }
+        reader->depth--;
+        return size;
+    }
+    default:
+        CPLError(CE_Failure, CPLE_AppDefined, "Unsupported geometry type");
+        return 0;
+    }
+}
+
+/************************************************************************/
+/*                        OGRDAMENGGserToIsoWkb()                       */
+/*                                                                      */
+/*      Convert a GSERIALIZED value to ISO WKB in machine byte order,   */
+/*      written to *ppabyBuf which is grown (with *pnBufSize) when too  */
+/*      small. Returns the WKB size, or 0 on failure.                   */
+/************************************************************************/
+
+size_t OGRDAMENGGserToIsoWkb(const GSERIALIZED* gser, size_t nSize,
+    GByte** ppabyBuf, size_t* pnBufSize)
+{
+    gser_reader reader;
+    const GByte* body;
+    size_t size;
+
+    if (gser == NULL || gser_reader_init(&reader, gser, nSize) != CE_None)
+        return 0;
+
+    /* First pass sizes the output, the second one writes it. */
+    body = reader.pos;
+    size = gser_to_iso_wkb(&reader, NULL, 0);
+    if (size == 0)
+        return 0;
+
+    if (*ppabyBuf == NULL || *pnBufSize < size)
+    {
+        *pnBufSize = size;
+        *ppabyBuf = (GByte*)CPLRealloc(*ppabyBuf, size);
+    }
+
+    reader.pos = body;
+    return gser_to_iso_wkb(&reader, *ppabyBuf, 0);
+}
@@ -179,3 +179,108 @@ OGRwkbGeometryType OGRDAMENGCheckType(int typid)
             return OGRFromOGCGeomType("UNKNOWN");
     }
 }
+
+/************************************************************************/
+/*                         OGRDAMENGStats::Add()                        */
+/************************************************************************/
+
+static const char *const apszStatsOpNames[OGRDAMENGStats::OP_COUNT] = {
+    "PREPARE", "EXECUTE", "FETCH", "COMMIT", "DECODE", "ENCODE"};
+
+void OGRDAMENGStats::Add(Op eOp, GIntBig nMicroSec, GIntBig nRows,
+                         GIntBig nBytes)
+{
+    for (OGRDAMENGStats *poStats = this; poStats != nullptr;
+         poStats = poStats->poParent)
+    {
+        poStats->anCalls[eOp]++;
+        poStats->anMicroSec[eOp] += nMicroSec;
+        poStats->anRows[eOp] += nRows;
+        poStats->anBytes[eOp] += nBytes;
+    }
+}
+
+/************************************************************************/
+/*                        OGRDAMENGStats::Reset()                       */
+/************************************************************************/
+
+void OGRDAMENGStats::Reset()
+{
+    for (int i = 0; i < OP_COUNT; i++)
+    {
+        anCalls[i] = 0;
+        anMicroSec[i] = 0;
+        anRows[i] = 0;
+        anBytes[i] = 0;
+    }
+}
+
+/************************************************************************/
+/*                       OGRDAMENGStats::IsEmpty()                      */
+/************************************************************************/
+
+bool OGRDAMENGStats::IsEmpty() const
+{
+    for (int i = 0; i < OP_COUNT; i++)
+    {
+        if (anCalls[i] != 0)
+            return false;
+    }
+    return true;
+}
+
+/************************************************************************/
+/*                     OGRDAMENGStats::GetMetadata()                    */
+/*                                                                      */
+/*      <OP>_CALLS and <OP>_TIME_MS items for each operation, plus      */
+/*      <OP>_ROWS and <OP>_BYTES for those moving data. The returned    */
+/*      list is owned by the caller.                                    */
+/************************************************************************/
+
+char **OGRDAMENGStats::GetMetadata() const
+{
+    CPLStringList aosMD;
+    for (int i = 0; i < OP_COUNT; i++)
+    {
+        const char *pszOp = apszStatsOpNames[i];
+        aosMD.SetNameValue(CPLSPrintf("%s_CALLS", pszOp),
+                           CPLSPrintf(CPL_FRMT_GIB, anCalls[i].load()));
+        aosMD.SetNameValue(CPLSPrintf("%s_TIME_MS", pszOp),
+                           CPLSPrintf("%.3f", anMicroSec[i].load() / 1000.0));
+        if (i == EXECUTE || i == FETCH || i == DECODE || i == ENCODE)
+            aosMD.SetNameValue(CPLSPrintf("%s_ROWS", pszOp),
+                               CPLSPrintf(CPL_FRMT_GIB, anRows[i].load()));
+        if (i == EXECUTE || i == FETCH)
+            aosMD.SetNameValue(CPLSPrintf("%s_BYTES", pszOp),
+                               CPLSPrintf(CPL_FRMT_GIB, anBytes[i].load()));
+    }
+    return aosMD.StealList();
+}
+
+/************************************************************************/
+/*                     OGRDAMENGStats::GetSummary()                     */
+/*                                                                      */
+/*      One line summary of the operations done at least once.          */
+/************************************************************************/
+
+CPLString OGRDAMENGStats::GetSummary() const
+{
+    CPLString osSummary;
+    for (int i = 0; i < OP_COUNT; i++)
+    {
+        const GIntBig nCalls = anCalls[i].load();
+        if (nCalls == 0)
+            continue;
+        if (!osSummary.empty())
+            osSummary += ", ";
+        osSummary += CPLSPrintf("%s " CPL_FRMT_GIB " calls %.3f ms",
+                                CPLString(apszStatsOpNames[i]).tolower().c_str(),
+                                nCalls, anMicroSec[i].load() / 1000.0);
+        if (anRows[i] != 0)
+            osSummary += CPLSPrintf(" " CPL_FRMT_GIB " rows", anRows[i].load());
+        if (anBytes[i] != 0)
+            osSummary +=
+                CPLSPrintf(" " CPL_FRMT_GIB " bytes", anBytes[i].load());
+    }
+    return osSummary;
+}
@@ -19,10 +19,14 @@
 #include "ogr_recordbatch.h"
 #include "ogrlayerarrow.h"
 #include "cpl_time.h"
+#include "cpl_vsi.h"
 #include <algorithm>
+#include <cmath>
 #include <limits>
 #include <map>
+#include <memory>
 #include <set>
+#include <unordered_map>
 #include <vector>
 
 //! @cond Doxygen_Suppress
@@ -46,6 +50,236 @@ class OGRGenSQLGeomFieldDefn final : public OGRGeomFieldDefn
 
 OGRGenSQLGeomFieldDefn::~OGRGenSQLGeomFieldDefn() = default;
 
+/************************************************************************/
+/*                           OGRGenSQLSortRow                           */
+/*                                                                      */
+/*      One row of an ORDER BY result: its key values as captured by    */
+/*      ReadIndexFields(), its rank in the source layer (used to keep   */
+/*      the sort stable) and the translated feature.                    */
+/************************************************************************/
+
+struct OGRGenSQLSortRow
+{
+    std::vector<OGRField> asKeys{};
+    GIntBig nSeq = 0;
+    std::unique_ptr<OGRFeature> poFeature{};
+    size_t nMemSize = 0;
+
+    // Flags telling which keys own a string (owned by OGRGenSQLSortedRows)
+    const std::vector<bool> *pabStringKeys = nullptr;
+
+    OGRGenSQLSortRow() = default;
+
+    explicit OGRGenSQLSortRow(const std::vector<bool> *pabStringKeysIn)
+        : asKeys(pabStringKeysIn->size()), pabStringKeys(pabStringKeysIn)
+    {
+        memset(asKeys.data(), 0, sizeof(OGRField) * asKeys.size());
+    }
+
+    OGRGenSQLSortRow(OGRGenSQLSortRow &&other) noexcept
+        : asKeys(std::move(other.asKeys)), nSeq(other.nSeq),
+          poFeature(std::move(other.poFeature)), nMemSize(other.nMemSize),
+          pabStringKeys(other.pabStringKeys)
+    {
+        other.asKeys.clear();
+    }
+
+    OGRGenSQLSortRow &operator=(OGRGenSQLSortRow &&other) noexcept
+    {
+        if (this != &other)
+        {
+            FreeKeys();
+            asKeys = std::move(other.asKeys);
+            other.asKeys.clear();
+            nSeq = other.nSeq;
+            poFeature = std::move(other.poFeature);
+            nMemSize = other.nMemSize;
+            pabStringKeys = other.pabStringKeys;
+        }
+        return *this;
+    }
+
+    ~OGRGenSQLSortRow()
+    {
+        FreeKeys();
+    }
+
+    void FreeKeys()
+    {
+        for (size_t i = 0; i < asKeys.size(); ++i)
+        {
+            if ((*pabStringKeys)[i] && !OGR_RawField_IsUnset(&asKeys[i]) &&
+                !OGR_RawField_IsNull(&asKeys[i]))
+                CPLFree(asKeys[i].String);
+        }
+        asKeys.clear();
+    }
+
+    CPL_DISALLOW_COPY_ASSIGN(OGRGenSQLSortRow)
+};
+
+/************************************************************************/
+/*                         OGRGenSQLSortedRows                          */
+/*                                                                      */
+/*      Bounded-memory sorter for the rows of an ORDER BY result.       */
+/*      Rows are accumulated in memory until their estimated size       */
+/*      exceeds the OGR_SQL_ORDER_BY_MAX_MEMORY limit, at which point   */
+/*      they are sorted and spilled as a run into a temporary file.     */
+/*      Runs are merged (at most MERGE_FAN_IN at a time) and the        */
+/*      remaining ones are k-way merged when the result is read.        */
+/*      When only the first nMaxRows rows are needed (ORDER BY ...      */
+/*      LIMIT), a bounded max-heap of the best rows is kept instead.    */
+/************************************************************************/
+
+class OGRGenSQLSortedRows
+{
+  public:
+    OGRGenSQLSortedRows(OGRGenSQLResultsLayer *poLayer, GIntBig nMaxMemory,
+                        GIntBig nMaxRows);
+    ~OGRGenSQLSortedRows();
+
+    OGRGenSQLSortRow NewRow() const
+    {
+        return OGRGenSQLSortRow(&m_abStringKeys);
+    }
+
+    bool IsCandidate(const OGRGenSQLSortRow &oRow);
+    bool AddRow(OGRGenSQLSortRow &&oRow);
+    bool Finish();
+    std::unique_ptr<OGRFeature> GetRow(GIntBig nIndex);
+
+    /** Number of rows of the result, or -1 if rows were discarded without
+     * being evaluated against the filters */
+    GIntBig GetRowCount() const
+    {
+        return m_bRowCountExact ? m_nRowCount : -1;
+    }
+
+    bool IsInMemory() const
+    {
+        return m_apoRuns.empty();
+    }
+
+  private:
+    struct Run
+    {
+        std::string osFilename{};
+        VSILFILE *fp = nullptr;
+        int nLevel = 0;
+        GIntBig nRows = 0;
+
+        // Current record while merging
+        GIntBig nRowsRead = 0;
+        std::vector<GByte> abyRecord{};
+        OGRGenSQLSortRow oRow{};
+        size_t nFeatureOffset = 0;
+
+        Run() = default;
+        ~Run();
+        CPL_DISALLOW_COPY_ASSIGN(Run)
+    };
+
+    static constexpr int MERGE_FAN_IN = 16;
+
+    OGRGenSQLResultsLayer *m_poLayer = nullptr;
+    std::vector<bool> m_abStringKeys{};
+    GIntBig m_nMaxMemory = 0;
+    GIntBig m_nMaxRows = -1;
+    bool m_bTopK = false;
+
+    GIntBig m_nMemSize = 0;
+    std::vector<OGRGenSQLSortRow> m_aoRows{};
+
+    std::vector<std::unique_ptr<Run>> m_apoRuns{};
+    std::vector<Run *> m_apoMergeHeap{};
+    GIntBig m_nMergeIndex = 0;
+
+    GIntBig m_nRowCount = 0;
+    bool m_bRowCountExact = true;
+    bool m_bError = false;
+
+    bool Less(const OGRGenSQLSortRow &oA, const OGRGenSQLSortRow &oB) const;
+    bool SpillRows();
+    std::unique_ptr<Run> CreateRun(int nLevel);
+    bool WriteRecord(Run &oRun, const std::vector<GByte> &abyRecord);
+    bool RewindRun(Run &oRun);
+    bool ReadRecord(Run &oRun);
+    bool FillMergeHeap(std::vector<Run *> &apoHeap,
+                       const std::vector<Run *> &apoRuns);
+    bool PopMergeHeap(std::vector<Run *> &apoHeap, Run *&poRun);
+    bool MergeRuns(int nLevel);
+    std::unique_ptr<OGRFeature> DecodeFeature(const Run &oRun);
+
+    CPL_DISALLOW_COPY_ASSIGN(OGRGenSQLSortedRows)
+};
+
+/************************************************************************/
+/*                           OGRGenSQLKeyType                           */
+/*                                                                      */
+/*      How a value is encoded in the key of a GROUP BY or hash join    */
+/*      table.                                                          */
+/************************************************************************/
+
+enum class OGRGenSQLKeyType
+{
+    INTEGER,
+    REAL,
+    STRING,
+    STRING_NOCASE,  // OGR SQL '=' compares strings case-insensitively
+};
+
+/************************************************************************/
+/*                          OGRGenSQLHashJoin                           */
+/*                                                                      */
+/*      Hash table over the features of a joined layer, keyed by the    */
+/*      columns of an equi-join condition. It is built with a single    */
+/*      scan of the joined layer, and replaces the attribute filter     */
+/*      installed on it for each source feature otherwise.              */
+/************************************************************************/
+
+class OGRGenSQLHashJoin
+{
+  public:
+    OGRGenSQLHashJoin() = default;
+
+    static std::unique_ptr<OGRGenSQLHashJoin>
+    Create(const swq_join_def *psJoinInfo, OGRLayer *poSrcLayer,
+           OGRLayer *poJoinLayer);
+
+    bool Build(GIntBig nMaxMemory);
+    std::unique_ptr<OGRFeature> Lookup(const OGRFeature *poSrcFeat) const;
+
+    GIntBig GetMemSize() const
+    {
+        return m_nMemSize;
+    }
+
+  private:
+    struct KeyPart
+    {
+        int iSrcField = -1;
+        int iJoinField = -1;
+        OGRGenSQLKeyType eType = OGRGenSQLKeyType::STRING_NOCASE;
+    };
+
+    OGRLayer *m_poJoinLayer = nullptr;
+    std::vector<KeyPart> m_aoKeyParts{};
+    GIntBig m_nMemSize = 0;
+
+    // First feature of the joined layer for each key value, as the
+    // attribute filter would return it
+    std::unordered_map<std::string, std::unique_ptr<OGRFeature>>
+        m_oMapFeatures{};
+
+    bool CollectKeyParts(const swq_expr_node *poExpr, int nSecondaryTable,
+                         const OGRFeatureDefn *poSrcDefn,
+                         const OGRFeatureDefn *poJoinDefn);
+    bool ComputeKey(const OGRFeature *poFeature, bool bSrcFeature,
+                    std::string &osKey) const;
+
+    CPL_DISALLOW_COPY_ASSIGN(OGRGenSQLHashJoin)
+};
+
 /************************************************************************/
 /*                OGRGenSQLResultsLayerHasSpecialField()                */
 /************************************************************************/
@@ -644,7 +878,7 @@ OGRErr OGRGenSQLResultsLayer::SetNextByIndex(GIntBig nIndex)
         return OGRERR_NON_EXISTING_FEATURE;
     }
     if (psSelectInfo->query_mode == SWQM_SUMMARY_RECORD ||
-        psSelectInfo->query_mode == SWQM_DISTINCT_LIST || !m_anFIDIndex.empty())
+        psSelectInfo->query_mode == SWQM_DISTINCT_LIST || m_poSortedRows)
     {
         m_nNextIndexFID = nIndex + psSelectInfo->offset;
         return OGRERR_NONE;
@@ -703,8 +937,19 @@ GIntBig OGRGenSQLResultsLayer::GetFeatureCount(int bForce)
 
         nRet = psSelectInfo->column_summary[0].count;
     }
+    else if (psSelectInfo->group_by_count > 0)
+    {
+        if (!PrepareSummary())
+            return 0;
+
+        nRet = static_cast<GIntBig>(m_apoGroupFeatures.size());
+    }
     else if (psSelectInfo->query_mode != SWQM_RECORDSET)
         return 1;
+    else if (m_poSortedRows && m_poSortedRows->GetRowCount() >= 0)
+    {
+        nRet = m_poSortedRows->GetRowCount();
+    }
     else if (m_poAttrQuery == nullptr && !MustEvaluateSpatialFilterOnGenSQL())
     {
         nRet = m_poSrcLayer->GetFeatureCount(bForce);
@@ -735,7 +980,7 @@ int OGRGenSQLResultsLayer::TestCapability(const char *pszCap) const
     {
         if (psSelectInfo->query_mode == SWQM_SUMMARY_RECORD ||
             psSelectInfo->query_mode == SWQM_DISTINCT_LIST ||
-            !m_anFIDIndex.empty())
+            (m_poSortedRows && m_poSortedRows->IsInMemory()))
             return TRUE;
         else
             return m_poSrcLayer->TestCapability(pszCap);
@@ -848,6 +1093,160 @@ int OGRGenSQLResultsLayer::ContainGeomSpecialField(
     return FALSE;
 }
 
+/************************************************************************/
+/*                    OGRGenSQLEstimateFeatureSize()                    */
+/*                                                                      */
+/*      Rough estimate of the memory used by a feature.                 */
+/************************************************************************/
+
+static size_t OGRGenSQLEstimateFeatureSize(const OGRFeature *poFeature)
+{
+    size_t nSize = sizeof(OGRFeature);
+
+    const OGRFeatureDefn *poDefn = poFeature->GetDefnRef();
+    const int nFieldCount = poDefn->GetFieldCount();
+    nSize += nFieldCount * sizeof(OGRField);
+    for (int i = 0; i < nFieldCount; ++i)
+    {
+        if (!poFeature->IsFieldSetAndNotNull(i))
+            continue;
+        const OGRField *psField = poFeature->GetRawFieldRef(i);
+        switch (poDefn->GetFieldDefn(i)->GetType())
+        {
+            case OFTString:
+                nSize += strlen(psField->String) + 1;
+                break;
+            case OFTBinary:
+                nSize += psField->Binary.nCount;
+                break;
+            case OFTIntegerList:
+                nSize += psField->IntegerList.nCount * sizeof(int);
+                break;
+            case OFTInteger64List:
+                nSize += psField->Integer64List.nCount * sizeof(GIntBig);
+                break;
+            case OFTRealList:
+                nSize += psField->RealList.nCount * sizeof(double);
+                break;
+            case OFTStringList:
+                for (int j = 0; j < psField->StringList.nCount; ++j)
+                    nSize += sizeof(char *) +
+                             strlen(psField->StringList.paList[j]) + 1;
+                break;
+            default:
+                break;
+        }
+    }
+
+    const int nGeomFieldCount = poDefn->GetGeomFieldCount();
+    for (int i = 0; i < nGeomFieldCount; ++i)
+    {
+        const OGRGeometry *poGeom = poFeature->GetGeomFieldRef(i);
+        if (poGeom)
+            nSize += sizeof(OGRGeometry *) + poGeom->WkbSize();
+    }
+
+    if (poFeature->GetStyleString())
+        nSize += strlen(poFeature->GetStyleString()) + 1;
+    if (poFeature->GetNativeData())
+        nSize += strlen(poFeature->GetNativeData()) + 1;
+
+    return nSize;
+}
+
+/************************************************************************/
+/*                       OGRGenSQLGetMaxMemory()                        */
+/*                                                                      */
+/*      Memory limit set by a OGR_SQL_xxx_MAX_MEMORY option, in bytes.  */
+/************************************************************************/
+
+static GIntBig OGRGenSQLGetMaxMemory(const char *pszOption)
+{
+    const char *pszMaxMemory = CPLGetConfigOption(pszOption, nullptr);
+    if (pszMaxMemory)
+    {
+        GIntBig nMaxMemory = 0;
+        bool bUnitSpecified = false;
+        if (CPLParseMemorySize(pszMaxMemory, &nMaxMemory, &bUnitSpecified) ==
+            CE_None)
+        {
+            // A value without unit is a number of megabytes
+            if (!bUnitSpecified)
+                nMaxMemory *= 1024 * 1024;
+            return nMaxMemory;
+        }
+        CPLError(CE_Warning, CPLE_AppDefined,
+                 "Invalid value for %s: %s. Using default value", pszOption,
+                 pszMaxMemory);
+    }
+
+    // Default to 10% of the usable RAM, or 1 GB if it cannot be determined
+    const GIntBig nUsableRAM = CPLGetUsablePhysicalRAM();
+    return nUsableRAM > 0 ? nUsableRAM / 10
+                          : static_cast<GIntBig>(1024) * 1024 * 1024;
+}
+
+/************************************************************************/
+/*                         OGRGenSQLAppendKey()                         */
+/*                                                                      */
+/*      Append the value of a field to a hash table key. Returns false  */
+/*      if the value is null or unset.                                  */
+/************************************************************************/
+
+static bool OGRGenSQLAppendKey(std::string &osKey, const OGRFeature *poFeature,
+                               int iField, OGRGenSQLKeyType eType)
+{
+    if (!poFeature->IsFieldSetAndNotNull(iField))
+        return false;
+
+    switch (eType)
+    {
+        case OGRGenSQLKeyType::INTEGER:
+        {
+            const GIntBig nValue = poFeature->GetFieldAsInteger64(iField);
+            osKey += 'I';
+            osKey.append(reinterpret_cast<const char *>(&nValue),
+                         sizeof(nValue));
+            break;
+        }
+
+        case OGRGenSQLKeyType::REAL:
+        {
+            double dfValue = poFeature->GetFieldAsDouble(iField);
+            if (std::isnan(dfValue))
+                dfValue = std::numeric_limits<double>::quiet_NaN();
+            else if (dfValue == 0)
+                dfValue = 0;  // -0.0 and 0.0 are the same key
+            osKey += 'R';
+            osKey.append(reinterpret_cast<const char *>(&dfValue),
+                         sizeof(dfValue));
+            break;
+        }
+
+        case OGRGenSQLKeyType::STRING:
+        {
+            osKey += 'S';
+            osKey += poFeature->GetFieldAsString(iField);
+            osKey += '\0';
+            break;
+        }
+
+        case OGRGenSQLKeyType::STRING_NOCASE:
+        {
+            osKey += 'S';
+            for (const char *pszIter = poFeature->GetFieldAsString(iField);
+                 *pszIter; ++pszIter)
+            {
+                osKey += static_cast<char>(CPLToupper(*pszIter));
+            }
+            osKey += '\0';
+            break;
+        }
+    }
+
+    return true;
+}
+
 /************************************************************************/
 /*                           PrepareSummary()                           */
 /************************************************************************/
@@ -932,6 +1331,18 @@ bool OGRGenSQLResultsLayer::PrepareSummary() const
                 break;
             }
         }
+        for (int iGroup = 0;
+             !bFoundGeomExpr && iGroup < psSelectInfo->group_by_count; iGroup++)
+        {
+            const int nSpecialFieldIdx =
+                psSelectInfo->group_by_defs[iGroup].field_index -
+                poSrcLayerDefn->GetFieldCount();
+            if (nSpecialFieldIdx == SPF_OGR_GEOM_WKT ||
+                nSpecialFieldIdx == SPF_OGR_GEOM_AREA)
+            {
+                bFoundGeomExpr = true;
+            }
+        }
         if (!bFoundGeomExpr)
         {
             // cppcheck-suppress unreadVariable
@@ -946,6 +1357,7 @@ bool OGRGenSQLResultsLayer::PrepareSummary() const
     /* -------------------------------------------------------------------- */
 
     if (psSelectInfo->result_columns() == 1 &&
+        psSelectInfo->group_by_count == 0 &&
         psSelectInfo->column_defs[0].col_func == SWQCF_COUNT &&
         psSelectInfo->column_defs[0].field_index < 0)
     {
@@ -969,85 +1381,18 @@ bool OGRGenSQLResultsLayer::PrepareSummary() const
     /*      building facilities of SWQ.                                     */
     /* -------------------------------------------------------------------- */
 
+    if (psSelectInfo->group_by_count > 0)
+        return PrepareGroupedSummary();
+
     for (auto &&poSrcFeature : *m_poSrcLayer)
     {
-        for (int iField = 0; iField < psSelectInfo->result_columns(); iField++)
+        const char *pszError = SummarizeFeature(poSrcFeature.get());
+        if (pszError)
         {
-            const swq_col_def *psColDef = &psSelectInfo->column_defs[iField];
-            const char *pszError = nullptr;
-
-            if (psColDef->col_func == SWQCF_COUNT)
-            {
-                /* psColDef->field_index can be -1 in the case of a COUNT(*) */
-                if (psColDef->field_index < 0)
-                    pszError =
-                        swq_select_summarize(psSelectInfo, iField, "", nullptr);
-                else if (IS_GEOM_FIELD_INDEX(poSrcLayerDefn,
-                                             psColDef->field_index))
-                {
-                    const int iSrcGeomField =
-                        ALL_FIELD_INDEX_TO_GEOM_FIELD_INDEX(
-                            poSrcLayerDefn, psColDef->field_index);
-                    const OGRGeometry *poGeom =
-                        poSrcFeature->GetGeomFieldRef(iSrcGeomField);
-                    if (poGeom != nullptr)
-                        pszError = swq_select_summarize(psSelectInfo, iField,
-                                                        "", nullptr);
-                }
-                else if (poSrcFeature->IsFieldSetAndNotNull(
-                             psColDef->field_index))
-                {
-                    if (!psColDef->distinct_flag)
-                    {
-                        pszError = swq_select_summarize(psSelectInfo, iField,
-                                                        "", nullptr);
-                    }
-                    else
-                    {
-                        const char *pszVal = poSrcFeature->GetFieldAsString(
-                            psColDef->field_index);
-                        pszError = swq_select_summarize(psSelectInfo, iField,
-                                                        pszVal, nullptr);
-                    }
-                }
-            }
-            else
-            {
-                if (poSrcFeature->IsFieldSetAndNotNull(psColDef->field_index))
-                {
-                    if (!psColDef->distinct_flag &&
-                        (psColDef->field_type == SWQ_BOOLEAN ||
-                         psColDef->field_type == SWQ_INTEGER ||
-                         psColDef->field_type == SWQ_INTEGER64 ||
-                         psColDef->field_type == SWQ_FLOAT))
-                    {
-                        const double dfValue = poSrcFeature->GetFieldAsDouble(
-                            psColDef->field_index);
-                        pszError = swq_select_summarize(psSelectInfo, iField,
-                                                        nullptr, &dfValue);
-                    }
-                    else
-                    {
-                        const char *pszVal = poSrcFeature->GetFieldAsString(
-                            psColDef->field_index);
-                        pszError = swq_select_summarize(psSelectInfo, iField,
-                                                        pszVal, nullptr);
-                    }
-                }
-                else
-                {
-                    pszError = swq_select_summarize(psSelectInfo, iField,
-                                                    nullptr, nullptr);
-                }
-            }
-
-            if (pszError)
-            {
-                m_poSummaryFeature.reset();
+            m_poSummaryFeature.reset();
 
-                CPLError(CE_Failure, CPLE_AppDefined, "%s", pszError);
-                return false;
-            }
+            CPLError(CE_Failure, CPLE_AppDefined, "%s", pszError);
+            return false;
         }
     }
 
@@ -1087,135 +1432,535 @@ bool OGRGenSQLResultsLayer::PrepareSummary() const
             m_poSummaryFeature->SetFID(0);
         }
 
-        for (int iField = 0; iField < psSelectInfo->result_columns(); iField++)
-        {
-            const swq_col_def *psColDef = &psSelectInfo->column_defs[iField];
-            if (!psSelectInfo->column_summary.empty())
-            {
-                const swq_summary &oSummary =
-                    psSelectInfo->column_summary[iField];
-
-                switch (psColDef->col_func)
-                {
-                    case SWQCF_NONE:
-                    case SWQCF_CUSTOM:
-                        break;
-
-                    case SWQCF_AVG:
-                    {
-                        if (oSummary.count > 0)
-                        {
-                            const double dfAvg =
-                                oSummary.sum() / oSummary.count;
-                            if (psColDef->field_type == SWQ_DATE ||
-                                psColDef->field_type == SWQ_TIME ||
-                                psColDef->field_type == SWQ_TIMESTAMP)
-                            {
-                                struct tm brokendowntime;
-                                CPLUnixTimeToYMDHMS(static_cast<GIntBig>(dfAvg),
-                                                    &brokendowntime);
-                                m_poSummaryFeature->SetField(
-                                    iField, brokendowntime.tm_year + 1900,
-                                    brokendowntime.tm_mon + 1,
-                                    brokendowntime.tm_mday,
-                                    brokendowntime.tm_hour,
-                                    brokendowntime.tm_min,
-                                    static_cast<float>(brokendowntime.tm_sec +
-                                                       fmod(dfAvg, 1)),
-                                    0);
-                            }
-                            else
-                            {
-                                m_poSummaryFeature->SetField(iField, dfAvg);
-                            }
-                        }
-                        break;
-                    }
-
-                    case SWQCF_MIN:
-                    {
-                        if (oSummary.count > 0)
-                        {
-                            if (psColDef->field_type == SWQ_DATE ||
-                                psColDef->field_type == SWQ_TIME ||
-                                psColDef->field_type == SWQ_TIMESTAMP ||
-                                psColDef->field_type == SWQ_STRING)
-                                m_poSummaryFeature->SetField(
-                                    iField, oSummary.osMin.c_str());
-                            else
-                                m_poSummaryFeature->SetField(iField,
-                                                             oSummary.min);
-                        }
-                        break;
-                    }
-
-                    case SWQCF_MAX:
-                    {
-                        if (oSummary.count > 0)
-                        {
-                            if (psColDef->field_type == SWQ_DATE ||
-                                psColDef->field_type == SWQ_TIME ||
-                                psColDef->field_type == SWQ_TIMESTAMP ||
-                                psColDef->field_type == SWQ_STRING)
-                                m_poSummaryFeature->SetField(
-                                    iField, oSummary.osMax.c_str());
-                            else
-                                m_poSummaryFeature->SetField(iField,
-                                                             oSummary.max);
-                        }
-                        break;
-                    }
-
-                    case SWQCF_COUNT:
-                    {
-                        m_poSummaryFeature->SetField(iField, oSummary.count);
-                        break;
-                    }
-
-                    case SWQCF_SUM:
-                    {
-                        if (oSummary.count > 0)
-                            m_poSummaryFeature->SetField(iField,
-                                                         oSummary.sum());
-                        break;
-                    }
-
-                    case SWQCF_STDDEV_POP:
-                    {
-                        if (oSummary.count > 0)
-                        {
-                            const double dfVariance =
-                                oSummary.sq_dist_from_mean_acc / oSummary.count;
-                            m_poSummaryFeature->SetField(iField,
-                                                         sqrt(dfVariance));
-                        }
-                        break;
-                    }
-
-                    case SWQCF_STDDEV_SAMP:
-                    {
-                        if (oSummary.count > 1)
-                        {
-                            const double dfSampleVariance =
-                                oSummary.sq_dist_from_mean_acc /
-                                (oSummary.count - 1);
-                            m_poSummaryFeature->SetField(
-                                iField, sqrt(dfSampleVariance));
-                        }
-                        break;
-                    }
-                }
-            }
-            else if (psColDef->col_func == SWQCF_COUNT)
-                m_poSummaryFeature->SetField(iField, 0);
-        }
+        SetSummaryValues(m_poSummaryFeature.get());
     }
 
     return TRUE;
 }
 
 /************************************************************************/
-/*                       OGRMultiFeatureFetcher()                       */
+/*                          SummarizeFeature()                          */
+/*                                                                      */
+/*      Add the values of a source feature to the column summaries.     */
+/*      Returns an error message, or nullptr.                           */
+/************************************************************************/
+
+const char *
+OGRGenSQLResultsLayer::SummarizeFeature(OGRFeature *poSrcFeature) const
+{
+    swq_select *psSelectInfo = m_pSelectInfo.get();
+    auto poSrcLayerDefn = m_poSrcLayer->GetLayerDefn();
+
+    for (int iField = 0; iField < psSelectInfo->result_columns(); iField++)
+    {
+        const swq_col_def *psColDef = &psSelectInfo->column_defs[iField];
+        const char *pszError = nullptr;
+
+        if (psColDef->col_func == SWQCF_COUNT)
+        {
+            /* psColDef->field_index can be -1 in the case of a COUNT(*) */
+            if (psColDef->field_index < 0)
+                pszError =
+                    swq_select_summarize(psSelectInfo, iField, "", nullptr);
+            else if (IS_GEOM_FIELD_INDEX(poSrcLayerDefn, psColDef->field_index))
+            {
+                const int iSrcGeomField = ALL_FIELD_INDEX_TO_GEOM_FIELD_INDEX(
+                    poSrcLayerDefn, psColDef->field_index);
+                const OGRGeometry *poGeom =
+                    poSrcFeature->GetGeomFieldRef(iSrcGeomField);
+                if (poGeom != nullptr)
+                    pszError = swq_select_summarize(psSelectInfo, iField,
+                                                    "", nullptr);
+            }
+            else if (poSrcFeature->IsFieldSetAndNotNull(psColDef->field_index))
+            {
+                if (!psColDef->distinct_flag)
+                {
+                    pszError = swq_select_summarize(psSelectInfo, iField,
+                                                    "", nullptr);
+                }
+                else
+                {
+                    const char *pszVal = poSrcFeature->GetFieldAsString(
+                        psColDef->field_index);
+                    pszError = swq_select_summarize(psSelectInfo, iField,
+                                                    pszVal, nullptr);
+                }
+            }
+        }
+        else
+        {
+            if (poSrcFeature->IsFieldSetAndNotNull(psColDef->field_index))
+            {
+                if (!psColDef->distinct_flag &&
+                    (psColDef->field_type == SWQ_BOOLEAN ||
+                     psColDef->field_type == SWQ_INTEGER ||
+                     psColDef->field_type == SWQ_INTEGER64 ||
+                     psColDef->field_type == SWQ_FLOAT))
+                {
+                    const double dfValue = poSrcFeature->GetFieldAsDouble(
+                        psColDef->field_index);
+                    pszError = swq_select_summarize(psSelectInfo, iField,
+                                                    nullptr, &dfValue);
+                }
+                else
+                {
+                    const char *pszVal = poSrcFeature->GetFieldAsString(
+                        psColDef->field_index);
+                    pszError = swq_select_summarize(psSelectInfo, iField,
+                                                    pszVal, nullptr);
+                }
+            }
+            else
+            {
+                pszError = swq_select_summarize(psSelectInfo, iField,
+                                                nullptr, nullptr);
+            }
+        }
+
+        if (pszError)
+            return pszError;
+    }
+
+    return nullptr;
+}
+
+/************************************************************************/
+/*                          SetSummaryValues()                          */
+/*                                                                      */
+/*      Apply the column summaries to a result feature.                 */
+/************************************************************************/
+
+void OGRGenSQLResultsLayer::SetSummaryValues(OGRFeature *poDstFeature) const
+{
+    const swq_select *psSelectInfo = m_pSelectInfo.get();
+
+    for (int iField = 0; iField < psSelectInfo->result_columns(); iField++)
+    {
+        const swq_col_def *psColDef = &psSelectInfo->column_defs[iField];
+        if (!psSelectInfo->column_summary.empty())
+        {
+            const swq_summary &oSummary = psSelectInfo->column_summary[iField];
+
+            switch (psColDef->col_func)
+            {
+                case SWQCF_NONE:
+                case SWQCF_CUSTOM:
+                    break;
+
+                case SWQCF_AVG:
+                {
+                    if (oSummary.count > 0)
+                    {
+                        const double dfAvg = oSummary.sum() / oSummary.count;
+                        if (psColDef->field_type == SWQ_DATE ||
+                            psColDef->field_type == SWQ_TIME ||
+                            psColDef->field_type == SWQ_TIMESTAMP)
+                        {
+                            struct tm brokendowntime;
+                            CPLUnixTimeToYMDHMS(static_cast<GIntBig>(dfAvg),
+                                                &brokendowntime);
+                            poDstFeature->SetField(
+                                iField, brokendowntime.tm_year + 1900,
+                                brokendowntime.tm_mon + 1,
+                                brokendowntime.tm_mday, brokendowntime.tm_hour,
+                                brokendowntime.tm_min,
+                                static_cast<float>(brokendowntime.tm_sec +
+                                                   fmod(dfAvg, 1)),
+                                0);
+                        }
+                        else
+                        {
+                            poDstFeature->SetField(iField, dfAvg);
+                        }
+                    }
+                    break;
+                }
+
+                case SWQCF_MIN:
+                {
+                    if (oSummary.count > 0)
+                    {
+                        if (psColDef->field_type == SWQ_DATE ||
+                            psColDef->field_type == SWQ_TIME ||
+                            psColDef->field_type == SWQ_TIMESTAMP ||
+                            psColDef->field_type == SWQ_STRING)
+                            poDstFeature->SetField(iField,
+                                                   oSummary.osMin.c_str());
+                        else
+                            poDstFeature->SetField(iField, oSummary.min);
+                    }
+                    break;
+                }
+
+                case SWQCF_MAX:
+                {
+                    if (oSummary.count > 0)
+                    {
+                        if (psColDef->field_type == SWQ_DATE ||
+                            psColDef->field_type == SWQ_TIME ||
+                            psColDef->field_type == SWQ_TIMESTAMP ||
+                            psColDef->field_type == SWQ_STRING)
+                            poDstFeature->SetField(iField,
+                                                   oSummary.osMax.c_str());
+                        else
+                            poDstFeature->SetField(iField, oSummary.max);
+                    }
+                    break;
+                }
+
+                case SWQCF_COUNT:
+                {
+                    poDstFeature->SetField(iField, oSummary.count);
+                    break;
+                }
+
+                case SWQCF_SUM:
+                {
+                    if (oSummary.count > 0)
+                        poDstFeature->SetField(iField, oSummary.sum());
+                    break;
+                }
+
+                case SWQCF_STDDEV_POP:
+                {
+                    if (oSummary.count > 0)
+                    {
+                        const double dfVariance =
+                            oSummary.sq_dist_from_mean_acc / oSummary.count;
+                        poDstFeature->SetField(iField, sqrt(dfVariance));
+                    }
+                    break;
+                }
+
+                case SWQCF_STDDEV_SAMP:
+                {
+                    if (oSummary.count > 1)
+                    {
+                        const double dfSampleVariance =
+                            oSummary.sq_dist_from_mean_acc /
+                            (oSummary.count - 1);
+                        poDstFeature->SetField(iField,
+                                               sqrt(dfSampleVariance));
+                    }
+                    break;
+                }
+            }
+        }
+        else if (psColDef->col_func == SWQCF_COUNT)
+            poDstFeature->SetField(iField, 0);
+    }
+}
+
+/************************************************************************/
+/*                           OGRGenSQLGroups                            */
+/*                                                                      */
+/*      Groups of a GROUP BY query while they are being accumulated.   */
+/*      The GROUP BY values of each group are kept in a feature whose   */
+/*      fields are laid out the way ReadIndexFields() does, so that     */
+/*      Compare() can sort them.                                        */
+/************************************************************************/
+
+namespace
+{
+struct OGRGenSQLGroups
+{
+    OGRFeatureDefn *poKeyDefn = nullptr;
+    std::unordered_map<std::string, size_t> oMapKeyToGroup{};
+    std::vector<std::unique_ptr<OGRFeature>> apoKeyFeatures{};
+    std::vector<std::vector<swq_summary>> aaoSummaries{};
+
+    OGRGenSQLGroups() : poKeyDefn(new OGRFeatureDefn("GROUP_BY"))
+    {
+        poKeyDefn->Reference();
+    }
+
+    ~OGRGenSQLGroups()
+    {
+        apoKeyFeatures.clear();
+        poKeyDefn->Release();
+    }
+
+    CPL_DISALLOW_COPY_ASSIGN(OGRGenSQLGroups)
+};
+}  // namespace
+
+/************************************************************************/
+/*                       PrepareGroupedSummary()                        */
+/*                                                                      */
+/*      Compute the rows of a GROUP BY query in a single pass over the  */
+/*      source features: each one is dispatched to its group through a  */
+/*      hash table keyed by its GROUP BY values, and each group         */
+/*      accumulates its own column summaries.                           */
+/************************************************************************/
+
+bool OGRGenSQLResultsLayer::PrepareGroupedSummary() const
+
+{
+    swq_select *psSelectInfo = m_pSelectInfo.get();
+    const int nGroupFields = psSelectInfo->group_by_count;
+    const OGRFeatureDefn *poSrcLayerDefn = m_poSrcLayer->GetLayerDefn();
+
+    OGRGenSQLGroups oGroups;
+    std::vector<OGRGenSQLKeyType> aeKeyTypes;
+    for (int iGroup = 0; iGroup < nGroupFields; iGroup++)
+    {
+        const swq_group_def *psGroupDef = psSelectInfo->group_by_defs + iGroup;
+        if (psGroupDef->field_index >= m_iFIDFieldIndex)
+        {
+            CPLAssert(psGroupDef->field_index <
+                      m_iFIDFieldIndex + SPECIAL_FIELD_COUNT);
+            OGRFieldType eType = OFTString;
+            switch (
+                SpecialFieldTypes[psGroupDef->field_index - m_iFIDFieldIndex])
+            {
+                case SWQ_INTEGER:
+                case SWQ_INTEGER64:
+                    eType = OFTInteger64;
+                    break;
+                case SWQ_FLOAT:
+                    eType = OFTReal;
+                    break;
+                default:
+                    break;
+            }
+            OGRFieldDefn oFieldDefn(psGroupDef->field_name, eType);
+            oGroups.poKeyDefn->AddFieldDefn(&oFieldDefn);
+        }
+        else
+        {
+            oGroups.poKeyDefn->AddFieldDefn(
+                poSrcLayerDefn->GetFieldDefn(psGroupDef->field_index));
+        }
+
+        switch (oGroups.poKeyDefn->GetFieldDefn(iGroup)->GetType())
+        {
+            case OFTInteger:
+            case OFTInteger64:
+                aeKeyTypes.push_back(OGRGenSQLKeyType::INTEGER);
+                break;
+            case OFTReal:
+                aeKeyTypes.push_back(OGRGenSQLKeyType::REAL);
+                break;
+            default:
+                aeKeyTypes.push_back(OGRGenSQLKeyType::STRING);
+                break;
+        }
+    }
+
+    /* -------------------------------------------------------------------- */
+    /*      Dispatch the source features to their group.                    */
+    /* -------------------------------------------------------------------- */
+    const GIntBig nMaxMemory =
+        OGRGenSQLGetMaxMemory("OGR_SQL_GROUP_BY_MAX_MEMORY");
+    GIntBig nMemSize = 0;
+    std::string osKey;
+    for (auto &&poSrcFeature : *m_poSrcLayer)
+    {
+        osKey.clear();
+        for (int iGroup = 0; iGroup < nGroupFields; iGroup++)
+        {
+            // Null values make a group of their own
+            const int iSrcField =
+                psSelectInfo->group_by_defs[iGroup].field_index;
+            if (!OGRGenSQLAppendKey(osKey, poSrcFeature.get(), iSrcField,
+                                    aeKeyTypes[iGroup]))
+                osKey += 'N';
+        }
+
+        size_t nGroup = 0;
+        const auto oIter = oGroups.oMapKeyToGroup.find(osKey);
+        if (oIter != oGroups.oMapKeyToGroup.end())
+        {
+            nGroup = oIter->second;
+        }
+        else
+        {
+            auto poKeyFeature = std::make_unique<OGRFeature>(oGroups.poKeyDefn);
+            for (int iGroup = 0; iGroup < nGroupFields; iGroup++)
+            {
+                const int iSrcField =
+                    psSelectInfo->group_by_defs[iGroup].field_index;
+                if (!poSrcFeature->IsFieldSetAndNotNull(iSrcField))
+                    poKeyFeature->SetFieldNull(iGroup);
+                else if (iSrcField < m_iFIDFieldIndex)
+                    poKeyFeature->SetField(
+                        iGroup, poSrcFeature->GetRawFieldRef(iSrcField));
+                else if (aeKeyTypes[iGroup] == OGRGenSQLKeyType::INTEGER)
+                    poKeyFeature->SetField(
+                        iGroup, poSrcFeature->GetFieldAsInteger64(iSrcField));
+                else if (aeKeyTypes[iGroup] == OGRGenSQLKeyType::REAL)
+                    poKeyFeature->SetField(
+                        iGroup, poSrcFeature->GetFieldAsDouble(iSrcField));
+                else
+                    poKeyFeature->SetField(
+                        iGroup, poSrcFeature->GetFieldAsString(iSrcField));
+            }
+
+            // Key stored once in the node, plus the node and bucket overhead
+            nMemSize += OGRGenSQLEstimateFeatureSize(poKeyFeature.get()) +
+                        osKey.size() + sizeof(std::string) +
+                        4 * sizeof(void *) +
+                        psSelectInfo->column_defs.size() * sizeof(swq_summary);
+            if (nMemSize > nMaxMemory)
+            {
+                m_poSummaryFeature.reset();
+                CPLError(CE_Failure, CPLE_OutOfMemory,
+                         "GROUP BY: the groups do not fit within "
+                         "OGR_SQL_GROUP_BY_MAX_MEMORY (" CPL_FRMT_GIB
+                         " bytes)",
+                         nMaxMemory);
+                return false;
+            }
+
+            nGroup = oGroups.apoKeyFeatures.size();
+            oGroups.oMapKeyToGroup.emplace(osKey, nGroup);
+            oGroups.apoKeyFeatures.push_back(std::move(poKeyFeature));
+            oGroups.aaoSummaries.emplace_back();
+        }
+
+        // swq_select_summarize() works on psSelectInfo->column_summary
+        std::swap(psSelectInfo->column_summary, oGroups.aaoSummaries[nGroup]);
+        const char *pszError = SummarizeFeature(poSrcFeature.get());
+        std::swap(psSelectInfo->column_summary, oGroups.aaoSummaries[nGroup]);
+        if (pszError)
+        {
+            m_poSummaryFeature.reset();
+
+            CPLError(CE_Failure, CPLE_AppDefined, "%s", pszError);
+            return false;
+        }
+    }
+
+    const_cast<OGRGenSQLResultsLayer *>(this)->ClearFilters();
+
+    const size_t nGroups = oGroups.apoKeyFeatures.size();
+    CPLDebug("GenSQL", "GROUP BY: %d groups.", static_cast<int>(nGroups));
+
+    /* -------------------------------------------------------------------- */
+    /*      Narrow COUNT() columns to OFTInteger if all counts allow it.    */
+    /* -------------------------------------------------------------------- */
+    m_poSummaryFeature.reset();
+    m_apoGroupFeatures.clear();
+    for (int iField = 0; iField < psSelectInfo->result_columns(); iField++)
+    {
+        if (psSelectInfo->column_defs[iField].col_func != SWQCF_COUNT)
+            continue;
+
+        bool bFitsOnInt32 = true;
+        for (const auto &aoSummaries : oGroups.aaoSummaries)
+        {
+            if (!aoSummaries.empty() &&
+                !CPL_INT64_FITS_ON_INT32(aoSummaries[iField].count))
+            {
+                bFitsOnInt32 = false;
+                break;
+            }
+        }
+        if (bFitsOnInt32)
+            m_poDefn->GetFieldDefn(iField)->SetType(OFTInteger);
+    }
+
+    /* -------------------------------------------------------------------- */
+    /*      Sort the groups on the ORDER BY keys, which are all GROUP BY    */
+    /*      fields.                                                         */
+    /* -------------------------------------------------------------------- */
+    const auto GetGroupIndex = [psSelectInfo](int table_index, int field_index)
+    {
+        for (int iGroup = 0; iGroup < psSelectInfo->group_by_count; iGroup++)
+        {
+            if (psSelectInfo->group_by_defs[iGroup].table_index ==
+                    table_index &&
+                psSelectInfo->group_by_defs[iGroup].field_index == field_index)
+                return iGroup;
+        }
+        return -1;
+    };
+
+    std::vector<size_t> anOrder(nGroups);
+    for (size_t i = 0; i < nGroups; i++)
+        anOrder[i] = i;
+
+    const int nOrderItems = psSelectInfo->order_specs;
+    if (nOrderItems > 0)
+    {
+        // Shallow copies of the values of the key features
+        std::vector<OGRField> asKeys(nGroups * nOrderItems);
+        for (int iKey = 0; iKey < nOrderItems; iKey++)
+        {
+            const swq_order_def *psKeyDef = psSelectInfo->order_defs + iKey;
+            const int iGroup =
+                GetGroupIndex(psKeyDef->table_index, psKeyDef->field_index);
+            CPLAssert(iGroup >= 0);
+            for (size_t i = 0; i < nGroups; i++)
+            {
+                asKeys[i * nOrderItems + iKey] =
+                    *(oGroups.apoKeyFeatures[i]->GetRawFieldRef(iGroup));
+            }
+        }
+
+        auto poThis = const_cast<OGRGenSQLResultsLayer *>(this);
+        std::stable_sort(anOrder.begin(), anOrder.end(),
+                         [poThis, &asKeys, nOrderItems](size_t a, size_t b)
+                         {
+                             return poThis->Compare(&asKeys[a * nOrderItems],
+                                                    &asKeys[b * nOrderItems]) <
+                                    0;
+                         });
+    }
+
+    /* -------------------------------------------------------------------- */
+    /*      Build the result features.                                      */
+    /* -------------------------------------------------------------------- */
+    m_apoGroupFeatures.reserve(nGroups);
+    for (size_t i = 0; i < nGroups; i++)
+    {
+        const size_t nGroup = anOrder[i];
+        const OGRFeature *poKeyFeature = oGroups.apoKeyFeatures[nGroup].get();
+
+        auto poFeature = std::make_unique<OGRFeature>(m_poDefn);
+        poFeature->SetFID(static_cast<GIntBig>(i));
+
+        std::swap(psSelectInfo->column_summary, oGroups.aaoSummaries[nGroup]);
+        SetSummaryValues(poFeature.get());
+        std::swap(psSelectInfo->column_summary, oGroups.aaoSummaries[nGroup]);
+
+        for (int iField = 0; iField < psSelectInfo->result_columns(); iField++)
+        {
+            const swq_col_def *psColDef = &psSelectInfo->column_defs[iField];
+            if (psColDef->col_func != SWQCF_NONE || psColDef->bHidden)
+                continue;
+
+            const int iGroup =
+                GetGroupIndex(psColDef->table_index, psColDef->field_index);
+            CPLAssert(iGroup >= 0);
+            const OGRFieldType eKeyType =
+                oGroups.poKeyDefn->GetFieldDefn(iGroup)->GetType();
+            if (!poKeyFeature->IsFieldSetAndNotNull(iGroup))
+                poFeature->SetFieldNull(iField);
+            else if (eKeyType == m_poDefn->GetFieldDefn(iField)->GetType())
+                poFeature->SetField(iField,
+                                    poKeyFeature->GetRawFieldRef(iGroup));
+            else if (eKeyType == OFTInteger64)
+                poFeature->SetField(iField,
+                                    poKeyFeature->GetFieldAsInteger64(iGroup));
+            else
+                poFeature->SetField(iField,
+                                    poKeyFeature->GetFieldAsString(iGroup));
+        }
+
+        m_apoGroupFeatures.push_back(std::move(poFeature));
+    }
+
+    // Marks the result as prepared
+    m_poSummaryFeature = std::make_unique<OGRFeature>(m_poDefn);
+    m_poSummaryFeature->SetFID(0);
+
+    return true;
+}
+
+/************************************************************************/
+/*                       OGRMultiFeatureFetcher()                       */
 /************************************************************************/
 
 typedef std::vector<std::unique_ptr<OGRFeature>> VectorOfUniquePtrFeature;
@@ -1482,6 +2227,254 @@ static CPLString GetFilterForJoin(swq_expr_node *poExpr, OGRFeature *poSrcFeat,
     return "";
 }
 
+/************************************************************************/
+/*                      OGRGenSQLGetJoinKeyType()                       */
+/*                                                                      */
+/*      Key type of a column of an equi-join condition, if it can be    */
+/*      used as a hash join key.                                        */
+/************************************************************************/
+
+static bool OGRGenSQLGetJoinKeyType(const OGRFeatureDefn *poDefn,
+                                    int iField, OGRGenSQLKeyType &eType)
+{
+    if (iField == poDefn->GetFieldCount() + SPF_FID)
+    {
+        eType = OGRGenSQLKeyType::INTEGER;
+        return true;
+    }
+    if (iField < 0 || iField >= poDefn->GetFieldCount())
+        return false;
+
+    switch (poDefn->GetFieldDefn(iField)->GetType())
+    {
+        case OFTInteger:
+        case OFTInteger64:
+            eType = OGRGenSQLKeyType::INTEGER;
+            return true;
+
+        case OFTReal:
+            eType = OGRGenSQLKeyType::REAL;
+            return true;
+
+        case OFTString:
+            eType = OGRGenSQLKeyType::STRING_NOCASE;
+            return true;
+
+        default:
+            break;
+    }
+    return false;
+}
+
+/************************************************************************/
+/*                     OGRGenSQLHashJoin::Create()                      */
+/*                                                                      */
+/*      Returns nullptr if the join condition is not an equi-join on    */
+/*      columns of compatible types.                                    */
+/************************************************************************/
+
+std::unique_ptr<OGRGenSQLHashJoin>
+OGRGenSQLHashJoin::Create(const swq_join_def *psJoinInfo,
+                          OGRLayer *poSrcLayer, OGRLayer *poJoinLayer)
+{
+    // A self join would interfere with the reading of the source layer
+    if (poJoinLayer == poSrcLayer)
+        return nullptr;
+
+    auto poHashJoin = std::make_unique<OGRGenSQLHashJoin>();
+    poHashJoin->m_poJoinLayer = poJoinLayer;
+    if (!poHashJoin->CollectKeyParts(
+            psJoinInfo->poExpr, psJoinInfo->secondary_table,
+            poSrcLayer->GetLayerDefn(), poJoinLayer->GetLayerDefn()) ||
+        poHashJoin->m_aoKeyParts.empty())
+    {
+        return nullptr;
+    }
+    return poHashJoin;
+}
+
+/************************************************************************/
+/*                 OGRGenSQLHashJoin::CollectKeyParts()                 */
+/************************************************************************/
+
+bool OGRGenSQLHashJoin::CollectKeyParts(const swq_expr_node *poExpr,
+                                        int nSecondaryTable,
+                                        const OGRFeatureDefn *poSrcDefn,
+                                        const OGRFeatureDefn *poJoinDefn)
+{
+    if (poExpr->eNodeType != SNT_OPERATION)
+        return false;
+
+    if (poExpr->nOperation == SWQ_AND)
+    {
+        for (int i = 0; i < poExpr->nSubExprCount; i++)
+        {
+            if (!CollectKeyParts(poExpr->papoSubExpr[i], nSecondaryTable,
+                                 poSrcDefn, poJoinDefn))
+                return false;
+        }
+        return true;
+    }
+
+    if (poExpr->nOperation != SWQ_EQ || poExpr->nSubExprCount != 2)
+        return false;
+
+    const swq_expr_node *poSrcColumn = poExpr->papoSubExpr[0];
+    const swq_expr_node *poJoinColumn = poExpr->papoSubExpr[1];
+    if (poSrcColumn->eNodeType != SNT_COLUMN ||
+        poJoinColumn->eNodeType != SNT_COLUMN)
+        return false;
+    if (poSrcColumn->table_index == nSecondaryTable &&
+        poJoinColumn->table_index == 0)
+        std::swap(poSrcColumn, poJoinColumn);
+    if (poSrcColumn->table_index != 0 ||
+        poJoinColumn->table_index != nSecondaryTable)
+        return false;
+
+    OGRGenSQLKeyType eSrcType = OGRGenSQLKeyType::INTEGER;
+    OGRGenSQLKeyType eJoinType = OGRGenSQLKeyType::INTEGER;
+    if (!OGRGenSQLGetJoinKeyType(poSrcDefn, poSrcColumn->field_index,
+                                 eSrcType) ||
+        !OGRGenSQLGetJoinKeyType(poJoinDefn, poJoinColumn->field_index,
+                                 eJoinType))
+        return false;
+
+    KeyPart oPart;
+    oPart.iSrcField = poSrcColumn->field_index;
+    oPart.iJoinField = poJoinColumn->field_index;
+    if (eSrcType == eJoinType)
+        oPart.eType = eSrcType;
+    else if (eSrcType != OGRGenSQLKeyType::STRING_NOCASE &&
+             eJoinType != OGRGenSQLKeyType::STRING_NOCASE)
+        oPart.eType = OGRGenSQLKeyType::REAL;  // integer = real
+    else
+        return false;
+
+    m_aoKeyParts.push_back(oPart);
+    return true;
+}
+
+/************************************************************************/
+/*                   OGRGenSQLHashJoin::ComputeKey()                    */
+/*                                                                      */
+/*      Returns false if the feature cannot match anything, that is     */
+/*      if one of its key values is null or NaN.                        */
+/************************************************************************/
+
+bool OGRGenSQLHashJoin::ComputeKey(const OGRFeature *poFeature,
+                                   bool bSrcFeature, std::string &osKey) const
+{
+    osKey.clear();
+    for (const auto &oPart : m_aoKeyParts)
+    {
+        const int iField = bSrcFeature ? oPart.iSrcField : oPart.iJoinField;
+        if (!OGRGenSQLAppendKey(osKey, poFeature, iField, oPart.eType))
+            return false;
+        if (oPart.eType == OGRGenSQLKeyType::REAL &&
+            std::isnan(poFeature->GetFieldAsDouble(iField)))
+            return false;
+    }
+    return true;
+}
+
+/************************************************************************/
+/*                      OGRGenSQLHashJoin::Build()                      */
+/*                                                                      */
+/*      Returns false, with an empty table, if it does not fit within   */
+/*      nMaxMemory bytes.                                               */
+/************************************************************************/
+
+bool OGRGenSQLHashJoin::Build(GIntBig nMaxMemory)
+{
+    m_poJoinLayer->SetAttributeFilter(nullptr);
+    m_poJoinLayer->ResetReading();
+
+    std::string osKey;
+    while (true)
+    {
+        std::unique_ptr<OGRFeature> poFeature(m_poJoinLayer->GetNextFeature());
+        if (poFeature == nullptr)
+            break;
+
+        if (!ComputeKey(poFeature.get(), false, osKey) ||
+            m_oMapFeatures.find(osKey) != m_oMapFeatures.end())
+            continue;
+
+        // Key stored once in the node, plus the node and bucket overhead
+        m_nMemSize += OGRGenSQLEstimateFeatureSize(poFeature.get()) +
+                      osKey.size() + sizeof(std::string) +
+                      4 * sizeof(void *);
+        if (m_nMemSize > nMaxMemory)
+        {
+            CPLDebug("GenSQL",
+                     "Hash table over '%s' exceeds "
+                     "OGR_SQL_HASH_JOIN_MAX_MEMORY. Using attribute filters "
+                     "instead.",
+                     m_poJoinLayer->GetName());
+            m_oMapFeatures.clear();
+            m_nMemSize = 0;
+            return false;
+        }
+
+        m_oMapFeatures.emplace(osKey, std::move(poFeature));
+    }
+
+    CPLDebug("GenSQL", "Hash table over '%s' built with %d keys.",
+             m_poJoinLayer->GetName(), static_cast<int>(m_oMapFeatures.size()));
+    return true;
+}
+
+/************************************************************************/
+/*                     OGRGenSQLHashJoin::Lookup()                      */
+/************************************************************************/
+
+std::unique_ptr<OGRFeature>
+OGRGenSQLHashJoin::Lookup(const OGRFeature *poSrcFeat) const
+{
+    std::string osKey;
+    if (!ComputeKey(poSrcFeat, true, osKey))
+        return nullptr;
+
+    const auto oIter = m_oMapFeatures.find(osKey);
+    if (oIter == m_oMapFeatures.end())
+        return nullptr;
+    return std::unique_ptr<OGRFeature>(oIter->second->Clone());
+}
+
+// Joins of the first source features are resolved with attribute filters, so
+// that a query reading only a few features does not scan the joined layers
+static constexpr GIntBig HASH_JOIN_MIN_FEATURES = 32;
+
+/************************************************************************/
+/*                        InitializeHashJoins()                         */
+/*                                                                      */
+/*      Build a hash table over each joined layer whose join condition  */
+/*      allows it, within OGR_SQL_HASH_JOIN_MAX_MEMORY overall.         */
+/************************************************************************/
+
+void OGRGenSQLResultsLayer::InitializeHashJoins()
+{
+    swq_select *psSelectInfo = m_pSelectInfo.get();
+
+    m_bHashJoinsInitialized = true;
+    m_apoHashJoins.resize(psSelectInfo->join_count);
+
+    GIntBig nMaxMemory = OGRGenSQLGetMaxMemory("OGR_SQL_HASH_JOIN_MAX_MEMORY");
+    for (int iJoin = 0; iJoin < psSelectInfo->join_count && nMaxMemory > 0;
+         iJoin++)
+    {
+        const swq_join_def *psJoinInfo = psSelectInfo->join_defs + iJoin;
+        auto poHashJoin = OGRGenSQLHashJoin::Create(
+            psJoinInfo, m_poSrcLayer,
+            m_apoTableLayers[psJoinInfo->secondary_table]);
+        if (poHashJoin && poHashJoin->Build(nMaxMemory))
+        {
+            nMaxMemory -= poHashJoin->GetMemSize();
+            m_apoHashJoins[iJoin] = std::move(poHashJoin);
+        }
+    }
+}
+
 /************************************************************************/
 /*                          TranslateFeature()                          */
 /************************************************************************/
@@ -1504,6 +2497,11 @@ std::unique_ptr<OGRFeature> OGRGenSQLResultsLayer::TranslateFeature(
     /* -------------------------------------------------------------------- */
     /*      Fetch the corresponding features from any jointed tables.       */
     /* -------------------------------------------------------------------- */
+    if (!m_bHashJoinsInitialized && psSelectInfo->join_count > 0 &&
+        m_nFeaturesRead > HASH_JOIN_MIN_FEATURES)
+    {
+        InitializeHashJoins();
+    }
     for (int iJoin = 0; iJoin < psSelectInfo->join_count; iJoin++)
     {
         const swq_join_def *psJoinInfo = psSelectInfo->join_defs + iJoin;
@@ -1513,6 +2511,12 @@ std::unique_ptr<OGRFeature> OGRGenSQLResultsLayer::TranslateFeature(
         /* we have taken care of this */
         CPLAssert(psJoinInfo->secondary_table == iJoin + 1);
 
+        if (m_bHashJoinsInitialized && m_apoHashJoins[iJoin])
+        {
+            apoFeatures.push_back(m_apoHashJoins[iJoin]->Lookup(poSrcFeat));
+            continue;
+        }
+
         OGRLayer *poJoinLayer = m_apoTableLayers[psJoinInfo->secondary_table];
 
         const std::string osFilter =
@@ -1870,7 +2874,7 @@ OGRFeature *OGRGenSQLResultsLayer::GetNextFeature()
         return nullptr;
 
     CreateOrderByIndex();
-    if (m_anFIDIndex.empty() && m_nIteratedFeatures < 0 &&
+    if (m_poSortedRows == nullptr && m_nIteratedFeatures < 0 &&
         psSelectInfo->offset > 0 && psSelectInfo->query_mode == SWQM_RECORDSET)
     {
         m_poSrcLayer->SetNextByIndex(psSelectInfo->offset);
@@ -1888,36 +2892,25 @@ OGRFeature *OGRGenSQLResultsLayer::GetNextFeature()
         return GetFeature(m_nNextIndexFID++);
     }
 
-    int bEvaluateSpatialFilter = MustEvaluateSpatialFilterOnGenSQL();
-
     /* -------------------------------------------------------------------- */
-    /*      Handle ordered sets.                                            */
+    /*      Handle ordered sets. Their rows are already translated and      */
+    /*      filtered.                                                       */
     /* -------------------------------------------------------------------- */
-    while (true)
+    if (m_poSortedRows)
     {
-        std::unique_ptr<OGRFeature> poSrcFeat;
-        if (!m_anFIDIndex.empty())
-        {
-            /* --------------------------------------------------------------------
-             */
-            /*      Are we running in sorted mode?  If so, run the fid through
-             */
-            /*      the index. */
-            /* --------------------------------------------------------------------
-             */
-
-            if (m_nNextIndexFID >= static_cast<GIntBig>(m_anFIDIndex.size()))
-                return nullptr;
+        auto poFeature = m_poSortedRows->GetRow(m_nNextIndexFID);
+        if (poFeature == nullptr)
+            return nullptr;
+        m_nNextIndexFID++;
+        m_nIteratedFeatures++;
+        return poFeature.release();
+    }
 
-            poSrcFeat.reset(m_poSrcLayer->GetFeature(
-                m_anFIDIndex[static_cast<size_t>(m_nNextIndexFID)]));
-            m_nNextIndexFID++;
-        }
-        else
-        {
-            poSrcFeat.reset(m_poSrcLayer->GetNextFeature());
-        }
+    int bEvaluateSpatialFilter = MustEvaluateSpatialFilterOnGenSQL();
 
+    while (true)
+    {
+        std::unique_ptr<OGRFeature> poSrcFeat(m_poSrcLayer->GetNextFeature());
         if (poSrcFeat == nullptr)
             return nullptr;
 
@@ -1952,7 +2945,16 @@ OGRFeature *OGRGenSQLResultsLayer::GetFeature(GIntBig nFID)
     /* -------------------------------------------------------------------- */
     if (psSelectInfo->query_mode == SWQM_SUMMARY_RECORD)
     {
-        if (!PrepareSummary() || nFID != 0 || !m_poSummaryFeature)
+        if (!PrepareSummary() || !m_poSummaryFeature)
+            return nullptr;
+        else if (psSelectInfo->group_by_count > 0)
+        {
+            if (nFID < 0 ||
+                nFID >= static_cast<GIntBig>(m_apoGroupFeatures.size()))
+                return nullptr;
+            return m_apoGroupFeatures[static_cast<size_t>(nFID)]->Clone();
+        }
+        else if (nFID != 0)
             return nullptr;
         else
             return m_poSummaryFeature->Clone();
@@ -2075,55 +3077,40 @@ const OGRFeatureDefn *OGRGenSQLResultsLayer::GetLayerDefn() const
 }
 
 /************************************************************************/
-/*                          FreeIndexFields()                           */
+/*                        GetStringIndexFields()                        */
+/*                                                                      */
+/*      Return, for each ORDER BY key, whether ReadIndexFields()        */
+/*      stores it as an allocated string.                               */
 /************************************************************************/
 
-void OGRGenSQLResultsLayer::FreeIndexFields(OGRField *pasIndexFields,
-                                            size_t l_nIndexSize)
+std::vector<bool> OGRGenSQLResultsLayer::GetStringIndexFields() const
 {
-    swq_select *psSelectInfo = m_pSelectInfo.get();
+    const swq_select *psSelectInfo = m_pSelectInfo.get();
     const int nOrderItems = psSelectInfo->order_specs;
 
-    /* -------------------------------------------------------------------- */
-    /*      Free the key field values.                                      */
-    /* -------------------------------------------------------------------- */
+    std::vector<bool> abStringKeys(nOrderItems);
     for (int iKey = 0; iKey < nOrderItems; iKey++)
     {
-        swq_order_def *psKeyDef = psSelectInfo->order_defs + iKey;
+        const swq_order_def *psKeyDef = psSelectInfo->order_defs + iKey;
 
         if (psKeyDef->field_index >= m_iFIDFieldIndex)
         {
             CPLAssert(psKeyDef->field_index <
                       m_iFIDFieldIndex + SPECIAL_FIELD_COUNT);
-            /* warning: only special fields of type string should be deallocated
-             */
-            if (SpecialFieldTypes[psKeyDef->field_index - m_iFIDFieldIndex] ==
-                SWQ_STRING)
-            {
-                for (size_t i = 0; i < l_nIndexSize; i++)
-                {
-                    OGRField *psField = pasIndexFields + iKey + i * nOrderItems;
-                    CPLFree(psField->String);
-                }
-            }
-            continue;
+            /* warning: only special fields of type string are allocated */
+            abStringKeys[iKey] =
+                SpecialFieldTypes[psKeyDef->field_index - m_iFIDFieldIndex] ==
+                SWQ_STRING;
         }
-
-        OGRFieldDefn *poFDefn =
-            m_poSrcLayer->GetLayerDefn()->GetFieldDefn(psKeyDef->field_index);
-
-        if (poFDefn->GetType() == OFTString)
+        else
         {
-            for (size_t i = 0; i < l_nIndexSize; i++)
-            {
-                OGRField *psField = pasIndexFields + iKey + i * nOrderItems;
-
-                if (!OGR_RawField_IsUnset(psField) &&
-                    !OGR_RawField_IsNull(psField))
-                    CPLFree(psField->String);
-            }
+            const OGRFieldDefn *poFDefn =
+                m_poSrcLayer->GetLayerDefn()->GetFieldDefn(
+                    psKeyDef->field_index);
+            abStringKeys[iKey] = poFDefn->GetType() == OFTString;
         }
     }
+    return abStringKeys;
 }
 
 /************************************************************************/
@@ -2160,310 +3147,720 @@ void OGRGenSQLResultsLayer::ReadIndexFields(OGRFeature *poSrcFeat,
                         poSrcFeat->GetFieldAsDouble(psKeyDef->field_index);
                     break;
 
-                default:
-                    psDstField->String = CPLStrdup(
-                        poSrcFeat->GetFieldAsString(psKeyDef->field_index));
-                    break;
-            }
+                default:
+                    psDstField->String = CPLStrdup(
+                        poSrcFeat->GetFieldAsString(psKeyDef->field_index));
+                    break;
+            }
+
+            continue;
+        }
+
+        OGRFieldDefn *poFDefn =
+            m_poSrcLayer->GetLayerDefn()->GetFieldDefn(psKeyDef->field_index);
+
+        OGRField *psSrcField = poSrcFeat->GetRawFieldRef(psKeyDef->field_index);
+
+        if (poFDefn->GetType() == OFTInteger ||
+            poFDefn->GetType() == OFTInteger64 ||
+            poFDefn->GetType() == OFTReal || poFDefn->GetType() == OFTDate ||
+            poFDefn->GetType() == OFTTime || poFDefn->GetType() == OFTDateTime)
+            memcpy(psDstField, psSrcField, sizeof(OGRField));
+        else if (poFDefn->GetType() == OFTString)
+        {
+            if (poSrcFeat->IsFieldSetAndNotNull(psKeyDef->field_index))
+                psDstField->String = CPLStrdup(psSrcField->String);
+            else
+                memcpy(psDstField, psSrcField, sizeof(OGRField));
+        }
+    }
+}
+
+/************************************************************************/
+/*                      OGRGenSQLEstimateRowSize()                      */
+/*                                                                      */
+/*      Rough estimate of the memory used by a sorted row.              */
+/************************************************************************/
+
+static size_t OGRGenSQLEstimateRowSize(const OGRGenSQLSortRow &oRow)
+{
+    size_t nSize = sizeof(OGRGenSQLSortRow) +
+                   oRow.asKeys.size() * sizeof(OGRField) +
+                   OGRGenSQLEstimateFeatureSize(oRow.poFeature.get());
+    for (size_t i = 0; i < oRow.asKeys.size(); ++i)
+    {
+        const OGRField &sKey = oRow.asKeys[i];
+        if ((*oRow.pabStringKeys)[i] && !OGR_RawField_IsUnset(&sKey) &&
+            !OGR_RawField_IsNull(&sKey) && sKey.String)
+            nSize += strlen(sKey.String) + 1;
+    }
+
+    return nSize;
+}
+
+/************************************************************************/
+/*               Helpers to encode and decode run records               */
+/************************************************************************/
+
+template <class T>
+static void OGRGenSQLAppendRaw(std::vector<GByte> &abyBuffer, const T &value)
+{
+    const GByte *pabyValue = reinterpret_cast<const GByte *>(&value);
+    abyBuffer.insert(abyBuffer.end(), pabyValue, pabyValue + sizeof(T));
+}
+
+static void OGRGenSQLAppendString(std::vector<GByte> &abyBuffer,
+                                  const char *pszValue)
+{
+    if (pszValue == nullptr)
+    {
+        OGRGenSQLAppendRaw(abyBuffer, std::numeric_limits<uint32_t>::max());
+        return;
+    }
+    const uint32_t nLen = static_cast<uint32_t>(strlen(pszValue));
+    OGRGenSQLAppendRaw(abyBuffer, nLen);
+    abyBuffer.insert(abyBuffer.end(), pszValue, pszValue + nLen);
+}
+
+template <class T>
+static bool OGRGenSQLReadRaw(const GByte *&pabyIter, const GByte *pabyEnd,
+                             T &value)
+{
+    if (static_cast<size_t>(pabyEnd - pabyIter) < sizeof(T))
+        return false;
+    memcpy(&value, pabyIter, sizeof(T));
+    pabyIter += sizeof(T);
+    return true;
+}
+
+// Read a string written by OGRGenSQLAppendString(). *ppszValue is allocated
+// with CPLMalloc(), or nullptr for a null string.
+static bool OGRGenSQLReadString(const GByte *&pabyIter, const GByte *pabyEnd,
+                                char **ppszValue)
+{
+    *ppszValue = nullptr;
+    uint32_t nLen = 0;
+    if (!OGRGenSQLReadRaw(pabyIter, pabyEnd, nLen))
+        return false;
+    if (nLen == std::numeric_limits<uint32_t>::max())
+        return true;
+    if (nLen > static_cast<size_t>(pabyEnd - pabyIter))
+        return false;
+    *ppszValue = static_cast<char *>(CPLMalloc(nLen + 1));
+    memcpy(*ppszValue, pabyIter, nLen);
+    (*ppszValue)[nLen] = '\0';
+    pabyIter += nLen;
+    return true;
+}
+
+/************************************************************************/
+/*                        OGRGenSQLSortedRows()                         */
+/************************************************************************/
+
+OGRGenSQLSortedRows::OGRGenSQLSortedRows(OGRGenSQLResultsLayer *poLayer,
+                                         GIntBig nMaxMemory, GIntBig nMaxRows)
+    : m_poLayer(poLayer), m_abStringKeys(poLayer->GetStringIndexFields()),
+      m_nMaxMemory(nMaxMemory), m_nMaxRows(nMaxRows), m_bTopK(nMaxRows >= 0)
+{
+}
 
-            continue;
-        }
+OGRGenSQLSortedRows::~OGRGenSQLSortedRows() = default;
 
-        OGRFieldDefn *poFDefn =
-            m_poSrcLayer->GetLayerDefn()->GetFieldDefn(psKeyDef->field_index);
+OGRGenSQLSortedRows::Run::~Run()
+{
+    if (fp)
+        VSIFCloseL(fp);
+    if (!osFilename.empty())
+        VSIUnlink(osFilename.c_str());
+}
 
-        OGRField *psSrcField = poSrcFeat->GetRawFieldRef(psKeyDef->field_index);
+/************************************************************************/
+/*                                Less()                                */
+/************************************************************************/
 
-        if (poFDefn->GetType() == OFTInteger ||
-            poFDefn->GetType() == OFTInteger64 ||
-            poFDefn->GetType() == OFTReal || poFDefn->GetType() == OFTDate ||
-            poFDefn->GetType() == OFTTime || poFDefn->GetType() == OFTDateTime)
-            memcpy(psDstField, psSrcField, sizeof(OGRField));
-        else if (poFDefn->GetType() == OFTString)
-        {
-            if (poSrcFeat->IsFieldSetAndNotNull(psKeyDef->field_index))
-                psDstField->String = CPLStrdup(psSrcField->String);
-            else
-                memcpy(psDstField, psSrcField, sizeof(OGRField));
-        }
-    }
+bool OGRGenSQLSortedRows::Less(const OGRGenSQLSortRow &oA,
+                               const OGRGenSQLSortRow &oB) const
+{
+    const int nResult = m_poLayer->Compare(oA.asKeys.data(), oB.asKeys.data());
+    return nResult < 0 || (nResult == 0 && oA.nSeq < oB.nSeq);
 }
 
 /************************************************************************/
-/*                         CreateOrderByIndex()                         */
+/*                            IsCandidate()                             */
 /*                                                                      */
-/*      This method is responsible for creating an index providing      */
-/*      ordered access to the features according to the supplied        */
-/*      ORDER BY clauses.                                               */
-/*                                                                      */
-/*      This is accomplished by making one pass through all the         */
-/*      eligible source features, and capturing the order by fields     */
-/*      of all records in memory.  A quick sort is then applied to      */
-/*      this in memory copy of the order-by fields to create the        */
-/*      required index.                                                 */
-/*                                                                      */
-/*      Keeping all the key values in memory will *not* scale up to     */
-/*      very large input datasets.                                      */
+/*      In top-K mode, whether a row whose keys are set may belong to   */
+/*      the result. This avoids translating rows that cannot.           */
 /************************************************************************/
 
-void OGRGenSQLResultsLayer::CreateOrderByIndex()
-
+bool OGRGenSQLSortedRows::IsCandidate(const OGRGenSQLSortRow &oRow)
 {
-    swq_select *psSelectInfo = m_pSelectInfo.get();
-    const int nOrderItems = psSelectInfo->order_specs;
-
-    if (!(nOrderItems > 0 && psSelectInfo->query_mode == SWQM_RECORDSET))
-        return;
+    if (!m_bTopK || static_cast<GIntBig>(m_aoRows.size()) < m_nMaxRows)
+        return true;
+    if (m_nMaxRows > 0 && Less(oRow, m_aoRows.front()))
+        return true;
+    m_bRowCountExact = false;
+    return false;
+}
 
-    if (m_bOrderByValid)
-        return;
+/************************************************************************/
+/*                               AddRow()                               */
+/************************************************************************/
 
-    m_bOrderByValid = true;
-    m_anFIDIndex.clear();
+bool OGRGenSQLSortedRows::AddRow(OGRGenSQLSortRow &&oRow)
+{
+    ++m_nRowCount;
+    oRow.nMemSize = OGRGenSQLEstimateRowSize(oRow);
+    m_nMemSize += oRow.nMemSize;
 
-    ResetReading();
+    const auto oLess = [this](const OGRGenSQLSortRow &oA,
+                              const OGRGenSQLSortRow &oB)
+    { return Less(oA, oB); };
 
-    /* -------------------------------------------------------------------- */
-    /*      Optimize (memory-wise) ORDER BY ... LIMIT 1 [OFFSET 0] case.    */
-    /* -------------------------------------------------------------------- */
-    if (psSelectInfo->offset == 0 && psSelectInfo->limit == 1)
+    try
     {
-        std::vector<OGRField> asCurrentFields(nOrderItems);
-        std::vector<OGRField> asBestFields(nOrderItems);
-        memset(asCurrentFields.data(), 0, sizeof(OGRField) * nOrderItems);
-        memset(asBestFields.data(), 0, sizeof(OGRField) * nOrderItems);
-        bool bFoundSrcFeature = false;
-        GIntBig nBestFID = 0;
-        for (auto &&poSrcFeat : *m_poSrcLayer)
+        if (m_bTopK)
         {
-            ReadIndexFields(poSrcFeat.get(), nOrderItems,
-                            asCurrentFields.data());
-            if (!bFoundSrcFeature ||
-                Compare(asCurrentFields.data(), asBestFields.data()) < 0)
+            // Max-heap of the best m_nMaxRows rows seen so far
+            if (static_cast<GIntBig>(m_aoRows.size()) == m_nMaxRows)
             {
-                bFoundSrcFeature = true;
-                nBestFID = poSrcFeat->GetFID();
-                FreeIndexFields(asBestFields.data(), 1);
-                memcpy(asBestFields.data(), asCurrentFields.data(),
-                       sizeof(OGRField) * nOrderItems);
+                std::pop_heap(m_aoRows.begin(), m_aoRows.end(), oLess);
+                m_nMemSize -= m_aoRows.back().nMemSize;
+                m_aoRows.back() = std::move(oRow);
             }
             else
             {
-                FreeIndexFields(asCurrentFields.data(), 1);
+                m_aoRows.push_back(std::move(oRow));
             }
-            memset(asCurrentFields.data(), 0, sizeof(OGRField) * nOrderItems);
-        }
-        FreeIndexFields(asBestFields.data(), 1);
+            std::push_heap(m_aoRows.begin(), m_aoRows.end(), oLess);
+            if (m_nMemSize <= m_nMaxMemory)
+                return true;
 
-        if (bFoundSrcFeature)
+            // The heap does not fit in memory: fall back to runs
+            CPLDebug("GenSQL", "ORDER BY: %d rows exceed the memory limit, "
+                               "switching from top-K to external sort",
+                     static_cast<int>(m_aoRows.size()));
+            m_bTopK = false;
+        }
+        else
         {
-            m_anFIDIndex.resize(1);
-            m_anFIDIndex[0] = nBestFID;
+            m_aoRows.push_back(std::move(oRow));
         }
-        return;
+    }
+    catch (const std::bad_alloc &)
+    {
+        CPLError(CE_Failure, CPLE_OutOfMemory,
+                 "CreateOrderByIndex(): out of memory");
+        return false;
     }
 
-    /* -------------------------------------------------------------------- */
-    /*      Allocate set of key values, and the output index.               */
-    /* -------------------------------------------------------------------- */
-    size_t nFeaturesAlloc = 100;
-    size_t nIndexSize = 0;
-    std::vector<OGRField> asIndexFields(nOrderItems * nFeaturesAlloc);
-    memset(asIndexFields.data(), 0,
-           sizeof(OGRField) * nOrderItems * nFeaturesAlloc);
-    std::vector<GIntBig> anFIDList;
+    if (m_nMemSize > m_nMaxMemory)
+        return SpillRows();
+    return true;
+}
+
+/************************************************************************/
+/*                             CreateRun()                              */
+/************************************************************************/
+
+std::unique_ptr<OGRGenSQLSortedRows::Run>
+OGRGenSQLSortedRows::CreateRun(int nLevel)
+{
+    auto poRun = std::make_unique<Run>();
+    poRun->osFilename = CPLGenerateTempFilenameSafe("ogr_sql_sort");
+    poRun->fp = VSIFOpenL(poRun->osFilename.c_str(), "wb+");
+    if (poRun->fp == nullptr)
+    {
+        CPLError(CE_Failure, CPLE_FileIO,
+                 "ORDER BY: cannot create temporary file %s",
+                 poRun->osFilename.c_str());
+        poRun->osFilename.clear();
+        return nullptr;
+    }
+    poRun->nLevel = nLevel;
+    poRun->oRow = NewRow();
+    return poRun;
+}
+
+/************************************************************************/
+/*                            WriteRecord()                             */
+/************************************************************************/
 
-    // Frees nIndexSize rows of asIndexFields
-    struct IndexFieldsFreer
+bool OGRGenSQLSortedRows::WriteRecord(Run &oRun,
+                                      const std::vector<GByte> &abyRecord)
+{
+    const uint32_t nSize = static_cast<uint32_t>(abyRecord.size());
+    if (VSIFWriteL(&nSize, sizeof(nSize), 1, oRun.fp) != 1 ||
+        VSIFWriteL(abyRecord.data(), 1, abyRecord.size(), oRun.fp) !=
+            abyRecord.size())
     {
-        OGRGenSQLResultsLayer &m_oLayer;
-        std::vector<OGRField> &m_asIndexFields;
-        size_t &m_nIndexSize;
+        CPLError(CE_Failure, CPLE_FileIO,
+                 "ORDER BY: cannot write into temporary file %s",
+                 oRun.osFilename.c_str());
+        return false;
+    }
+    oRun.nRows++;
+    return true;
+}
+
+/************************************************************************/
+/*                             SpillRows()                              */
+/*                                                                      */
+/*      Sort the rows held in memory and write them as a new run.       */
+/************************************************************************/
+
+bool OGRGenSQLSortedRows::SpillRows()
+{
+    std::sort(m_aoRows.begin(), m_aoRows.end(),
+              [this](const OGRGenSQLSortRow &oA, const OGRGenSQLSortRow &oB)
+              { return Less(oA, oB); });
+
+    auto poRun = CreateRun(0);
+    if (!poRun)
+        return false;
 
-        IndexFieldsFreer(OGRGenSQLResultsLayer &poLayerIn,
-                         std::vector<OGRField> &asIndexFieldsIn,
-                         size_t &nIndexSizeIn)
-            : m_oLayer(poLayerIn), m_asIndexFields(asIndexFieldsIn),
-              m_nIndexSize(nIndexSizeIn)
+    std::vector<GByte> abyRecord;
+    std::vector<GByte> abyFeature;
+    for (const auto &oRow : m_aoRows)
+    {
+        abyRecord.clear();
+        OGRGenSQLAppendRaw(abyRecord, oRow.nSeq);
+        for (size_t i = 0; i < oRow.asKeys.size(); ++i)
         {
+            const OGRField &sKey = oRow.asKeys[i];
+            OGRGenSQLAppendRaw(abyRecord, sKey);
+            if (m_abStringKeys[i] && !OGR_RawField_IsUnset(&sKey) &&
+                !OGR_RawField_IsNull(&sKey))
+                OGRGenSQLAppendString(abyRecord, sKey.String);
         }
 
-        ~IndexFieldsFreer()
+        if (!oRow.poFeature->SerializeToBinary(abyFeature))
         {
-            m_oLayer.FreeIndexFields(m_asIndexFields.data(), m_nIndexSize);
+            CPLError(CE_Failure, CPLE_AppDefined,
+                     "ORDER BY: cannot serialize feature");
+            return false;
         }
+        OGRGenSQLAppendRaw(abyRecord, static_cast<uint32_t>(abyFeature.size()));
+        abyRecord.insert(abyRecord.end(), abyFeature.begin(), abyFeature.end());
+        OGRGenSQLAppendString(abyRecord, oRow.poFeature->GetStyleString());
+        OGRGenSQLAppendString(abyRecord, oRow.poFeature->GetNativeData());
+        OGRGenSQLAppendString(abyRecord,
+                              oRow.poFeature->GetNativeMediaType());
+
+        if (!WriteRecord(*poRun, abyRecord))
+            return false;
+    }
 
-        IndexFieldsFreer(const IndexFieldsFreer &) = delete;
-        IndexFieldsFreer &operator=(const IndexFieldsFreer &) = delete;
-    };
+    CPLDebug("GenSQL", "ORDER BY: spilled " CPL_FRMT_GIB " rows into %s",
+             poRun->nRows, poRun->osFilename.c_str());
 
-    IndexFieldsFreer oIndexFieldsFreer(*this, asIndexFields, nIndexSize);
+    m_aoRows.clear();
+    m_nMemSize = 0;
+    m_apoRuns.push_back(std::move(poRun));
 
-    /* -------------------------------------------------------------------- */
-    /*      Read in all the key values.                                     */
-    /* -------------------------------------------------------------------- */
+    // Merge runs level by level so that the number of open files stays small
+    for (int nLevel = 0;; ++nLevel)
+    {
+        const auto nRunsAtLevel =
+            std::count_if(m_apoRuns.begin(), m_apoRuns.end(),
+                          [nLevel](const std::unique_ptr<Run> &poIter)
+                          { return poIter->nLevel == nLevel; });
+        if (nRunsAtLevel == 0)
+            break;
+        if (nRunsAtLevel >= MERGE_FAN_IN && !MergeRuns(nLevel))
+            return false;
+    }
+
+    return true;
+}
+
+/************************************************************************/
+/*                             RewindRun()                              */
+/************************************************************************/
 
-    for (auto &&poSrcFeat : *m_poSrcLayer)
+bool OGRGenSQLSortedRows::RewindRun(Run &oRun)
+{
+    oRun.nRowsRead = 0;
+    if (VSIFSeekL(oRun.fp, 0, SEEK_SET) != 0)
     {
-        if (nIndexSize == nFeaturesAlloc)
-        {
-            const uint64_t nNewFeaturesAlloc64 =
-                static_cast<uint64_t>(nFeaturesAlloc) + nFeaturesAlloc / 3;
-#if SIZEOF_SIZE_T == 4
-            if (static_cast<size_t>(nNewFeaturesAlloc64) !=
-                    nNewFeaturesAlloc64 ||
-                static_cast<size_t>(sizeof(OGRField) * nOrderItems *
-                                    nNewFeaturesAlloc64) !=
-                    static_cast<uint64_t>(sizeof(OGRField)) * nOrderItems *
-                        nNewFeaturesAlloc64)
-            {
-                CPLError(CE_Failure, CPLE_AppDefined,
-                         "Cannot allocate pasIndexFields");
-                return;
-            }
-#endif
-            const size_t nNewFeaturesAlloc =
-                static_cast<size_t>(nNewFeaturesAlloc64);
+        CPLError(CE_Failure, CPLE_FileIO,
+                 "ORDER BY: cannot seek in temporary file %s",
+                 oRun.osFilename.c_str());
+        return false;
+    }
+    return true;
+}
 
-            try
-            {
-                asIndexFields.resize(nOrderItems * nNewFeaturesAlloc);
-                anFIDList.reserve(nNewFeaturesAlloc);
-            }
-            catch (const std::bad_alloc &)
-            {
-                CPLError(CE_Failure, CPLE_OutOfMemory,
-                         "CreateOrderByIndex(): out of memory");
-                return;
-            }
+/************************************************************************/
+/*                             ReadRecord()                             */
+/*                                                                      */
+/*      Read the next record of a run and decode its keys. Returns      */
+/*      false at the end of the run, or on error (m_bError is then      */
+/*      set).                                                           */
+/************************************************************************/
+
+bool OGRGenSQLSortedRows::ReadRecord(Run &oRun)
+{
+    if (oRun.nRowsRead == oRun.nRows)
+        return false;
 
-            memset(asIndexFields.data() + nFeaturesAlloc * nOrderItems, 0,
-                   sizeof(OGRField) * nOrderItems *
-                       (nNewFeaturesAlloc - nFeaturesAlloc));
+    const auto Corrupted = [this, &oRun]()
+    {
+        CPLError(CE_Failure, CPLE_FileIO,
+                 "ORDER BY: cannot read from temporary file %s",
+                 oRun.osFilename.c_str());
+        m_bError = true;
+        return false;
+    };
 
-            nFeaturesAlloc = nNewFeaturesAlloc;
+    uint32_t nSize = 0;
+    if (VSIFReadL(&nSize, sizeof(nSize), 1, oRun.fp) != 1)
+        return Corrupted();
+    try
+    {
+        oRun.abyRecord.resize(nSize);
+    }
+    catch (const std::bad_alloc &)
+    {
+        return Corrupted();
+    }
+    if (VSIFReadL(oRun.abyRecord.data(), 1, nSize, oRun.fp) != nSize)
+        return Corrupted();
+    oRun.nRowsRead++;
+
+    const GByte *pabyIter = oRun.abyRecord.data();
+    const GByte *const pabyEnd = pabyIter + nSize;
+    OGRGenSQLSortRow &oRow = oRun.oRow;
+    oRow.FreeKeys();
+    oRow.asKeys.resize(m_abStringKeys.size());
+    memset(oRow.asKeys.data(), 0, sizeof(OGRField) * oRow.asKeys.size());
+    if (!OGRGenSQLReadRaw(pabyIter, pabyEnd, oRow.nSeq))
+        return Corrupted();
+    for (size_t i = 0; i < oRow.asKeys.size(); ++i)
+    {
+        OGRField &sKey = oRow.asKeys[i];
+        if (!OGRGenSQLReadRaw(pabyIter, pabyEnd, sKey))
+        {
+            memset(&sKey, 0, sizeof(OGRField));
+            return Corrupted();
+        }
+        if (m_abStringKeys[i] && !OGR_RawField_IsUnset(&sKey) &&
+            !OGR_RawField_IsNull(&sKey))
+        {
+            sKey.String = nullptr;
+            if (!OGRGenSQLReadString(pabyIter, pabyEnd, &sKey.String))
+                return Corrupted();
         }
+    }
+    oRun.nFeatureOffset = static_cast<size_t>(pabyIter - oRun.abyRecord.data());
+    return true;
+}
+
+/************************************************************************/
+/*                           DecodeFeature()                            */
+/************************************************************************/
 
-        ReadIndexFields(poSrcFeat.get(), nOrderItems,
-                        asIndexFields.data() + nIndexSize * nOrderItems);
+std::unique_ptr<OGRFeature>
+OGRGenSQLSortedRows::DecodeFeature(const Run &oRun)
+{
+    const GByte *pabyIter = oRun.abyRecord.data() + oRun.nFeatureOffset;
+    const GByte *const pabyEnd = oRun.abyRecord.data() + oRun.abyRecord.size();
+
+    auto poFeature = std::make_unique<OGRFeature>(m_poLayer->m_poDefn);
+    uint32_t nFeatureSize = 0;
+    bool bOK = OGRGenSQLReadRaw(pabyIter, pabyEnd, nFeatureSize) &&
+               nFeatureSize <= static_cast<size_t>(pabyEnd - pabyIter) &&
+               poFeature->DeserializeFromBinary(pabyIter, nFeatureSize);
+    if (bOK)
+    {
+        pabyIter += nFeatureSize;
+
+        char *pszStyleString = nullptr;
+        char *pszNativeData = nullptr;
+        char *pszNativeMediaType = nullptr;
+        bOK = OGRGenSQLReadString(pabyIter, pabyEnd, &pszStyleString) &&
+              OGRGenSQLReadString(pabyIter, pabyEnd, &pszNativeData) &&
+              OGRGenSQLReadString(pabyIter, pabyEnd, &pszNativeMediaType);
+        poFeature->SetStyleString(pszStyleString);
+        poFeature->SetNativeData(pszNativeData);
+        poFeature->SetNativeMediaType(pszNativeMediaType);
+        CPLFree(pszStyleString);
+        CPLFree(pszNativeData);
+        CPLFree(pszNativeMediaType);
+    }
+    if (!bOK)
+    {
+        CPLError(CE_Failure, CPLE_FileIO,
+                 "ORDER BY: corrupted record in temporary file %s",
+                 oRun.osFilename.c_str());
+        m_bError = true;
+        return nullptr;
+    }
+    return poFeature;
+}
 
-        anFIDList.push_back(poSrcFeat->GetFID());
+/************************************************************************/
+/*                           FillMergeHeap()                            */
+/************************************************************************/
 
-        nIndexSize++;
+bool OGRGenSQLSortedRows::FillMergeHeap(std::vector<Run *> &apoHeap,
+                                        const std::vector<Run *> &apoRuns)
+{
+    apoHeap.clear();
+    for (Run *poRun : apoRuns)
+    {
+        if (!RewindRun(*poRun))
+            return false;
+        if (ReadRecord(*poRun))
+            apoHeap.push_back(poRun);
+        else if (m_bError)
+            return false;
     }
+    std::make_heap(apoHeap.begin(), apoHeap.end(),
+                   [this](const Run *poA, const Run *poB)
+                   { return Less(poB->oRow, poA->oRow); });
+    return true;
+}
 
-    // CPLDebug("GenSQL", "CreateOrderByIndex() = %zu features", nIndexSize);
+/************************************************************************/
+/*                            PopMergeHeap()                            */
+/*                                                                      */
+/*      Remove the run holding the smallest current record from the     */
+/*      heap. Once the caller is done with its record, it must call     */
+/*      ReadRecord() on it, and push it back if that succeeds.          */
+/************************************************************************/
 
-    /* -------------------------------------------------------------------- */
-    /*      Initialize m_anFIDIndex                                         */
-    /* -------------------------------------------------------------------- */
-    try
+bool OGRGenSQLSortedRows::PopMergeHeap(std::vector<Run *> &apoHeap,
+                                       Run *&poRun)
+{
+    if (apoHeap.empty())
+        return false;
+    std::pop_heap(apoHeap.begin(), apoHeap.end(),
+                  [this](const Run *poA, const Run *poB)
+                  { return Less(poB->oRow, poA->oRow); });
+    poRun = apoHeap.back();
+    apoHeap.pop_back();
+    return true;
+}
+
+/************************************************************************/
+/*                             MergeRuns()                              */
+/*                                                                      */
+/*      Merge all runs of a level into a single run of the next one.    */
+/************************************************************************/
+
+bool OGRGenSQLSortedRows::MergeRuns(int nLevel)
+{
+    std::vector<Run *> apoRuns;
+    for (const auto &poRun : m_apoRuns)
     {
-        m_anFIDIndex.reserve(nIndexSize);
+        if (poRun->nLevel == nLevel)
+            apoRuns.push_back(poRun.get());
     }
-    catch (const std::bad_alloc &)
+
+    auto poMergedRun = CreateRun(nLevel + 1);
+    if (!poMergedRun)
+        return false;
+
+    std::vector<Run *> apoHeap;
+    if (!FillMergeHeap(apoHeap, apoRuns))
+        return false;
+    const auto oGreater = [this](const Run *poA, const Run *poB)
+    { return Less(poB->oRow, poA->oRow); };
+    Run *poRun = nullptr;
+    while (PopMergeHeap(apoHeap, poRun))
     {
-        CPLError(CE_Failure, CPLE_OutOfMemory,
-                 "CreateOrderByIndex(): out of memory");
-        return;
+        if (!WriteRecord(*poMergedRun, poRun->abyRecord))
+            return false;
+        if (ReadRecord(*poRun))
+        {
+            apoHeap.push_back(poRun);
+            std::push_heap(apoHeap.begin(), apoHeap.end(), oGreater);
+        }
+        else if (m_bError)
+            return false;
     }
-    for (size_t i = 0; i < nIndexSize; i++)
-        m_anFIDIndex.push_back(static_cast<GIntBig>(i));
 
-    /* -------------------------------------------------------------------- */
-    /*      Quick sort the records.                                         */
-    /* -------------------------------------------------------------------- */
+    m_apoRuns.erase(std::remove_if(m_apoRuns.begin(), m_apoRuns.end(),
+                                   [nLevel](const std::unique_ptr<Run> &poIter)
+                                   { return poIter->nLevel == nLevel; }),
+                    m_apoRuns.end());
+    m_apoRuns.push_back(std::move(poMergedRun));
+    return true;
+}
 
-    GIntBig *panMerged = static_cast<GIntBig *>(
-        VSI_MALLOC_VERBOSE(sizeof(GIntBig) * nIndexSize));
-    if (panMerged == nullptr)
+/************************************************************************/
+/*                               Finish()                               */
+/************************************************************************/
+
+bool OGRGenSQLSortedRows::Finish()
+{
+    const auto oLess = [this](const OGRGenSQLSortRow &oA,
+                              const OGRGenSQLSortRow &oB)
+    { return Less(oA, oB); };
+
+    if (m_apoRuns.empty())
     {
-        m_anFIDIndex.clear();
-        return;
+        if (m_bTopK)
+            std::sort_heap(m_aoRows.begin(), m_aoRows.end(), oLess);
+        else
+            std::sort(m_aoRows.begin(), m_aoRows.end(), oLess);
+        return true;
     }
 
-    // Note: this merge sort is slightly faster than std::sort()
-    SortIndexSection(asIndexFields.data(), panMerged, 0, nIndexSize);
-    VSIFree(panMerged);
+    if (!m_aoRows.empty() && !SpillRows())
+        return false;
 
-    /* -------------------------------------------------------------------- */
-    /*      Rework the FID map to map to real FIDs.                         */
-    /* -------------------------------------------------------------------- */
-    bool bAlreadySorted = true;
-    for (size_t i = 0; i < nIndexSize; i++)
+    CPLDebug("GenSQL", "ORDER BY: merging %d runs",
+             static_cast<int>(m_apoRuns.size()));
+    std::vector<Run *> apoRuns;
+    for (const auto &poRun : m_apoRuns)
+        apoRuns.push_back(poRun.get());
+    m_nMergeIndex = 0;
+    return FillMergeHeap(m_apoMergeHeap, apoRuns);
+}
+
+/************************************************************************/
+/*                               GetRow()                               */
+/*                                                                      */
+/*      Return the row of index nIndex in the sorted result. Reading    */
+/*      spilled rows is efficient when done in increasing order.        */
+/************************************************************************/
+
+std::unique_ptr<OGRFeature> OGRGenSQLSortedRows::GetRow(GIntBig nIndex)
+{
+    if (m_bError || nIndex < 0)
+        return nullptr;
+
+    if (m_apoRuns.empty())
     {
-        if (m_anFIDIndex[i] != static_cast<GIntBig>(i))
-            bAlreadySorted = false;
-        m_anFIDIndex[i] = anFIDList[static_cast<size_t>(m_anFIDIndex[i])];
+        if (nIndex >= static_cast<GIntBig>(m_aoRows.size()))
+            return nullptr;
+        return std::unique_ptr<OGRFeature>(
+            m_aoRows[static_cast<size_t>(nIndex)].poFeature->Clone());
     }
 
-    /* If it is already sorted, then free than m_anFIDIndex array */
-    /* so that GetNextFeature() can call a sequential GetNextFeature() */
-    /* on the source array. Very useful for layers where random access */
-    /* is slow. */
-    /* Use case: the GML result of a WFS GetFeature with a SORTBY */
-    if (bAlreadySorted)
+    if (nIndex < m_nMergeIndex)
     {
-        m_anFIDIndex.clear();
+        std::vector<Run *> apoRuns;
+        for (const auto &poRun : m_apoRuns)
+            apoRuns.push_back(poRun.get());
+        m_nMergeIndex = 0;
+        if (!FillMergeHeap(m_apoMergeHeap, apoRuns))
+            return nullptr;
     }
 
-    ResetReading();
+    const auto oGreater = [this](const Run *poA, const Run *poB)
+    { return Less(poB->oRow, poA->oRow); };
+    Run *poRun = nullptr;
+    while (PopMergeHeap(m_apoMergeHeap, poRun))
+    {
+        std::unique_ptr<OGRFeature> poFeature;
+        if (m_nMergeIndex == nIndex)
+        {
+            poFeature = DecodeFeature(*poRun);
+            if (!poFeature)
+                return nullptr;
+        }
+        m_nMergeIndex++;
+        if (ReadRecord(*poRun))
+        {
+            m_apoMergeHeap.push_back(poRun);
+            std::push_heap(m_apoMergeHeap.begin(), m_apoMergeHeap.end(),
+                           oGreater);
+        }
+        else if (m_bError)
+            return nullptr;
+        if (poFeature)
+            return poFeature;
+    }
+    return nullptr;
 }
 
 /************************************************************************/
-/*                          SortIndexSection()                          */
+/*                         CreateOrderByIndex()                         */
+/*                                                                      */
+/*      This method is responsible for producing the rows of the        */
+/*      result in the order requested by the ORDER BY clauses.          */
 /*                                                                      */
-/*      Sort the records in a section of the index.                     */
+/*      This is accomplished by making one sequential pass through      */
+/*      the eligible source features, translating them and handing      */
+/*      them to a OGRGenSQLSortedRows, which sorts them in memory,      */
+/*      or spills sorted runs into temporary files and merges them      */
+/*      when they do not fit within OGR_SQL_ORDER_BY_MAX_MEMORY.        */
+/*      With a LIMIT, only the first OFFSET + LIMIT rows are kept.      */
 /************************************************************************/
 
-void OGRGenSQLResultsLayer::SortIndexSection(const OGRField *pasIndexFields,
-                                             GIntBig *panMerged, size_t nStart,
-                                             size_t nEntries)
+void OGRGenSQLResultsLayer::CreateOrderByIndex()
 
 {
-    if (nEntries < 2)
-        return;
-
     swq_select *psSelectInfo = m_pSelectInfo.get();
     const int nOrderItems = psSelectInfo->order_specs;
 
-    size_t nFirstGroup = nEntries / 2;
-    size_t nFirstStart = nStart;
-    size_t nSecondGroup = nEntries - nFirstGroup;
-    size_t nSecondStart = nStart + nFirstGroup;
+    if (!(nOrderItems > 0 && psSelectInfo->query_mode == SWQM_RECORDSET))
+        return;
+
+    if (m_bOrderByValid)
+        return;
+
+    m_bOrderByValid = true;
+    m_poSortedRows.reset();
 
-    SortIndexSection(pasIndexFields, panMerged, nFirstStart, nFirstGroup);
-    SortIndexSection(pasIndexFields, panMerged, nSecondStart, nSecondGroup);
+    ResetReading();
 
-    for (size_t iMerge = 0; iMerge < nEntries; ++iMerge)
+    GIntBig nMaxRows = -1;
+    if (psSelectInfo->limit >= 0 &&
+        psSelectInfo->offset <=
+            std::numeric_limits<GIntBig>::max() - psSelectInfo->limit)
     {
-        int nResult = 0;
+        nMaxRows = psSelectInfo->offset + psSelectInfo->limit;
+    }
 
-        if (nFirstGroup == 0)
-            nResult = 1;
-        else if (nSecondGroup == 0)
-            nResult = -1;
-        else
-            nResult = Compare(
-                pasIndexFields + m_anFIDIndex[nFirstStart] * nOrderItems,
-                pasIndexFields + m_anFIDIndex[nSecondStart] * nOrderItems);
+    auto poSortedRows = std::make_unique<OGRGenSQLSortedRows>(
+        this, OGRGenSQLGetMaxMemory("OGR_SQL_ORDER_BY_MAX_MEMORY"), nMaxRows);
 
-        if (nResult > 0)
-        {
-            panMerged[iMerge] = m_anFIDIndex[nSecondStart];
-            nSecondStart++;
-            nSecondGroup--;
-        }
-        else
+    /* -------------------------------------------------------------------- */
+    /*      Read, filter and translate the source features.                 */
+    /* -------------------------------------------------------------------- */
+    const int bEvaluateSpatialFilter = MustEvaluateSpatialFilterOnGenSQL();
+    bool bOK = true;
+    GIntBig nSeq = 0;
+    while (bOK)
+    {
+        std::unique_ptr<OGRFeature> poSrcFeat(m_poSrcLayer->GetNextFeature());
+        if (poSrcFeat == nullptr)
+            break;
+
+        OGRGenSQLSortRow oRow = poSortedRows->NewRow();
+        ReadIndexFields(poSrcFeat.get(), nOrderItems, oRow.asKeys.data());
+        oRow.nSeq = nSeq++;
+        if (!poSortedRows->IsCandidate(oRow))
+            continue;
+
+        oRow.poFeature = TranslateFeature(std::move(poSrcFeat));
+        if (oRow.poFeature == nullptr)
+            break;
+
+        if ((m_poAttrQuery == nullptr ||
+             m_poAttrQuery->Evaluate(oRow.poFeature.get())) &&
+            (!bEvaluateSpatialFilter ||
+             FilterGeometry(
+                 oRow.poFeature->GetGeomFieldRef(m_iGeomFieldFilter))))
         {
-            panMerged[iMerge] = m_anFIDIndex[nFirstStart];
-            nFirstStart++;
-            nFirstGroup--;
+            bOK = poSortedRows->AddRow(std::move(oRow));
         }
     }
 
-    /* Copy the merge list back into the main index */
-    memcpy(m_anFIDIndex.data() + nStart, panMerged, sizeof(GIntBig) * nEntries);
+    if (bOK)
+        bOK = poSortedRows->Finish();
+    if (!bOK)
+    {
+        // Return no rows rather than unsorted ones
+        poSortedRows = std::make_unique<OGRGenSQLSortedRows>(this, 0, 0);
+        poSortedRows->Finish();
+    }
+    m_poSortedRows = std::move(poSortedRows);
+
+    ResetReading();
 }
 
 /************************************************************************/
@@ -2685,6 +4082,13 @@ void OGRGenSQLResultsLayer::FindAndSetIgnoredFields()
                           hSet);
     }
 
+    for (int iGroup = 0; iGroup < psSelectInfo->group_by_count; iGroup++)
+    {
+        swq_group_def *psGroupDef = psSelectInfo->group_by_defs + iGroup;
+        AddFieldDefnToSet(psGroupDef->table_index, psGroupDef->field_index,
+                          hSet);
+    }
+
     /* -------------------------------------------------------------------- */
     /*      2nd phase : now, we can exclude the unused fields               */
     /* -------------------------------------------------------------------- */
@@ -2733,7 +4137,7 @@ void OGRGenSQLResultsLayer::FindAndSetIgnoredFields()
 
 void OGRGenSQLResultsLayer::InvalidateOrderByIndex()
 {
-    m_anFIDIndex.clear();
+    m_poSortedRows.reset();
     m_bOrderByValid = false;
 }
 
@@ -39,6 +39,8 @@
 /************************************************************************/
 
 class swq_select;
+class OGRGenSQLSortedRows;
+class OGRGenSQLHashJoin;
 
 class OGRGenSQLResultsLayer final : public OGRLayer
 {
@@ -62,26 +64,38 @@ class OGRGenSQLResultsLayer final : public OGRLayer
 
     std::vector<int> m_anGeomFieldToSrcGeomField{};
 
-    std::vector<GIntBig> m_anFIDIndex{};
+    // Rows of a ORDER BY result, sorted in memory or merged from temp files
+    std::unique_ptr<OGRGenSQLSortedRows> m_poSortedRows{};
     bool m_bOrderByValid = false;
 
     GIntBig m_nNextIndexFID = 0;
     mutable std::unique_ptr<OGRFeature> m_poSummaryFeature{};
 
+    // Result rows of a GROUP BY query, in output order
+    mutable std::vector<std::unique_ptr<OGRFeature>> m_apoGroupFeatures{};
+
+    // Hash tables over the joined layers, or null for the joins resolved
+    // with one attribute filter per source feature
+    std::vector<std::unique_ptr<OGRGenSQLHashJoin>> m_apoHashJoins{};
+    bool m_bHashJoinsInitialized = false;
+
     int m_iFIDFieldIndex = 0;
 
     GIntBig m_nIteratedFeatures = -1;
     std::vector<std::string> m_aosDistinctList{};
 
     bool PrepareSummary() const;
+    bool PrepareGroupedSummary() const;
+    const char *SummarizeFeature(OGRFeature *poSrcFeature) const;
+    void SetSummaryValues(OGRFeature *poDstFeature) const;
+
+    void InitializeHashJoins();
 
     std::unique_ptr<OGRFeature> TranslateFeature(std::unique_ptr<OGRFeature>);
     void CreateOrderByIndex();
     void ReadIndexFields(OGRFeature *poSrcFeat, int nOrderItems,
                          OGRField *pasIndexFields);
-    void SortIndexSection(const OGRField *pasIndexFields, GIntBig *panMerged,
-                          size_t nStart, size_t nEntries);
-    void FreeIndexFields(OGRField *pasIndexFields, size_t l_nIndexSize);
+    std::vector<bool> GetStringIndexFields() const;
     int Compare(const OGRField *pasFirst, const OGRField *pasSecond);
 
     void ClearFilters();
@@ -134,6 +148,7 @@ class OGRGenSQLResultsLayer final : public OGRLayer
 
   protected:
     friend struct OGRGenSQLResultsLayerArrowStreamPrivateData;
+    friend class OGRGenSQLSortedRows;
 
     int GetArrowSchemaForwarded(struct ArrowArrayStream *stream,
                                 struct ArrowSchema *out_schema) const;
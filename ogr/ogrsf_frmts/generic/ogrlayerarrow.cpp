@@ -5029,6 +5029,1209 @@ static bool SetFieldForOtherFormats(OGRFeature &oFeature,
     return true;
 }
 
+/************************************************************************/
+/*                         OGRArrowFilterString                         */
+/************************************************************************/
+
+namespace
+{
+
+/** String value of an Arrow array, not nul-terminated. */
+struct OGRArrowFilterString
+{
+    const char *pszValue = nullptr;
+    size_t nLength = 0;
+};
+
+inline int OGRArrowFilterToLower(unsigned char ch)
+{
+    return (ch >= 'A' && ch <= 'Z') ? ch - 'A' + 'a' : ch;
+}
+
+/** Same as strncasecmp(), on strings that are not nul-terminated. */
+int OGRArrowFilterCompareNoCase(
+    const OGRArrowFilterString &a, const OGRArrowFilterString &b,
+    size_t nMax = std::numeric_limits<size_t>::max())
+{
+    const size_t nLength = std::min(std::min(a.nLength, b.nLength), nMax);
+    for (size_t i = 0; i < nLength; ++i)
+    {
+        const int chA =
+            OGRArrowFilterToLower(static_cast<unsigned char>(a.pszValue[i]));
+        const int chB =
+            OGRArrowFilterToLower(static_cast<unsigned char>(b.pszValue[i]));
+        if (chA != chB)
+            return chA - chB;
+    }
+    if (nLength == nMax || a.nLength == b.nLength)
+        return 0;
+    return a.nLength < b.nLength ? -1 : 1;
+}
+
+// The comparison operators of OGR SQL ignore the case of strings.
+
+inline bool operator==(const OGRArrowFilterString &a,
+                       const OGRArrowFilterString &b)
+{
+    return a.nLength == b.nLength && OGRArrowFilterCompareNoCase(a, b) == 0;
+}
+
+inline bool operator!=(const OGRArrowFilterString &a,
+                       const OGRArrowFilterString &b)
+{
+    return !(a == b);
+}
+
+inline bool operator<(const OGRArrowFilterString &a,
+                      const OGRArrowFilterString &b)
+{
+    return OGRArrowFilterCompareNoCase(a, b) < 0;
+}
+
+inline bool operator<=(const OGRArrowFilterString &a,
+                       const OGRArrowFilterString &b)
+{
+    return OGRArrowFilterCompareNoCase(a, b) <= 0;
+}
+
+inline bool operator>(const OGRArrowFilterString &a,
+                      const OGRArrowFilterString &b)
+{
+    return OGRArrowFilterCompareNoCase(a, b) > 0;
+}
+
+inline bool operator>=(const OGRArrowFilterString &a,
+                       const OGRArrowFilterString &b)
+{
+    return OGRArrowFilterCompareNoCase(a, b) >= 0;
+}
+
+/** The = operator of OGR SQL on strings also ignores a "+00" time zone
+ * suffix on one side when the other side has none. */
+bool OGRArrowFilterEqualStrings(const OGRArrowFilterString &a,
+                                const OGRArrowFilterString &b)
+{
+    if (a.nLength > 3 && b.nLength > 3)
+    {
+        if (memcmp(a.pszValue + a.nLength - 3, "+00", 3) == 0 &&
+            b.pszValue[b.nLength - 3] == ':')
+        {
+            return OGRArrowFilterCompareNoCase(a, b, b.nLength) == 0;
+        }
+        if (a.pszValue[a.nLength - 3] == ':' &&
+            memcmp(b.pszValue + b.nLength - 3, "+00", 3) == 0)
+        {
+            return OGRArrowFilterCompareNoCase(a, b, a.nLength) == 0;
+        }
+    }
+    return a == b;
+}
+
+/************************************************************************/
+/*                       OGRArrowFilterEvaluator                        */
+/************************************************************************/
+
+/** Column-at-a-time evaluation of an attribute filter over an Arrow array.
+ *
+ * Compile() turns the comparisons (=, <>, <, <=, >, >=, BETWEEN, IN), LIKE,
+ * ILIKE, IS NULL and boolean operators of the swq expression into kernels
+ * that each process a whole column, instead of building an OGRFeature and
+ * walking the expression tree for every row. The results are the ones of
+ * swq_expr_node::Evaluate(), including the propagation of NULL. Expressions
+ * with other operators, or columns whose Arrow format cannot be read
+ * directly, are rejected by Compile() and must be evaluated row by row.
+ */
+class OGRArrowFilterEvaluator
+{
+  public:
+    OGRArrowFilterEvaluator(
+        const OGRFeatureDefn *poDefn, const struct ArrowSchema *schema,
+        const struct ArrowArray *array,
+        const std::map<std::string, std::vector<int>> &oMapFieldNameToArrowPath,
+        GIntBig nBaseSeqFID, const std::vector<int> &anArrowPathToFIDColumn,
+        bool bUTF8Strings);
+
+    bool Compile(const swq_expr_node *poExpr);
+
+    size_t Evaluate(std::vector<bool> &abyValidityFromFilters);
+
+  private:
+    enum class Domain
+    {
+        INTEGER,
+        REAL,
+        STRING,
+    };
+
+    enum class KernelType
+    {
+        LOGICAL,     // AND, OR, NOT
+        TRUTH,       // integer column or constant used as a boolean
+        COMPARISON,  // =, <>, <, <=, >, >=
+        BETWEEN,
+        IN,
+        LIKE,
+        IS_NULL,
+    };
+
+    struct Column
+    {
+        // From the child of the top-level array down to the leaf array
+        std::vector<const struct ArrowArray *> apsArrays{};
+        const char *pszFormat = nullptr;
+        bool bIsFID = false;
+        bool bClampFIDToInt = false;
+
+        bool bNullsLoaded = false;
+        std::vector<uint8_t> abyNull{};
+        bool bIntegersLoaded = false;
+        std::vector<int64_t> anValues{};
+        bool bRealsLoaded = false;
+        std::vector<double> adfValues{};
+        bool bStringsLoaded = false;
+        std::vector<OGRArrowFilterString> asValues{};
+    };
+
+    struct Operand
+    {
+        int iColumn = -1;
+        const swq_expr_node *poConstant = nullptr;
+        swq_field_type eType = SWQ_OTHER;
+    };
+
+    struct Kernel
+    {
+        KernelType eType = KernelType::LOGICAL;
+        swq_op eOp = SWQ_AND;
+        Domain eDomain = Domain::INTEGER;
+        std::vector<Operand> aoOperands{};
+        std::vector<std::unique_ptr<Kernel>> apoChildren{};
+        std::string osPattern{};
+        char chEscape = '\0';
+        bool bInsensitive = false;
+    };
+
+    /** Boolean column, with the int_value and is_null members of the
+     * swq_expr_node the row by row evaluation would return. */
+    struct Result
+    {
+        std::vector<uint8_t> abyValue{};
+        std::vector<uint8_t> abyNull{};
+    };
+
+    /** Values of an operand: a column or a constant. */
+    template <class T> struct Values
+    {
+        const T *paValues = nullptr;
+        T value{};
+        const uint8_t *pabyNull = nullptr;
+        bool bNull = false;
+
+        inline const T &Get(size_t i) const
+        {
+            return paValues ? paValues[i] : value;
+        }
+
+        inline bool IsNull(size_t i) const
+        {
+            return pabyNull ? pabyNull[i] != 0 : bNull;
+        }
+    };
+
+    const OGRFeatureDefn *m_poDefn;
+    const struct ArrowSchema *m_psSchema;
+    const struct ArrowArray *m_psArray;
+    const std::map<std::string, std::vector<int>> &m_oMapFieldNameToArrowPath;
+    const GIntBig m_nBaseSeqFID;
+    const std::vector<int> &m_anArrowPathToFIDColumn;
+    const bool m_bUTF8Strings;
+    const size_t m_nLength;
+
+    std::vector<Column> m_aoColumns{};
+    std::map<int, int> m_oMapFieldIndexToColumn{};
+    std::unique_ptr<Kernel> m_poRoot{};
+
+    std::unique_ptr<Kernel> CompileLogical(const swq_expr_node *poNode);
+    std::unique_ptr<Kernel> CompileOperation(const swq_expr_node *poNode);
+    bool CompileOperand(const swq_expr_node *poNode, Operand &sOperand);
+    bool CanLoad(const Operand &sOperand, Domain eDomain) const;
+
+    const uint8_t *LoadNulls(Column &oColumn);
+    void LoadIntegers(Column &oColumn);
+    void LoadReals(Column &oColumn);
+    void LoadStrings(Column &oColumn);
+
+    Values<int64_t> GetIntegers(const Operand &sOperand);
+    Values<double> GetReals(const Operand &sOperand);
+    Values<OGRArrowFilterString> GetStrings(const Operand &sOperand);
+
+    void Evaluate(const Kernel &oKernel, Result &oResult);
+    template <class T>
+    void EvaluateComparison(const Kernel &oKernel,
+                            const std::vector<Values<T>> &aoValues,
+                            Result &oResult);
+    void EvaluateLike(const Kernel &oKernel, Result &oResult);
+
+    CPL_DISALLOW_COPY_ASSIGN(OGRArrowFilterEvaluator)
+};
+
+/************************************************************************/
+/*                      OGRArrowFilterEvaluator()                       */
+/************************************************************************/
+
+OGRArrowFilterEvaluator::OGRArrowFilterEvaluator(
+    const OGRFeatureDefn *poDefn, const struct ArrowSchema *schema,
+    const struct ArrowArray *array,
+    const std::map<std::string, std::vector<int>> &oMapFieldNameToArrowPath,
+    GIntBig nBaseSeqFID, const std::vector<int> &anArrowPathToFIDColumn,
+    bool bUTF8Strings)
+    : m_poDefn(poDefn), m_psSchema(schema), m_psArray(array),
+      m_oMapFieldNameToArrowPath(oMapFieldNameToArrowPath),
+      m_nBaseSeqFID(nBaseSeqFID),
+      m_anArrowPathToFIDColumn(anArrowPathToFIDColumn),
+      m_bUTF8Strings(bUTF8Strings),
+      m_nLength(static_cast<size_t>(array->length))
+{
+}
+
+/************************************************************************/
+/*                              Compile()                               */
+/************************************************************************/
+
+bool OGRArrowFilterEvaluator::Compile(const swq_expr_node *poExpr)
+{
+    m_poRoot = CompileLogical(poExpr);
+    return m_poRoot != nullptr;
+}
+
+/************************************************************************/
+/*                           CompileLogical()                           */
+/*                                                                      */
+/*      Compile a node whose value is used as a boolean.                */
+/************************************************************************/
+
+std::unique_ptr<OGRArrowFilterEvaluator::Kernel>
+OGRArrowFilterEvaluator::CompileLogical(const swq_expr_node *poNode)
+{
+    if (poNode->eNodeType == SNT_OPERATION)
+        return CompileOperation(poNode);
+
+    // Only integer values have a truth value.
+    auto poKernel = std::make_unique<Kernel>();
+    poKernel->eType = KernelType::TRUTH;
+    Operand sOperand;
+    if (!CompileOperand(poNode, sOperand) ||
+        !CanLoad(sOperand, Domain::INTEGER))
+    {
+        return nullptr;
+    }
+    poKernel->aoOperands.push_back(sOperand);
+    return poKernel;
+}
+
+/************************************************************************/
+/*                          CompileOperation()                          */
+/************************************************************************/
+
+std::unique_ptr<OGRArrowFilterEvaluator::Kernel>
+OGRArrowFilterEvaluator::CompileOperation(const swq_expr_node *poNode)
+{
+    auto poKernel = std::make_unique<Kernel>();
+    poKernel->eOp = static_cast<swq_op>(poNode->nOperation);
+    const int nSubExprCount = poNode->nSubExprCount;
+
+    switch (poNode->nOperation)
+    {
+        case SWQ_AND:
+        case SWQ_OR:
+        case SWQ_NOT:
+        {
+            if (nSubExprCount != (poNode->nOperation == SWQ_NOT ? 1 : 2))
+                return nullptr;
+            poKernel->eType = KernelType::LOGICAL;
+            for (int i = 0; i < nSubExprCount; ++i)
+            {
+                auto poChild = CompileLogical(poNode->papoSubExpr[i]);
+                if (!poChild)
+                    return nullptr;
+                poKernel->apoChildren.push_back(std::move(poChild));
+            }
+            return poKernel;
+        }
+
+        case SWQ_ISNULL:
+        {
+            if (nSubExprCount != 1)
+                return nullptr;
+            poKernel->eType = KernelType::IS_NULL;
+            const swq_expr_node *poSubExpr = poNode->papoSubExpr[0];
+            if (poSubExpr->eNodeType == SNT_OPERATION)
+            {
+                auto poChild = CompileOperation(poSubExpr);
+                if (!poChild)
+                    return nullptr;
+                poKernel->apoChildren.push_back(std::move(poChild));
+            }
+            else
+            {
+                Operand sOperand;
+                if (!CompileOperand(poSubExpr, sOperand))
+                    return nullptr;
+                poKernel->aoOperands.push_back(sOperand);
+            }
+            return poKernel;
+        }
+
+        case SWQ_LIKE:
+        case SWQ_ILIKE:
+        {
+            if (nSubExprCount < 2 || nSubExprCount > 3)
+                return nullptr;
+            poKernel->eType = KernelType::LIKE;
+            poKernel->eDomain = Domain::STRING;
+            Operand sOperand;
+            if (!CompileOperand(poNode->papoSubExpr[0], sOperand) ||
+                !CanLoad(sOperand, Domain::STRING))
+            {
+                return nullptr;
+            }
+            poKernel->aoOperands.push_back(sOperand);
+            for (int i = 1; i < nSubExprCount; ++i)
+            {
+                const swq_expr_node *poSubExpr = poNode->papoSubExpr[i];
+                if (poSubExpr->eNodeType != SNT_CONSTANT ||
+                    poSubExpr->field_type != SWQ_STRING ||
+                    poSubExpr->is_null || !poSubExpr->string_value)
+                {
+                    return nullptr;
+                }
+            }
+            poKernel->osPattern = poNode->papoSubExpr[1]->string_value;
+            if (nSubExprCount == 3)
+                poKernel->chEscape = poNode->papoSubExpr[2]->string_value[0];
+            poKernel->bInsensitive =
+                poNode->nOperation == SWQ_ILIKE ||
+                CPLTestBool(
+                    CPLGetConfigOption("OGR_SQL_LIKE_AS_ILIKE", "FALSE"));
+            return poKernel;
+        }
+
+        case SWQ_EQ:
+        case SWQ_NE:
+        case SWQ_LT:
+        case SWQ_LE:
+        case SWQ_GT:
+        case SWQ_GE:
+        case SWQ_BETWEEN:
+        case SWQ_IN:
+        {
+            if (poNode->nOperation == SWQ_IN)
+            {
+                if (nSubExprCount < 2)
+                    return nullptr;
+                poKernel->eType = KernelType::IN;
+            }
+            else if (poNode->nOperation == SWQ_BETWEEN)
+            {
+                if (nSubExprCount != 3)
+                    return nullptr;
+                poKernel->eType = KernelType::BETWEEN;
+            }
+            else
+            {
+                if (nSubExprCount != 2)
+                    return nullptr;
+                poKernel->eType = KernelType::COMPARISON;
+            }
+
+            for (int i = 0; i < nSubExprCount; ++i)
+            {
+                Operand sOperand;
+                if (!CompileOperand(poNode->papoSubExpr[i], sOperand))
+                    return nullptr;
+                poKernel->aoOperands.push_back(sOperand);
+            }
+
+            // Same choice of the comparison type as SWQGeneralEvaluator()
+            const swq_field_type eType0 = poKernel->aoOperands[0].eType;
+            const swq_field_type eType1 = poKernel->aoOperands[1].eType;
+            if (eType0 == SWQ_FLOAT || eType1 == SWQ_FLOAT)
+                poKernel->eDomain = Domain::REAL;
+            else if (SWQ_IS_INTEGER(eType0) || eType0 == SWQ_BOOLEAN)
+                poKernel->eDomain = Domain::INTEGER;
+            else if (eType0 == SWQ_STRING)
+                poKernel->eDomain = Domain::STRING;
+            else
+                return nullptr;
+
+            for (int i = 0; i < nSubExprCount; ++i)
+            {
+                const Operand &sOperand = poKernel->aoOperands[i];
+                if (sOperand.poConstant && sOperand.poConstant->is_null)
+                    continue;
+                // SWQGeneralEvaluator() only converts the first two values
+                // of a real comparison from integers.
+                if (poKernel->eDomain == Domain::REAL && i >= 2 &&
+                    sOperand.eType != SWQ_FLOAT)
+                {
+                    return nullptr;
+                }
+                if (!CanLoad(sOperand, poKernel->eDomain))
+                    return nullptr;
+            }
+            return poKernel;
+        }
+
+        default:
+            break;
+    }
+    return nullptr;
+}
+
+/************************************************************************/
+/*                           CompileOperand()                           */
+/************************************************************************/
+
+bool OGRArrowFilterEvaluator::CompileOperand(const swq_expr_node *poNode,
+                                             Operand &sOperand)
+{
+    sOperand.eType = poNode->field_type;
+    if (poNode->eNodeType == SNT_CONSTANT)
+    {
+        sOperand.poConstant = poNode;
+        return true;
+    }
+    if (poNode->eNodeType != SNT_COLUMN || poNode->table_index != 0)
+        return false;
+
+    const auto oIter = m_oMapFieldIndexToColumn.find(poNode->field_index);
+    if (oIter != m_oMapFieldIndexToColumn.end())
+    {
+        sOperand.iColumn = oIter->second;
+        return true;
+    }
+
+    const int nFieldCount = m_poDefn->GetFieldCount();
+    Column oColumn;
+    std::vector<int> anArrowPath;
+    if (poNode->field_index >= 0 && poNode->field_index < nFieldCount)
+    {
+        const auto oIterPath = m_oMapFieldNameToArrowPath.find(
+            m_poDefn->GetFieldDefn(poNode->field_index)->GetNameRef());
+        if (oIterPath == m_oMapFieldNameToArrowPath.end())
+            return false;
+        anArrowPath = oIterPath->second;
+    }
+    else if (poNode->field_index == nFieldCount + SPF_FID ||
+             poNode->field_index == nFieldCount + SPECIAL_FIELD_COUNT +
+                                        m_poDefn->GetGeomFieldCount())
+    {
+        oColumn.bIsFID = true;
+        oColumn.bClampFIDToInt = poNode->field_type == SWQ_INTEGER;
+        if (m_nBaseSeqFID < 0)
+        {
+            // The row by row evaluation does not skip a FID whose parent
+            // is null, so only handle a top-level FID column.
+            if (m_anArrowPathToFIDColumn.size() != 1)
+                return false;
+            anArrowPath = m_anArrowPathToFIDColumn;
+        }
+    }
+    else
+    {
+        return false;
+    }
+
+    const struct ArrowSchema *psSchema = m_psSchema;
+    const struct ArrowArray *psArray = m_psArray;
+    for (const int iChild : anArrowPath)
+    {
+        psSchema = psSchema->children[iChild];
+        psArray = psArray->children[iChild];
+        oColumn.apsArrays.push_back(psArray);
+    }
+    if (!anArrowPath.empty())
+    {
+        oColumn.pszFormat = psSchema->format;
+        if (oColumn.bIsFID && !IsInt32(oColumn.pszFormat) &&
+            !IsInt64(oColumn.pszFormat))
+        {
+            return false;
+        }
+    }
+
+    sOperand.iColumn = static_cast<int>(m_aoColumns.size());
+    m_oMapFieldIndexToColumn[poNode->field_index] = sOperand.iColumn;
+    m_aoColumns.push_back(std::move(oColumn));
+    return true;
+}
+
+/************************************************************************/
+/*                              CanLoad()                               */
+/*                                                                      */
+/*      Whether an operand can be read as values of the domain, with    */
+/*      the same conversions as OGRFeatureFetcher().                    */
+/************************************************************************/
+
+bool OGRArrowFilterEvaluator::CanLoad(const Operand &sOperand,
+                                      Domain eDomain) const
+{
+    const swq_field_type eType = sOperand.eType;
+    switch (eDomain)
+    {
+        case Domain::INTEGER:
+            if (!SWQ_IS_INTEGER(eType) && eType != SWQ_BOOLEAN)
+                return false;
+            break;
+        case Domain::REAL:
+            if (!SWQ_IS_INTEGER(eType) && eType != SWQ_BOOLEAN &&
+                eType != SWQ_FLOAT)
+                return false;
+            break;
+        case Domain::STRING:
+            if (eType != SWQ_STRING)
+                return false;
+            break;
+    }
+    if (sOperand.poConstant)
+    {
+        // A boolean constant is not converted to a real by
+        // SWQGeneralEvaluator(), unlike a boolean column value.
+        if (eDomain == Domain::REAL && eType == SWQ_BOOLEAN)
+            return false;
+        return eDomain != Domain::STRING ||
+               sOperand.poConstant->string_value != nullptr;
+    }
+
+    const Column &oColumn = m_aoColumns[sOperand.iColumn];
+    if (oColumn.bIsFID)
+        return eDomain != Domain::STRING;
+
+    const char *format = oColumn.pszFormat;
+    const bool bIsInteger = IsBoolean(format) || IsInt8(format) ||
+                            IsUInt8(format) || IsInt16(format) ||
+                            IsUInt16(format) || IsInt32(format) ||
+                            IsUInt32(format) || IsInt64(format);
+    switch (eDomain)
+    {
+        case Domain::INTEGER:
+            return bIsInteger;
+        case Domain::REAL:
+            return bIsInteger || IsUInt64(format) || IsFloat32(format) ||
+                   IsFloat64(format);
+        case Domain::STRING:
+            return IsString(format) || IsLargeString(format);
+    }
+    return false;
+}
+
+/************************************************************************/
+/*                             LoadNulls()                              */
+/*                                                                      */
+/*      A value is null when it, or any of its parent structures, is.   */
+/************************************************************************/
+
+const uint8_t *OGRArrowFilterEvaluator::LoadNulls(Column &oColumn)
+{
+    if (oColumn.bNullsLoaded)
+        return oColumn.abyNull.empty() ? nullptr : oColumn.abyNull.data();
+    oColumn.bNullsLoaded = true;
+
+    if (oColumn.bIsFID)
+    {
+        // The FID is null when it is OGRNullFID
+        if (m_nBaseSeqFID >= 0)
+            return nullptr;
+        LoadIntegers(oColumn);
+        oColumn.abyNull.resize(m_nLength);
+        for (size_t i = 0; i < m_nLength; ++i)
+            oColumn.abyNull[i] = oColumn.anValues[i] == OGRNullFID;
+        return oColumn.abyNull.data();
+    }
+
+    for (const struct ArrowArray *psArray : oColumn.apsArrays)
+    {
+        if (psArray->null_count == 0 || psArray->buffers[0] == nullptr)
+            continue;
+        if (oColumn.abyNull.empty())
+            oColumn.abyNull.resize(m_nLength);
+        const uint8_t *pabyValidity =
+            static_cast<const uint8_t *>(psArray->buffers[0]);
+        const size_t nOffset = static_cast<size_t>(psArray->offset);
+        for (size_t i = 0; i < m_nLength; ++i)
+        {
+            if (!TestBit(pabyValidity, i + nOffset))
+                oColumn.abyNull[i] = 1;
+        }
+    }
+    return oColumn.abyNull.empty() ? nullptr : oColumn.abyNull.data();
+}
+
+/************************************************************************/
+/*                         OGRArrowFilterCopy()                         */
+/************************************************************************/
+
+template <class TIn, class TOut>
+static void OGRArrowFilterCopy(const struct ArrowArray *psArray,
+                               size_t nLength, std::vector<TOut> &aValues)
+{
+    const TIn *paIn = static_cast<const TIn *>(psArray->buffers[1]) +
+                      static_cast<size_t>(psArray->offset);
+    aValues.resize(nLength);
+    for (size_t i = 0; i < nLength; ++i)
+        aValues[i] = static_cast<TOut>(paIn[i]);
+}
+
+template <class TOut>
+static void OGRArrowFilterCopyNumbers(const char *format,
+                                      const struct ArrowArray *psArray,
+                                      size_t nLength,
+                                      std::vector<TOut> &aValues)
+{
+    if (IsBoolean(format))
+    {
+        const uint8_t *pabyData =
+            static_cast<const uint8_t *>(psArray->buffers[1]);
+        const size_t nOffset = static_cast<size_t>(psArray->offset);
+        aValues.resize(nLength);
+        for (size_t i = 0; i < nLength; ++i)
+            aValues[i] = TestBit(pabyData, i + nOffset) ? 1 : 0;
+    }
+    else if (IsInt8(format))
+        OGRArrowFilterCopy<int8_t>(psArray, nLength, aValues);
+    else if (IsUInt8(format))
+        OGRArrowFilterCopy<uint8_t>(psArray, nLength, aValues);
+    else if (IsInt16(format))
+        OGRArrowFilterCopy<int16_t>(psArray, nLength, aValues);
+    else if (IsUInt16(format))
+        OGRArrowFilterCopy<uint16_t>(psArray, nLength, aValues);
+    else if (IsInt32(format))
+        OGRArrowFilterCopy<int32_t>(psArray, nLength, aValues);
+    else if (IsUInt32(format))
+        OGRArrowFilterCopy<uint32_t>(psArray, nLength, aValues);
+    else if (IsInt64(format))
+        OGRArrowFilterCopy<int64_t>(psArray, nLength, aValues);
+    else if (IsUInt64(format))
+        OGRArrowFilterCopy<uint64_t>(psArray, nLength, aValues);
+    else if (IsFloat32(format))
+        OGRArrowFilterCopy<float>(psArray, nLength, aValues);
+    else if (IsFloat64(format))
+        OGRArrowFilterCopy<double>(psArray, nLength, aValues);
+    else
+        CPLAssert(false);  // Rejected by CanLoad()
+}
+
+/************************************************************************/
+/*                            LoadIntegers()                            */
+/************************************************************************/
+
+void OGRArrowFilterEvaluator::LoadIntegers(Column &oColumn)
+{
+    if (oColumn.bIntegersLoaded)
+        return;
+    oColumn.bIntegersLoaded = true;
+
+    if (oColumn.bIsFID && m_nBaseSeqFID >= 0)
+    {
+        oColumn.anValues.resize(m_nLength);
+        for (size_t i = 0; i < m_nLength; ++i)
+            oColumn.anValues[i] = m_nBaseSeqFID + static_cast<int64_t>(i);
+    }
+    else
+    {
+        OGRArrowFilterCopyNumbers(oColumn.pszFormat, oColumn.apsArrays.back(),
+                                  m_nLength, oColumn.anValues);
+    }
+
+    if (oColumn.bIsFID)
+    {
+        if (m_nBaseSeqFID < 0)
+        {
+            // Same as the FID set by FillValidityArrayFromAttrQuery()
+            const struct ArrowArray *psArray = oColumn.apsArrays.back();
+            if (psArray->null_count != 0 && psArray->buffers[0] != nullptr)
+            {
+                const uint8_t *pabyValidity =
+                    static_cast<const uint8_t *>(psArray->buffers[0]);
+                const size_t nOffset = static_cast<size_t>(psArray->offset);
+                for (size_t i = 0; i < m_nLength; ++i)
+                {
+                    if (!TestBit(pabyValidity, i + nOffset))
+                        oColumn.anValues[i] = OGRNullFID;
+                }
+            }
+        }
+        if (oColumn.bClampFIDToInt)
+        {
+            // Same as OGRFeature::GetFieldAsInteger()
+            for (auto &nValue : oColumn.anValues)
+            {
+                nValue = std::clamp<int64_t>(
+                    nValue, std::numeric_limits<int>::min(),
+                    std::numeric_limits<int>::max());
+            }
+        }
+    }
+}
+
+/************************************************************************/
+/*                             LoadReals()                              */
+/************************************************************************/
+
+void OGRArrowFilterEvaluator::LoadReals(Column &oColumn)
+{
+    if (oColumn.bRealsLoaded)
+        return;
+    oColumn.bRealsLoaded = true;
+
+    if (oColumn.bIsFID)
+    {
+        LoadIntegers(oColumn);
+        oColumn.adfValues.resize(m_nLength);
+        for (size_t i = 0; i < m_nLength; ++i)
+            oColumn.adfValues[i] = static_cast<double>(oColumn.anValues[i]);
+    }
+    else
+    {
+        OGRArrowFilterCopyNumbers(oColumn.pszFormat, oColumn.apsArrays.back(),
+                                  m_nLength, oColumn.adfValues);
+    }
+}
+
+/************************************************************************/
+/*                            LoadStrings()                             */
+/************************************************************************/
+
+template <class OffsetType>
+static void OGRArrowFilterCopyStrings(const struct ArrowArray *psArray,
+                                      size_t nLength,
+                                      std::vector<OGRArrowFilterString> &asValues)
+{
+    const OffsetType *panOffsets =
+        static_cast<const OffsetType *>(psArray->buffers[1]) +
+        static_cast<size_t>(psArray->offset);
+    const char *pachData = static_cast<const char *>(psArray->buffers[2]);
+    asValues.resize(nLength);
+    for (size_t i = 0; i < nLength; ++i)
+    {
+        const char *pszValue = pachData + static_cast<size_t>(panOffsets[i]);
+        const size_t nSize =
+            static_cast<size_t>(panOffsets[i + 1] - panOffsets[i]);
+        // OGR strings stop at the first nul character
+        const void *pNul = nSize ? memchr(pszValue, 0, nSize) : nullptr;
+        asValues[i].pszValue = pszValue;
+        asValues[i].nLength =
+            pNul ? static_cast<size_t>(static_cast<const char *>(pNul) -
+                                       pszValue)
+                 : nSize;
+    }
+}
+
+void OGRArrowFilterEvaluator::LoadStrings(Column &oColumn)
+{
+    if (oColumn.bStringsLoaded)
+        return;
+    oColumn.bStringsLoaded = true;
+
+    const struct ArrowArray *psArray = oColumn.apsArrays.back();
+    if (IsString(oColumn.pszFormat))
+        OGRArrowFilterCopyStrings<uint32_t>(psArray, m_nLength,
+                                            oColumn.asValues);
+    else
+        OGRArrowFilterCopyStrings<uint64_t>(psArray, m_nLength,
+                                            oColumn.asValues);
+}
+
+/************************************************************************/
+/*                            GetIntegers()                             */
+/************************************************************************/
+
+OGRArrowFilterEvaluator::Values<int64_t>
+OGRArrowFilterEvaluator::GetIntegers(const Operand &sOperand)
+{
+    Values<int64_t> oValues;
+    if (sOperand.poConstant)
+    {
+        oValues.value = sOperand.poConstant->int_value;
+        oValues.bNull = sOperand.poConstant->is_null != 0;
+    }
+    else
+    {
+        Column &oColumn = m_aoColumns[sOperand.iColumn];
+        LoadIntegers(oColumn);
+        oValues.paValues = oColumn.anValues.data();
+        oValues.pabyNull = LoadNulls(oColumn);
+    }
+    return oValues;
+}
+
+/************************************************************************/
+/*                              GetReals()                              */
+/************************************************************************/
+
+OGRArrowFilterEvaluator::Values<double>
+OGRArrowFilterEvaluator::GetReals(const Operand &sOperand)
+{
+    Values<double> oValues;
+    if (sOperand.poConstant)
+    {
+        oValues.value = sOperand.eType == SWQ_FLOAT
+                            ? sOperand.poConstant->float_value
+                            : static_cast<double>(sOperand.poConstant->int_value);
+        oValues.bNull = sOperand.poConstant->is_null != 0;
+    }
+    else
+    {
+        Column &oColumn = m_aoColumns[sOperand.iColumn];
+        LoadReals(oColumn);
+        oValues.paValues = oColumn.adfValues.data();
+        oValues.pabyNull = LoadNulls(oColumn);
+    }
+    return oValues;
+}
+
+/************************************************************************/
+/*                             GetStrings()                             */
+/************************************************************************/
+
+OGRArrowFilterEvaluator::Values<OGRArrowFilterString>
+OGRArrowFilterEvaluator::GetStrings(const Operand &sOperand)
+{
+    Values<OGRArrowFilterString> oValues;
+    if (sOperand.poConstant)
+    {
+        oValues.bNull = sOperand.poConstant->is_null != 0;
+        if (!oValues.bNull)
+        {
+            oValues.value.pszValue = sOperand.poConstant->string_value;
+            oValues.value.nLength = strlen(sOperand.poConstant->string_value);
+        }
+    }
+    else
+    {
+        Column &oColumn = m_aoColumns[sOperand.iColumn];
+        LoadStrings(oColumn);
+        oValues.paValues = oColumn.asValues.data();
+        oValues.pabyNull = LoadNulls(oColumn);
+    }
+    return oValues;
+}
+
+/************************************************************************/
+/*                         EvaluateComparison()                         */
+/************************************************************************/
+
+template <class T>
+void OGRArrowFilterEvaluator::EvaluateComparison(
+    const Kernel &oKernel, const std::vector<Values<T>> &aoValues,
+    Result &oResult)
+{
+    const size_t nLength = m_nLength;
+    uint8_t *pabyValue = oResult.abyValue.data();
+    uint8_t *pabyNull = oResult.abyNull.data();
+    const Values<T> &a = aoValues[0];
+    const Values<T> &b = aoValues[1];
+
+    if (oKernel.eType == KernelType::IN)
+    {
+        // NULL if the value is NULL, or if it is not found and the list
+        // has a NULL.
+        std::vector<uint8_t> abyNullInList(nLength);
+        for (size_t iList = 1; iList < aoValues.size(); ++iList)
+        {
+            const Values<T> &c = aoValues[iList];
+            for (size_t i = 0; i < nLength; ++i)
+            {
+                if (c.IsNull(i))
+                    abyNullInList[i] = 1;
+                else if (a.Get(i) == c.Get(i))
+                    pabyValue[i] = 1;
+            }
+        }
+        for (size_t i = 0; i < nLength; ++i)
+        {
+            if (a.IsNull(i))
+            {
+                pabyValue[i] = 0;
+                pabyNull[i] = 1;
+            }
+            else if (!pabyValue[i] && abyNullInList[i])
+            {
+                pabyNull[i] = 1;
+            }
+        }
+        return;
+    }
+
+    switch (oKernel.eType == KernelType::BETWEEN ? SWQ_BETWEEN : oKernel.eOp)
+    {
+        case SWQ_EQ:
+            for (size_t i = 0; i < nLength; ++i)
+                pabyValue[i] = a.Get(i) == b.Get(i);
+            break;
+        case SWQ_NE:
+            for (size_t i = 0; i < nLength; ++i)
+                pabyValue[i] = a.Get(i) != b.Get(i);
+            break;
+        case SWQ_LT:
+            for (size_t i = 0; i < nLength; ++i)
+                pabyValue[i] = a.Get(i) < b.Get(i);
+            break;
+        case SWQ_LE:
+            for (size_t i = 0; i < nLength; ++i)
+                pabyValue[i] = a.Get(i) <= b.Get(i);
+            break;
+        case SWQ_GT:
+            for (size_t i = 0; i < nLength; ++i)
+                pabyValue[i] = a.Get(i) > b.Get(i);
+            break;
+        case SWQ_GE:
+            for (size_t i = 0; i < nLength; ++i)
+                pabyValue[i] = a.Get(i) >= b.Get(i);
+            break;
+        case SWQ_BETWEEN:
+        {
+            const Values<T> &c = aoValues[2];
+            for (size_t i = 0; i < nLength; ++i)
+                pabyValue[i] = a.Get(i) >= b.Get(i) && a.Get(i) <= c.Get(i);
+            break;
+        }
+        default:
+            CPLAssert(false);
+            break;
+    }
+
+    // The result is NULL if any operand is
+    for (const auto &oValues : aoValues)
+    {
+        if (!oValues.pabyNull && !oValues.bNull)
+            continue;
+        for (size_t i = 0; i < nLength; ++i)
+        {
+            if (oValues.IsNull(i))
+            {
+                pabyValue[i] = 0;
+                pabyNull[i] = 1;
+            }
+        }
+    }
+}
+
+/************************************************************************/
+/*                            EvaluateLike()                            */
+/************************************************************************/
+
+void OGRArrowFilterEvaluator::EvaluateLike(const Kernel &oKernel,
+                                           Result &oResult)
+{
+    const Values<OGRArrowFilterString> oValues =
+        GetStrings(oKernel.aoOperands[0]);
+    const char *pszPattern = oKernel.osPattern.c_str();
+
+    // "prefix%" without other wildcard, case sensitive: a simple comparison
+    const size_t nPatternLength = oKernel.osPattern.size();
+    const bool bIsPrefix =
+        !oKernel.bInsensitive && nPatternLength > 0 &&
+        pszPattern[nPatternLength - 1] == '%' &&
+        oKernel.osPattern.find_first_of("%_") == nPatternLength - 1 &&
+        (oKernel.chEscape == '\0' ||
+         oKernel.osPattern.find(oKernel.chEscape) == std::string::npos);
+
+    std::string osValue;
+    for (size_t i = 0; i < m_nLength; ++i)
+    {
+        if (oValues.IsNull(i))
+        {
+            oResult.abyNull[i] = 1;
+            continue;
+        }
+        const OGRArrowFilterString &sValue = oValues.Get(i);
+        if (bIsPrefix)
+        {
+            oResult.abyValue[i] =
+                sValue.nLength >= nPatternLength - 1 &&
+                memcmp(sValue.pszValue, pszPattern, nPatternLength - 1) == 0;
+        }
+        else
+        {
+            osValue.assign(sValue.pszValue, sValue.nLength);
+            oResult.abyValue[i] = static_cast<uint8_t>(
+                swq_test_like(osValue.c_str(), pszPattern, oKernel.chEscape,
+                              oKernel.bInsensitive, m_bUTF8Strings) != 0);
+        }
+    }
+}
+
+/************************************************************************/
+/*                              Evaluate()                              */
+/************************************************************************/
+
+void OGRArrowFilterEvaluator::Evaluate(const Kernel &oKernel, Result &oResult)
+{
+    const size_t nLength = m_nLength;
+    oResult.abyValue.assign(nLength, 0);
+    oResult.abyNull.assign(nLength, 0);
+
+    switch (oKernel.eType)
+    {
+        case KernelType::LOGICAL:
+        {
+            Result oFirst;
+            Evaluate(*(oKernel.apoChildren[0]), oFirst);
+            if (oKernel.eOp == SWQ_NOT)
+            {
+                for (size_t i = 0; i < nLength; ++i)
+                {
+                    oResult.abyValue[i] =
+                        !oFirst.abyValue[i] && !oFirst.abyNull[i];
+                    oResult.abyNull[i] = oFirst.abyNull[i];
+                }
+                break;
+            }
+            Result oSecond;
+            Evaluate(*(oKernel.apoChildren[1]), oSecond);
+            if (oKernel.eOp == SWQ_AND)
+            {
+                // As SWQGeneralEvaluator(): NULL only if both sides are
+                for (size_t i = 0; i < nLength; ++i)
+                {
+                    oResult.abyValue[i] =
+                        oFirst.abyValue[i] & oSecond.abyValue[i];
+                    oResult.abyNull[i] = oFirst.abyNull[i] & oSecond.abyNull[i];
+                }
+            }
+            else
+            {
+                for (size_t i = 0; i < nLength; ++i)
+                {
+                    oResult.abyValue[i] =
+                        oFirst.abyValue[i] | oSecond.abyValue[i];
+                    oResult.abyNull[i] = oFirst.abyNull[i] | oSecond.abyNull[i];
+                }
+            }
+            break;
+        }
+
+        case KernelType::TRUTH:
+        {
+            const Values<int64_t> oValues = GetIntegers(oKernel.aoOperands[0]);
+            for (size_t i = 0; i < nLength; ++i)
+            {
+                oResult.abyNull[i] = oValues.IsNull(i);
+                oResult.abyValue[i] =
+                    !oResult.abyNull[i] && oValues.Get(i) != 0;
+            }
+            break;
+        }
+
+        case KernelType::COMPARISON:
+        case KernelType::BETWEEN:
+        case KernelType::IN:
+        {
+            switch (oKernel.eDomain)
+            {
+                case Domain::INTEGER:
+                {
+                    std::vector<Values<int64_t>> aoValues;
+                    for (const auto &sOperand : oKernel.aoOperands)
+                        aoValues.push_back(GetIntegers(sOperand));
+                    EvaluateComparison(oKernel, aoValues, oResult);
+                    break;
+                }
+                case Domain::REAL:
+                {
+                    std::vector<Values<double>> aoValues;
+                    for (const auto &sOperand : oKernel.aoOperands)
+                        aoValues.push_back(GetReals(sOperand));
+                    EvaluateComparison(oKernel, aoValues, oResult);
+                    break;
+                }
+                case Domain::STRING:
+                {
+                    std::vector<Values<OGRArrowFilterString>> aoValues;
+                    for (const auto &sOperand : oKernel.aoOperands)
+                        aoValues.push_back(GetStrings(sOperand));
+                    if (oKernel.eType == KernelType::COMPARISON &&
+                        oKernel.eOp == SWQ_EQ)
+                    {
+                        const auto &a = aoValues[0];
+                        const auto &b = aoValues[1];
+                        for (size_t i = 0; i < nLength; ++i)
+                        {
+                            if (a.IsNull(i) || b.IsNull(i))
+                                oResult.abyNull[i] = 1;
+                            else
+                                oResult.abyValue[i] =
+                                    OGRArrowFilterEqualStrings(a.Get(i),
+                                                               b.Get(i));
+                        }
+                    }
+                    else
+                    {
+                        EvaluateComparison(oKernel, aoValues, oResult);
+                    }
+                    break;
+                }
+            }
+            break;
+        }
+
+        case KernelType::LIKE:
+            EvaluateLike(oKernel, oResult);
+            break;
+
+        case KernelType::IS_NULL:
+        {
+            if (!oKernel.apoChildren.empty())
+            {
+                Result oChild;
+                Evaluate(*(oKernel.apoChildren[0]), oChild);
+                oResult.abyValue = std::move(oChild.abyNull);
+            }
+            else if (oKernel.aoOperands[0].poConstant)
+            {
+                if (oKernel.aoOperands[0].poConstant->is_null)
+                    oResult.abyValue.assign(nLength, 1);
+            }
+            else
+            {
+                const uint8_t *pabyNull =
+                    LoadNulls(m_aoColumns[oKernel.aoOperands[0].iColumn]);
+                if (pabyNull)
+                    memcpy(oResult.abyValue.data(), pabyNull, nLength);
+            }
+            break;
+        }
+    }
+}
+
+/************************************************************************/
+/*                              Evaluate()                              */
+/************************************************************************/
+
+/** Clear the selection of the rows not matching the filter, and return the
+ * number of rows still selected. */
+size_t
+OGRArrowFilterEvaluator::Evaluate(std::vector<bool> &abyValidityFromFilters)
+{
+    Result oResult;
+    Evaluate(*m_poRoot, oResult);
+
+    size_t nCountIntersecting = 0;
+    for (size_t i = 0; i < m_nLength; ++i)
+    {
+        if (!abyValidityFromFilters[i])
+            continue;
+        if (oResult.abyValue[i])
+            ++nCountIntersecting;
+        else
+            abyValidityFromFilters[i] = false;
+    }
+    return nCountIntersecting;
+}
+
+}  // namespace
+
 /************************************************************************/
 /*                   FillValidityArrayFromAttrQuery()                   */
 /************************************************************************/
@@ -5141,6 +6344,21 @@ static size_t FillValidityArrayFromAttrQuery(
         }
     }
 
+    // Evaluate the filter a column at a time when possible.
+    // OGR_ARROW_VECTORIZED_FILTER=NO is mostly for testing purposes.
+    if (CPLTestBool(CPLGetConfigOption("OGR_ARROW_VECTORIZED_FILTER", "YES")))
+    {
+        OGRArrowFilterEvaluator oEvaluator(
+            poFeatureDefn, schema, array, oMapFieldNameToArrowPath,
+            nBaseSeqFID, anArrowPathToFIDColumn,
+            poLayer->TestCapability(OLCStringsAsUTF8) != FALSE);
+        if (oEvaluator.Compile(
+                static_cast<swq_expr_node *>(poAttrQuery->GetSWQExpr())))
+        {
+            return oEvaluator.Evaluate(abyValidityFromFilters);
+        }
+    }
+
     for (size_t iRow = 0; iRow < nLength; ++iRow)
     {
         if (!abyValidityFromFilters[iRow])
@@ -63,6 +63,26 @@ void swqerror(swq_parse_context *context, const char *msg)
     CPLError(CE_Failure, CPLE_AppDefined, "%s", osMsg.c_str());
 }
 
+/************************************************************************/
+/*                        IsFollowedByKeyword()                         */
+/*                                                                      */
+/*      Whether the next token of the input is pszKeyword.              */
+/************************************************************************/
+
+static bool IsFollowedByKeyword(const char *pszNext, const char *pszKeyword)
+{
+    while (*pszNext == ' ' || *pszNext == '\t' || *pszNext == 10 ||
+           *pszNext == 13)
+        pszNext++;
+
+    const size_t nLen = strlen(pszKeyword);
+    if (!EQUALN(pszNext, pszKeyword, nLen))
+        return false;
+    const char chAfter = pszNext[nLen];
+    return !(isalnum(static_cast<unsigned char>(chAfter)) || chAfter == '_' ||
+             static_cast<unsigned char>(chAfter) > 127);
+}
+
 /************************************************************************/
 /*                               swqlex()                               */
 /*                                                                      */
@@ -269,6 +289,11 @@ int swqlex(YYSTYPE *ppNode, swq_parse_context *context)
             nReturn = SWQT_ON;
         else if (EQUAL(osToken, "ORDER"))
             nReturn = SWQT_ORDER;
+        // GROUP is only a keyword in GROUP BY, so that it remains usable
+        // as an unquoted identifier.
+        else if (EQUAL(osToken, "GROUP") &&
+                 IsFollowedByKeyword(pszNext, "BY"))
+            nReturn = SWQT_GROUP;
         else if (EQUAL(osToken, "BY"))
             nReturn = SWQT_BY;
         else if (EQUAL(osToken, "FROM"))
@@ -156,67 +156,71 @@ enum yysymbol_kind_t
   YYSYMBOL_SWQT_WHERE = 17,                /* "WHERE"  */
   YYSYMBOL_SWQT_ON = 18,                   /* "ON"  */
   YYSYMBOL_SWQT_ORDER = 19,                /* "ORDER"  */
-  YYSYMBOL_SWQT_BY = 20,                   /* "BY"  */
-  YYSYMBOL_SWQT_FROM = 21,                 /* "FROM"  */
-  YYSYMBOL_SWQT_AS = 22,                   /* "AS"  */
-  YYSYMBOL_SWQT_ASC = 23,                  /* "ASC"  */
-  YYSYMBOL_SWQT_DESC = 24,                 /* "DESC"  */
-  YYSYMBOL_SWQT_DISTINCT = 25,             /* "DISTINCT"  */
-  YYSYMBOL_SWQT_CAST = 26,                 /* "CAST"  */
-  YYSYMBOL_SWQT_UNION = 27,                /* "UNION"  */
-  YYSYMBOL_SWQT_ALL = 28,                  /* "ALL"  */
-  YYSYMBOL_SWQT_LIMIT = 29,                /* "LIMIT"  */
-  YYSYMBOL_SWQT_OFFSET = 30,               /* "OFFSET"  */
-  YYSYMBOL_SWQT_EXCEPT = 31,               /* "EXCEPT"  */
-  YYSYMBOL_SWQT_EXCLUDE = 32,              /* "EXCLUDE"  */
-  YYSYMBOL_SWQT_HIDDEN = 33,               /* "HIDDEN"  */
-  YYSYMBOL_SWQT_VALUE_START = 34,          /* SWQT_VALUE_START  */
-  YYSYMBOL_SWQT_SELECT_START = 35,         /* SWQT_SELECT_START  */
-  YYSYMBOL_SWQT_NOT = 36,                  /* "NOT"  */
-  YYSYMBOL_SWQT_OR = 37,                   /* "OR"  */
-  YYSYMBOL_SWQT_AND = 38,                  /* "AND"  */
-  YYSYMBOL_39_ = 39,                       /* '='  */
-  YYSYMBOL_40_ = 40,                       /* '<'  */
-  YYSYMBOL_41_ = 41,                       /* '>'  */
-  YYSYMBOL_42_ = 42,                       /* '!'  */
-  YYSYMBOL_43_ = 43,                       /* '+'  */
-  YYSYMBOL_44_ = 44,                       /* '-'  */
-  YYSYMBOL_45_ = 45,                       /* '*'  */
-  YYSYMBOL_46_ = 46,                       /* '/'  */
-  YYSYMBOL_47_ = 47,                       /* '%'  */
-  YYSYMBOL_SWQT_UMINUS = 48,               /* SWQT_UMINUS  */
-  YYSYMBOL_SWQT_RESERVED_KEYWORD = 49,     /* "reserved keyword"  */
-  YYSYMBOL_50_ = 50,                       /* '('  */
-  YYSYMBOL_51_ = 51,                       /* ')'  */
-  YYSYMBOL_52_ = 52,                       /* ','  */
-  YYSYMBOL_53_ = 53,                       /* '.'  */
-  YYSYMBOL_YYACCEPT = 54,                  /* $accept  */
-  YYSYMBOL_input = 55,                     /* input  */
-  YYSYMBOL_value_expr = 56,                /* value_expr  */
-  YYSYMBOL_value_expr_list = 57,           /* value_expr_list  */
-  YYSYMBOL_identifier = 58,                /* identifier  */
-  YYSYMBOL_field_value = 59,               /* field_value  */
-  YYSYMBOL_value_expr_non_logical = 60,    /* value_expr_non_logical  */
-  YYSYMBOL_type_def = 61,                  /* type_def  */
-  YYSYMBOL_select_statement = 62,          /* select_statement  */
-  YYSYMBOL_select_core = 63,               /* select_core  */
-  YYSYMBOL_opt_union_all = 64,             /* opt_union_all  */
-  YYSYMBOL_union_all = 65,                 /* union_all  */
-  YYSYMBOL_select_field_list = 66,         /* select_field_list  */
-  YYSYMBOL_exclude_field = 67,             /* exclude_field  */
-  YYSYMBOL_exclude_field_list = 68,        /* exclude_field_list  */
-  YYSYMBOL_except_or_exclude = 69,         /* except_or_exclude  */
-  YYSYMBOL_column_spec = 70,               /* column_spec  */
-  YYSYMBOL_as_clause = 71,                 /* as_clause  */
-  YYSYMBOL_as_clause_with_hidden = 72,     /* as_clause_with_hidden  */
-  YYSYMBOL_opt_where = 73,                 /* opt_where  */
-  YYSYMBOL_opt_joins = 74,                 /* opt_joins  */
-  YYSYMBOL_opt_order_by = 75,              /* opt_order_by  */
-  YYSYMBOL_sort_spec_list = 76,            /* sort_spec_list  */
-  YYSYMBOL_sort_spec = 77,                 /* sort_spec  */
-  YYSYMBOL_opt_limit = 78,                 /* opt_limit  */
-  YYSYMBOL_opt_offset = 79,                /* opt_offset  */
-  YYSYMBOL_table_def = 80                  /* table_def  */
+  YYSYMBOL_SWQT_GROUP = 20,                /* "GROUP"  */
+  YYSYMBOL_SWQT_BY = 21,                   /* "BY"  */
+  YYSYMBOL_SWQT_FROM = 22,                 /* "FROM"  */
+  YYSYMBOL_SWQT_AS = 23,                   /* "AS"  */
+  YYSYMBOL_SWQT_ASC = 24,                  /* "ASC"  */
+  YYSYMBOL_SWQT_DESC = 25,                 /* "DESC"  */
+  YYSYMBOL_SWQT_DISTINCT = 26,             /* "DISTINCT"  */
+  YYSYMBOL_SWQT_CAST = 27,                 /* "CAST"  */
+  YYSYMBOL_SWQT_UNION = 28,                /* "UNION"  */
+  YYSYMBOL_SWQT_ALL = 29,                  /* "ALL"  */
+  YYSYMBOL_SWQT_LIMIT = 30,                /* "LIMIT"  */
+  YYSYMBOL_SWQT_OFFSET = 31,               /* "OFFSET"  */
+  YYSYMBOL_SWQT_EXCEPT = 32,               /* "EXCEPT"  */
+  YYSYMBOL_SWQT_EXCLUDE = 33,              /* "EXCLUDE"  */
+  YYSYMBOL_SWQT_HIDDEN = 34,               /* "HIDDEN"  */
+  YYSYMBOL_SWQT_VALUE_START = 35,          /* SWQT_VALUE_START  */
+  YYSYMBOL_SWQT_SELECT_START = 36,         /* SWQT_SELECT_START  */
+  YYSYMBOL_SWQT_NOT = 37,                  /* "NOT"  */
+  YYSYMBOL_SWQT_OR = 38,                   /* "OR"  */
+  YYSYMBOL_SWQT_AND = 39,                  /* "AND"  */
+  YYSYMBOL_40_ = 40,                       /* '='  */
+  YYSYMBOL_41_ = 41,                       /* '<'  */
+  YYSYMBOL_42_ = 42,                       /* '>'  */
+  YYSYMBOL_43_ = 43,                       /* '!'  */
+  YYSYMBOL_44_ = 44,                       /* '+'  */
+  YYSYMBOL_45_ = 45,                       /* '-'  */
+  YYSYMBOL_46_ = 46,                       /* '*'  */
+  YYSYMBOL_47_ = 47,                       /* '/'  */
+  YYSYMBOL_48_ = 48,                       /* '%'  */
+  YYSYMBOL_SWQT_UMINUS = 49,               /* SWQT_UMINUS  */
+  YYSYMBOL_SWQT_RESERVED_KEYWORD = 50,     /* "reserved keyword"  */
+  YYSYMBOL_51_ = 51,                       /* '('  */
+  YYSYMBOL_52_ = 52,                       /* ')'  */
+  YYSYMBOL_53_ = 53,                       /* ','  */
+  YYSYMBOL_54_ = 54,                       /* '.'  */
+  YYSYMBOL_YYACCEPT = 55,                  /* $accept  */
+  YYSYMBOL_input = 56,                     /* input  */
+  YYSYMBOL_value_expr = 57,                /* value_expr  */
+  YYSYMBOL_value_expr_list = 58,           /* value_expr_list  */
+  YYSYMBOL_identifier = 59,                /* identifier  */
+  YYSYMBOL_field_value = 60,               /* field_value  */
+  YYSYMBOL_value_expr_non_logical = 61,    /* value_expr_non_logical  */
+  YYSYMBOL_type_def = 62,                  /* type_def  */
+  YYSYMBOL_select_statement = 63,          /* select_statement  */
+  YYSYMBOL_select_core = 64,               /* select_core  */
+  YYSYMBOL_opt_union_all = 65,             /* opt_union_all  */
+  YYSYMBOL_union_all = 66,                 /* union_all  */
+  YYSYMBOL_select_field_list = 67,         /* select_field_list  */
+  YYSYMBOL_exclude_field = 68,             /* exclude_field  */
+  YYSYMBOL_exclude_field_list = 69,        /* exclude_field_list  */
+  YYSYMBOL_except_or_exclude = 70,         /* except_or_exclude  */
+  YYSYMBOL_column_spec = 71,               /* column_spec  */
+  YYSYMBOL_as_clause = 72,                 /* as_clause  */
+  YYSYMBOL_as_clause_with_hidden = 73,     /* as_clause_with_hidden  */
+  YYSYMBOL_opt_where = 74,                 /* opt_where  */
+  YYSYMBOL_opt_joins = 75,                 /* opt_joins  */
+  YYSYMBOL_opt_group_by = 76,              /* opt_group_by  */
+  YYSYMBOL_group_spec_list = 77,           /* group_spec_list  */
+  YYSYMBOL_group_spec = 78,                /* group_spec  */
+  YYSYMBOL_opt_order_by = 79,              /* opt_order_by  */
+  YYSYMBOL_sort_spec_list = 80,            /* sort_spec_list  */
+  YYSYMBOL_sort_spec = 81,                 /* sort_spec  */
+  YYSYMBOL_opt_limit = 82,                 /* opt_limit  */
+  YYSYMBOL_opt_offset = 83,                /* opt_offset  */
+  YYSYMBOL_table_def = 84                  /* table_def  */
 };
 typedef enum yysymbol_kind_t yysymbol_kind_t;
 
@@ -544,19 +548,19 @@ union yyalloc
 /* YYFINAL -- State number of the termination state.  */
 #define YYFINAL  22
 /* YYLAST -- Last index in YYTABLE.  */
-#define YYLAST   469
+#define YYLAST   493
 
 /* YYNTOKENS -- Number of terminals.  */
-#define YYNTOKENS  54
+#define YYNTOKENS  55
 /* YYNNTS -- Number of nonterminals.  */
-#define YYNNTS  27
+#define YYNNTS  30
 /* YYNRULES -- Number of rules.  */
-#define YYNRULES  105
+#define YYNRULES  110
 /* YYNSTATES -- Number of states.  */
-#define YYNSTATES  215
+#define YYNSTATES  224
 
 /* YYMAXUTOK -- Last valid token kind.  */
-#define YYMAXUTOK   295
+#define YYMAXUTOK   296
 
 
 /* YYTRANSLATE(TOKEN-NUM) -- Symbol number corresponding to TOKEN-NUM
@@ -573,10 +577,10 @@ static const yytype_int8 yytranslate[] =
        0,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-       2,     2,     2,    42,     2,     2,     2,    47,     2,     2,
-      50,    51,    45,    43,    52,    44,    53,    46,     2,     2,
+       2,     2,     2,    43,     2,     2,     2,    48,     2,     2,
+      51,    52,    46,    44,    53,    45,    54,    47,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-      40,    39,    41,     2,     2,     2,     2,     2,     2,     2,
+      41,    40,    42,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
@@ -599,24 +603,25 @@ static const yytype_int8 yytranslate[] =
        5,     6,     7,     8,     9,    10,    11,    12,    13,    14,
       15,    16,    17,    18,    19,    20,    21,    22,    23,    24,
       25,    26,    27,    28,    29,    30,    31,    32,    33,    34,
-      35,    36,    37,    38,    48,    49
+      35,    36,    37,    38,    39,    49,    50
 };
 
 #if YYDEBUG
 /* YYRLINE[YYN] -- Source line where rule number YYN was defined.  */
 static const yytype_int16 yyrline[] =
 {
-       0,   109,   109,   110,   116,   123,   128,   139,   150,   163,
-     177,   191,   205,   219,   233,   247,   261,   275,   289,   303,
-     321,   336,   355,   369,   387,   402,   421,   436,   455,   470,
-     489,   502,   520,   532,   545,   547,   550,   558,   571,   576,
-     581,   585,   590,   595,   600,   641,   654,   667,   680,   693,
-     706,   742,   756,   768,   775,   784,   802,   822,   823,   826,
-     831,   837,   838,   840,   848,   849,   852,   862,   863,   866,
-     867,   870,   879,   890,   905,   920,   941,   972,  1007,  1032,
-    1061,  1067,  1070,  1072,  1081,  1082,  1087,  1088,  1094,  1101,
-    1102,  1105,  1106,  1109,  1115,  1121,  1128,  1129,  1136,  1137,
-    1145,  1155,  1166,  1177,  1190,  1201
+       0,   110,   110,   111,   117,   124,   129,   140,   151,   164,
+     178,   192,   206,   220,   234,   248,   262,   276,   290,   304,
+     322,   337,   356,   370,   388,   403,   422,   437,   456,   471,
+     490,   503,   521,   533,   546,   548,   551,   559,   572,   577,
+     582,   586,   591,   596,   601,   642,   655,   668,   681,   694,
+     707,   743,   757,   769,   776,   785,   803,   823,   824,   827,
+     832,   838,   839,   841,   849,   850,   853,   863,   864,   867,
+     868,   871,   880,   891,   906,   921,   942,   973,  1008,  1033,
+    1062,  1068,  1071,  1073,  1082,  1083,  1088,  1089,  1095,  1102,
+    1103,  1106,  1107,  1110,  1117,  1118,  1121,  1122,  1125,  1131,
+    1137,  1144,  1145,  1152,  1153,  1161,  1171,  1182,  1193,  1206,
+    1217
 };
 #endif
 
@@ -637,9 +642,9 @@ static const char *const yytname[] =
   "\"floating point number\"", "\"string\"", "\"identifier\"", "\"IN\"",
   "\"LIKE\"", "\"ILIKE\"", "\"ESCAPE\"", "\"BETWEEN\"", "\"NULL\"",
   "\"IS\"", "\"SELECT\"", "\"LEFT\"", "\"JOIN\"", "\"WHERE\"", "\"ON\"",
-  "\"ORDER\"", "\"BY\"", "\"FROM\"", "\"AS\"", "\"ASC\"", "\"DESC\"",
-  "\"DISTINCT\"", "\"CAST\"", "\"UNION\"", "\"ALL\"", "\"LIMIT\"",
-  "\"OFFSET\"", "\"EXCEPT\"", "\"EXCLUDE\"", "\"HIDDEN\"",
+  "\"ORDER\"", "\"GROUP\"", "\"BY\"", "\"FROM\"", "\"AS\"", "\"ASC\"",
+  "\"DESC\"", "\"DISTINCT\"", "\"CAST\"", "\"UNION\"", "\"ALL\"",
+  "\"LIMIT\"", "\"OFFSET\"", "\"EXCEPT\"", "\"EXCLUDE\"", "\"HIDDEN\"",
   "SWQT_VALUE_START", "SWQT_SELECT_START", "\"NOT\"", "\"OR\"", "\"AND\"",
   "'='", "'<'", "'>'", "'!'", "'+'", "'-'", "'*'", "'/'", "'%'",
   "SWQT_UMINUS", "\"reserved keyword\"", "'('", "')'", "','", "'.'",
@@ -648,8 +653,9 @@ static const char *const yytname[] =
   "select_core", "opt_union_all", "union_all", "select_field_list",
   "exclude_field", "exclude_field_list", "except_or_exclude",
   "column_spec", "as_clause", "as_clause_with_hidden", "opt_where",
-  "opt_joins", "opt_order_by", "sort_spec_list", "sort_spec", "opt_limit",
-  "opt_offset", "table_def", YY_NULLPTR
+  "opt_joins", "opt_group_by", "group_spec_list", "group_spec",
+  "opt_order_by", "sort_spec_list", "sort_spec", "opt_limit", "opt_offset",
+  "table_def", YY_NULLPTR
 };
 
 #if 0
@@ -674,28 +680,29 @@ yysymbol_name (yysymbol_kind_t yysymbol)
    STATE-NUM.  */
 static const yytype_int16 yypact[] =
 {
-      66,    93,   -13,    11,  -136,  -136,  -136,  -136,  -136,   -24,
-    -136,    93,   292,    93,   413,   -34,  -136,   174,   136,    21,
-    -136,    30,  -136,    93,   427,  -136,   315,    -9,    93,    93,
-     292,     2,   116,    93,    93,   172,   197,   239,    25,    93,
-       0,   292,   292,   292,   292,   292,   258,    84,   356,   -32,
-      27,    19,    23,    48,  -136,   -13,   377,  -136,    93,    73,
-      75,   145,  -136,    92,    57,    93,    93,   292,   420,   298,
-      93,    93,  -136,    93,    93,  -136,    93,  -136,    93,   308,
-      62,  -136,   -22,   -22,  -136,  -136,  -136,   107,  -136,  -136,
-      72,     0,  -136,   111,  -136,   223,    14,     7,   258,    30,
-    -136,  -136,     0,    95,    93,    93,   292,  -136,    93,   144,
-     149,   399,  -136,  -136,  -136,  -136,  -136,  -136,    93,  -136,
-       7,     0,  -136,  -136,     0,   109,  -136,   110,    55,   102,
-    -136,  -136,   114,   115,  -136,  -136,  -136,   174,   117,    93,
-      93,   292,  -136,   102,   118,  -136,   121,   119,   128,     9,
-       0,     0,  -136,   151,     7,   165,    -1,  -136,  -136,  -136,
-    -136,   174,   165,     0,  -136,     9,  -136,     9,     9,     7,
-     167,    93,   176,    83,   101,   176,  -136,  -136,  -136,  -136,
-     175,    93,   413,   179,   178,  -136,   193,  -136,   201,   178,
-      93,   364,     0,   207,   181,   163,   164,   181,   364,  -136,
-     134,  -136,   173,  -136,   221,  -136,  -136,  -136,  -136,  -136,
-    -136,  -136,     0,  -136,  -136
+      65,   276,   -13,    26,  -136,  -136,  -136,  -136,  -136,   -37,
+    -136,   276,   320,   276,   443,   -49,  -136,   204,    71,     2,
+    -136,     5,  -136,   276,   288,  -136,   342,   -14,   276,   276,
+     320,    -6,   133,   276,   276,   157,   177,   233,    19,   276,
+       6,   320,   320,   320,   320,   320,   271,    86,   384,   -36,
+      20,    -7,    12,    41,  -136,   -13,   406,  -136,   276,    62,
+      75,   131,  -136,    76,    42,   276,   276,   320,   327,   450,
+     276,   276,  -136,   276,   276,  -136,   276,  -136,   276,   335,
+      44,  -136,   -23,   -23,  -136,  -136,  -136,    85,  -136,  -136,
+      53,     6,  -136,    77,  -136,   220,     1,    14,   271,     5,
+    -136,  -136,     6,    57,   276,   276,   320,  -136,   276,   103,
+     105,   196,  -136,  -136,  -136,  -136,  -136,  -136,   276,  -136,
+      14,     6,  -136,  -136,     6,    74,  -136,    83,    89,   109,
+    -136,  -136,    78,   102,  -136,  -136,  -136,   204,   116,   276,
+     276,   320,  -136,   109,   117,  -136,   119,   121,   136,    -2,
+       6,     6,  -136,   170,    14,   173,     7,  -136,  -136,  -136,
+    -136,   204,   173,     6,  -136,    -2,  -136,    -2,    -2,    14,
+     175,   276,   176,    82,   100,   176,  -136,  -136,  -136,  -136,
+     182,   276,   443,   174,   186,  -136,   198,  -136,   206,   186,
+     276,   393,     6,   189,   183,   155,   160,   183,   393,  -136,
+    -136,  -136,   162,     6,   213,   187,  -136,  -136,   187,  -136,
+       6,   134,  -136,   167,  -136,   218,  -136,  -136,  -136,  -136,
+    -136,     6,  -136,  -136
 };
 
 /* YYDEFACT[STATE-NUM] -- Default reduction number in state STATE-NUM.
@@ -715,24 +722,25 @@ static const yytype_int8 yydefact[] =
        0,     0,    81,    82,    72,     0,     0,     0,     0,    61,
       63,    62,     0,     0,     0,     0,     0,    31,     0,    19,
       23,     0,    15,    16,    14,    10,    17,    11,     0,    50,
-       0,     0,    80,    83,     0,     0,    75,     0,   100,    86,
+       0,     0,    80,    83,     0,     0,    75,     0,   105,    86,
       65,    58,    52,     0,    26,    20,    24,    28,     0,     0,
        0,     0,    32,    86,    36,    66,    67,     0,     0,    76,
-       0,     0,   101,     0,     0,    84,     0,    51,    27,    21,
-      25,    29,    84,     0,    73,    78,    77,   102,   104,     0,
-       0,     0,    89,     0,     0,    89,    68,    79,   103,   105,
-       0,     0,    85,     0,    96,    53,     0,    55,     0,    96,
-       0,    86,     0,     0,    98,     0,     0,    98,    86,    87,
-      93,    90,    92,    97,     0,    59,    54,    56,    60,    88,
-      94,    95,     0,    99,    91
+       0,     0,   106,     0,     0,    84,     0,    51,    27,    21,
+      25,    29,    84,     0,    73,    78,    77,   107,   109,     0,
+       0,     0,    89,     0,     0,    89,    68,    79,   108,   110,
+       0,     0,    85,     0,    94,    53,     0,    55,     0,    94,
+       0,    86,     0,     0,   101,     0,     0,   101,    86,    87,
+      93,    90,    92,     0,     0,   103,    54,    56,   103,    88,
+       0,    98,    95,    97,   102,     0,    59,    60,    91,    99,
+     100,     0,   104,    96
 };
 
 /* YYPGOTO[NTERM-NUM].  */
 static const yytype_int16 yypgoto[] =
 {
-    -136,  -136,    16,   -48,   -18,  -117,    24,  -136,   177,   212,
-     135,  -136,   -43,  -136,    74,  -136,  -136,   -56,  -136,    77,
-    -135,    65,    34,  -136,    61,    56,  -111
+    -136,  -136,    16,   -47,   -18,   -64,    24,  -136,   172,   210,
+     132,  -136,   -43,  -136,    67,  -136,  -136,    -1,  -136,    72,
+    -135,    58,    43,  -136,    66,    35,  -136,    61,    51,  -111
 };
 
 /* YYDEFGOTO[NTERM-NUM].  */
@@ -740,7 +748,7 @@ static const yytype_uint8 yydefgoto[] =
 {
        0,     3,    79,    80,    15,    16,    17,   133,    20,    21,
       54,    55,    50,   146,   147,    90,    51,    93,    94,   172,
-     155,   184,   201,   202,   194,   205,   129
+     155,   184,   201,   202,   194,   212,   213,   205,   216,   129
 };
 
 /* YYTABLE[YYPACT[STATE-NUM]] -- What to do in state STATE-NUM.  If
@@ -748,148 +756,156 @@ static const yytype_uint8 yydefgoto[] =
    number is the opposite.  If YYTABLE_NINF, syntax error.  */
 static const yytype_uint8 yytable[] =
 {
-      49,    18,   173,    87,   145,     7,     7,   148,   162,   143,
-     103,    22,   127,     7,    62,     7,    39,    14,    95,    40,
-       7,    96,    81,    43,    44,    45,    23,    24,    49,    26,
-      92,    91,    10,    10,    48,    18,    25,    19,    63,    56,
-      10,    58,    10,   170,    59,    60,   145,    10,    97,    68,
-      69,    72,    75,    77,    61,   130,   199,    53,   180,   126,
-     138,     7,    48,   209,    78,    82,    83,    84,    85,    86,
-     142,    98,   152,   122,    99,   200,   100,    91,    81,   128,
-      49,   109,   110,   104,   132,   105,   112,   113,    10,   114,
-     115,   111,   116,   166,   117,   200,     4,     5,     6,     7,
-       1,     2,   128,   144,   107,     8,   144,   108,   151,   177,
-      92,   178,   179,   119,    48,    88,    89,   153,   154,     9,
-     135,   136,   121,    64,    65,    66,    10,    67,   120,    11,
-     137,    92,   167,   168,   185,   186,   128,    12,   174,     4,
-       5,     6,     7,    13,   123,   144,   134,    92,     8,    92,
-      92,   128,   187,   188,   139,   159,   160,   210,   211,   140,
-     149,    46,     9,   150,   156,   161,   157,   169,   158,    10,
-     164,    40,    11,   163,   144,     4,     5,     6,     7,   165,
-      12,    47,   171,   106,     8,   181,    13,   182,    41,    42,
-      43,    44,    45,   190,   144,   183,   195,   191,     9,   192,
-       4,     5,     6,     7,   196,    10,   198,   193,    11,     8,
-     203,   204,    70,    71,   206,   207,    12,    41,    42,    43,
-      44,    45,    13,     9,   213,   212,     4,     5,     6,     7,
-      10,    52,   101,    11,   131,     8,    73,   176,    74,   175,
-     189,    12,     4,     5,     6,     7,   214,    13,   124,     9,
-     197,     8,     0,   208,     0,     0,    10,     0,     0,    11,
-       0,     4,     5,     6,     7,     9,     0,    12,   125,     0,
-       8,     0,    10,    13,     0,    11,     0,     0,    76,     0,
-       0,     0,     0,    12,     9,     0,     0,     0,     0,    13,
-       0,    10,     0,     0,    11,     4,     5,     6,     7,     0,
-       0,     0,    12,    47,     8,    27,    28,    29,    13,    30,
-       0,    31,     0,     0,     0,    27,    28,    29,     9,    30,
-       0,    31,    27,    28,    29,    10,    30,     0,    31,     0,
-       0,     0,     0,     0,    32,     0,    12,    35,    36,    37,
-      38,     0,    13,     0,    32,    33,    34,    35,    36,    37,
-      38,    32,    33,    34,    35,    36,    37,    38,     0,     0,
-     118,     0,     7,    27,    28,    29,    57,    30,     0,    31,
-       0,    27,    28,    29,     0,    30,     0,    31,    91,   153,
-     154,     0,     0,     0,    27,    28,    29,     0,    30,    10,
-      31,     0,    32,    33,    34,    35,    36,    37,    38,   102,
+      49,    18,    39,    87,     7,    40,    62,     7,   162,   143,
+     173,   103,     7,     7,    23,    95,    18,    14,    96,   127,
+       7,    91,    81,    43,    44,    45,    22,    24,    49,    26,
+      92,    63,    10,    53,    48,    10,    25,    58,    19,    56,
+      10,    10,    97,   170,    59,    60,    98,   126,    10,    68,
+      69,    72,    75,    77,    61,   130,   199,   145,   180,    78,
+     148,   138,    48,   209,    99,    82,    83,    84,    85,    86,
+     100,   142,   104,   122,     4,     5,     6,     7,    81,   128,
+      49,   109,   110,     8,   132,   105,   112,   113,   107,   114,
+     115,   111,   116,   108,   117,     7,   119,    46,     9,   145,
+       1,     2,   128,   144,   121,    10,   144,   120,    11,   134,
+      92,   123,    91,   139,    48,   140,    12,    47,    88,    89,
+     135,   136,    13,    10,   153,   154,   149,   152,   200,   156,
+     137,    92,   167,   168,   185,   186,   128,   150,   174,   211,
+      64,    65,    66,   151,    67,   144,   200,    92,   166,    92,
+      92,   128,   187,   188,   157,   159,   160,   211,   219,   220,
+       4,     5,     6,     7,   177,   161,   178,   179,   158,     8,
+     106,    40,   163,   164,   144,    41,    42,    43,    44,    45,
+       4,     5,     6,     7,     9,   144,   169,   182,   165,     8,
+     171,    10,   144,   181,    11,   192,   183,   191,    70,    71,
+     190,   195,    12,   144,     9,   193,   198,   206,    13,   196,
+     203,    10,   207,   204,    11,   210,   214,    73,   215,    74,
+     221,   222,    12,     4,     5,     6,     7,   101,    13,    52,
+     176,   131,     8,   189,   175,   141,     4,     5,     6,     7,
+      41,    42,    43,    44,    45,     8,   124,     9,    41,    42,
+      43,    44,    45,   218,    10,   197,   223,    11,   208,   217,
+       9,     0,     0,     0,     0,    12,   125,    10,     0,     0,
+      11,    13,     0,    76,     4,     5,     6,     7,    12,     4,
+       5,     6,     7,     8,    13,     0,     0,     0,     8,     0,
+       0,     0,     0,     0,     0,    27,    28,    29,     9,    30,
+       0,    31,     0,     9,     0,    10,     0,     0,    11,     0,
+      10,     0,     0,    11,     0,     0,    12,    47,     0,     0,
+       0,    12,    13,     4,     5,     6,     7,    13,    35,    36,
+      37,    38,     8,     0,    27,    28,    29,     0,    30,     0,
+      31,     0,    27,    28,    29,     0,    30,     9,    31,    27,
+      28,    29,     0,    30,    10,    31,     0,     0,     0,     0,
+       0,     0,     0,     0,    32,    12,    34,    35,    36,    37,
+      38,    13,    32,    33,    34,    35,    36,    37,    38,    32,
+      33,    34,    35,    36,    37,    38,     0,     0,   118,     0,
+       7,    27,    28,    29,    57,    30,     0,    31,     0,     0,
+      27,    28,    29,     0,    30,     0,    31,    91,   153,   154,
+       0,     0,     0,    27,    28,    29,     0,    30,    10,    31,
+       0,    32,    33,    34,    35,    36,    37,    38,     0,   102,
       32,    33,    34,    35,    36,    37,    38,     0,     0,     0,
        0,     0,     0,    32,    33,    34,    35,    36,    37,    38,
       27,    28,    29,     0,    30,     0,    31,    27,    28,    29,
-       0,    30,     0,    31,    27,    28,    29,   141,    30,     0,
-      31,     0,    41,    42,    43,    44,    45,     0,     0,    32,
-      33,    34,    35,    36,    37,    38,    32,     0,    34,    35,
-      36,    37,    38,     0,     0,     0,    35,    36,    37,    38
+       0,    30,     0,    31,     0,     0,     0,     0,     0,     0,
+       0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+      32,    33,    34,    35,    36,    37,    38,    32,     0,     0,
+      35,    36,    37,    38
 };
 
 static const yytype_int16 yycheck[] =
 {
-      18,    14,     3,    46,   121,     6,     6,   124,   143,   120,
-      58,     0,     5,     6,    12,     6,    50,     1,    50,    53,
-       6,    53,    40,    45,    46,    47,    50,    11,    46,    13,
-      48,    22,    33,    33,    18,    14,    12,    50,    36,    23,
-      33,    50,    33,   154,    28,    29,   163,    33,    21,    33,
-      34,    35,    36,    37,    30,    98,   191,    27,   169,    45,
-     108,     6,    46,   198,    39,    41,    42,    43,    44,    45,
-     118,    52,   128,    91,    51,   192,    28,    22,    96,    97,
-      98,    65,    66,    10,   102,    10,    70,    71,    33,    73,
-      74,    67,    76,   149,    78,   212,     3,     4,     5,     6,
-      34,    35,   120,   121,    12,    12,   124,    50,    53,   165,
-     128,   167,   168,    51,    98,    31,    32,    15,    16,    26,
-     104,   105,    50,     7,     8,     9,    33,    11,    21,    36,
-     106,   149,   150,   151,    51,    52,   154,    44,   156,     3,
-       4,     5,     6,    50,    33,   163,    51,   165,    12,   167,
-     168,   169,    51,    52,    10,   139,   140,    23,    24,    10,
-      51,    25,    26,    53,    50,   141,    51,    16,    51,    33,
-      51,    53,    36,    52,   192,     3,     4,     5,     6,    51,
-      44,    45,    17,    38,    12,    18,    50,   171,    43,    44,
-      45,    46,    47,    18,   212,    19,     3,   181,    26,    20,
-       3,     4,     5,     6,     3,    33,   190,    29,    36,    12,
-       3,    30,    40,    41,    51,    51,    44,    43,    44,    45,
-      46,    47,    50,    26,     3,    52,     3,     4,     5,     6,
-      33,    19,    55,    36,    99,    12,    39,   163,    41,   162,
-     175,    44,     3,     4,     5,     6,   212,    50,    25,    26,
-     189,    12,    -1,   197,    -1,    -1,    33,    -1,    -1,    36,
-      -1,     3,     4,     5,     6,    26,    -1,    44,    45,    -1,
-      12,    -1,    33,    50,    -1,    36,    -1,    -1,    39,    -1,
-      -1,    -1,    -1,    44,    26,    -1,    -1,    -1,    -1,    50,
-      -1,    33,    -1,    -1,    36,     3,     4,     5,     6,    -1,
-      -1,    -1,    44,    45,    12,     7,     8,     9,    50,    11,
-      -1,    13,    -1,    -1,    -1,     7,     8,     9,    26,    11,
-      -1,    13,     7,     8,     9,    33,    11,    -1,    13,    -1,
-      -1,    -1,    -1,    -1,    36,    -1,    44,    39,    40,    41,
-      42,    -1,    50,    -1,    36,    37,    38,    39,    40,    41,
-      42,    36,    37,    38,    39,    40,    41,    42,    -1,    -1,
-      52,    -1,     6,     7,     8,     9,    51,    11,    -1,    13,
-      -1,     7,     8,     9,    -1,    11,    -1,    13,    22,    15,
-      16,    -1,    -1,    -1,     7,     8,     9,    -1,    11,    33,
-      13,    -1,    36,    37,    38,    39,    40,    41,    42,    22,
-      36,    37,    38,    39,    40,    41,    42,    -1,    -1,    -1,
-      -1,    -1,    -1,    36,    37,    38,    39,    40,    41,    42,
+      18,    14,    51,    46,     6,    54,    12,     6,   143,   120,
+       3,    58,     6,     6,    51,    51,    14,     1,    54,     5,
+       6,    23,    40,    46,    47,    48,     0,    11,    46,    13,
+      48,    37,    34,    28,    18,    34,    12,    51,    51,    23,
+      34,    34,    22,   154,    28,    29,    53,    46,    34,    33,
+      34,    35,    36,    37,    30,    98,   191,   121,   169,    40,
+     124,   108,    46,   198,    52,    41,    42,    43,    44,    45,
+      29,   118,    10,    91,     3,     4,     5,     6,    96,    97,
+      98,    65,    66,    12,   102,    10,    70,    71,    12,    73,
+      74,    67,    76,    51,    78,     6,    52,    26,    27,   163,
+      35,    36,   120,   121,    51,    34,   124,    22,    37,    52,
+     128,    34,    23,    10,    98,    10,    45,    46,    32,    33,
+     104,   105,    51,    34,    15,    16,    52,   128,   192,    51,
+     106,   149,   150,   151,    52,    53,   154,    54,   156,   203,
+       7,     8,     9,    54,    11,   163,   210,   165,   149,   167,
+     168,   169,    52,    53,    52,   139,   140,   221,    24,    25,
+       3,     4,     5,     6,   165,   141,   167,   168,    52,    12,
+      39,    54,    53,    52,   192,    44,    45,    46,    47,    48,
+       3,     4,     5,     6,    27,   203,    16,   171,    52,    12,
+      17,    34,   210,    18,    37,    21,    20,   181,    41,    42,
+      18,     3,    45,   221,    27,    19,   190,    52,    51,     3,
+      21,    34,    52,    30,    37,    53,     3,    40,    31,    42,
+      53,     3,    45,     3,     4,     5,     6,    55,    51,    19,
+     163,    99,    12,   175,   162,    39,     3,     4,     5,     6,
+      44,    45,    46,    47,    48,    12,    26,    27,    44,    45,
+      46,    47,    48,   210,    34,   189,   221,    37,   197,   208,
+      27,    -1,    -1,    -1,    -1,    45,    46,    34,    -1,    -1,
+      37,    51,    -1,    40,     3,     4,     5,     6,    45,     3,
+       4,     5,     6,    12,    51,    -1,    -1,    -1,    12,    -1,
+      -1,    -1,    -1,    -1,    -1,     7,     8,     9,    27,    11,
+      -1,    13,    -1,    27,    -1,    34,    -1,    -1,    37,    -1,
+      34,    -1,    -1,    37,    -1,    -1,    45,    46,    -1,    -1,
+      -1,    45,    51,     3,     4,     5,     6,    51,    40,    41,
+      42,    43,    12,    -1,     7,     8,     9,    -1,    11,    -1,
+      13,    -1,     7,     8,     9,    -1,    11,    27,    13,     7,
+       8,     9,    -1,    11,    34,    13,    -1,    -1,    -1,    -1,
+      -1,    -1,    -1,    -1,    37,    45,    39,    40,    41,    42,
+      43,    51,    37,    38,    39,    40,    41,    42,    43,    37,
+      38,    39,    40,    41,    42,    43,    -1,    -1,    53,    -1,
+       6,     7,     8,     9,    52,    11,    -1,    13,    -1,    -1,
+       7,     8,     9,    -1,    11,    -1,    13,    23,    15,    16,
+      -1,    -1,    -1,     7,     8,     9,    -1,    11,    34,    13,
+      -1,    37,    38,    39,    40,    41,    42,    43,    -1,    23,
+      37,    38,    39,    40,    41,    42,    43,    -1,    -1,    -1,
+      -1,    -1,    -1,    37,    38,    39,    40,    41,    42,    43,
        7,     8,     9,    -1,    11,    -1,    13,     7,     8,     9,
-      -1,    11,    -1,    13,     7,     8,     9,    38,    11,    -1,
-      13,    -1,    43,    44,    45,    46,    47,    -1,    -1,    36,
-      37,    38,    39,    40,    41,    42,    36,    -1,    38,    39,
-      40,    41,    42,    -1,    -1,    -1,    39,    40,    41,    42
+      -1,    11,    -1,    13,    -1,    -1,    -1,    -1,    -1,    -1,
+      -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,
+      37,    38,    39,    40,    41,    42,    43,    37,    -1,    -1,
+      40,    41,    42,    43
 };
 
 /* YYSTOS[STATE-NUM] -- The symbol kind of the accessing symbol of
    state STATE-NUM.  */
 static const yytype_int8 yystos[] =
 {
-       0,    34,    35,    55,     3,     4,     5,     6,    12,    26,
-      33,    36,    44,    50,    56,    58,    59,    60,    14,    50,
-      62,    63,     0,    50,    56,    60,    56,     7,     8,     9,
-      11,    13,    36,    37,    38,    39,    40,    41,    42,    50,
-      53,    43,    44,    45,    46,    47,    25,    45,    56,    58,
-      66,    70,    63,    27,    64,    65,    56,    51,    50,    56,
-      56,    60,    12,    36,     7,     8,     9,    11,    56,    56,
-      40,    41,    56,    39,    41,    56,    39,    56,    39,    56,
-      57,    58,    60,    60,    60,    60,    60,    66,    31,    32,
-      69,    22,    58,    71,    72,    50,    53,    21,    52,    51,
-      28,    62,    22,    57,    10,    10,    38,    12,    50,    56,
-      56,    60,    56,    56,    56,    56,    56,    56,    52,    51,
-      21,    50,    58,    33,    25,    45,    45,     5,    58,    80,
-      66,    64,    58,    61,    51,    56,    56,    60,    57,    10,
-      10,    38,    57,    80,    58,    59,    67,    68,    59,    51,
-      53,    53,    71,    15,    16,    74,    50,    51,    51,    56,
-      56,    60,    74,    52,    51,    51,    71,    58,    58,    16,
-      80,    17,    73,     3,    58,    73,    68,    71,    71,    71,
-      80,    18,    56,    19,    75,    51,    52,    51,    52,    75,
-      18,    56,    20,    29,    78,     3,     3,    78,    56,    74,
-      59,    76,    77,     3,    30,    79,    51,    51,    79,    74,
-      23,    24,    52,     3,    76
+       0,    35,    36,    56,     3,     4,     5,     6,    12,    27,
+      34,    37,    45,    51,    57,    59,    60,    61,    14,    51,
+      63,    64,     0,    51,    57,    61,    57,     7,     8,     9,
+      11,    13,    37,    38,    39,    40,    41,    42,    43,    51,
+      54,    44,    45,    46,    47,    48,    26,    46,    57,    59,
+      67,    71,    64,    28,    65,    66,    57,    52,    51,    57,
+      57,    61,    12,    37,     7,     8,     9,    11,    57,    57,
+      41,    42,    57,    40,    42,    57,    40,    57,    40,    57,
+      58,    59,    61,    61,    61,    61,    61,    67,    32,    33,
+      70,    23,    59,    72,    73,    51,    54,    22,    53,    52,
+      29,    63,    23,    58,    10,    10,    39,    12,    51,    57,
+      57,    61,    57,    57,    57,    57,    57,    57,    53,    52,
+      22,    51,    59,    34,    26,    46,    46,     5,    59,    84,
+      67,    65,    59,    62,    52,    57,    57,    61,    58,    10,
+      10,    39,    58,    84,    59,    60,    68,    69,    60,    52,
+      54,    54,    72,    15,    16,    75,    51,    52,    52,    57,
+      57,    61,    75,    53,    52,    52,    72,    59,    59,    16,
+      84,    17,    74,     3,    59,    74,    69,    72,    72,    72,
+      84,    18,    57,    20,    76,    52,    53,    52,    53,    76,
+      18,    57,    21,    19,    79,     3,     3,    79,    57,    75,
+      60,    77,    78,    21,    30,    82,    52,    52,    82,    75,
+      53,    60,    80,    81,     3,    31,    83,    83,    77,    24,
+      25,    53,     3,    80
 };
 
 /* YYR1[RULE-NUM] -- Symbol kind of the left-hand side of rule RULE-NUM.  */
 static const yytype_int8 yyr1[] =
 {
-       0,    54,    55,    55,    55,    56,    56,    56,    56,    56,
-      56,    56,    56,    56,    56,    56,    56,    56,    56,    56,
-      56,    56,    56,    56,    56,    56,    56,    56,    56,    56,
-      56,    56,    57,    57,    58,    58,    59,    59,    60,    60,
-      60,    60,    60,    60,    60,    60,    60,    60,    60,    60,
-      60,    60,    61,    61,    61,    61,    61,    62,    62,    63,
-      63,    64,    64,    65,    66,    66,    67,    68,    68,    69,
-      69,    70,    70,    70,    70,    70,    70,    70,    70,    70,
-      71,    71,    72,    72,    73,    73,    74,    74,    74,    75,
-      75,    76,    76,    77,    77,    77,    78,    78,    79,    79,
-      80,    80,    80,    80,    80,    80
+       0,    55,    56,    56,    56,    57,    57,    57,    57,    57,
+      57,    57,    57,    57,    57,    57,    57,    57,    57,    57,
+      57,    57,    57,    57,    57,    57,    57,    57,    57,    57,
+      57,    57,    58,    58,    59,    59,    60,    60,    61,    61,
+      61,    61,    61,    61,    61,    61,    61,    61,    61,    61,
+      61,    61,    62,    62,    62,    62,    62,    63,    63,    64,
+      64,    65,    65,    66,    67,    67,    68,    69,    69,    70,
+      70,    71,    71,    71,    71,    71,    71,    71,    71,    71,
+      72,    72,    73,    73,    74,    74,    75,    75,    75,    76,
+      76,    77,    77,    78,    79,    79,    80,    80,    81,    81,
+      81,    82,    82,    83,    83,    84,    84,    84,    84,    84,
+      84
 };
 
 /* YYR2[RULE-NUM] -- Number of symbols on the right-hand side of rule RULE-NUM.  */
@@ -900,12 +916,13 @@ static const yytype_int8 yyr2[] =
        5,     6,     3,     4,     5,     6,     5,     6,     5,     6,
        3,     4,     3,     1,     1,     1,     1,     3,     1,     1,
        1,     1,     3,     1,     2,     3,     3,     3,     3,     3,
-       4,     6,     1,     4,     6,     4,     6,     2,     4,     9,
-      10,     0,     2,     2,     1,     3,     1,     1,     3,     1,
+       4,     6,     1,     4,     6,     4,     6,     2,     4,    10,
+      11,     0,     2,     2,     1,     3,     1,     1,     3,     1,
        1,     1,     2,     5,     1,     3,     4,     5,     5,     6,
        2,     1,     1,     2,     0,     2,     0,     5,     6,     0,
-       3,     3,     1,     1,     2,     2,     0,     2,     0,     2,
-       1,     2,     3,     4,     3,     4
+       3,     3,     1,     1,     0,     3,     3,     1,     1,     2,
+       2,     0,     2,     0,     2,     1,     2,     3,     4,     3,
+       4
 };
 
 
@@ -2458,16 +2475,16 @@ yyreduce:
     }
     break;
 
-  case 59: /* select_core: "SELECT" select_field_list "FROM" table_def opt_joins opt_where opt_order_by opt_limit opt_offset  */
+  case 59: /* select_core: "SELECT" select_field_list "FROM" table_def opt_joins opt_where opt_group_by opt_order_by opt_limit opt_offset  */
     {
-        delete yyvsp[-5];
+        delete yyvsp[-6];
     }
     break;
 
-  case 60: /* select_core: "SELECT" "DISTINCT" select_field_list "FROM" table_def opt_joins opt_where opt_order_by opt_limit opt_offset  */
+  case 60: /* select_core: "SELECT" "DISTINCT" select_field_list "FROM" table_def opt_joins opt_where opt_group_by opt_order_by opt_limit opt_offset  */
     {
         context->poCurSelect->query_mode = SWQM_DISTINCT_LIST;
-        delete yyvsp[-5];
+        delete yyvsp[-6];
     }
     break;
 
@@ -2727,7 +2744,15 @@ yyreduce:
         }
     break;
 
-  case 93: /* sort_spec: field_value  */
+  case 93: /* group_spec: field_value  */
+        {
+            context->poCurSelect->PushGroupBy( yyvsp[0]->table_name, yyvsp[0]->string_value );
+            delete yyvsp[0];
+            yyvsp[0] = nullptr;
+        }
+    break;
+
+  case 98: /* sort_spec: field_value  */
         {
             context->poCurSelect->PushOrderBy( yyvsp[0]->table_name, yyvsp[0]->string_value, TRUE );
             delete yyvsp[0];
@@ -2735,7 +2760,7 @@ yyreduce:
         }
     break;
 
-  case 94: /* sort_spec: field_value "ASC"  */
+  case 99: /* sort_spec: field_value "ASC"  */
         {
             context->poCurSelect->PushOrderBy( yyvsp[-1]->table_name, yyvsp[-1]->string_value, TRUE );
             delete yyvsp[-1];
@@ -2743,7 +2768,7 @@ yyreduce:
         }
     break;
 
-  case 95: /* sort_spec: field_value "DESC"  */
+  case 100: /* sort_spec: field_value "DESC"  */
         {
             context->poCurSelect->PushOrderBy( yyvsp[-1]->table_name, yyvsp[-1]->string_value, FALSE );
             delete yyvsp[-1];
@@ -2751,7 +2776,7 @@ yyreduce:
         }
     break;
 
-  case 97: /* opt_limit: "LIMIT" "integer number"  */
+  case 102: /* opt_limit: "LIMIT" "integer number"  */
     {
         context->poCurSelect->SetLimit( yyvsp[0]->int_value );
         delete yyvsp[0];
@@ -2759,7 +2784,7 @@ yyreduce:
     }
     break;
 
-  case 99: /* opt_offset: "OFFSET" "integer number"  */
+  case 104: /* opt_offset: "OFFSET" "integer number"  */
     {
         context->poCurSelect->SetOffset( yyvsp[0]->int_value );
         delete yyvsp[0];
@@ -2767,7 +2792,7 @@ yyreduce:
     }
     break;
 
-  case 100: /* table_def: identifier  */
+  case 105: /* table_def: identifier  */
     {
         const int iTable =
             context->poCurSelect->PushTableDef( nullptr, yyvsp[0]->string_value,
@@ -2778,7 +2803,7 @@ yyreduce:
     }
     break;
 
-  case 101: /* table_def: identifier as_clause  */
+  case 106: /* table_def: identifier as_clause  */
     {
         const int iTable =
             context->poCurSelect->PushTableDef( nullptr, yyvsp[-1]->string_value,
@@ -2790,7 +2815,7 @@ yyreduce:
     }
     break;
 
-  case 102: /* table_def: "string" '.' identifier  */
+  case 107: /* table_def: "string" '.' identifier  */
     {
         const int iTable =
             context->poCurSelect->PushTableDef( yyvsp[-2]->string_value,
@@ -2802,7 +2827,7 @@ yyreduce:
     }
     break;
 
-  case 103: /* table_def: "string" '.' identifier as_clause  */
+  case 108: /* table_def: "string" '.' identifier as_clause  */
     {
         const int iTable =
             context->poCurSelect->PushTableDef( yyvsp[-3]->string_value,
@@ -2816,7 +2841,7 @@ yyreduce:
     }
     break;
 
-  case 104: /* table_def: identifier '.' identifier  */
+  case 109: /* table_def: identifier '.' identifier  */
     {
         const int iTable =
             context->poCurSelect->PushTableDef( yyvsp[-2]->string_value,
@@ -2828,7 +2853,7 @@ yyreduce:
     }
     break;
 
-  case 105: /* table_def: identifier '.' identifier as_clause  */
+  case 110: /* table_def: identifier '.' identifier as_clause  */
     {
         const int iTable =
             context->poCurSelect->PushTableDef( yyvsp[-3]->string_value,
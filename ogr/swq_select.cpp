@@ -84,6 +84,14 @@ swq_select::~swq_select()
 
     CPLFree(order_defs);
 
+    for (int i = 0; i < group_by_count; i++)
+    {
+        CPLFree(group_by_defs[i].table_name);
+        CPLFree(group_by_defs[i].field_name);
+    }
+
+    CPLFree(group_by_defs);
+
     for (int i = 0; i < join_count; i++)
     {
         delete join_defs[i].poExpr;
@@ -288,6 +296,18 @@ char *swq_select::Unparse()
         CPLFree(pszTmp);
     }
 
+    if (group_by_count > 0)
+    {
+        osSelect += " GROUP BY ";
+        for (int i = 0; i < group_by_count; i++)
+        {
+            if (i > 0)
+                osSelect += ", ";
+            osSelect += swq_expr_node::QuoteIfNecessary(
+                group_by_defs[i].field_name, '"');
+        }
+    }
+
     if (order_specs > 0)
     {
         osSelect += " ORDER BY ";
@@ -696,6 +716,24 @@ int swq_select::PushTableDef(const char *pszDataSource, const char *pszName,
     return table_count - 1;
 }
 
+/************************************************************************/
+/*                            PushGroupBy()                             */
+/************************************************************************/
+
+void swq_select::PushGroupBy(const char *pszTableName, const char *pszFieldName)
+
+{
+    group_by_count++;
+    group_by_defs = static_cast<swq_group_def *>(
+        CPLRealloc(group_by_defs, sizeof(swq_group_def) * group_by_count));
+
+    group_by_defs[group_by_count - 1].table_name =
+        CPLStrdup(pszTableName ? pszTableName : "");
+    group_by_defs[group_by_count - 1].field_name = CPLStrdup(pszFieldName);
+    group_by_defs[group_by_count - 1].table_index = -1;
+    group_by_defs[group_by_count - 1].field_index = -1;
+}
+
 /************************************************************************/
 /*                            PushOrderBy()                             */
 /************************************************************************/
@@ -955,6 +993,22 @@ static bool CheckCompatibleJoinExpr(swq_expr_node *poExpr, int secondary_table,
     return false;
 }
 
+/************************************************************************/
+/*                        swq_is_group_by_field()                       */
+/************************************************************************/
+
+static bool swq_is_group_by_field(const swq_select *select, int table_index,
+                                  int field_index)
+{
+    for (int i = 0; i < select->group_by_count; i++)
+    {
+        if (select->group_by_defs[i].table_index == table_index &&
+            select->group_by_defs[i].field_index == field_index)
+            return true;
+    }
+    return false;
+}
+
 /************************************************************************/
 /*                               parse()                                */
 /*                                                                      */
@@ -1034,6 +1088,50 @@ CPLErr swq_select::parse(swq_field_list *field_list,
         }
     }
 
+    /* -------------------------------------------------------------------- */
+    /*      Process column names in GROUP BY specs.                         */
+    /* -------------------------------------------------------------------- */
+    if (group_by_count > 0 && query_mode == SWQM_DISTINCT_LIST)
+    {
+        CPLError(CE_Failure, CPLE_NotSupported,
+                 "SELECT DISTINCT cannot be combined with GROUP BY.");
+        return CE_Failure;
+    }
+    if (group_by_count > 0 && join_count > 0)
+    {
+        CPLError(CE_Failure, CPLE_NotSupported,
+                 "GROUP BY cannot be combined with JOIN.");
+        return CE_Failure;
+    }
+
+    for (int i = 0; i < group_by_count; i++)
+    {
+        swq_group_def *def = group_by_defs + i;
+
+        // Identify field.
+        swq_field_type field_type;
+        def->field_index =
+            swq_identify_field(def->table_name, def->field_name, field_list,
+                               &field_type, &(def->table_index));
+        if (def->field_index == -1)
+        {
+            CPLError(CE_Failure, CPLE_AppDefined,
+                     "Unrecognized field name %s in GROUP BY.",
+                     def->table_name[0]
+                         ? CPLSPrintf("%s.%s", def->table_name, def->field_name)
+                         : def->field_name);
+            return CE_Failure;
+        }
+
+        if (field_type == SWQ_GEOMETRY)
+        {
+            CPLError(CE_Failure, CPLE_AppDefined,
+                     "Cannot use geometry field '%s' in a GROUP BY clause",
+                     def->field_name);
+            return CE_Failure;
+        }
+    }
+
     /* -------------------------------------------------------------------- */
     /*      Check if we are producing a one row summary result or a set     */
     /*      of records.  Generate an error if we get conflicting            */
@@ -1074,9 +1172,39 @@ CPLErr swq_select::parse(swq_field_list *field_list,
                 def->distinct_flag = TRUE;
                 this_indicator = SWQM_DISTINCT_LIST;
             }
+            else if (group_by_count > 0)
+            {
+                // Outside of aggregates, only the grouped fields may be
+                // selected
+                if (def->bHidden)
+                    continue;
+                if (def->field_index < 0)
+                {
+                    CPLError(CE_Failure, CPLE_NotSupported,
+                             "Expressions are not supported in the column "
+                             "list of a GROUP BY query.");
+                    return CE_Failure;
+                }
+                if (!swq_is_group_by_field(this, def->table_index,
+                                           def->field_index))
+                {
+                    CPLError(CE_Failure, CPLE_AppDefined,
+                             "Column '%s' must appear in the GROUP BY clause "
+                             "or be used in an aggregate function.",
+                             def->field_name);
+                    return CE_Failure;
+                }
+                this_indicator = SWQM_SUMMARY_RECORD;
+            }
             else
                 this_indicator = SWQM_RECORDSET;
         }
+        else if (def->col_func == SWQCF_CUSTOM && group_by_count > 0)
+        {
+            CPLError(CE_Failure, CPLE_NotSupported,
+                     "Function calls are not supported in a GROUP BY query.");
+            return CE_Failure;
+        }
         else if (def->col_func != SWQCF_CUSTOM)
         {
             this_indicator = SWQM_SUMMARY_RECORD;
@@ -1159,6 +1287,16 @@ CPLErr swq_select::parse(swq_field_list *field_list,
                      def->field_name);
             return CE_Failure;
         }
+
+        if (group_by_count > 0 &&
+            !swq_is_group_by_field(this, def->table_index, def->field_index))
+        {
+            CPLError(CE_Failure, CPLE_AppDefined,
+                     "Only GROUP BY fields can be used in the ORDER BY clause "
+                     "of a GROUP BY query, which is not the case of '%s'",
+                     def->field_name);
+            return CE_Failure;
+        }
     }
 
     /* -------------------------------------------------------------------- */
@@ -0,0 +1,224 @@
+/******************************************************************************
+ *
+ * Project:  GDAL Performance Tests
+ * Purpose:  Compare the direct OGRGeometry <-> GSERIALIZED conversions of
+ *           the DaMeng driver with the former EWKB based paths.
+ * Author:   YiLun Wu, wuyilun@dameng.com
+ *
+ ******************************************************************************
+ * Copyright (c) 2026, YiLun Wu
+ *
+ * SPDX-License-Identifier: MIT
+ ****************************************************************************/
+
+#include "ogr_dameng.h"
+#include "ogr_p.h"
+
+#include <chrono>
+#include <cmath>
+#include <memory>
+
+/************************************************************************/
+/*                               Usage()                                */
+/************************************************************************/
+
+static void Usage()
+{
+    printf("Usage: bench_dameng_gser [-n iterations]\n");
+    exit(1);
+}
+
+/************************************************************************/
+/*                            MakeRing()                                */
+/************************************************************************/
+
+static OGRLinearRing *MakeRing(double dfX, double dfY, double dfRadius,
+                               int nPoints)
+{
+    auto poRing = new OGRLinearRing();
+    poRing->setNumPoints(nPoints + 1);
+    for (int i = 0; i < nPoints; ++i)
+    {
+        const double dfAngle = 2 * M_PI * i / nPoints;
+        poRing->setPoint(i, dfX + dfRadius * cos(dfAngle),
+                         dfY + dfRadius * sin(dfAngle));
+    }
+    poRing->setPoint(nPoints, dfX + dfRadius, dfY);
+    return poRing;
+}
+
+/************************************************************************/
+/*                           EncodeViaHex()                             */
+/************************************************************************/
+
+static size_t EncodeViaHex(const OGRGeometry *poGeom, int nSRSId,
+                           GSERIALIZED **ppsOut)
+{
+    OGREnvelope3D sEnvelope;
+    poGeom->getEnvelope(&sEnvelope);
+    char *pszHexEWKB = OGRGeometryToHexEWKB(poGeom, nSRSId, 3, 3);
+    size_t nSize = 0;
+    *ppsOut = OGRDAMENGGeoFromHexwkb(pszHexEWKB, &nSize, sEnvelope);
+    CPLFree(pszHexEWKB);
+    return nSize;
+}
+
+/************************************************************************/
+/*                              Bench()                                 */
+/************************************************************************/
+
+static bool Bench(const char *pszName, const OGRGeometry *poGeom,
+                  int nIterations)
+{
+    const int nSRSId = 4326;
+
+    // Both encoders must agree byte for byte before timing them.
+    GSERIALIZED *psRef = nullptr;
+    const size_t nRefSize = EncodeViaHex(poGeom, nSRSId, &psRef);
+    GByte *pabyBuf = nullptr;
+    size_t nBufSize = 0;
+    const size_t nSize =
+        OGRDAMENGGeometryToGser(poGeom, nSRSId, &pabyBuf, &nBufSize);
+    const bool bSame = psRef != nullptr && nSize == nRefSize &&
+                       memcmp(psRef, pabyBuf, nSize) == 0;
+    CPLFree(psRef);
+    if (!bSame)
+    {
+        fprintf(stderr, "%s: encoders disagree (%d vs %d bytes)\n", pszName,
+                static_cast<int>(nRefSize), static_cast<int>(nSize));
+        CPLFree(pabyBuf);
+        return false;
+    }
+
+    auto tStart = std::chrono::steady_clock::now();
+    for (int i = 0; i < nIterations; ++i)
+    {
+        GSERIALIZED *psOut = nullptr;
+        EncodeViaHex(poGeom, nSRSId, &psOut);
+        CPLFree(psOut);
+    }
+    const double dfHex = std::chrono::duration<double>(
+                             std::chrono::steady_clock::now() - tStart)
+                             .count();
+
+    tStart = std::chrono::steady_clock::now();
+    for (int i = 0; i < nIterations; ++i)
+        OGRDAMENGGeometryToGser(poGeom, nSRSId, &pabyBuf, &nBufSize);
+    const double dfDirect = std::chrono::duration<double>(
+                                std::chrono::steady_clock::now() - tStart)
+                                .count();
+    CPLFree(pabyBuf);
+
+    printf("%-14s %8d %12.0f %12.0f %8.1fx\n", pszName,
+           static_cast<int>(nSize), nIterations / dfHex,
+           nIterations / dfDirect, dfHex / dfDirect);
+    return true;
+}
+
+/************************************************************************/
+/*                            BenchDecode()                             */
+/************************************************************************/
+
+static bool BenchDecode(const char *pszName, const OGRGeometry *poGeom,
+                        int nIterations)
+{
+    GByte *pabyGser = nullptr;
+    size_t nGserBufSize = 0;
+    const size_t nGserSize =
+        OGRDAMENGGeometryToGser(poGeom, 4326, &pabyGser, &nGserBufSize);
+    GSERIALIZED *psGser = reinterpret_cast<GSERIALIZED *>(pabyGser);
+
+    std::unique_ptr<OGRGeometry> poDecoded(
+        OGRDAMENGGeometryFromGser(psGser, nGserSize));
+    if (!poDecoded || !poDecoded->Equals(poGeom))
+    {
+        fprintf(stderr, "%s: decoded geometry differs\n", pszName);
+        CPLFree(pabyGser);
+        return false;
+    }
+
+    auto tStart = std::chrono::steady_clock::now();
+    for (int i = 0; i < nIterations; ++i)
+    {
+        int nLength = 0;
+        GByte *pabyEWKB = OGRDAMENGGeoToHexwkb(psGser, &nLength);
+        delete OGRGeometryFromEWKB(pabyEWKB, nLength, nullptr, false);
+        CPLFree(pabyEWKB);
+    }
+    const double dfEWKB = std::chrono::duration<double>(
+                              std::chrono::steady_clock::now() - tStart)
+                              .count();
+
+    tStart = std::chrono::steady_clock::now();
+    for (int i = 0; i < nIterations; ++i)
+        delete OGRDAMENGGeometryFromGser(psGser, nGserSize);
+    const double dfDirect = std::chrono::duration<double>(
+                                std::chrono::steady_clock::now() - tStart)
+                                .count();
+
+    GByte *pabyWKB = nullptr;
+    size_t nWKBBufSize = 0;
+    tStart = std::chrono::steady_clock::now();
+    for (int i = 0; i < nIterations; ++i)
+        OGRDAMENGGserToIsoWkb(psGser, nGserSize, &pabyWKB, &nWKBBufSize);
+    const double dfWKB = std::chrono::duration<double>(
+                             std::chrono::steady_clock::now() - tStart)
+                             .count();
+    CPLFree(pabyWKB);
+    CPLFree(pabyGser);
+
+    printf("%-14s %12.0f %12.0f %12.0f\n", pszName, nIterations / dfEWKB,
+           nIterations / dfDirect, nIterations / dfWKB);
+    return true;
+}
+
+/************************************************************************/
+/*                                main()                                */
+/************************************************************************/
+
+int main(int argc, char *argv[])
+{
+    int nIterations = 100000;
+
+    for (int iArg = 1; iArg < argc; ++iArg)
+    {
+        if (iArg + 1 < argc && strcmp(argv[iArg], "-n") == 0)
+            nIterations = atoi(argv[++iArg]);
+        else
+            Usage();
+    }
+
+    OGRPoint oPoint(116.39, 39.91);
+
+    OGRLineString oLine;
+    oLine.setNumPoints(200);
+    for (int i = 0; i < 200; ++i)
+        oLine.setPoint(i, 116.0 + i * 0.001, 39.0 + sin(i * 0.1));
+
+    OGRMultiPolygon oMultiPolygon;
+    for (int iPoly = 0; iPoly < 5; ++iPoly)
+    {
+        auto poPoly = std::make_unique<OGRPolygon>();
+        poPoly->addRingDirectly(MakeRing(iPoly * 10.0, 0, 4, 100));
+        poPoly->addRingDirectly(MakeRing(iPoly * 10.0, 0, 1, 20));
+        oMultiPolygon.addGeometry(std::move(poPoly));
+    }
+
+    printf("%d iterations\n\nencoding, geometries per second\n",
+           nIterations);
+    printf("%-14s %8s %12s %12s %9s\n", "geometry", "bytes", "hex EWKB",
+           "direct", "speedup");
+
+    bool bOK = Bench("point", &oPoint, nIterations);
+    bOK &= Bench("linestring", &oLine, nIterations / 10);
+    bOK &= Bench("multipolygon", &oMultiPolygon, nIterations / 10);
+
+    printf("\ndecoding, geometries per second\n");
+    printf("%-14s %12s %12s %12s\n", "geometry", "EWKB", "direct",
+           "ISO WKB");
+    bOK &= BenchDecode("point", &oPoint, nIterations);
+    bOK &= BenchDecode("linestring", &oLine, nIterations / 10);
+    bOK &= BenchDecode("multipolygon", &oMultiPolygon, nIterations / 10);
+
+    return bOK ? 0 : 1;
+}
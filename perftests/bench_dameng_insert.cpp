@@ -0,0 +1,131 @@
+/******************************************************************************
+ *
+ * Project:  GDAL Performance Tests
+ * Purpose:  Insert throughput of the DaMeng driver for several batch sizes,
+ *           run against the DPI stand-in with a simulated round trip.
+ * Author:   YiLun Wu, wuyilun@dameng.com
+ *
+ ******************************************************************************
+ * Copyright (c) 2026, YiLun Wu
+ *
+ * SPDX-License-Identifier: MIT
+ ****************************************************************************/
+
+#include "ogr_dameng.h"
+#include "dpi_stub.h"
+
+#include "cpl_string.h"
+
+#include <chrono>
+#include <memory>
+
+/************************************************************************/
+/*                               Usage()                                */
+/************************************************************************/
+
+static void Usage()
+{
+    printf("Usage: bench_dameng_insert [-n features] [-latency microsec]\n");
+    printf("                           [-batch size[,size]*]\n");
+    exit(1);
+}
+
+/************************************************************************/
+/*                                main()                                */
+/************************************************************************/
+
+int main(int argc, char *argv[])
+{
+    int nFeatures = 20000;
+    int nLatency = 100;
+    CPLStringList aosBatchSizes(CSLTokenizeString2("1,100,1000", ",", 0));
+
+    for (int iArg = 1; iArg < argc; ++iArg)
+    {
+        if (iArg + 1 < argc && strcmp(argv[iArg], "-n") == 0)
+            nFeatures = atoi(argv[++iArg]);
+        else if (iArg + 1 < argc && strcmp(argv[iArg], "-latency") == 0)
+            nLatency = atoi(argv[++iArg]);
+        else if (iArg + 1 < argc && strcmp(argv[iArg], "-batch") == 0)
+            aosBatchSizes.Assign(CSLTokenizeString2(argv[++iArg], ",", 0));
+        else
+            Usage();
+    }
+
+    DPIStubSetRoundTripMicroSec(nLatency);
+    DPIStubSetClassParamCount(1);
+
+    std::unique_ptr<OGRDAMENGConn> poConn(
+        OGRGetDAMENGConnection("bench", "bench", "localhost", ""));
+    if (!poConn)
+        return 1;
+
+    OGRDAMENGFeatureDefn *poDefn = new OGRDAMENGFeatureDefn("bench");
+    poDefn->Reference();
+    {
+        auto poGeomField =
+            std::make_unique<OGRDAMENGGeomFieldDefn>(nullptr, "GEOM");
+        poGeomField->SetType(wkbPoint);
+        poGeomField->eDAMENGGeoType = GEOM_TYPE_GEOMETRY;
+        poGeomField->nSRSId = 4326;
+        poDefn->AddGeomFieldDefn(std::move(poGeomField));
+    }
+    OGRFieldDefn oName("NAME", OFTString);
+    poDefn->AddFieldDefn(&oName);
+    OGRFieldDefn oValue("VAL", OFTReal);
+    poDefn->AddFieldDefn(&oValue);
+    OGRFieldDefn oId("ID", OFTInteger);
+    poDefn->AddFieldDefn(&oId);
+
+    std::map<std::string, int> oMapParams = {
+        {"GEOM", 1}, {"NAME", 2}, {"VAL", 3}, {"ID", 4}};
+
+    OGRFeature oFeature(poDefn);
+
+    printf("%d features, %d us simulated round trip\n", nFeatures, nLatency);
+    printf("%10s %12s %12s %10s %10s\n", "batch", "seconds", "features/s",
+           "execs", "commits");
+
+    for (int iBatch = 0; iBatch < aosBatchSizes.size(); ++iBatch)
+    {
+        const int nBatchSize = atoi(aosBatchSizes[iBatch]);
+        OGRDAMENGStatement oStmt(poConn.get());
+        oStmt.SetBatchSize(nBatchSize, nBatchSize);
+        if (oStmt.Prepare("INSERT INTO \"BENCH\"(\"GEOM\", \"NAME\", \"VAL\", "
+                          "\"ID\") VALUES(?,?,?,?)") != CE_None)
+            return 1;
+
+        DPIStubResetStats();
+        const auto tStart = std::chrono::steady_clock::now();
+        for (int i = 0; i < nFeatures; ++i)
+        {
+            oFeature.SetGeometryDirectly(
+                new OGRPoint(100.0 + (i % 1000) * 0.001, 30.0 + i * 1e-6));
+            oFeature.SetField(0, CPLSPrintf("feature_%d", i));
+            oFeature.SetField(1, i * 0.5);
+            oFeature.SetField(2, i);
+            if (oStmt.Execute_for_insert(poDefn, &oFeature, oMapParams) !=
+                CE_None)
+                return 1;
+        }
+        if (oStmt.FlushInsert(true) != CE_None)
+            return 1;
+        const double dfSeconds =
+            std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                          tStart)
+                .count();
+
+        const DPIStubStats sStats = DPIStubGetStats();
+        printf("%10d %12.3f %12.0f %10lld %10lld\n", nBatchSize, dfSeconds,
+               nFeatures / dfSeconds, sStats.nExecutions, sStats.nCommits);
+        if (sStats.nRowsInserted != nFeatures)
+        {
+            fprintf(stderr, "expected %d rows, stub saw %lld\n", nFeatures,
+                    sStats.nRowsInserted);
+            return 1;
+        }
+    }
+
+    poDefn->Release();
+    return 0;
+}
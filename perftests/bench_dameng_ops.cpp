@@ -0,0 +1,325 @@
+/******************************************************************************
+ *
+ * Project:  GDAL Performance Tests
+ * Purpose:  Insert, read, update and spatial filter throughput of the
+ *           DaMeng driver, through the OGR API, against the in-memory
+ *           tables of the DPI stand-in with a simulated round trip.
+ * Author:   YiLun Wu, wuyilun@dameng.com
+ *
+ ******************************************************************************
+ * Copyright (c) 2026, YiLun Wu
+ *
+ * SPDX-License-Identifier: MIT
+ ****************************************************************************/
+
+#include "ogr_dameng.h"
+#include "ogrsf_frmts.h"
+#include "dpi_stub.h"
+
+#include <chrono>
+#include <memory>
+#include <random>
+
+/************************************************************************/
+/*                               Usage()                                */
+/************************************************************************/
+
+static void Usage()
+{
+    printf("Usage: bench_dameng_ops [-n features] [-latency microsec]\n");
+    printf("                        [-lookups count] [-filters count]\n");
+    printf("                        [-oo NAME=VALUE]*\n");
+    exit(1);
+}
+
+/************************************************************************/
+/*                            GserEnvelope()                            */
+/*                                                                      */
+/*      Envelope of the geometries the stand-in stores, so that it can  */
+/*      evaluate the spatial predicates of the driver.                  */
+/************************************************************************/
+
+static int GserEnvelope(const void *pData, int nLength, double *padfEnvelope)
+{
+    std::unique_ptr<OGRGeometry> poGeom(OGRDAMENGGeometryFromGser(
+        static_cast<const GSERIALIZED *>(pData), static_cast<size_t>(nLength)));
+    if (poGeom == nullptr || poGeom->IsEmpty())
+        return 0;
+    OGREnvelope sEnvelope;
+    poGeom->getEnvelope(&sEnvelope);
+    padfEnvelope[0] = sEnvelope.MinX;
+    padfEnvelope[1] = sEnvelope.MinY;
+    padfEnvelope[2] = sEnvelope.MaxX;
+    padfEnvelope[3] = sEnvelope.MaxY;
+    return 1;
+}
+
+/************************************************************************/
+/*                             PointOfRow()                             */
+/*                                                                      */
+/*      Location of the i-th feature: a regular 1000 columns grid.      */
+/************************************************************************/
+
+static void PointOfRow(int i, double &dfX, double &dfY)
+{
+    dfX = 100.0 + (i % 1000) * 0.001;
+    dfY = 30.0 + (i / 1000) * 0.001;
+}
+
+/************************************************************************/
+/*                               Report()                               */
+/************************************************************************/
+
+typedef std::chrono::steady_clock::time_point BenchTime;
+
+static void Report(const char *pszPhase, int nOps, BenchTime tStart)
+{
+    const double dfSeconds = std::chrono::duration<double>(
+                                 std::chrono::steady_clock::now() - tStart)
+                                 .count();
+    const DPIStubStats sStats = DPIStubGetStats();
+    printf("%-12s %10d %12.3f %12.0f %10lld %10lld\n", pszPhase, nOps,
+           dfSeconds, nOps / dfSeconds, sStats.nExecutions, sStats.nFetches);
+}
+
+/************************************************************************/
+/*                                main()                                */
+/************************************************************************/
+
+int main(int argc, char *argv[])
+{
+    int nFeatures = 20000;
+    int nLatency = 100;
+    int nLookups = 1000;
+    int nFilters = 100;
+    CPLStringList aosOpenOptions;
+
+    for (int iArg = 1; iArg < argc; ++iArg)
+    {
+        if (iArg + 1 < argc && strcmp(argv[iArg], "-n") == 0)
+            nFeatures = atoi(argv[++iArg]);
+        else if (iArg + 1 < argc && strcmp(argv[iArg], "-latency") == 0)
+            nLatency = atoi(argv[++iArg]);
+        else if (iArg + 1 < argc && strcmp(argv[iArg], "-lookups") == 0)
+            nLookups = atoi(argv[++iArg]);
+        else if (iArg + 1 < argc && strcmp(argv[iArg], "-filters") == 0)
+            nFilters = atoi(argv[++iArg]);
+        else if (iArg + 1 < argc && strcmp(argv[iArg], "-oo") == 0)
+            aosOpenOptions.AddString(argv[++iArg]);
+        else
+            Usage();
+    }
+    if (nFeatures < 1)
+        Usage();
+    nLookups = std::min(nLookups, nFeatures);
+
+    DPIStubSetRoundTripMicroSec(nLatency);
+    DPIStubSetEnvelopeFunc(GserEnvelope);
+    if (DPIStubCreateTable("BENCH", "POINTS",
+                           "ogc_fid BIGINT, wkb_geometry POINT 4326, "
+                           "name VARCHAR, val DOUBLE") != 0)
+        return 1;
+
+    RegisterOGRDAMENG();
+    const char *const apszDrivers[] = {"DAMENG", nullptr};
+    std::unique_ptr<GDALDataset> poDS(GDALDataset::Open(
+        "DAMENG:BENCH/bench@localhost", GDAL_OF_VECTOR | GDAL_OF_UPDATE,
+        apszDrivers, aosOpenOptions.List(), nullptr));
+    if (poDS == nullptr)
+        return 1;
+    OGRLayer *poLayer = poDS->GetLayerByName("POINTS");
+    if (poLayer == nullptr)
+    {
+        fprintf(stderr, "layer POINTS not found\n");
+        return 1;
+    }
+    OGRFeatureDefn *poDefn = poLayer->GetLayerDefn();
+    const int iName = poDefn->GetFieldIndex("name");
+    const int iVal = poDefn->GetFieldIndex("val");
+    if (iName < 0 || iVal < 0 || poDefn->GetGeomFieldCount() != 1)
+    {
+        fprintf(stderr, "unexpected layer definition\n");
+        return 1;
+    }
+
+    printf("%d features, %d us simulated round trip\n", nFeatures, nLatency);
+    printf("%-12s %10s %12s %12s %10s %10s\n", "phase", "ops", "seconds",
+           "ops/s", "execs", "fetches");
+
+    /* -------------------------------------------------------------------- */
+    /*      Insert.                                                         */
+    /* -------------------------------------------------------------------- */
+    DPIStubResetStats();
+    BenchTime tStart = std::chrono::steady_clock::now();
+    for (int i = 0; i < nFeatures; ++i)
+    {
+        OGRFeature oFeature(poDefn);
+        double dfX, dfY;
+        PointOfRow(i, dfX, dfY);
+        oFeature.SetGeometryDirectly(new OGRPoint(dfX, dfY));
+        oFeature.SetField(iName, CPLSPrintf("feature_%d", i));
+        oFeature.SetField(iVal, i * 0.5);
+        if (poLayer->CreateFeature(&oFeature) != OGRERR_NONE)
+            return 1;
+    }
+    if (poLayer->SyncToDisk() != OGRERR_NONE)
+        return 1;
+    Report("insert", nFeatures, tStart);
+    if (DPIStubGetTableRowCount("BENCH", "POINTS") != nFeatures)
+    {
+        fprintf(stderr, "expected %d rows, stand-in has %lld\n", nFeatures,
+                DPIStubGetTableRowCount("BENCH", "POINTS"));
+        return 1;
+    }
+
+    /* -------------------------------------------------------------------- */
+    /*      Full scan.                                                      */
+    /* -------------------------------------------------------------------- */
+    DPIStubResetStats();
+    tStart = std::chrono::steady_clock::now();
+    int nRead = 0;
+    poLayer->ResetReading();
+    for (auto &&poFeature : *poLayer)
+    {
+        if (poFeature->GetGeometryRef() == nullptr)
+            return 1;
+        nRead++;
+    }
+    Report("scan", nRead, tStart);
+    if (nRead != nFeatures)
+    {
+        fprintf(stderr, "expected %d features, read %d\n", nFeatures, nRead);
+        return 1;
+    }
+
+    /* -------------------------------------------------------------------- */
+    /*      Random lookups by FID, then updates of the same features.       */
+    /* -------------------------------------------------------------------- */
+    std::mt19937 oGen(42);
+    std::uniform_int_distribution<int> oDist(1, nFeatures);
+    std::vector<GIntBig> anFIDs;
+    for (int i = 0; i < nLookups; ++i)
+        anFIDs.push_back(oDist(oGen));
+
+    DPIStubResetStats();
+    tStart = std::chrono::steady_clock::now();
+    for (GIntBig nFID : anFIDs)
+    {
+        std::unique_ptr<OGRFeature> poFeature(poLayer->GetFeature(nFID));
+        if (poFeature == nullptr || poFeature->GetFID() != nFID)
+        {
+            fprintf(stderr, "feature " CPL_FRMT_GIB " not found\n", nFID);
+            return 1;
+        }
+    }
+    Report("getfeature", nLookups, tStart);
+
+    DPIStubResetStats();
+    tStart = std::chrono::steady_clock::now();
+    for (GIntBig nFID : anFIDs)
+    {
+        OGRFeature oFeature(poDefn);
+        oFeature.SetFID(nFID);
+        double dfX, dfY;
+        PointOfRow(static_cast<int>(nFID - 1), dfX, dfY);
+        oFeature.SetGeometryDirectly(new OGRPoint(dfX, dfY));
+        oFeature.SetField(iName, CPLSPrintf("updated_" CPL_FRMT_GIB, nFID));
+        oFeature.SetField(iVal, -1.0);
+        if (poLayer->SetFeature(&oFeature) != OGRERR_NONE)
+            return 1;
+    }
+    Report("update", nLookups, tStart);
+    if (DPIStubGetStats().nRowsUpdated != nLookups)
+    {
+        fprintf(stderr, "expected %d updated rows, stand-in saw %lld\n",
+                nLookups, DPIStubGetStats().nRowsUpdated);
+        return 1;
+    }
+
+    /* -------------------------------------------------------------------- */
+    /*      Spatial filters: windows of 10 x 10 grid cells, read with a     */
+    /*      count and a scan.                                               */
+    /* -------------------------------------------------------------------- */
+    const int nRows = (nFeatures + 999) / 1000;
+    std::uniform_int_distribution<int> oDistX(0, 990);
+    std::uniform_int_distribution<int> oDistY(0, std::max(0, nRows - 10));
+    DPIStubResetStats();
+    tStart = std::chrono::steady_clock::now();
+    GIntBig nFiltered = 0;
+    for (int i = 0; i < nFilters; ++i)
+    {
+        const double dfMinX = 100.0 + oDistX(oGen) * 0.001 - 0.0005;
+        const double dfMinY = 30.0 + oDistY(oGen) * 0.001 - 0.0005;
+        poLayer->SetSpatialFilterRect(dfMinX, dfMinY, dfMinX + 0.01,
+                                      dfMinY + 0.01);
+        const GIntBig nCount = poLayer->GetFeatureCount(TRUE);
+        GIntBig nScanned = 0;
+        for (auto &&poFeature : *poLayer)
+        {
+            CPL_IGNORE_RET_VAL(poFeature);
+            nScanned++;
+        }
+        if (nScanned != nCount)
+        {
+            fprintf(stderr, "filter %d: count " CPL_FRMT_GIB
+                            " but scan " CPL_FRMT_GIB "\n",
+                    i, nCount, nScanned);
+            return 1;
+        }
+        nFiltered += nScanned;
+    }
+    poLayer->SetSpatialFilter(nullptr);
+    Report("filter", nFilters, tStart);
+    printf("%-12s " CPL_FRMT_GIB " features matched\n", "", nFiltered);
+
+    /* -------------------------------------------------------------------- */
+    /*      Paging: pages of 100 features reached with SetNextByIndex(),    */
+    /*      in order and then at random.                                    */
+    /* -------------------------------------------------------------------- */
+    const int nPageSize = 100;
+    const int nPages = (nFeatures + nPageSize - 1) / nPageSize;
+    std::uniform_int_distribution<int> oDistPage(0, nPages - 1);
+    for (int iPass = 0; iPass < 2; ++iPass)
+    {
+        DPIStubResetStats();
+        tStart = std::chrono::steady_clock::now();
+        for (int i = 0; i < nPages; ++i)
+        {
+            const int iPage = iPass == 0 ? i : oDistPage(oGen);
+            if (poLayer->SetNextByIndex(iPage * nPageSize) != OGRERR_NONE)
+                return 1;
+            for (int j = 0; j < nPageSize; ++j)
+            {
+                const GIntBig nFID = iPage * nPageSize + j + 1;
+                std::unique_ptr<OGRFeature> poFeature(
+                    poLayer->GetNextFeature());
+                if (nFID > nFeatures)
+                {
+                    if (poFeature != nullptr)
+                        return 1;
+                    break;
+                }
+                if (poFeature == nullptr || poFeature->GetFID() != nFID)
+                {
+                    fprintf(stderr, "page %d: expected feature " CPL_FRMT_GIB
+                                    "\n",
+                            iPage, nFID);
+                    return 1;
+                }
+            }
+        }
+        Report(iPass == 0 ? "page" : "randompage", nPages, tStart);
+    }
+
+    /* -------------------------------------------------------------------- */
+    /*      Where the time went, as seen by the driver.                     */
+    /* -------------------------------------------------------------------- */
+    printf("\n");
+    for (const char *pszItem :
+         cpl::Iterate(poDS->GetMetadata("DAMENG_STATS")))
+        printf("%s\n", pszItem);
+
+    poDS.reset();
+    DPIStubDropTables();
+    return 0;
+}
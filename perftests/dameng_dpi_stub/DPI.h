@@ -0,0 +1,171 @@
+/******************************************************************************
+ *
+ * Project:  GDAL Performance Tests
+ * Purpose:  Stand-in for the DaMeng DPI API. Only the entry points and
+ *           constants used by the OGR DaMeng driver are declared.
+ * Author:   YiLun Wu, wuyilun@dameng.com
+ *
+ ******************************************************************************
+ * Copyright (c) 2026, YiLun Wu
+ *
+ * SPDX-License-Identifier: MIT
+ ****************************************************************************/
+
+#ifndef DPI_STUB_H_INCLUDED
+#define DPI_STUB_H_INCLUDED
+
+#include "DPItypes.h"
+
+/* Return codes */
+#define DSQL_SUCCESS 0
+#define DSQL_SUCCESS_WITH_INFO 1
+#define DSQL_NO_DATA 100
+#define DSQL_ERROR (-1)
+#define DSQL_INVALID_HANDLE (-2)
+#define DSQL_SUCCEEDED(rc) (((rc) & (~1)) == 0)
+
+#define DSQL_NULL_DATA (-1)
+#define DSQL_NTS (-3)
+
+/* Handle types */
+#define DSQL_HANDLE_ENV 1
+#define DSQL_HANDLE_DBC 2
+#define DSQL_HANDLE_STMT 3
+#define DSQL_HANDLE_DESC 4
+
+/* Connection attributes */
+#define DSQL_ATTR_AUTOCOMMIT 102
+#define DSQL_AUTOCOMMIT_OFF 0
+#define DSQL_AUTOCOMMIT_ON 1
+#define DSQL_ATTR_CURRENT_SCHEMA 12001
+
+/* Statement attributes */
+#define DSQL_ATTR_CURSOR_TYPE 6
+#define DSQL_CURSOR_FORWARD_ONLY 0
+#define DSQL_CURSOR_DYNAMIC 2
+#define DSQL_ATTR_ROW_ARRAY_SIZE 27
+#define DSQL_ATTR_PARAMSET_SIZE 22
+#define DSQL_ATTR_IMP_ROW_DESC 10012
+#define DSQL_ATTR_IMP_PARAM_DESC 10013
+
+/* Descriptor fields */
+#define DSQL_DESC_CONCISE_TYPE 2
+#define DSQL_DESC_DISPLAY_SIZE 6
+#define DSQL_DESC_SCHEMA_NAME 16
+#define DSQL_DESC_BASE_COLUMN_NAME 22
+#define DSQL_DESC_BASE_TABLE_NAME 23
+#define DSQL_DESC_OBJ_DESCRIPTOR 10001
+#define DSQL_DESC_OBJ_CLASSID 10002
+
+/* Diagnostics */
+#define DSQL_DIAG_DYNAMIC_FUNCTION_CODE (-20)
+#define DSQL_DIAG_FUNC_CODE_SELECT 85
+
+#define DSQL_PARAM_INPUT 1
+
+/* SQL types */
+#define DSQL_CHAR 1
+#define DSQL_VARCHAR 2
+#define DSQL_BIT 3
+#define DSQL_TINYINT 5
+#define DSQL_SMALLINT 6
+#define DSQL_INT 7
+#define DSQL_BIGINT 8
+#define DSQL_DEC 9
+#define DSQL_FLOAT 10
+#define DSQL_DOUBLE 11
+#define DSQL_BLOB 12
+#define DSQL_DATE 14
+#define DSQL_TIME 15
+#define DSQL_TIMESTAMP 16
+#define DSQL_BINARY 17
+#define DSQL_VARBINARY 18
+#define DSQL_CLOB 19
+#define DSQL_TIME_TZ 22
+#define DSQL_TIMESTAMP_TZ 23
+#define DSQL_CLASS 24
+
+/* C types */
+#define DSQL_C_NCHAR 0
+#define DSQL_C_SLONG 7
+#define DSQL_C_SBIGINT 9
+#define DSQL_C_DOUBLE 11
+#define DSQL_C_TIMESTAMP 16
+#define DSQL_C_BINARY 17
+#define DSQL_C_CLASS 24
+#define DSQL_C_LOB_HANDLE 31
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    DPIRETURN dpi_alloc_env(dhenv *env);
+    DPIRETURN dpi_free_env(dhenv env);
+    DPIRETURN dpi_alloc_con(dhenv env, dhcon *con);
+    DPIRETURN dpi_free_con(dhcon con);
+    DPIRETURN dpi_login(dhcon con, sdbyte *svr, sdbyte *user, sdbyte *pwd);
+    DPIRETURN dpi_logout(dhcon con);
+    DPIRETURN dpi_set_con_attr(dhcon con, sdint4 attr_id, dpointer val,
+                               sdint4 val_len);
+    DPIRETURN dpi_commit(dhcon con);
+    DPIRETURN dpi_rollback(dhcon con);
+
+    DPIRETURN dpi_alloc_stmt(dhcon con, dhstmt *stmt);
+    DPIRETURN dpi_free_stmt(dhstmt stmt);
+    DPIRETURN dpi_prepare(dhstmt stmt, sdbyte *sql_txt);
+    DPIRETURN dpi_exec(dhstmt stmt);
+    DPIRETURN dpi_exec_direct(dhstmt stmt, sdbyte *sql_txt);
+    DPIRETURN dpi_close_cursor(dhstmt stmt);
+    DPIRETURN dpi_set_stmt_attr(dhstmt stmt, sdint4 attr_id, dpointer val,
+                                sdint4 val_len);
+    DPIRETURN dpi_get_stmt_attr(dhstmt stmt, sdint4 attr_id, dpointer val,
+                                sdint4 buf_len, sdint4 *val_len);
+    DPIRETURN dpi_number_columns(dhstmt stmt, sdint2 *col_cnt);
+    DPIRETURN dpi_number_params(dhstmt stmt, udint2 *param_cnt);
+    DPIRETURN dpi_desc_column(dhstmt stmt, sdint2 icol, sdbyte *name,
+                              sdint2 buf_len, sdint2 *name_len,
+                              sdint2 *sqltype, ulength *col_sz,
+                              sdint2 *dec_digits, sdint2 *nullable);
+    DPIRETURN dpi_desc_param(dhstmt stmt, udint2 iparam, sdint2 *sql_type,
+                             ulength *prec, sdint2 *scale, sdint2 *nullable);
+    DPIRETURN dpi_col_attr(dhstmt stmt, udint2 icol, udint2 fldid,
+                           dpointer chr_attr, sdint2 buf_len,
+                           sdint2 *chr_attr_len, slength *num_attr);
+    DPIRETURN dpi_bind_param(dhstmt stmt, udint2 iparam, sdint2 param_type,
+                             sdint2 ctype, sdint2 dtype, ulength precision,
+                             sdint2 scale, dpointer buf, slength buf_len,
+                             slength *ind_ptr);
+    DPIRETURN dpi_bind_col(dhstmt stmt, udint2 icol, sdint2 ctype,
+                           dpointer val, slength buf_len, slength *ind);
+    DPIRETURN dpi_fetch(dhstmt stmt, ulength *row_num);
+    DPIRETURN dpi_row_count(dhstmt stmt, sdint8 *row_num);
+    DPIRETURN dpi_get_desc_field(dhdesc desc, sdint2 rec_num, sdint2 field,
+                                 dpointer val, sdint4 val_len,
+                                 sdint4 *str_len);
+    DPIRETURN dpi_get_diag_field(sdint2 hndl_type, dhandle hndl,
+                                 sdint2 rec_num, sdint2 diag_id,
+                                 dpointer diag_info, slength buf_len,
+                                 slength *info_len);
+
+    DPIRETURN dpi_alloc_obj(dhcon con, dhobj *obj);
+    DPIRETURN dpi_free_obj(dhobj obj);
+    DPIRETURN dpi_free_obj_desc(dhobjdesc obj_desc);
+    DPIRETURN dpi_bind_obj_desc(dhobj obj, dhobjdesc obj_desc);
+    DPIRETURN dpi_set_obj_val(dhobj obj, udint4 nth, udint2 ctype,
+                              dpointer val, udint4 val_len);
+    DPIRETURN dpi_get_obj_val(dhobj obj, udint4 nth, udint2 ctype,
+                              dpointer val, udint4 buf_len, slength *len);
+
+    DPIRETURN dpi_alloc_lob_locator(dhstmt stmt, dhloblctr *loblctr);
+    DPIRETURN dpi_free_lob_locator(dhloblctr loblctr);
+    DPIRETURN dpi_lob_get_length(dhloblctr loblctr, slength *len);
+    DPIRETURN dpi_lob_read(dhloblctr loblctr, ulength start_pos, sdint2 ctype,
+                           slength data_to_read, dpointer val_buf,
+                           slength buf_len, slength *data_get);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DPI_STUB_H_INCLUDED */
@@ -0,0 +1,18 @@
+/******************************************************************************
+ *
+ * Project:  GDAL Performance Tests
+ * Purpose:  Stand-in for the DaMeng DPI extension header.
+ * Author:   YiLun Wu, wuyilun@dameng.com
+ *
+ ******************************************************************************
+ * Copyright (c) 2026, YiLun Wu
+ *
+ * SPDX-License-Identifier: MIT
+ ****************************************************************************/
+
+#ifndef DPI_STUB_EXT_H_INCLUDED
+#define DPI_STUB_EXT_H_INCLUDED
+
+#include "DPItypes.h"
+
+#endif /* DPI_STUB_EXT_H_INCLUDED */
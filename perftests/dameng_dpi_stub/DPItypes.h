@@ -0,0 +1,52 @@
+/******************************************************************************
+ *
+ * Project:  GDAL Performance Tests
+ * Purpose:  Stand-in for the DaMeng DPI type definitions, used to build
+ *           the DaMeng driver benchmarks without the DM client SDK.
+ * Author:   YiLun Wu, wuyilun@dameng.com
+ *
+ ******************************************************************************
+ * Copyright (c) 2026, YiLun Wu
+ *
+ * SPDX-License-Identifier: MIT
+ ****************************************************************************/
+
+#ifndef DPI_STUB_TYPES_H_INCLUDED
+#define DPI_STUB_TYPES_H_INCLUDED
+
+typedef signed char sdbyte;
+typedef unsigned char udbyte;
+typedef short sdint2;
+typedef unsigned short udint2;
+typedef int sdint4;
+typedef unsigned int udint4;
+typedef long long sdint8;
+typedef unsigned long long udint8;
+
+typedef sdint8 slength;
+typedef udint8 ulength;
+
+typedef void *dpointer;
+typedef sdint2 DPIRETURN;
+
+typedef void *dhandle;
+typedef dhandle dhenv;
+typedef dhandle dhcon;
+typedef dhandle dhstmt;
+typedef dhandle dhdesc;
+typedef dhandle dhloblctr;
+typedef dhandle dhobjdesc;
+typedef dhandle dhobj;
+
+typedef struct
+{
+    sdint2 year;
+    udint2 month;
+    udint2 day;
+    udint2 hour;
+    udint2 minute;
+    udint2 second;
+    udint4 fraction; /* nanoseconds */
+} dpi_timestamp_t;
+
+#endif /* DPI_STUB_TYPES_H_INCLUDED */
@@ -0,0 +1,2044 @@
+/******************************************************************************
+ *
+ * Project:  GDAL Performance Tests
+ * Purpose:  In-process stand-in for the DaMeng DPI client library. It
+ *           accepts every call made by the OGR DaMeng driver, models the
+ *           cost of a server round trip with a configurable delay and
+ *           counts what would have been sent to the server. Tables
+ *           registered with DPIStubCreateTable() are kept in memory and
+ *           answer the catalog queries and the simple statements the
+ *           driver issues, so that its read and write paths can run
+ *           without a server. Writes are applied immediately: there is
+ *           no transaction isolation and rollbacks have no effect.
+ * Author:   YiLun Wu, wuyilun@dameng.com
+ *
+ ******************************************************************************
+ * Copyright (c) 2026, YiLun Wu
+ *
+ * SPDX-License-Identifier: MIT
+ ****************************************************************************/
+
+#include "DPI.h"
+#include "dpi_stub.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/* Class id of DMGEO2 ST_Geometry columns in SYSCOLUMNS.TYPE$ */
+#define STUB_GEOMETRY_CLASS_ID ((14 << 24) | 113)
+
+namespace
+{
+
+struct StubParam
+{
+    sdint2 nCType = 0;
+    dpointer pBuffer = nullptr;
+    slength nBufferLength = 0;
+    slength *pnInd = nullptr;
+};
+
+struct StubObj
+{
+    const void *pValue = nullptr;
+    udint4 nLength = 0;
+};
+
+struct StubLob
+{
+    const char *pabyData = nullptr;
+    slength nLength = -1;
+};
+
+/************************************************************************/
+/*                           In-memory tables                           */
+/************************************************************************/
+
+struct StubValue
+{
+    bool bNull = true;
+    std::string osData{};
+    bool bHasEnvelope = false;
+    double adfEnvelope[4] = {0, 0, 0, 0};
+};
+
+struct StubRow
+{
+    std::vector<StubValue> aoValues{};
+};
+
+struct StubTableColumn
+{
+    std::string osName{};
+    std::string osType{}; /* type name, or geometry type */
+    sdint2 nSQLType = DSQL_VARCHAR;
+    ulength nPrec = 0;
+    int nSRID = 0;
+};
+
+struct StubTable
+{
+    std::string osSchema{};
+    std::string osName{};
+    std::vector<StubTableColumn> aoColumns{};
+    std::vector<std::shared_ptr<const StubRow>> apoRows{};
+    long long nNextFID = 1;
+};
+
+std::mutex goTablesMutex;
+std::vector<std::shared_ptr<StubTable>> gapoTables;
+std::atomic<DPIStubEnvelopeFunc> gpfnEnvelope{nullptr};
+
+/************************************************************************/
+/*                          Prepared statements                         */
+/************************************************************************/
+
+enum class StubKind
+{
+    OTHER,
+    ROWS, /* catalog query or SELECT */
+    INSERT,
+    UPDATE,
+    DELETE
+};
+
+enum class StubPredKind
+{
+    EQUAL,
+    NOT_EQUAL,
+    LESS,
+    LESS_EQUAL,
+    GREATER,
+    GREATER_EQUAL,
+    BETWEEN,
+    IN,
+    LIKE,
+    IS_NULL,
+    INTERSECTS_ENVELOPE
+};
+
+/* An operand of a predicate: a parameter marker, or a literal */
+struct StubOperand
+{
+    int iParam = -1;
+    std::string osLiteral{};
+};
+
+struct StubPredicate
+{
+    StubPredKind eKind = StubPredKind::EQUAL;
+    int iColumn = 0;
+    std::vector<StubOperand> aoOperands{};
+};
+
+enum class StubAggregate
+{
+    NONE,
+    COUNT,
+    MIN,
+    MAX
+};
+
+struct StubResultColumn
+{
+    std::string osName{};
+    sdint2 nSQLType = DSQL_VARCHAR;
+    ulength nPrec = 128;
+    int iSource = -1; /* column of the table, or of the owned rows */
+    StubAggregate eAggregate = StubAggregate::NONE;
+};
+
+struct StubBoundCol
+{
+    sdint2 nCType = 0;
+    dpointer pBuffer = nullptr;
+    slength nBufferLength = 0;
+    slength *pnInd = nullptr;
+};
+
+struct StubStmt
+{
+    std::string osSQL{};
+    ulength nParamSetSize = 1;
+    ulength nRowArraySize = 1;
+    std::vector<StubParam> aoParams{};
+
+    StubKind eKind = StubKind::OTHER;
+    bool bValid = true;
+    std::shared_ptr<StubTable> poTable{};
+    std::vector<StubResultColumn> aoColumns{};
+    std::vector<StubPredicate> aoPredicates{};
+    std::vector<int> anTargetColumns{}; /* of INSERT and UPDATE */
+    std::vector<int> anTargetParams{};
+    std::vector<sdint2> anParamTypes{};
+    long long nLimit = -1;
+    long long nOffset = 0;
+
+    /* Catalog queries only: the rows they return */
+    std::vector<std::vector<std::string>> aaosCatalogRows{};
+    std::string osCatalogSchema{};
+    std::string osCatalogTable{};
+    int nCatalogQuery = 0;
+
+    std::vector<std::shared_ptr<const StubRow>> apoResult{};
+    size_t iNextRow = 0;
+    long long nRowCount = 0;
+    std::vector<StubBoundCol> aoBoundCols{};
+};
+
+std::atomic<int> gnRoundTripMicroSec{0};
+std::atomic<int> gnClassParamCount{0};
+std::atomic<long long> gnExecutions{0};
+std::atomic<long long> gnPrepares{0};
+std::atomic<long long> gnLogins{0};
+std::atomic<long long> gnRowsInserted{0};
+std::atomic<long long> gnCommits{0};
+std::atomic<long long> gnBytesSent{0};
+std::atomic<long long> gnFetches{0};
+std::atomic<long long> gnRowsFetched{0};
+std::atomic<long long> gnRowsUpdated{0};
+
+int gnDummyObjDesc = 0;
+
+void RoundTrip()
+{
+    const int nMicroSec = gnRoundTripMicroSec.load();
+    if (nMicroSec > 0)
+        std::this_thread::sleep_for(std::chrono::microseconds(nMicroSec));
+}
+
+bool EqualCI(const std::string &osA, const std::string &osB)
+{
+    if (osA.size() != osB.size())
+        return false;
+    for (size_t i = 0; i < osA.size(); i++)
+    {
+        if (toupper(static_cast<unsigned char>(osA[i])) !=
+            toupper(static_cast<unsigned char>(osB[i])))
+            return false;
+    }
+    return true;
+}
+
+std::string ToUpper(const std::string &osIn)
+{
+    std::string osOut(osIn);
+    for (char &ch : osOut)
+        ch = static_cast<char>(toupper(static_cast<unsigned char>(ch)));
+    return osOut;
+}
+
+bool StartsWithCI(const std::string &osSQL, const char *pszPrefix)
+{
+    size_t i = 0;
+    while (i < osSQL.size() && isspace(static_cast<unsigned char>(osSQL[i])))
+        i++;
+    const size_t nLen = strlen(pszPrefix);
+    if (osSQL.size() - i < nLen)
+        return false;
+    for (size_t j = 0; j < nLen; j++)
+    {
+        if (toupper(static_cast<unsigned char>(osSQL[i + j])) != pszPrefix[j])
+            return false;
+    }
+    return true;
+}
+
+int CountParams(const std::string &osSQL, size_t nEnd = std::string::npos)
+{
+    int nCount = 0;
+    bool bInString = false;
+    nEnd = std::min(nEnd, osSQL.size());
+    for (size_t i = 0; i < nEnd; i++)
+    {
+        const char ch = osSQL[i];
+        if (ch == '\'')
+            bInString = !bInString;
+        else if (ch == '?' && !bInString)
+            nCount++;
+    }
+    return nCount;
+}
+
+/************************************************************************/
+/*                             SQL parsing                              */
+/*                                                                      */
+/*      Only the shapes of statements the driver generates are          */
+/*      understood. Anything else makes the statement invalid.          */
+/************************************************************************/
+
+void SkipSpaces(const std::string &osSQL, size_t &iPos)
+{
+    while (iPos < osSQL.size() &&
+           isspace(static_cast<unsigned char>(osSQL[iPos])))
+        iPos++;
+}
+
+bool IsWordChar(char ch)
+{
+    return isalnum(static_cast<unsigned char>(ch)) || ch == '_' || ch == '$';
+}
+
+/* Consume a keyword at iPos, case insensitively */
+bool ConsumeKeyword(const std::string &osSQL, size_t &iPos,
+                    const char *pszKeyword)
+{
+    size_t i = iPos;
+    SkipSpaces(osSQL, i);
+    const size_t nLen = strlen(pszKeyword);
+    if (osSQL.size() - i < nLen)
+        return false;
+    for (size_t j = 0; j < nLen; j++)
+    {
+        if (toupper(static_cast<unsigned char>(osSQL[i + j])) != pszKeyword[j])
+            return false;
+    }
+    if (IsWordChar(pszKeyword[nLen - 1]) && i + nLen < osSQL.size() &&
+        IsWordChar(osSQL[i + nLen]))
+        return false;
+    iPos = i + nLen;
+    return true;
+}
+
+/* Position of a keyword at parenthesis depth 0, outside of quotes */
+size_t FindKeyword(const std::string &osSQL, const char *pszKeyword,
+                   size_t iStart)
+{
+    int nDepth = 0;
+    bool bInString = false;
+    bool bInIdent = false;
+    const size_t nLen = strlen(pszKeyword);
+    for (size_t i = iStart; i < osSQL.size(); i++)
+    {
+        const char ch = osSQL[i];
+        if (ch == '\'' && !bInIdent)
+            bInString = !bInString;
+        else if (ch == '"' && !bInString)
+            bInIdent = !bInIdent;
+        if (bInString || bInIdent)
+            continue;
+        if (ch == '(')
+            nDepth++;
+        else if (ch == ')')
+            nDepth--;
+        else if (nDepth == 0 && (i == 0 || !IsWordChar(osSQL[i - 1])))
+        {
+            size_t iPos = i;
+            if (ConsumeKeyword(osSQL, iPos, pszKeyword) && iPos == i + nLen)
+                return i;
+        }
+    }
+    return std::string::npos;
+}
+
+bool ParseIdentifier(const std::string &osSQL, size_t &iPos,
+                     std::string &osIdent)
+{
+    SkipSpaces(osSQL, iPos);
+    osIdent.clear();
+    if (iPos >= osSQL.size())
+        return false;
+    if (osSQL[iPos] == '"')
+    {
+        iPos++;
+        while (iPos < osSQL.size())
+        {
+            if (osSQL[iPos] == '"')
+            {
+                if (iPos + 1 < osSQL.size() && osSQL[iPos + 1] == '"')
+                {
+                    osIdent += '"';
+                    iPos += 2;
+                    continue;
+                }
+                iPos++;
+                return true;
+            }
+            osIdent += osSQL[iPos++];
+        }
+        return false;
+    }
+    while (iPos < osSQL.size() && IsWordChar(osSQL[iPos]))
+        osIdent += osSQL[iPos++];
+    return !osIdent.empty();
+}
+
+/* Table reference, optionally qualified by its schema */
+std::shared_ptr<StubTable> ParseTable(const std::string &osSQL, size_t &iPos)
+{
+    std::string osFirst;
+    if (!ParseIdentifier(osSQL, iPos, osFirst))
+        return nullptr;
+    std::string osSecond;
+    if (iPos < osSQL.size() && osSQL[iPos] == '.')
+    {
+        iPos++;
+        if (!ParseIdentifier(osSQL, iPos, osSecond))
+            return nullptr;
+    }
+
+    std::lock_guard<std::mutex> oLock(goTablesMutex);
+    for (const auto &poTable : gapoTables)
+    {
+        if (osSecond.empty() ? EqualCI(poTable->osName, osFirst)
+                             : EqualCI(poTable->osSchema, osFirst) &&
+                                   EqualCI(poTable->osName, osSecond))
+            return poTable;
+    }
+    return nullptr;
+}
+
+int FindColumn(const StubTable &oTable, const std::string &osName)
+{
+    for (size_t i = 0; i < oTable.aoColumns.size(); i++)
+    {
+        if (EqualCI(oTable.aoColumns[i].osName, osName))
+            return static_cast<int>(i);
+    }
+    return -1;
+}
+
+bool ParseOperand(const StubStmt &oStmt, size_t &iPos, StubOperand &oOperand)
+{
+    const std::string &osSQL = oStmt.osSQL;
+    SkipSpaces(osSQL, iPos);
+    if (iPos >= osSQL.size())
+        return false;
+    if (osSQL[iPos] == '?')
+    {
+        oOperand.iParam = CountParams(osSQL, iPos);
+        iPos++;
+        return true;
+    }
+    if (osSQL[iPos] == '\'')
+    {
+        for (iPos++; iPos < osSQL.size(); iPos++)
+        {
+            if (osSQL[iPos] == '\'')
+            {
+                if (iPos + 1 < osSQL.size() && osSQL[iPos + 1] == '\'')
+                    iPos++;
+                else
+                {
+                    iPos++;
+                    return true;
+                }
+            }
+            oOperand.osLiteral += osSQL[iPos];
+        }
+        return false;
+    }
+    const size_t iStart = iPos;
+    while (iPos < osSQL.size() &&
+           (IsWordChar(osSQL[iPos]) || osSQL[iPos] == '.' ||
+            osSQL[iPos] == '-' || osSQL[iPos] == '+'))
+        iPos++;
+    oOperand.osLiteral = osSQL.substr(iStart, iPos - iStart);
+    return iPos > iStart;
+}
+
+/* Conjunction of predicates, up to iEnd or a closing parenthesis */
+bool ParseConjunction(StubStmt &oStmt, size_t &iPos, size_t iEnd)
+{
+    const std::string &osSQL = oStmt.osSQL;
+    while (true)
+    {
+        SkipSpaces(osSQL, iPos);
+        if (iPos >= iEnd)
+            return false;
+
+        if (osSQL[iPos] == '(')
+        {
+            iPos++;
+            if (!ParseConjunction(oStmt, iPos, iEnd))
+                return false;
+            SkipSpaces(osSQL, iPos);
+            if (iPos >= iEnd || osSQL[iPos] != ')')
+                return false;
+            iPos++;
+        }
+        else if (ConsumeKeyword(osSQL, iPos, "DMGEO2.ST_INTERSECTS("))
+        {
+            StubPredicate oPred;
+            oPred.eKind = StubPredKind::INTERSECTS_ENVELOPE;
+            std::string osColumn;
+            if (!ParseIdentifier(osSQL, iPos, osColumn))
+                return false;
+            oPred.iColumn = FindColumn(*oStmt.poTable, osColumn);
+            SkipSpaces(osSQL, iPos);
+            if (oPred.iColumn < 0 || iPos >= iEnd || osSQL[iPos] != ',' ||
+                !ConsumeKeyword(osSQL, ++iPos, "DMGEO2.ST_MAKEENVELOPE("))
+                return false;
+            for (int i = 0; i < 4; i++)
+            {
+                StubOperand oOperand;
+                if (!ParseOperand(oStmt, iPos, oOperand))
+                    return false;
+                oPred.aoOperands.push_back(oOperand);
+                SkipSpaces(osSQL, iPos);
+                if (iPos >= iEnd || osSQL[iPos] != ',')
+                    return false;
+                iPos++;
+            }
+            StubOperand oSRID;
+            if (!ParseOperand(oStmt, iPos, oSRID))
+                return false;
+            if (!ConsumeKeyword(osSQL, iPos, ")") ||
+                !ConsumeKeyword(osSQL, iPos, ")"))
+                return false;
+            oStmt.aoPredicates.push_back(oPred);
+        }
+        else
+        {
+            StubPredicate oPred;
+            std::string osColumn;
+            if (!ParseIdentifier(osSQL, iPos, osColumn))
+                return false;
+            oPred.iColumn = FindColumn(*oStmt.poTable, osColumn);
+            if (oPred.iColumn < 0)
+                return false;
+            static const struct
+            {
+                const char *pszOperator;
+                StubPredKind eKind;
+            } asComparisons[] = {
+                {"<>", StubPredKind::NOT_EQUAL},
+                {"<=", StubPredKind::LESS_EQUAL},
+                {">=", StubPredKind::GREATER_EQUAL},
+                {"=", StubPredKind::EQUAL},
+                {"<", StubPredKind::LESS},
+                {">", StubPredKind::GREATER},
+                {"LIKE", StubPredKind::LIKE},
+            };
+            StubOperand oOperand;
+            bool bComparison = false;
+            for (const auto &sComparison : asComparisons)
+            {
+                if (ConsumeKeyword(osSQL, iPos, sComparison.pszOperator))
+                {
+                    oPred.eKind = sComparison.eKind;
+                    bComparison = true;
+                    break;
+                }
+            }
+            if (bComparison)
+            {
+                if (!ParseOperand(oStmt, iPos, oOperand))
+                    return false;
+                oPred.aoOperands.push_back(oOperand);
+            }
+            else if (ConsumeKeyword(osSQL, iPos, "IS"))
+            {
+                oPred.eKind = StubPredKind::IS_NULL;
+                if (!ConsumeKeyword(osSQL, iPos, "NULL"))
+                    return false;
+            }
+            else if (ConsumeKeyword(osSQL, iPos, "IN"))
+            {
+                oPred.eKind = StubPredKind::IN;
+                if (!ConsumeKeyword(osSQL, iPos, "("))
+                    return false;
+                do
+                {
+                    if (!ParseOperand(oStmt, iPos, oOperand))
+                        return false;
+                    oPred.aoOperands.push_back(oOperand);
+                    oOperand = StubOperand();
+                } while (ConsumeKeyword(osSQL, iPos, ","));
+                if (!ConsumeKeyword(osSQL, iPos, ")"))
+                    return false;
+            }
+            else if (ConsumeKeyword(osSQL, iPos, "BETWEEN"))
+            {
+                oPred.eKind = StubPredKind::BETWEEN;
+                if (!ParseOperand(oStmt, iPos, oOperand))
+                    return false;
+                oPred.aoOperands.push_back(oOperand);
+                if (!ConsumeKeyword(osSQL, iPos, "AND") ||
+                    !ParseOperand(oStmt, iPos, oOperand))
+                    return false;
+                oPred.aoOperands.push_back(oOperand);
+            }
+            else
+            {
+                return false;
+            }
+            oStmt.aoPredicates.push_back(oPred);
+        }
+
+        SkipSpaces(osSQL, iPos);
+        if (iPos >= iEnd || osSQL[iPos] == ')')
+            return true;
+        if (!ConsumeKeyword(osSQL, iPos, "AND"))
+            return false;
+    }
+}
+
+/* Split a comma separated list at parenthesis depth 0 */
+std::vector<std::string> SplitList(const std::string &osList)
+{
+    std::vector<std::string> aosItems;
+    int nDepth = 0;
+    bool bInQuotes = false;
+    std::string osItem;
+    for (char ch : osList)
+    {
+        if (ch == '"' || ch == '\'')
+            bInQuotes = !bInQuotes;
+        else if (!bInQuotes && ch == '(')
+            nDepth++;
+        else if (!bInQuotes && ch == ')')
+            nDepth--;
+        if (ch == ',' && nDepth == 0 && !bInQuotes)
+        {
+            aosItems.push_back(osItem);
+            osItem.clear();
+        }
+        else
+            osItem += ch;
+    }
+    aosItems.push_back(osItem);
+    return aosItems;
+}
+
+StubResultColumn TableResultColumn(const StubTable &oTable, int iColumn)
+{
+    StubResultColumn oColumn;
+    oColumn.osName = oTable.aoColumns[iColumn].osName;
+    oColumn.nSQLType = oTable.aoColumns[iColumn].nSQLType;
+    oColumn.nPrec = oTable.aoColumns[iColumn].nPrec;
+    oColumn.iSource = iColumn;
+    return oColumn;
+}
+
+bool ParseSelect(StubStmt &oStmt)
+{
+    const std::string &osSQL = oStmt.osSQL;
+    size_t iPos = 0;
+    ConsumeKeyword(osSQL, iPos, "SELECT");
+    const size_t iFrom = FindKeyword(osSQL, "FROM", iPos);
+    if (iFrom == std::string::npos)
+        return false;
+    const std::string osFields = osSQL.substr(iPos, iFrom - iPos);
+
+    iPos = iFrom + 4;
+    oStmt.poTable = ParseTable(osSQL, iPos);
+    if (oStmt.poTable == nullptr)
+        return false;
+    const StubTable &oTable = *oStmt.poTable;
+
+    for (const std::string &osItem : SplitList(osFields))
+    {
+        size_t iItem = 0;
+        std::string osIdent;
+        if (ConsumeKeyword(osItem, iItem, "*"))
+        {
+            for (size_t i = 0; i < oTable.aoColumns.size(); i++)
+                oStmt.aoColumns.push_back(
+                    TableResultColumn(oTable, static_cast<int>(i)));
+            continue;
+        }
+        if (ConsumeKeyword(osItem, iItem, "COUNT(*)"))
+        {
+            StubResultColumn oColumn;
+            oColumn.osName = "COUNT(*)";
+            oColumn.nSQLType = DSQL_BIGINT;
+            oColumn.nPrec = 19;
+            oColumn.eAggregate = StubAggregate::COUNT;
+            oStmt.aoColumns.push_back(oColumn);
+            continue;
+        }
+        StubAggregate eAggregate = StubAggregate::NONE;
+        if (ConsumeKeyword(osItem, iItem, "MIN("))
+            eAggregate = StubAggregate::MIN;
+        else if (ConsumeKeyword(osItem, iItem, "MAX("))
+            eAggregate = StubAggregate::MAX;
+        if (!ParseIdentifier(osItem, iItem, osIdent))
+            return false;
+        const int iColumn = FindColumn(oTable, osIdent);
+        if (iColumn < 0)
+            return false;
+        StubResultColumn oColumn = TableResultColumn(oTable, iColumn);
+        oColumn.eAggregate = eAggregate;
+        if (eAggregate != StubAggregate::NONE &&
+            !ConsumeKeyword(osItem, iItem, ")"))
+            return false;
+        SkipSpaces(osItem, iItem);
+        if (iItem != osItem.size())
+            return false;
+        oStmt.aoColumns.push_back(oColumn);
+    }
+
+    // All columns or none are aggregates.
+    for (const auto &oColumn : oStmt.aoColumns)
+    {
+        if ((oColumn.eAggregate == StubAggregate::NONE) !=
+            (oStmt.aoColumns[0].eAggregate == StubAggregate::NONE))
+            return false;
+    }
+
+    // Rows are kept in FID order, which is the only ORDER BY the driver
+    // uses, so ORDER BY is ignored.
+    size_t iEnd = osSQL.size();
+    const size_t iOrderBy = FindKeyword(osSQL, "ORDER", iPos);
+    const size_t iLimit = FindKeyword(osSQL, "LIMIT", iPos);
+    const size_t iOffset = FindKeyword(osSQL, "OFFSET", iPos);
+    iEnd = std::min(iEnd, std::min(iOrderBy, std::min(iLimit, iOffset)));
+    if (iLimit != std::string::npos)
+        oStmt.nLimit = atoll(osSQL.c_str() + iLimit + 5);
+    // OFFSET n ROWS
+    if (iOffset != std::string::npos)
+        oStmt.nOffset = atoll(osSQL.c_str() + iOffset + 6);
+
+    SkipSpaces(osSQL, iPos);
+    if (iPos < iEnd && ConsumeKeyword(osSQL, iPos, "WHERE"))
+    {
+        if (!ParseConjunction(oStmt, iPos, iEnd))
+            return false;
+    }
+    SkipSpaces(osSQL, iPos);
+    if (iPos < iEnd && osSQL[iPos] == ';')
+        iPos++;
+    SkipSpaces(osSQL, iPos);
+    return iPos >= iEnd;
+}
+
+bool ParseInsert(StubStmt &oStmt)
+{
+    const std::string &osSQL = oStmt.osSQL;
+    size_t iPos = 0;
+    if (!ConsumeKeyword(osSQL, iPos, "INSERT") ||
+        !ConsumeKeyword(osSQL, iPos, "INTO"))
+        return false;
+    oStmt.poTable = ParseTable(osSQL, iPos);
+    if (oStmt.poTable == nullptr)
+        return false;
+    if (!ConsumeKeyword(osSQL, iPos, "("))
+        return false;
+    const size_t iClose = osSQL.find(')', iPos);
+    if (iClose == std::string::npos)
+        return false;
+    for (const std::string &osItem :
+         SplitList(osSQL.substr(iPos, iClose - iPos)))
+    {
+        size_t iItem = 0;
+        std::string osIdent;
+        if (!ParseIdentifier(osItem, iItem, osIdent))
+            return false;
+        const int iColumn = FindColumn(*oStmt.poTable, osIdent);
+        if (iColumn < 0)
+            return false;
+        oStmt.anTargetColumns.push_back(iColumn);
+        oStmt.anTargetParams.push_back(
+            static_cast<int>(oStmt.anTargetParams.size()));
+    }
+    // Only VALUES made of markers, one per column.
+    iPos = iClose + 1;
+    if (!ConsumeKeyword(osSQL, iPos, "VALUES") ||
+        CountParams(osSQL) != static_cast<int>(oStmt.anTargetColumns.size()))
+        return false;
+    return true;
+}
+
+bool ParseUpdate(StubStmt &oStmt)
+{
+    const std::string &osSQL = oStmt.osSQL;
+    size_t iPos = 0;
+    ConsumeKeyword(osSQL, iPos, "UPDATE");
+    oStmt.poTable = ParseTable(osSQL, iPos);
+    if (oStmt.poTable == nullptr || !ConsumeKeyword(osSQL, iPos, "SET"))
+        return false;
+    const size_t iWhere = FindKeyword(osSQL, "WHERE", iPos);
+    if (iWhere == std::string::npos)
+        return false;
+    for (const std::string &osItem :
+         SplitList(osSQL.substr(iPos, iWhere - iPos)))
+    {
+        size_t iItem = 0;
+        std::string osIdent;
+        if (!ParseIdentifier(osItem, iItem, osIdent) ||
+            !ConsumeKeyword(osItem, iItem, "=") ||
+            !ConsumeKeyword(osItem, iItem, "?"))
+            return false;
+        const int iColumn = FindColumn(*oStmt.poTable, osIdent);
+        if (iColumn < 0)
+            return false;
+        oStmt.anTargetColumns.push_back(iColumn);
+        oStmt.anTargetParams.push_back(
+            static_cast<int>(oStmt.anTargetParams.size()));
+    }
+    iPos = iWhere + 5;
+    return ParseConjunction(oStmt, iPos, osSQL.size());
+}
+
+bool ParseDelete(StubStmt &oStmt)
+{
+    const std::string &osSQL = oStmt.osSQL;
+    size_t iPos = 0;
+    if (!ConsumeKeyword(osSQL, iPos, "DELETE") ||
+        !ConsumeKeyword(osSQL, iPos, "FROM"))
+        return false;
+    oStmt.poTable = ParseTable(osSQL, iPos);
+    if (oStmt.poTable == nullptr || !ConsumeKeyword(osSQL, iPos, "WHERE"))
+        return false;
+    return ParseConjunction(oStmt, iPos, osSQL.size());
+}
+
+/* Value of a quoted literal following pszKey in the SQL, if any */
+std::string LiteralAfter(const std::string &osSQL, const char *pszKey)
+{
+    const std::string osUpper = ToUpper(osSQL);
+    const size_t iKey = osUpper.find(pszKey);
+    if (iKey == std::string::npos)
+        return std::string();
+    const size_t iStart = osSQL.find('\'', iKey);
+    if (iStart == std::string::npos)
+        return std::string();
+    const size_t iEnd = osSQL.find('\'', iStart + 1);
+    if (iEnd == std::string::npos)
+        return std::string();
+    return osSQL.substr(iStart + 1, iEnd - iStart - 1);
+}
+
+enum
+{
+    CATALOG_NONE,
+    CATALOG_GEOMETRY_COLUMNS,
+    CATALOG_COLUMNS,
+    CATALOG_COLUMN_NAMES,
+    CATALOG_PARAMETER
+};
+
+/* Recognize the catalog queries of the driver, and set the columns of
+ * their results. */
+bool ParseCatalogQuery(StubStmt &oStmt)
+{
+    const std::string osUpper = ToUpper(oStmt.osSQL);
+    std::vector<const char *> apszColumns;
+    if (osUpper.find("SYSGEO2.GEOMETRY_COLUMNS") != std::string::npos &&
+        osUpper.find("UNION ALL") != std::string::npos)
+    {
+        oStmt.nCatalogQuery = CATALOG_GEOMETRY_COLUMNS;
+        apszColumns = {"F_TABLE_SCHEMA",  "F_TABLE_NAME", "F_GEOMETRY_COLUMN",
+                       "TYPE",           "COORD_DIMENSION", "SRID",
+                       "GEOGRAPHY"};
+    }
+    else if (osUpper.find("FROM SYSCOLUMNS C") != std::string::npos &&
+             osUpper.find("JOIN SYSOBJECTS") != std::string::npos)
+    {
+        oStmt.nCatalogQuery = CATALOG_COLUMNS;
+        apszColumns = {"SCHEMA", "TABLE", "NAME", "TYPE$", "NULLABLE$",
+                       "DEFVAL"};
+    }
+    else if (StartsWithCI(oStmt.osSQL, "SELECT NAME FROM SYSCOLUMNS"))
+    {
+        oStmt.nCatalogQuery = CATALOG_COLUMN_NAMES;
+        oStmt.osCatalogTable = LiteralAfter(oStmt.osSQL, "O.NAME =");
+        oStmt.osCatalogSchema = LiteralAfter(oStmt.osSQL, "T.OWNER =");
+        apszColumns = {"NAME"};
+    }
+    else if (osUpper.find("SF_GET_PARA_VALUE") != std::string::npos)
+    {
+        oStmt.nCatalogQuery = CATALOG_PARAMETER;
+        apszColumns = {"VALUE"};
+    }
+    else
+    {
+        return false;
+    }
+
+    for (size_t i = 0; i < apszColumns.size(); i++)
+    {
+        StubResultColumn oColumn;
+        oColumn.osName = apszColumns[i];
+        oColumn.iSource = static_cast<int>(i);
+        oStmt.aoColumns.push_back(oColumn);
+    }
+    return true;
+}
+
+void PrepareStatement(StubStmt &oStmt)
+{
+    oStmt.eKind = StubKind::OTHER;
+    oStmt.bValid = true;
+    oStmt.poTable.reset();
+    oStmt.aoColumns.clear();
+    oStmt.aoPredicates.clear();
+    oStmt.anTargetColumns.clear();
+    oStmt.anTargetParams.clear();
+    oStmt.anParamTypes.clear();
+    oStmt.nLimit = -1;
+    oStmt.nOffset = 0;
+    oStmt.nCatalogQuery = CATALOG_NONE;
+    oStmt.apoResult.clear();
+    oStmt.aaosCatalogRows.clear();
+    oStmt.iNextRow = 0;
+    oStmt.nRowCount = 0;
+    oStmt.aoParams.assign(CountParams(oStmt.osSQL), StubParam());
+
+    if (StartsWithCI(oStmt.osSQL, "SELECT"))
+    {
+        oStmt.eKind = StubKind::ROWS;
+        // Other queries are answered with an empty result set.
+        if (!ParseCatalogQuery(oStmt) && !ParseSelect(oStmt))
+        {
+            oStmt.bValid = oStmt.poTable == nullptr;
+            oStmt.poTable.reset();
+            oStmt.aoColumns.clear();
+            oStmt.aoPredicates.clear();
+        }
+    }
+    else if (StartsWithCI(oStmt.osSQL, "INSERT"))
+    {
+        oStmt.eKind = StubKind::INSERT;
+        if (!ParseInsert(oStmt))
+            oStmt.poTable.reset();
+    }
+    else if (StartsWithCI(oStmt.osSQL, "UPDATE"))
+    {
+        oStmt.eKind = StubKind::UPDATE;
+        if (!ParseUpdate(oStmt))
+            oStmt.poTable.reset();
+    }
+    else if (StartsWithCI(oStmt.osSQL, "DELETE"))
+    {
+        oStmt.eKind = StubKind::DELETE;
+        if (!ParseDelete(oStmt))
+            oStmt.poTable.reset();
+    }
+
+    // Types of the markers that set a column.
+    if (oStmt.poTable != nullptr)
+    {
+        oStmt.anParamTypes.assign(oStmt.aoParams.size(), DSQL_VARCHAR);
+        for (size_t i = 0; i < oStmt.anTargetColumns.size(); i++)
+        {
+            if (oStmt.anTargetParams[i] <
+                static_cast<int>(oStmt.anParamTypes.size()))
+                oStmt.anParamTypes[oStmt.anTargetParams[i]] =
+                    oStmt.poTable->aoColumns[oStmt.anTargetColumns[i]]
+                        .nSQLType;
+        }
+    }
+}
+
+/************************************************************************/
+/*                              Execution                               */
+/************************************************************************/
+
+/* Value of a parameter for one row of the parameter set */
+StubValue GetParamValue(const StubStmt &oStmt, int iParam, ulength iRow)
+{
+    StubValue oValue;
+    if (iParam < 0 || iParam >= static_cast<int>(oStmt.aoParams.size()))
+        return oValue;
+    const StubParam &sParam = oStmt.aoParams[iParam];
+    if (sParam.pBuffer == nullptr ||
+        (sParam.pnInd && sParam.pnInd[iRow] == DSQL_NULL_DATA))
+        return oValue;
+    const char *pabyRow =
+        static_cast<const char *>(sParam.pBuffer) + iRow * sParam.nBufferLength;
+    char szBuf[64];
+    switch (sParam.nCType)
+    {
+        case DSQL_C_SBIGINT:
+            snprintf(szBuf, sizeof(szBuf), "%lld",
+                     *reinterpret_cast<const sdint8 *>(pabyRow));
+            oValue.osData = szBuf;
+            break;
+        case DSQL_C_SLONG:
+            snprintf(szBuf, sizeof(szBuf), "%d",
+                     *reinterpret_cast<const sdint4 *>(pabyRow));
+            oValue.osData = szBuf;
+            break;
+        case DSQL_C_DOUBLE:
+            snprintf(szBuf, sizeof(szBuf), "%.17g",
+                     *reinterpret_cast<const double *>(pabyRow));
+            oValue.osData = szBuf;
+            break;
+        case DSQL_C_CLASS:
+        {
+            const StubObj *psObj =
+                *reinterpret_cast<StubObj *const *>(pabyRow);
+            if (psObj == nullptr || psObj->pValue == nullptr)
+                return oValue;
+            oValue.osData.assign(static_cast<const char *>(psObj->pValue),
+                                 psObj->nLength);
+            break;
+        }
+        default:
+            oValue.osData.assign(
+                pabyRow,
+                strnlen(pabyRow, static_cast<size_t>(sParam.nBufferLength)));
+            // Batched inserts send NULL as an empty string.
+            if (oValue.osData.empty())
+                return oValue;
+            break;
+    }
+    oValue.bNull = false;
+    return oValue;
+}
+
+/* Set the envelope of a value written to a geometry column */
+void ComputeEnvelope(const StubTableColumn &oColumn, StubValue &oValue)
+{
+    oValue.bHasEnvelope = false;
+    const DPIStubEnvelopeFunc pfnEnvelope = gpfnEnvelope.load();
+    if (oColumn.nSQLType != DSQL_CLASS || oValue.bNull ||
+        pfnEnvelope == nullptr)
+        return;
+    oValue.bHasEnvelope =
+        pfnEnvelope(oValue.osData.data(), static_cast<int>(oValue.osData.size()),
+                    oValue.adfEnvelope) != 0;
+}
+
+std::string GetOperand(const StubStmt &oStmt, const StubOperand &oOperand)
+{
+    if (oOperand.iParam < 0)
+        return oOperand.osLiteral;
+    return GetParamValue(oStmt, oOperand.iParam, 0).osData;
+}
+
+/* LIKE pattern matching, with the % and _ wildcards */
+bool MatchLike(const char *pszValue, const char *pszPattern)
+{
+    if (*pszPattern == '\0')
+        return *pszValue == '\0';
+    if (*pszPattern == '%')
+    {
+        for (const char *psz = pszValue;; psz++)
+        {
+            if (MatchLike(psz, pszPattern + 1))
+                return true;
+            if (*psz == '\0')
+                return false;
+        }
+    }
+    if (*pszValue == '\0' ||
+        (*pszPattern != '_' && *pszPattern != *pszValue))
+        return false;
+    return MatchLike(pszValue + 1, pszPattern + 1);
+}
+
+bool MatchRow(const StubStmt &oStmt, const StubRow &oRow)
+{
+    for (const StubPredicate &oPred : oStmt.aoPredicates)
+    {
+        const StubValue &oValue = oRow.aoValues[oPred.iColumn];
+        if (oPred.eKind == StubPredKind::INTERSECTS_ENVELOPE)
+        {
+            if (oValue.bNull)
+                return false;
+            if (!oValue.bHasEnvelope)
+                continue;
+            double adfFilter[4];
+            for (int i = 0; i < 4; i++)
+                adfFilter[i] =
+                    strtod(GetOperand(oStmt, oPred.aoOperands[i]).c_str(),
+                           nullptr);
+            if (oValue.adfEnvelope[0] > adfFilter[2] ||
+                oValue.adfEnvelope[2] < adfFilter[0] ||
+                oValue.adfEnvelope[1] > adfFilter[3] ||
+                oValue.adfEnvelope[3] < adfFilter[1])
+                return false;
+            continue;
+        }
+        if (oPred.eKind == StubPredKind::IS_NULL)
+        {
+            if (!oValue.bNull)
+                return false;
+            continue;
+        }
+        if (oValue.bNull)
+            return false;
+        const StubTableColumn &oColumn =
+            oStmt.poTable->aoColumns[oPred.iColumn];
+        const bool bNumeric = oColumn.nSQLType == DSQL_INT ||
+                              oColumn.nSQLType == DSQL_BIGINT ||
+                              oColumn.nSQLType == DSQL_DOUBLE;
+        const auto Compare = [&oValue, bNumeric](const std::string &osOperand)
+        {
+            if (!bNumeric)
+                return oValue.osData.compare(osOperand);
+            const double dfValue = strtod(oValue.osData.c_str(), nullptr);
+            const double dfOperand = strtod(osOperand.c_str(), nullptr);
+            return dfValue < dfOperand ? -1 : dfValue > dfOperand ? 1 : 0;
+        };
+        const std::string osFirst = GetOperand(oStmt, oPred.aoOperands[0]);
+        bool bMatch = false;
+        switch (oPred.eKind)
+        {
+            case StubPredKind::EQUAL:
+                bMatch = Compare(osFirst) == 0;
+                break;
+            case StubPredKind::NOT_EQUAL:
+                bMatch = Compare(osFirst) != 0;
+                break;
+            case StubPredKind::LESS:
+                bMatch = Compare(osFirst) < 0;
+                break;
+            case StubPredKind::LESS_EQUAL:
+                bMatch = Compare(osFirst) <= 0;
+                break;
+            case StubPredKind::GREATER:
+                bMatch = Compare(osFirst) > 0;
+                break;
+            case StubPredKind::GREATER_EQUAL:
+                bMatch = Compare(osFirst) >= 0;
+                break;
+            case StubPredKind::BETWEEN:
+                bMatch = Compare(osFirst) >= 0 &&
+                         Compare(GetOperand(oStmt, oPred.aoOperands[1])) <= 0;
+                break;
+            case StubPredKind::IN:
+                for (const StubOperand &oOperand : oPred.aoOperands)
+                    bMatch = bMatch || Compare(GetOperand(oStmt, oOperand)) == 0;
+                break;
+            case StubPredKind::LIKE:
+                bMatch = MatchLike(oValue.osData.c_str(), osFirst.c_str());
+                break;
+            default:
+                break;
+        }
+        if (!bMatch)
+            return false;
+    }
+    return true;
+}
+
+/* Rows of the table, taken while holding the lock */
+std::vector<std::shared_ptr<const StubRow>> SnapshotRows(const StubTable &oTable)
+{
+    std::lock_guard<std::mutex> oLock(goTablesMutex);
+    return oTable.apoRows;
+}
+
+void ExecuteCatalogQuery(StubStmt &oStmt)
+{
+    std::lock_guard<std::mutex> oLock(goTablesMutex);
+    for (const auto &poTable : gapoTables)
+    {
+        for (const auto &oColumn : poTable->aoColumns)
+        {
+            const bool bGeometry = oColumn.nSQLType == DSQL_CLASS;
+            if (oStmt.nCatalogQuery == CATALOG_GEOMETRY_COLUMNS && bGeometry)
+            {
+                oStmt.aaosCatalogRows.push_back(
+                    {poTable->osSchema, poTable->osName, oColumn.osName,
+                     "ST_" + oColumn.osType, "2",
+                     std::to_string(oColumn.nSRID),
+                     "0"});
+            }
+            else if (oStmt.nCatalogQuery == CATALOG_COLUMNS)
+            {
+                oStmt.aaosCatalogRows.push_back(
+                    {poTable->osSchema, poTable->osName, oColumn.osName,
+                     bGeometry ? "CLASS" + std::to_string(STUB_GEOMETRY_CLASS_ID)
+                               : oColumn.osType,
+                     &oColumn == &poTable->aoColumns[0] ? "Y" : "N", ""});
+            }
+            else if (oStmt.nCatalogQuery == CATALOG_COLUMN_NAMES &&
+                     EqualCI(poTable->osSchema, oStmt.osCatalogSchema) &&
+                     EqualCI(poTable->osName, oStmt.osCatalogTable))
+            {
+                oStmt.aaosCatalogRows.push_back({oColumn.osName});
+            }
+        }
+    }
+    // GEO2_CONS_CHECK: geometry types are those of GEOMETRY_COLUMNS.
+    if (oStmt.nCatalogQuery == CATALOG_PARAMETER)
+        oStmt.aaosCatalogRows.push_back({"1"});
+    oStmt.nRowCount = static_cast<long long>(oStmt.aaosCatalogRows.size());
+}
+
+void ExecuteSelect(StubStmt &oStmt)
+{
+    oStmt.apoResult.clear();
+    oStmt.iNextRow = 0;
+    if (oStmt.nCatalogQuery != CATALOG_NONE)
+    {
+        ExecuteCatalogQuery(oStmt);
+        return;
+    }
+    if (oStmt.poTable == nullptr)
+    {
+        oStmt.nRowCount = 0;
+        return;
+    }
+
+    const auto apoRows = SnapshotRows(*oStmt.poTable);
+    long long nSkipped = 0;
+    for (const auto &poRow : apoRows)
+    {
+        if (oStmt.nLimit >= 0 &&
+            static_cast<long long>(oStmt.apoResult.size()) >= oStmt.nLimit)
+            break;
+        if (!MatchRow(oStmt, *poRow))
+            continue;
+        if (nSkipped < oStmt.nOffset)
+            nSkipped++;
+        else
+            oStmt.apoResult.push_back(poRow);
+    }
+
+    /* Aggregates are computed into a single row of their own */
+    if (!oStmt.aoColumns.empty() &&
+        oStmt.aoColumns[0].eAggregate != StubAggregate::NONE)
+    {
+        auto poAggregate = std::make_shared<StubRow>();
+        for (const auto &oColumn : oStmt.aoColumns)
+        {
+            StubValue oValue;
+            if (oColumn.eAggregate == StubAggregate::COUNT)
+            {
+                oValue.bNull = false;
+                oValue.osData = std::to_string(oStmt.apoResult.size());
+            }
+            for (const auto &poRow : oStmt.apoResult)
+            {
+                if (oColumn.eAggregate == StubAggregate::COUNT)
+                    break;
+                const StubValue &oRowValue = poRow->aoValues[oColumn.iSource];
+                if (oRowValue.bNull)
+                    continue;
+                const double dfValue = strtod(oRowValue.osData.c_str(), nullptr);
+                const double dfCur = strtod(oValue.osData.c_str(), nullptr);
+                if (oValue.bNull ||
+                    (oColumn.eAggregate == StubAggregate::MIN ? dfValue < dfCur
+                                                              : dfValue > dfCur))
+                    oValue = oRowValue;
+            }
+            poAggregate->aoValues.push_back(oValue);
+        }
+        oStmt.apoResult.assign(1, poAggregate);
+        for (size_t i = 0; i < oStmt.aoColumns.size(); i++)
+            oStmt.aoColumns[i].iSource = static_cast<int>(i);
+    }
+    oStmt.nRowCount = static_cast<long long>(oStmt.apoResult.size());
+}
+
+void ExecuteInsert(StubStmt &oStmt)
+{
+    StubTable &oTable = *oStmt.poTable;
+    std::vector<std::shared_ptr<const StubRow>> apoNewRows;
+    for (ulength iRow = 0; iRow < oStmt.nParamSetSize; iRow++)
+    {
+        auto poRow = std::make_shared<StubRow>();
+        poRow->aoValues.resize(oTable.aoColumns.size());
+        for (size_t i = 0; i < oStmt.anTargetColumns.size(); i++)
+        {
+            const int iColumn = oStmt.anTargetColumns[i];
+            poRow->aoValues[iColumn] =
+                GetParamValue(oStmt, oStmt.anTargetParams[i], iRow);
+            ComputeEnvelope(oTable.aoColumns[iColumn],
+                            poRow->aoValues[iColumn]);
+        }
+        apoNewRows.push_back(poRow);
+    }
+
+    std::lock_guard<std::mutex> oLock(goTablesMutex);
+    for (auto &poNewRow : apoNewRows)
+    {
+        // The first column is the identity column.
+        StubValue &oFID = const_cast<StubRow *>(poNewRow.get())->aoValues[0];
+        if (oFID.bNull)
+        {
+            oFID.bNull = false;
+            oFID.osData = std::to_string(oTable.nNextFID++);
+        }
+        else
+        {
+            oTable.nNextFID =
+                std::max(oTable.nNextFID, atoll(oFID.osData.c_str()) + 1);
+        }
+        oTable.apoRows.push_back(std::move(poNewRow));
+    }
+    oStmt.nRowCount = static_cast<long long>(apoNewRows.size());
+}
+
+void ExecuteUpdateOrDelete(StubStmt &oStmt)
+{
+    StubTable &oTable = *oStmt.poTable;
+    std::lock_guard<std::mutex> oLock(goTablesMutex);
+    long long nChanged = 0;
+    std::vector<std::shared_ptr<const StubRow>> apoKept;
+    apoKept.reserve(oTable.apoRows.size());
+    for (auto &poRow : oTable.apoRows)
+    {
+        if (!MatchRow(oStmt, *poRow))
+        {
+            apoKept.push_back(poRow);
+            continue;
+        }
+        nChanged++;
+        if (oStmt.eKind == StubKind::DELETE)
+            continue;
+
+        // Rows are shared with pending result sets: replace, don't modify.
+        auto poNewRow = std::make_shared<StubRow>(*poRow);
+        for (size_t i = 0; i < oStmt.anTargetColumns.size(); i++)
+        {
+            const int iColumn = oStmt.anTargetColumns[i];
+            poNewRow->aoValues[iColumn] =
+                GetParamValue(oStmt, oStmt.anTargetParams[i], 0);
+            ComputeEnvelope(oTable.aoColumns[iColumn],
+                            poNewRow->aoValues[iColumn]);
+        }
+        apoKept.push_back(std::move(poNewRow));
+    }
+    oTable.apoRows = std::move(apoKept);
+    oStmt.nRowCount = nChanged;
+    gnRowsUpdated += nChanged;
+}
+
+/* Walk the bound parameter arrays as the real client would when
+ * marshalling a batch, so that the benchmark pays for reading them. */
+void ConsumeParams(StubStmt *psStmt)
+{
+    long long nBytes = 0;
+    for (const StubParam &sParam : psStmt->aoParams)
+    {
+        if (sParam.pBuffer == nullptr)
+            continue;
+        for (ulength iRow = 0; iRow < psStmt->nParamSetSize; iRow++)
+        {
+            const char *pabyRow = static_cast<const char *>(sParam.pBuffer) +
+                                  iRow * sParam.nBufferLength;
+            if (sParam.nCType == DSQL_C_CLASS)
+            {
+                const StubObj *psObj =
+                    *reinterpret_cast<StubObj *const *>(pabyRow);
+                if (psObj)
+                    nBytes += psObj->nLength;
+            }
+            else if (sParam.nCType == DSQL_C_NCHAR)
+            {
+                nBytes += static_cast<long long>(
+                    strnlen(pabyRow, static_cast<size_t>(sParam.nBufferLength)));
+            }
+            else
+            {
+                nBytes += sParam.nBufferLength;
+            }
+        }
+    }
+    gnBytesSent += nBytes;
+}
+
+DPIRETURN ExecuteStatement(StubStmt *psStmt)
+{
+    RoundTrip();
+    gnExecutions++;
+    if (!psStmt->bValid)
+        return DSQL_ERROR;
+    psStmt->nRowCount = 0;
+    switch (psStmt->eKind)
+    {
+        case StubKind::ROWS:
+            ExecuteSelect(*psStmt);
+            break;
+        case StubKind::INSERT:
+            ConsumeParams(psStmt);
+            gnRowsInserted += static_cast<long long>(psStmt->nParamSetSize);
+            // Inserts into tables that are not registered are only counted.
+            if (psStmt->poTable != nullptr)
+                ExecuteInsert(*psStmt);
+            else
+                psStmt->nRowCount =
+                    static_cast<long long>(psStmt->nParamSetSize);
+            break;
+        case StubKind::UPDATE:
+        case StubKind::DELETE:
+            ConsumeParams(psStmt);
+            if (psStmt->poTable != nullptr)
+                ExecuteUpdateOrDelete(*psStmt);
+            break;
+        case StubKind::OTHER:
+            break;
+    }
+    return DSQL_SUCCESS;
+}
+
+/************************************************************************/
+/*                           Fetching a row                             */
+/************************************************************************/
+
+/* Text of a value as the C types of dpi_bind_col() expect it */
+void ParseTimestamp(const std::string &osValue, dpi_timestamp_t *psTS)
+{
+    int nYear = 0, nMonth = 0, nDay = 0, nHour = 0, nMinute = 0;
+    double dfSecond = 0;
+    sscanf(osValue.c_str(), "%d-%d-%d %d:%d:%lf", &nYear, &nMonth, &nDay,
+           &nHour, &nMinute, &dfSecond);
+    psTS->year = static_cast<sdint2>(nYear);
+    psTS->month = static_cast<udint2>(nMonth);
+    psTS->day = static_cast<udint2>(nDay);
+    psTS->hour = static_cast<udint2>(nHour);
+    psTS->minute = static_cast<udint2>(nMinute);
+    psTS->second = static_cast<udint2>(dfSecond);
+    psTS->fraction =
+        static_cast<udint4>((dfSecond - static_cast<int>(dfSecond)) * 1e9);
+}
+
+void WriteValue(const StubBoundCol &oCol, ulength iRow, const StubValue &oValue)
+{
+    const slength nStride =
+        oCol.nBufferLength > 0 ? oCol.nBufferLength
+                               : static_cast<slength>(sizeof(dhandle));
+    char *pabyRow = static_cast<char *>(oCol.pBuffer) + iRow * nStride;
+    slength nInd = oValue.bNull ? DSQL_NULL_DATA
+                                : static_cast<slength>(oValue.osData.size());
+
+    switch (oCol.nCType)
+    {
+        case DSQL_C_CLASS:
+        {
+            StubObj *psObj = *reinterpret_cast<StubObj **>(pabyRow);
+            if (psObj)
+            {
+                psObj->pValue = oValue.bNull ? nullptr : oValue.osData.data();
+                psObj->nLength = static_cast<udint4>(oValue.osData.size());
+            }
+            break;
+        }
+        case DSQL_C_LOB_HANDLE:
+        {
+            StubLob *psLob = *reinterpret_cast<StubLob **>(pabyRow);
+            if (psLob)
+            {
+                psLob->pabyData = oValue.osData.data();
+                psLob->nLength = oValue.bNull
+                                     ? -1
+                                     : static_cast<slength>(oValue.osData.size());
+            }
+            break;
+        }
+        case DSQL_C_SLONG:
+            if (!oValue.bNull)
+                *reinterpret_cast<sdint4 *>(pabyRow) =
+                    static_cast<sdint4>(atoll(oValue.osData.c_str()));
+            nInd = sizeof(sdint4);
+            break;
+        case DSQL_C_SBIGINT:
+            if (!oValue.bNull)
+                *reinterpret_cast<sdint8 *>(pabyRow) =
+                    atoll(oValue.osData.c_str());
+            nInd = sizeof(sdint8);
+            break;
+        case DSQL_C_DOUBLE:
+            if (!oValue.bNull)
+                *reinterpret_cast<double *>(pabyRow) =
+                    strtod(oValue.osData.c_str(), nullptr);
+            nInd = sizeof(double);
+            break;
+        case DSQL_C_TIMESTAMP:
+            if (!oValue.bNull)
+                ParseTimestamp(oValue.osData,
+                               reinterpret_cast<dpi_timestamp_t *>(pabyRow));
+            nInd = sizeof(dpi_timestamp_t);
+            break;
+        default:
+        {
+            const size_t nMax =
+                oCol.nBufferLength > 0
+                    ? static_cast<size_t>(oCol.nBufferLength) - 1
+                    : 0;
+            const size_t nLen = std::min(nMax, oValue.osData.size());
+            memcpy(pabyRow, oValue.osData.data(), nLen);
+            if (oCol.nBufferLength > 0)
+                pabyRow[nLen] = '\0';
+            nInd = static_cast<slength>(nLen);
+            break;
+        }
+    }
+    if (oValue.bNull)
+        nInd = DSQL_NULL_DATA;
+    if (oCol.pnInd)
+        oCol.pnInd[iRow] = nInd;
+}
+
+}  // namespace
+
+/************************************************************************/
+/*                          Control interface                           */
+/************************************************************************/
+
+void DPIStubSetRoundTripMicroSec(int nMicroSec)
+{
+    gnRoundTripMicroSec = std::max(0, nMicroSec);
+}
+
+void DPIStubSetClassParamCount(int nCount)
+{
+    gnClassParamCount = std::max(0, nCount);
+}
+
+void DPIStubResetStats()
+{
+    gnExecutions = 0;
+    gnPrepares = 0;
+    gnLogins = 0;
+    gnRowsInserted = 0;
+    gnCommits = 0;
+    gnBytesSent = 0;
+    gnFetches = 0;
+    gnRowsFetched = 0;
+    gnRowsUpdated = 0;
+}
+
+DPIStubStats DPIStubGetStats()
+{
+    DPIStubStats sStats;
+    sStats.nExecutions = gnExecutions.load();
+    sStats.nPrepares = gnPrepares.load();
+    sStats.nLogins = gnLogins.load();
+    sStats.nRowsInserted = gnRowsInserted.load();
+    sStats.nCommits = gnCommits.load();
+    sStats.nBytesSent = gnBytesSent.load();
+    sStats.nFetches = gnFetches.load();
+    sStats.nRowsFetched = gnRowsFetched.load();
+    sStats.nRowsUpdated = gnRowsUpdated.load();
+    return sStats;
+}
+
+int DPIStubCreateTable(const char *pszSchema, const char *pszTable,
+                       const char *pszColumns)
+{
+    auto poTable = std::make_shared<StubTable>();
+    poTable->osSchema = pszSchema;
+    poTable->osName = pszTable;
+
+    std::string osColumns(pszColumns);
+    for (const std::string &osItem : SplitList(osColumns))
+    {
+        size_t iPos = 0;
+        StubTableColumn oColumn;
+        std::string osType;
+        if (!ParseIdentifier(osItem, iPos, oColumn.osName) ||
+            !ParseIdentifier(osItem, iPos, osType))
+            return -1;
+        oColumn.osType = ToUpper(osType);
+        if (oColumn.osType == "INT" || oColumn.osType == "INTEGER")
+        {
+            oColumn.nSQLType = DSQL_INT;
+            oColumn.nPrec = 10;
+        }
+        else if (oColumn.osType == "BIGINT")
+        {
+            oColumn.nSQLType = DSQL_BIGINT;
+            oColumn.nPrec = 19;
+        }
+        else if (oColumn.osType == "DOUBLE")
+        {
+            oColumn.nSQLType = DSQL_DOUBLE;
+            oColumn.nPrec = 53;
+        }
+        else if (oColumn.osType == "VARCHAR")
+        {
+            oColumn.nSQLType = DSQL_VARCHAR;
+            oColumn.nPrec = 256;
+        }
+        else if (oColumn.osType == "TIMESTAMP")
+        {
+            oColumn.nSQLType = DSQL_TIMESTAMP;
+            oColumn.nPrec = 26;
+        }
+        else if (oColumn.osType == "BLOB")
+            oColumn.nSQLType = DSQL_BLOB;
+        else if (oColumn.osType == "CLOB")
+            oColumn.nSQLType = DSQL_CLOB;
+        else
+        {
+            // Geometry column, with an optional SRID
+            oColumn.nSQLType = DSQL_CLASS;
+            std::string osSRID;
+            if (ParseIdentifier(osItem, iPos, osSRID))
+                oColumn.nSRID = atoi(osSRID.c_str());
+        }
+        poTable->aoColumns.push_back(oColumn);
+    }
+    if (poTable->aoColumns.empty() ||
+        (poTable->aoColumns[0].nSQLType != DSQL_INT &&
+         poTable->aoColumns[0].nSQLType != DSQL_BIGINT))
+        return -1;
+
+    std::lock_guard<std::mutex> oLock(goTablesMutex);
+    for (auto &poOther : gapoTables)
+    {
+        if (EqualCI(poOther->osSchema, pszSchema) &&
+            EqualCI(poOther->osName, pszTable))
+        {
+            poOther = poTable;
+            return 0;
+        }
+    }
+    gapoTables.push_back(poTable);
+    return 0;
+}
+
+void DPIStubDropTables(void)
+{
+    std::lock_guard<std::mutex> oLock(goTablesMutex);
+    gapoTables.clear();
+}
+
+long long DPIStubGetTableRowCount(const char *pszSchema, const char *pszTable)
+{
+    std::lock_guard<std::mutex> oLock(goTablesMutex);
+    for (const auto &poTable : gapoTables)
+    {
+        if (EqualCI(poTable->osSchema, pszSchema) &&
+            EqualCI(poTable->osName, pszTable))
+            return static_cast<long long>(poTable->apoRows.size());
+    }
+    return -1;
+}
+
+void DPIStubSetEnvelopeFunc(DPIStubEnvelopeFunc pfnEnvelope)
+{
+    gpfnEnvelope = pfnEnvelope;
+}
+
+/************************************************************************/
+/*                       Environment and connection                     */
+/************************************************************************/
+
+DPIRETURN dpi_alloc_env(dhenv *env)
+{
+    *env = new int(0);
+    return DSQL_SUCCESS;
+}
+
+DPIRETURN dpi_free_env(dhenv env)
+{
+    delete static_cast<int *>(env);
+    return DSQL_SUCCESS;
+}
+
+DPIRETURN dpi_alloc_con(dhenv, dhcon *con)
+{
+    *con = new int(0);
+    return DSQL_SUCCESS;
+}
+
+DPIRETURN dpi_free_con(dhcon con)
+{
+    delete static_cast<int *>(con);
+    return DSQL_SUCCESS;
+}
+
+DPIRETURN dpi_login(dhcon, sdbyte *, sdbyte *, sdbyte *)
+{
+    gnLogins++;
+    RoundTrip();
+    return DSQL_SUCCESS;
+}
+
+DPIRETURN dpi_logout(dhcon)
+{
+    return DSQL_SUCCESS;
+}
+
+DPIRETURN dpi_set_con_attr(dhcon, sdint4, dpointer, sdint4)
+{
+    return DSQL_SUCCESS;
+}
+
+DPIRETURN dpi_commit(dhcon)
+{
+    RoundTrip();
+    gnCommits++;
+    return DSQL_SUCCESS;
+}
+
+DPIRETURN dpi_rollback(dhcon)
+{
+    RoundTrip();
+    return DSQL_SUCCESS;
+}
+
+/************************************************************************/
+/*                              Statements                              */
+/************************************************************************/
+
+DPIRETURN dpi_alloc_stmt(dhcon, dhstmt *stmt)
+{
+    *stmt = new StubStmt();
+    return DSQL_SUCCESS;
+}
+
+DPIRETURN dpi_free_stmt(dhstmt stmt)
+{
+    delete static_cast<StubStmt *>(stmt);
+    return DSQL_SUCCESS;
+}
+
+DPIRETURN dpi_prepare(dhstmt stmt, sdbyte *sql_txt)
+{
+    StubStmt *psStmt = static_cast<StubStmt *>(stmt);
+    psStmt->osSQL = reinterpret_cast<const char *>(sql_txt);
+    PrepareStatement(*psStmt);
+    gnPrepares++;
+    return psStmt->bValid ? DSQL_SUCCESS : DSQL_ERROR;
+}
+
+DPIRETURN dpi_exec(dhstmt stmt)
+{
+    return ExecuteStatement(static_cast<StubStmt *>(stmt));
+}
+
+DPIRETURN dpi_exec_direct(dhstmt stmt, sdbyte *sql_txt)
+{
+    StubStmt *psStmt = static_cast<StubStmt *>(stmt);
+    psStmt->osSQL = reinterpret_cast<const char *>(sql_txt);
+    PrepareStatement(*psStmt);
+    return ExecuteStatement(psStmt);
+}
+
+DPIRETURN dpi_close_cursor(dhstmt stmt)
+{
+    StubStmt *psStmt = static_cast<StubStmt *>(stmt);
+    psStmt->apoResult.clear();
+    psStmt->aaosCatalogRows.clear();
+    psStmt->iNextRow = 0;
+    return DSQL_SUCCESS;
+}
+
+DPIRETURN dpi_set_stmt_attr(dhstmt stmt, sdint4 attr_id, dpointer val, sdint4)
+{
+    StubStmt *psStmt = static_cast<StubStmt *>(stmt);
+    if (attr_id == DSQL_ATTR_PARAMSET_SIZE)
+        psStmt->nParamSetSize = static_cast<ulength>(
+            reinterpret_cast<size_t>(val));
+    else if (attr_id == DSQL_ATTR_ROW_ARRAY_SIZE)
+        psStmt->nRowArraySize = std::max<ulength>(
+            1, static_cast<ulength>(reinterpret_cast<size_t>(val)));
+    return DSQL_SUCCESS;
+}
+
+DPIRETURN dpi_get_stmt_attr(dhstmt stmt, sdint4, dpointer val, sdint4,
+                            sdint4 *val_len)
+{
+    /* Descriptors are represented by the statement itself. */
+    *static_cast<dhdesc *>(val) = stmt;
+    if (val_len)
+        *val_len = static_cast<sdint4>(sizeof(dhdesc));
+    return DSQL_SUCCESS;
+}
+
+DPIRETURN dpi_number_columns(dhstmt stmt, sdint2 *col_cnt)
+{
+    *col_cnt = static_cast<sdint2>(
+        static_cast<StubStmt *>(stmt)->aoColumns.size());
+    return DSQL_SUCCESS;
+}
+
+DPIRETURN dpi_number_params(dhstmt stmt, udint2 *param_cnt)
+{
+    *param_cnt = static_cast<udint2>(
+        static_cast<StubStmt *>(stmt)->aoParams.size());
+    return DSQL_SUCCESS;
+}
+
+DPIRETURN dpi_desc_column(dhstmt stmt, sdint2 icol, sdbyte *name,
+                          sdint2 buf_len, sdint2 *name_len, sdint2 *sqltype,
+                          ulength *col_sz, sdint2 *dec_digits,
+                          sdint2 *nullable)
+{
+    const StubStmt *psStmt = static_cast<const StubStmt *>(stmt);
+    if (icol < 1 || icol > static_cast<sdint2>(psStmt->aoColumns.size()))
+        return DSQL_ERROR;
+    const StubResultColumn &oColumn = psStmt->aoColumns[icol - 1];
+    if (name && buf_len > 0)
+    {
+        const size_t nLen = std::min(oColumn.osName.size(),
+                                     static_cast<size_t>(buf_len - 1));
+        memcpy(name, oColumn.osName.c_str(), nLen);
+        name[nLen] = 0;
+        if (name_len)
+            *name_len = static_cast<sdint2>(nLen);
+    }
+    if (sqltype)
+        *sqltype = oColumn.nSQLType;
+    if (col_sz)
+        *col_sz = oColumn.nPrec;
+    if (dec_digits)
+        *dec_digits = 0;
+    if (nullable)
+        *nullable = 1;
+    return DSQL_SUCCESS;
+}
+
+DPIRETURN dpi_desc_param(dhstmt stmt, udint2 iparam, sdint2 *sql_type,
+                         ulength *prec, sdint2 *scale, sdint2 *nullable)
+{
+    const StubStmt *psStmt = static_cast<const StubStmt *>(stmt);
+    if (iparam >= 1 && iparam <= psStmt->anParamTypes.size())
+    {
+        // Marker setting a column of a registered table
+        *sql_type = psStmt->anParamTypes[iparam - 1];
+        *prec = *sql_type == DSQL_CLASS ? 0 : 50;
+    }
+    else if (iparam <= gnClassParamCount.load())
+    {
+        *sql_type = DSQL_CLASS;
+        *prec = 0;
+    }
+    else
+    {
+        *sql_type = DSQL_VARCHAR;
+        *prec = 50;
+    }
+    *scale = 0;
+    *nullable = 1;
+    return DSQL_SUCCESS;
+}
+
+DPIRETURN dpi_col_attr(dhstmt stmt, udint2 icol, udint2 fldid,
+                       dpointer chr_attr, sdint2 buf_len, sdint2 *chr_attr_len,
+                       slength *num_attr)
+{
+    const StubStmt *psStmt = static_cast<const StubStmt *>(stmt);
+    std::string osValue;
+    if (icol >= 1 && icol <= psStmt->aoColumns.size())
+    {
+        if (fldid == DSQL_DESC_BASE_COLUMN_NAME)
+            osValue = psStmt->aoColumns[icol - 1].osName;
+        else if (fldid == DSQL_DESC_BASE_TABLE_NAME && psStmt->poTable)
+            osValue = psStmt->poTable->osName;
+        else if (fldid == DSQL_DESC_SCHEMA_NAME && psStmt->poTable)
+            osValue = psStmt->poTable->osSchema;
+    }
+    if (chr_attr && buf_len > 0)
+    {
+        const size_t nLen =
+            std::min(osValue.size(), static_cast<size_t>(buf_len - 1));
+        memcpy(chr_attr, osValue.c_str(), nLen);
+        static_cast<char *>(chr_attr)[nLen] = 0;
+    }
+    if (chr_attr_len)
+        *chr_attr_len = static_cast<sdint2>(osValue.size());
+    if (num_attr)
+        *num_attr = 0;
+    return DSQL_SUCCESS;
+}
+
+DPIRETURN dpi_bind_param(dhstmt stmt, udint2 iparam, sdint2, sdint2 ctype,
+                         sdint2, ulength, sdint2, dpointer buf,
+                         slength buf_len, slength *ind_ptr)
+{
+    StubStmt *psStmt = static_cast<StubStmt *>(stmt);
+    if (iparam == 0 || iparam > psStmt->aoParams.size())
+        return DSQL_ERROR;
+    StubParam &sParam = psStmt->aoParams[iparam - 1];
+    sParam.nCType = ctype;
+    sParam.pBuffer = buf;
+    sParam.nBufferLength = buf_len;
+    sParam.pnInd = ind_ptr;
+    return DSQL_SUCCESS;
+}
+
+DPIRETURN dpi_bind_col(dhstmt stmt, udint2 icol, sdint2 ctype, dpointer val,
+                       slength buf_len, slength *ind)
+{
+    StubStmt *psStmt = static_cast<StubStmt *>(stmt);
+    if (icol == 0 || icol > psStmt->aoColumns.size())
+        return DSQL_ERROR;
+    if (psStmt->aoBoundCols.size() < psStmt->aoColumns.size())
+        psStmt->aoBoundCols.resize(psStmt->aoColumns.size());
+    StubBoundCol &oCol = psStmt->aoBoundCols[icol - 1];
+    oCol.nCType = ctype;
+    oCol.pBuffer = val;
+    oCol.nBufferLength = buf_len;
+    oCol.pnInd = ind;
+    return DSQL_SUCCESS;
+}
+
+DPIRETURN dpi_fetch(dhstmt stmt, ulength *row_num)
+{
+    StubStmt *psStmt = static_cast<StubStmt *>(stmt);
+    const bool bCatalog = psStmt->nCatalogQuery != CATALOG_NONE;
+    const size_t nTotal = bCatalog ? psStmt->aaosCatalogRows.size()
+                                   : psStmt->apoResult.size();
+    const ulength nRows = std::min<ulength>(psStmt->nRowArraySize,
+                                            nTotal - psStmt->iNextRow);
+    if (row_num)
+        *row_num = nRows;
+    if (nRows == 0)
+        return DSQL_NO_DATA;
+
+    RoundTrip();
+    gnFetches++;
+    gnRowsFetched += static_cast<long long>(nRows);
+    psStmt->aoBoundCols.resize(psStmt->aoColumns.size());
+    StubValue oCatalogValue;
+    for (ulength iRow = 0; iRow < nRows; iRow++)
+    {
+        const size_t iResultRow = psStmt->iNextRow + iRow;
+        for (size_t iCol = 0; iCol < psStmt->aoColumns.size(); iCol++)
+        {
+            const StubBoundCol &oCol = psStmt->aoBoundCols[iCol];
+            if (oCol.pBuffer == nullptr)
+                continue;
+            const int iSource = psStmt->aoColumns[iCol].iSource;
+            if (bCatalog)
+            {
+                oCatalogValue.bNull = false;
+                oCatalogValue.osData =
+                    psStmt->aaosCatalogRows[iResultRow][iSource];
+                WriteValue(oCol, iRow, oCatalogValue);
+            }
+            else
+            {
+                WriteValue(oCol, iRow,
+                           psStmt->apoResult[iResultRow]->aoValues[iSource]);
+            }
+        }
+    }
+    psStmt->iNextRow += nRows;
+    return DSQL_SUCCESS;
+}
+
+DPIRETURN dpi_row_count(dhstmt stmt, sdint8 *row_num)
+{
+    *row_num = static_cast<sdint8>(static_cast<StubStmt *>(stmt)->nRowCount);
+    return DSQL_SUCCESS;
+}
+
+DPIRETURN dpi_get_desc_field(dhdesc desc, sdint2 rec_num, sdint2 field,
+                             dpointer val, sdint4, sdint4 *)
+{
+    if (field == DSQL_DESC_OBJ_DESCRIPTOR)
+        *static_cast<dhobjdesc *>(val) = &gnDummyObjDesc;
+    else if (field == DSQL_DESC_DISPLAY_SIZE)
+    {
+        // Descriptors are represented by the statement itself.
+        const StubStmt *psStmt = static_cast<const StubStmt *>(desc);
+        slength nSize = 128;
+        if (rec_num >= 1 &&
+            rec_num <= static_cast<sdint2>(psStmt->aoColumns.size()))
+            nSize = static_cast<slength>(
+                std::max<ulength>(psStmt->aoColumns[rec_num - 1].nPrec, 24));
+        *static_cast<slength *>(val) = nSize;
+    }
+    return DSQL_SUCCESS;
+}
+
+DPIRETURN dpi_get_diag_field(sdint2, dhandle hndl, sdint2, sdint2 diag_id,
+                             dpointer diag_info, slength, slength *info_len)
+{
+    if (diag_id == DSQL_DIAG_DYNAMIC_FUNCTION_CODE)
+    {
+        StubStmt *psStmt = static_cast<StubStmt *>(hndl);
+        *static_cast<sdint4 *>(diag_info) = psStmt->eKind == StubKind::ROWS
+                                                ? DSQL_DIAG_FUNC_CODE_SELECT
+                                                : 0;
+    }
+    if (info_len)
+        *info_len = static_cast<slength>(sizeof(sdint4));
+    return DSQL_SUCCESS;
+}
+
+/************************************************************************/
+/*                           Objects and LOBs                           */
+/************************************************************************/
+
+DPIRETURN dpi_alloc_obj(dhcon, dhobj *obj)
+{
+    *obj = new StubObj();
+    return DSQL_SUCCESS;
+}
+
+DPIRETURN dpi_free_obj(dhobj obj)
+{
+    delete static_cast<StubObj *>(obj);
+    return DSQL_SUCCESS;
+}
+
+DPIRETURN dpi_free_obj_desc(dhobjdesc)
+{
+    return DSQL_SUCCESS;
+}
+
+DPIRETURN dpi_bind_obj_desc(dhobj, dhobjdesc)
+{
+    return DSQL_SUCCESS;
+}
+
+DPIRETURN dpi_set_obj_val(dhobj obj, udint4, udint2, dpointer val,
+                          udint4 val_len)
+{
+    StubObj *psObj = static_cast<StubObj *>(obj);
+    psObj->pValue = val;
+    psObj->nLength = val_len;
+    return DSQL_SUCCESS;
+}
+
+DPIRETURN dpi_get_obj_val(dhobj obj, udint4, udint2, dpointer val,
+                          udint4 buf_len, slength *len)
+{
+    const StubObj *psObj = static_cast<const StubObj *>(obj);
+    if (psObj->pValue == nullptr)
+        return DSQL_ERROR;
+    if (val && buf_len > 0)
+        memcpy(val, psObj->pValue, std::min(buf_len, psObj->nLength));
+    if (len)
+        *len = psObj->nLength;
+    return DSQL_SUCCESS;
+}
+
+DPIRETURN dpi_alloc_lob_locator(dhstmt, dhloblctr *loblctr)
+{
+    *loblctr = new StubLob();
+    return DSQL_SUCCESS;
+}
+
+DPIRETURN dpi_free_lob_locator(dhloblctr loblctr)
+{
+    delete static_cast<StubLob *>(loblctr);
+    return DSQL_SUCCESS;
+}
+
+DPIRETURN dpi_lob_get_length(dhloblctr loblctr, slength *len)
+{
+    *len = static_cast<const StubLob *>(loblctr)->nLength;
+    return DSQL_SUCCESS;
+}
+
+DPIRETURN dpi_lob_read(dhloblctr loblctr, ulength start_pos, sdint2 ctype,
+                       slength data_to_read, dpointer val_buf, slength buf_len,
+                       slength *data_get)
+{
+    const StubLob *psLob = static_cast<const StubLob *>(loblctr);
+    const slength nStart = static_cast<slength>(start_pos > 0 ? start_pos - 1 : 0);
+    if (psLob->nLength < 0 || nStart >= psLob->nLength)
+    {
+        if (data_get)
+            *data_get = 0;
+        return DSQL_NO_DATA;
+    }
+    // Character data is returned NUL terminated.
+    const slength nRoom = ctype == DSQL_C_NCHAR ? buf_len - 1 : buf_len;
+    slength nCopy = std::min(std::max<slength>(nRoom, 0),
+                             psLob->nLength - nStart);
+    // Zero reads up to the end of the value.
+    if (data_to_read > 0)
+        nCopy = std::min(nCopy, data_to_read);
+    memcpy(val_buf, psLob->pabyData + nStart, static_cast<size_t>(nCopy));
+    if (ctype == DSQL_C_NCHAR && buf_len > 0)
+        static_cast<char *>(val_buf)[nCopy] = '\0';
+    if (data_get)
+        *data_get = nCopy;
+    return DSQL_SUCCESS;
+}
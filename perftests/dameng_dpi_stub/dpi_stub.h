@@ -0,0 +1,66 @@
+/******************************************************************************
+ *
+ * Project:  GDAL Performance Tests
+ * Purpose:  Control interface of the DaMeng DPI stand-in.
+ * Author:   YiLun Wu, wuyilun@dameng.com
+ *
+ ******************************************************************************
+ * Copyright (c) 2026, YiLun Wu
+ *
+ * SPDX-License-Identifier: MIT
+ ****************************************************************************/
+
+#ifndef DPI_STUB_CONTROL_H_INCLUDED
+#define DPI_STUB_CONTROL_H_INCLUDED
+
+typedef struct
+{
+    long long nExecutions; /* dpi_exec / dpi_exec_direct calls */
+    long long nPrepares;   /* dpi_prepare calls */
+    long long nLogins;     /* dpi_login calls */
+    long long nRowsInserted;
+    long long nCommits;
+    long long nBytesSent; /* parameter payload seen by dpi_exec */
+    long long nFetches;   /* dpi_fetch calls that returned rows */
+    long long nRowsFetched;
+    long long nRowsUpdated; /* rows changed by UPDATE and DELETE */
+} DPIStubStats;
+
+/* Simulated client/server round trip, applied to every dpi_exec(),
+ * dpi_exec_direct(), dpi_commit() and to every block of rows returned
+ * by dpi_fetch(). */
+void DPIStubSetRoundTripMicroSec(int nMicroSec);
+
+/* Register an in-memory table, which the catalog queries of the driver
+ * report and its SELECT, INSERT, UPDATE and DELETE statements work on.
+ * pszColumns lists "name type" pairs separated by commas. The type is
+ * INT, BIGINT, DOUBLE, VARCHAR, TIMESTAMP, BLOB, CLOB or an OGC geometry
+ * type name, optionally followed by a SRID, for a geometry column. The
+ * first column must be the integer identity column used as FID.
+ * Returns 0 on success. */
+int DPIStubCreateTable(const char *pszSchema, const char *pszTable,
+                       const char *pszColumns);
+
+/* Drop all in-memory tables. */
+void DPIStubDropTables(void);
+
+/* Number of rows of an in-memory table, or -1 if it does not exist. */
+long long DPIStubGetTableRowCount(const char *pszSchema, const char *pszTable);
+
+/* Function computing the envelope (minx, miny, maxx, maxy) of a
+ * serialized geometry, returning 0 if it has none. It is called when
+ * geometries are written, and lets ST_Intersects() predicates with an
+ * envelope filter rows. Without it, such predicates keep all rows. */
+typedef int (*DPIStubEnvelopeFunc)(const void *pData, int nLength,
+                                   double *padfEnvelope);
+void DPIStubSetEnvelopeFunc(DPIStubEnvelopeFunc pfnEnvelope);
+
+/* Number of leading parameters of a prepared statement that dpi_desc_param()
+ * reports as DSQL_CLASS (geometry) parameters, for statements that do not
+ * write to an in-memory table. */
+void DPIStubSetClassParamCount(int nCount);
+
+void DPIStubResetStats();
+DPIStubStats DPIStubGetStats();
+
+#endif /* DPI_STUB_CONTROL_H_INCLUDED */
@@ -708,6 +708,7 @@ constexpr static const char* const apszKnownConfigOptions[] =
    "OGR_ARROW_READ_GDAL_FOOTER", // from ogrfeatherlayer.cpp
    "OGR_ARROW_REGISTER_GEOARROW_WKB_EXTENSION", // from ogrfeatherdriver.cpp
    "OGR_ARROW_USE_VSI", // from ogrfeatherdriver.cpp
+   "OGR_ARROW_VECTORIZED_FILTER", // from ogrlayerarrow.cpp
    "OGR_ARROW_WRITE_BBOX", // from ogrfeatherwriterlayer.cpp
    "OGR_ARROW_WRITE_GDAL_FOOTER", // from ogrfeatherwriterlayer.cpp
    "OGR_ARROW_WRITE_GDAL_GEOMETRY_TYPE", // from ogrfeatherwriterlayer.cpp
@@ -824,7 +825,10 @@ constexpr static const char* const apszKnownConfigOptions[] =
    "OGR_SHAPE_PACK_IN_PLACE", // from ogrshapedatasource.cpp, ogrshapelayer.cpp
    "OGR_SHAPE_USE_VSIMEM_FOR_TEMP", // from ogrshapedatasource.cpp
    "OGR_SKIP", // from gdaldrivermanager.cpp
+   "OGR_SQL_GROUP_BY_MAX_MEMORY", // from ogr_gensql.cpp
+   "OGR_SQL_HASH_JOIN_MAX_MEMORY", // from ogr_gensql.cpp
    "OGR_SQL_LIKE_AS_ILIKE", // from ogrwfsfilter.cpp, swq_op_general.cpp
+   "OGR_SQL_ORDER_BY_MAX_MEMORY", // from ogr_gensql.cpp
    "OGR_SQL_STRICT", // from swq.cpp
    "OGR_SQLITE_ALLOW_EXTERNAL_ACCESS", // from ogrsqlitesqlfunctionscommon.cpp
    "OGR_SQLITE_CACHE", // from ogrgmldatasource.cpp, ogrsqlitedatasource.cpp